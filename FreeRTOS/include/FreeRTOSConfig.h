@@ -45,6 +45,8 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
  #include <stdint.h>
  extern uint32_t SystemCoreClock;
+ extern void telemetry_runtime_init(void);
+ extern uint32_t telemetry_runtime_count(void);
 #endif
 
 #define configUSE_PREEMPTION                    1
@@ -66,7 +68,12 @@
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_APPLICATION_TASK_TAG          0
 #define configUSE_COUNTING_SEMAPHORES           1
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
+
+/* The CPU time of the tasks, for /tasks.json: the DWT cycle counter
+   (app_telemetry.c) */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    telemetry_runtime_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()            telemetry_runtime_count()
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                   0
@@ -0,0 +1,174 @@
+#include "systemNetLend.h"
+#include "lwip/tcp.h"
+#include "lwip/sys.h"
+#include "lwip/tcpip.h"
+
+/*
+ * Buffers lent to the stack, see systemNetLend.h.
+ *
+ * The datagrams are used in turn: head and tail are free running counts,
+ * one datagram each. The stack frees their parts in the tcpip thread or in
+ * the interface thread once the DMA is done, possibly out of order (one is
+ * dropped while an older one is still in flight); only the lender moves
+ * tail, past the datagrams whose parts are all freed.
+ */
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "systemNetLend needs LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/**
+ * Bytes written to conn with NETCONN_NOCOPY and not acknowledged yet: the
+ * stack still references the last ones written. Only valid while every
+ * write to conn is made in place.
+ */
+uint32_t netlend_tcp_unacked(struct netconn * conn)
+{
+	uint32_t unacked = 0;
+
+	LOCK_TCPIP_CORE();
+	if(NULL != conn->pcb.tcp)
+	{
+		unacked = TCP_SND_BUF - tcp_sndbuf(conn->pcb.tcp);
+	}
+	UNLOCK_TCPIP_CORE();
+
+	return unacked;
+}
+
+/**
+ * Aborts conn if the stack still references bytes written in place: it
+ * would go on retransmitting them, closed or not, after the regions are
+ * reused. Called before giving them back for good; the receiver of conn
+ * gets ERR_ABRT.
+ * @return the unacknowledged bytes dropped with the connection
+ */
+uint32_t netlend_tcp_abort(struct netconn * conn)
+{
+	uint32_t unacked = 0;
+
+	LOCK_TCPIP_CORE();
+	if(NULL != conn->pcb.tcp)
+	{
+		unacked = TCP_SND_BUF - tcp_sndbuf(conn->pcb.tcp);
+		if(0 != unacked)
+		{
+			tcp_abort(conn->pcb.tcp);
+		}
+	}
+	UNLOCK_TCPIP_CORE();
+
+	return unacked;
+}
+
+/* custom_free_function of the parts */
+static void netlend_free(struct pbuf * p)
+{
+	netlend_part_t * part = (netlend_part_t *)p;
+	SYS_ARCH_DECL_PROTECT(old_level);
+
+	SYS_ARCH_PROTECT(old_level);
+	part->dgram->held--;
+	SYS_ARCH_UNPROTECT(old_level);
+}
+
+/* Moves tail past the datagrams the stack has freed */
+static void netlend_reclaim(netlend_t * l)
+{
+	while((l->tail != l->head) && (0 == l->dgram[l->tail % NETLEND_UDP_MAX].held))
+	{
+		l->tail++;
+	}
+}
+
+/**
+ * Sends the regions as one datagram on the connected UDP conn, in place.
+ * buf is only used to carry the chain to netconn_send().
+ * @return ERR_WOULDBLOCK while NETLEND_UDP_MAX datagrams are still held,
+ *         or the error of netconn_send(): the regions are lent either way
+ */
+err_t netlend_udp_send(netlend_t * l, struct netconn * conn, struct netbuf * buf,
+		const struct netvector * vectors, uint16_t count)
+{
+	netlend_dgram_t		* d;
+	struct pbuf			* chain = NULL;
+	struct pbuf			* p;
+	uint16_t			i;
+	err_t				err;
+
+	LWIP_ASSERT("too many regions", count <= NETLEND_REGION_MAX);
+
+	netlend_reclaim(l);
+	if(l->head - l->tail >= NETLEND_UDP_MAX)
+	{
+		l->stats.busy++;
+		return ERR_WOULDBLOCK;
+	}
+
+	d = &l->dgram[l->head % NETLEND_UDP_MAX];
+	d->len = 0;
+	d->held = 0;
+	for(i = 0; i < count; i++)
+	{
+		if(0 == vectors[i].len)
+		{
+			continue;
+		}
+
+		d->part[d->held].dgram = d;
+		d->part[d->held].pc.custom_free_function = netlend_free;
+		p = pbuf_alloced_custom(PBUF_RAW, (u16_t)vectors[i].len, PBUF_REF, &d->part[d->held].pc,
+				(void *)vectors[i].ptr, (u16_t)vectors[i].len);
+		d->held++;
+		d->len += vectors[i].len;
+
+		if(NULL == chain)
+		{
+			chain = p;
+		}
+		else
+		{
+			pbuf_cat(chain, p);
+		}
+	}
+
+	if(NULL == chain)
+	{
+		return ERR_OK;
+	}
+	l->head++;
+
+	/* The netbuf does not own the chain: the stack takes its own
+	   references, the last one freed gives the datagram back */
+	buf->p = chain;
+	buf->ptr = chain;
+	err = netconn_send(conn, buf);
+	buf->p = NULL;
+	buf->ptr = NULL;
+	pbuf_free(chain);
+
+	if(ERR_OK == err)
+	{
+		l->stats.datagrams++;
+		l->stats.bytes += d->len;
+	}
+	return err;
+}
+
+/**
+ * Bytes lent since the oldest datagram the stack still holds was: what
+ * ring_release() keeps.
+ */
+uint32_t netlend_udp_unacked(netlend_t * l)
+{
+	uint32_t unacked = 0;
+	uint32_t i;
+
+	netlend_reclaim(l);
+	for(i = l->tail; i != l->head; i++)
+	{
+		unacked += l->dgram[i % NETLEND_UDP_MAX].len;
+	}
+
+	return unacked;
+}
@@ -0,0 +1,72 @@
+#ifndef __SYS_NET_LEND_H__
+#define __SYS_NET_LEND_H__
+
+#include <stdint.h>
+
+#include "lwip/api.h"
+#include "lwip/pbuf.h"
+
+/*
+ * Application buffers lent to the stack: sent in place, without copying,
+ * and given back once the stack no longer references them.
+ *
+ * TCP: the regions are written with netconn_write_vectors_partly() and
+ * NETCONN_NOCOPY, in one call so that a segment spans them (both sides of
+ * the end of a ring). They are referenced until acknowledged:
+ * netlend_tcp_unacked() tells how many of the last bytes written that is.
+ * Closing conn does not end that, netlend_tcp_abort() does.
+ *
+ * UDP: netlend_udp_send() sends the regions as one datagram, a chain of
+ * PBUF_REF pbufs pointing at them. The driver may hold it until its DMA is
+ * done: netlend_udp_unacked() tells how many of the last bytes lent the
+ * oldest datagram still held starts back from.
+ *
+ * Both counts are what ring_release() takes.
+ */
+
+/* Datagrams lent at once: sent and not freed by the stack yet */
+#ifndef NETLEND_UDP_MAX
+#define NETLEND_UDP_MAX			4
+#endif
+
+/* Regions of a datagram */
+#define NETLEND_REGION_MAX		2
+
+typedef struct netlend netlend_t;
+
+typedef struct
+{
+	struct pbuf_custom		pc;				/* first: its pbuf is what the stack frees */
+	struct netlend_dgram	* dgram;
+} netlend_part_t;
+
+typedef struct netlend_dgram
+{
+	netlend_part_t			part[NETLEND_REGION_MAX];
+	uint32_t				len;
+	volatile uint8_t		held;			/* parts the stack has not freed yet */
+} netlend_dgram_t;
+
+typedef struct
+{
+	uint32_t	datagrams;		/* sent in place */
+	uint32_t	bytes;
+	uint32_t	busy;			/* refused, every datagram still held */
+} netlend_stats_t;
+
+struct netlend
+{
+	netlend_dgram_t			dgram[NETLEND_UDP_MAX];
+	uint32_t				head;			/* datagrams lent */
+	uint32_t				tail;			/* oldest one still held */
+	netlend_stats_t			stats;
+};
+
+uint32_t netlend_tcp_unacked(struct netconn * conn);
+uint32_t netlend_tcp_abort(struct netconn * conn);
+
+err_t netlend_udp_send(netlend_t * l, struct netconn * conn, struct netbuf * buf,
+		const struct netvector * vectors, uint16_t count);
+uint32_t netlend_udp_unacked(netlend_t * l);
+
+#endif
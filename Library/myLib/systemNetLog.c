@@ -0,0 +1,5 @@
+#include "systemNetLog.h"
+
+static uint8_t		netlog_buf[NETLOG_BUFFER_SIZE];
+
+ring_t				netlog = RING_INIT(netlog_buf);
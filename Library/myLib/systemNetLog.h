@@ -0,0 +1,44 @@
+#ifndef __SYS_NET_LOG_H__
+#define __SYS_NET_LOG_H__
+
+#include <stdint.h>
+
+#include "systemRing.h"
+
+/*
+ * Log records streamed to the network, on a systemRing.h ring.
+ *
+ * printlog() and fputc() write whole records with netlog_write(). One
+ * sender thread takes them out in place with netlog_peek()/netlog_consume()
+ * and hands them to the stack without copying. The bytes stay in the ring
+ * until the sender gives them back with netlog_release(), once the stack no
+ * longer references them (for TCP: once they are acknowledged).
+ */
+
+/* Bytes of the ring, a power of 2. It holds what the stack has not
+   acknowledged yet and the records waiting behind: with less than
+   TCP_SND_BUF, the ring and not the send buffer bounds what is in flight. */
+#ifndef NETLOG_BUFFER_SIZE
+#define NETLOG_BUFFER_SIZE		(1U << 12)
+#endif
+
+/* Signal flag set on the sender thread by netlog_write() */
+#define NETLOG_SIGNAL			RING_SIGNAL
+
+typedef ring_stats_t netlog_stats_t;
+
+extern ring_t netlog;
+
+#define netlog_write(data, len)				ring_write(&netlog, data, len)
+#define netlog_attach(sender, wake_level)	ring_attach(&netlog, sender, wake_level)
+#define netlog_detach(unacked)				ring_detach(&netlog, unacked)
+#define netlog_attached()					ring_attached(&netlog)
+#define netlog_pending()					ring_pending(&netlog)
+#define netlog_peek(data)					ring_peek(&netlog, data)
+#define netlog_peekv(data, len)				ring_peekv(&netlog, data, len)
+#define netlog_consume(len)					ring_consume(&netlog, len)
+#define netlog_release(unacked)				ring_release(&netlog, unacked)
+#define netlog_stall()						ring_stall(&netlog)
+#define netlog_get_stats(stats)				ring_get_stats(&netlog, stats)
+
+#endif
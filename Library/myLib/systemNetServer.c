@@ -0,0 +1,588 @@
+#include <string.h>
+
+#include "systemNetServer.h"
+#include "lwip/sys.h"
+
+/*
+ * Event driven TCP server, see systemNetServer.h.
+ *
+ * The event table is shared with the tcpip thread: netsrv_event() counts
+ * the events of a netconn in its entry, the worker takes them, both under
+ * SYS_ARCH_PROTECT(). An entry is created by the first event of a netconn,
+ * which may come before the worker accepted it, and given back when the
+ * worker deletes the netconn. The connection slots belong to the worker.
+ */
+
+#if NETSRV_CONN_MAX > 0x7f
+#error "NETSRV_CONN_MAX must be below 128"
+#endif
+
+#define NETSRV_NONE			0xff	/* entry of a netconn not accepted yet */
+#define NETSRV_LISTENER		0x80	/* entry of a listener, its index below */
+
+typedef struct
+{
+	struct netconn	* conn;			/* NULL: free */
+	int16_t			rcv;			/* receptions or accepts that will not block */
+	uint8_t			ready;			/* events the worker has not looked at */
+	uint8_t			wait_send;		/* the worker waits for room in the send buffer */
+	uint8_t			slot;			/* connection slot, NETSRV_LISTENER | listener or NETSRV_NONE */
+} netsrv_evt_t;
+
+typedef struct
+{
+	struct netconn				* conn;
+	const netsrv_handler_t		* handler;		/* NULL: free */
+} netsrv_listener_t;
+
+static netsrv_evt_t				netsrv_evt[NETSRV_EVT_MAX];
+static netsrv_listener_t		netsrv_listeners[NETSRV_LISTEN_MAX];
+static netsrv_conn_t			netsrv_conns[NETSRV_CONN_MAX];
+static osThreadId volatile		netsrv_worker = NULL;
+static netsrv_stats_t			netsrv_stats;
+
+/* The entry of conn, created if it has none. Under SYS_ARCH_PROTECT(). */
+static netsrv_evt_t * netsrv_evt_get(struct netconn * conn)
+{
+	netsrv_evt_t	* e;
+	netsrv_evt_t	* unused = NULL;
+
+	for(e = netsrv_evt; e < &netsrv_evt[NETSRV_EVT_MAX]; e++)
+	{
+		if(conn == e->conn)
+		{
+			return e;
+		}
+		if((NULL == e->conn) && (NULL == unused))
+		{
+			unused = e;
+		}
+	}
+
+	if(NULL != unused)
+	{
+		unused->conn = conn;
+		unused->rcv = 0;
+		unused->ready = 0;
+		unused->wait_send = 0;
+		unused->slot = NETSRV_NONE;
+	}
+	return unused;
+}
+
+/* Callback of the netconns given back: they are being deleted */
+static void netsrv_ignore(struct netconn * conn, enum netconn_evt evt, u16_t len)
+{
+}
+
+/* netconn callback, in the tcpip thread, or in the worker for the
+   NETCONN_EVT_RCVMINUS of its own receptions */
+static void netsrv_event(struct netconn * conn, enum netconn_evt evt, u16_t len)
+{
+	netsrv_evt_t	* e;
+	osThreadId		worker;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	e = (netsrv_event == conn->callback) ? netsrv_evt_get(conn) : NULL;
+	if(NULL == e)
+	{
+		SYS_ARCH_UNPROTECT(lev);
+		return;
+	}
+
+	switch(evt)
+	{
+	case NETCONN_EVT_RCVPLUS:
+		e->rcv++;
+		break;
+
+	case NETCONN_EVT_RCVMINUS:
+		e->rcv--;
+		SYS_ARCH_UNPROTECT(lev);
+		return;
+
+	case NETCONN_EVT_SENDPLUS:
+		/* Every acknowledgement makes room: only wanted when waited for */
+		if(0 == e->wait_send)
+		{
+			SYS_ARCH_UNPROTECT(lev);
+			return;
+		}
+		break;
+
+	case NETCONN_EVT_SENDMINUS:
+		SYS_ARCH_UNPROTECT(lev);
+		return;
+
+	default:
+		break;
+	}
+	e->ready = 1;
+	netsrv_stats.events++;
+	SYS_ARCH_UNPROTECT(lev);
+
+	worker = netsrv_worker;
+	if(NULL != worker)
+	{
+		osSignalSet(worker, NETSRV_SIGNAL);
+	}
+}
+
+/* Deletes conn, its entry being given back first: no event may reach the
+   entry once another netconn got the same address */
+static void netsrv_release(struct netconn * conn, netsrv_evt_t * e)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	conn->callback = netsrv_ignore;
+	if(NULL != e)
+	{
+		e->conn = NULL;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	netconn_delete(conn);
+}
+
+static int16_t netsrv_rcv(netsrv_evt_t * e)
+{
+	int16_t		rcv;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	rcv = e->rcv;
+	SYS_ARCH_UNPROTECT(lev);
+
+	return rcv;
+}
+
+static void netsrv_free(netsrv_conn_t * c)
+{
+	if(NULL != c->handler->close)
+	{
+		c->handler->close(c);
+	}
+	if(NULL != c->rx)
+	{
+		pbuf_free(c->rx);
+		c->rx = NULL;
+	}
+	netsrv_release(c->conn, &netsrv_evt[c->evt]);
+
+	c->conn = NULL;
+	c->state = NETSRV_FREE;
+	netsrv_stats.used--;
+	netsrv_stats.closed++;
+}
+
+/* Hands the send buffer to the stack, as much as it takes */
+static void netsrv_flush(netsrv_conn_t * c)
+{
+	netsrv_evt_t		* e = &netsrv_evt[c->evt];
+	struct netvector	vectors[2];
+	uint32_t			pos, len;
+	size_t				written;
+	err_t				err;
+
+	while(c->tx_head != c->tx_tail)
+	{
+		/* Before trying: the room may come before the answer */
+		e->wait_send = 1;
+
+		/* Both sides of the end of the buffer in one write, copied: the
+		   handler reuses the room at once */
+		pos = c->tx_tail & (NETSRV_TX_SIZE - 1);
+		len = c->tx_head - c->tx_tail;
+		vectors[0].ptr = &c->tx[pos];
+		vectors[0].len = len;
+		vectors[1].ptr = &c->tx[0];
+		vectors[1].len = 0;
+		if(len > NETSRV_TX_SIZE - pos)
+		{
+			vectors[0].len = NETSRV_TX_SIZE - pos;
+			vectors[1].len = len - vectors[0].len;
+		}
+
+		err = netconn_write_vectors_partly(c->conn, vectors, 2, NETCONN_COPY | NETCONN_DONTBLOCK, &written);
+		if(ERR_OK == err)
+		{
+			c->tx_tail += (uint32_t)written;
+			netsrv_stats.tx_bytes += (uint32_t)written;
+		}
+		else
+		{
+			if(ERR_WOULDBLOCK != err)
+			{
+				c->state = NETSRV_CLOSED;
+			}
+			return;
+		}
+	}
+
+	if(0 != e->wait_send)
+	{
+		e->wait_send = 0;
+		if((NETSRV_OPEN == c->state) && (NULL != c->handler->sent))
+		{
+			c->handler->sent(c);
+		}
+	}
+}
+
+/* Gives the held pbuf to the handler from where it stopped
+   @return the bytes it took */
+static uint32_t netsrv_deliver(netsrv_conn_t * c)
+{
+	struct pbuf		* q;
+	uint32_t		off = c->rx_off;
+	uint32_t		len, n, taken = 0;
+
+	for(q = c->rx; (NULL != q) && (NETSRV_OPEN == c->state); q = q->next)
+	{
+		if(off >= q->len)
+		{
+			off -= q->len;
+			continue;
+		}
+
+		len = q->len - off;
+		n = c->handler->recv(c, (const uint8_t *)q->payload + off, len);
+		taken += n;
+		if(n < len)
+		{
+			break;
+		}
+		off = 0;
+	}
+
+	netsrv_stats.rx_bytes += taken;
+	c->rx_off = (uint16_t)(c->rx_off + taken);
+	if(c->rx_off >= c->rx->tot_len)
+	{
+		pbuf_free(c->rx);
+		c->rx = NULL;
+	}
+
+	return taken;
+}
+
+/* Runs the state machine of a connection as far as it goes without
+   blocking */
+static void netsrv_serve(netsrv_conn_t * c)
+{
+	netsrv_evt_t	* e = &netsrv_evt[c->evt];
+	err_t			err;
+
+	for(;;)
+	{
+		netsrv_flush(c);
+		if(NETSRV_OPEN != c->state)
+		{
+			break;
+		}
+
+		if(NULL == c->rx)
+		{
+			if(netsrv_rcv(e) <= 0)
+			{
+				break;
+			}
+			err = netconn_recv_tcp_pbuf(c->conn, &c->rx);
+			if(ERR_OK != err)
+			{
+				/* FIN: what is buffered is still sent, anything else is fatal */
+				c->rx = NULL;
+				c->state = (ERR_CLSD == err) ? NETSRV_DRAIN : NETSRV_CLOSED;
+				break;
+			}
+			c->rx_off = 0;
+		}
+
+		if(0 == netsrv_deliver(c))
+		{
+			/* The handler waits for room: woken by NETCONN_EVT_SENDPLUS */
+			netsrv_stats.rx_held++;
+			break;
+		}
+	}
+
+	if((NETSRV_CLOSED == c->state) || ((NETSRV_DRAIN == c->state) && (c->tx_head == c->tx_tail)))
+	{
+		netsrv_free(c);
+	}
+}
+
+static void netsrv_accept(netsrv_listener_t * l, netsrv_evt_t * le)
+{
+	struct netconn	* conn;
+	netsrv_conn_t	* c;
+	netsrv_evt_t	* e;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	while(netsrv_rcv(le) > 0)
+	{
+		if(ERR_OK != netconn_accept(l->conn, &conn))
+		{
+			break;
+		}
+
+		SYS_ARCH_PROTECT(lev);
+		e = netsrv_evt_get(conn);
+		SYS_ARCH_UNPROTECT(lev);
+
+		for(c = netsrv_conns; c < &netsrv_conns[NETSRV_CONN_MAX]; c++)
+		{
+			if(NETSRV_FREE == c->state)
+			{
+				break;
+			}
+		}
+		if((c == &netsrv_conns[NETSRV_CONN_MAX]) || (NULL == e))
+		{
+			netsrv_stats.refused++;
+			netsrv_release(conn, e);
+			continue;
+		}
+
+		c->state = NETSRV_OPEN;
+		c->conn = conn;
+		c->handler = l->handler;
+		c->user = NULL;
+		c->evt = (uint16_t)(e - netsrv_evt);
+		c->rx = NULL;
+		c->rx_off = 0;
+		c->tx_head = 0;
+		c->tx_tail = 0;
+
+		SYS_ARCH_PROTECT(lev);
+		e->slot = (uint8_t)(c - netsrv_conns);
+		SYS_ARCH_UNPROTECT(lev);
+
+		netsrv_stats.accepted++;
+		if(++netsrv_stats.used > netsrv_stats.high_water)
+		{
+			netsrv_stats.high_water = netsrv_stats.used;
+		}
+
+		if(NULL != c->handler->accept)
+		{
+			c->handler->accept(c);
+		}
+		/* What came before the accept */
+		netsrv_serve(c);
+	}
+}
+
+static void netsrv_thread(void const * argument)
+{
+	netsrv_evt_t	* e;
+	uint8_t			ready, slot;
+	int				busy;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	for(;;)
+	{
+		osSignalWait(NETSRV_SIGNAL, osWaitForever);
+		netsrv_stats.wakeups++;
+
+		do
+		{
+			busy = 0;
+			for(e = netsrv_evt; e < &netsrv_evt[NETSRV_EVT_MAX]; e++)
+			{
+				SYS_ARCH_PROTECT(lev);
+				ready = e->ready;
+				e->ready = 0;
+				slot = e->slot;
+				SYS_ARCH_UNPROTECT(lev);
+
+				if(0 == ready)
+				{
+					continue;
+				}
+				busy = 1;
+
+				if(NETSRV_NONE == slot)
+				{
+					/* Served once accepted */
+				}
+				else if(0 != (slot & NETSRV_LISTENER))
+				{
+					netsrv_accept(&netsrv_listeners[slot & ~NETSRV_LISTENER], e);
+				}
+				else
+				{
+					netsrv_serve(&netsrv_conns[slot]);
+				}
+			}
+		} while(busy);
+	}
+}
+
+/**
+ * Starts the worker, once.
+ * @return its thread
+ */
+osThreadId netsrv_init(void)
+{
+	osThreadDef(netsrv_thread, netsrv_thread, NETSRV_PRIORITY, 0, NETSRV_STACK_SIZE);
+
+	if(NULL == netsrv_worker)
+	{
+		netsrv_worker = osThreadCreate(osThread(netsrv_thread), NULL);
+	}
+
+	return netsrv_worker;
+}
+
+/**
+ * Serves the TCP port with handler, from any thread.
+ * @return ERR_MEM if NETSRV_LISTEN_MAX ports are served already, or the
+ *         error of the netconn
+ */
+err_t netsrv_listen(uint16_t port, const netsrv_handler_t * handler)
+{
+	netsrv_listener_t	* l;
+	struct netconn		* conn;
+	netsrv_evt_t		* e;
+	osThreadId			worker;
+	err_t				err;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	for(l = netsrv_listeners; l < &netsrv_listeners[NETSRV_LISTEN_MAX]; l++)
+	{
+		if(NULL == l->handler)
+		{
+			l->handler = handler;
+			break;
+		}
+	}
+	SYS_ARCH_UNPROTECT(lev);
+	if(l == &netsrv_listeners[NETSRV_LISTEN_MAX])
+	{
+		return ERR_MEM;
+	}
+
+	conn = netconn_new_with_callback(NETCONN_TCP, netsrv_event);
+	if(NULL == conn)
+	{
+		l->handler = NULL;
+		return ERR_MEM;
+	}
+	err = netconn_bind(conn, NULL, port);
+	if(ERR_OK == err)
+	{
+		err = netconn_listen(conn);
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	e = netsrv_evt_get(conn);
+	if((ERR_OK == err) && (NULL != e))
+	{
+		l->conn = conn;
+		e->slot = (uint8_t)(NETSRV_LISTENER | (l - netsrv_listeners));
+		e->ready = 1;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	if((ERR_OK != err) || (NULL == e))
+	{
+		netsrv_release(conn, e);
+		l->handler = NULL;
+		return (ERR_OK != err) ? err : ERR_MEM;
+	}
+
+	/* For the connections that came before */
+	worker = netsrv_worker;
+	if(NULL != worker)
+	{
+		osSignalSet(worker, NETSRV_SIGNAL);
+	}
+	return ERR_OK;
+}
+
+/**
+ * Sends data on c: what the stack has no room for is kept in the send
+ * buffer, as much as fits.
+ * @return the bytes taken, len unless the send buffer is full
+ */
+uint32_t netsrv_write(netsrv_conn_t * c, const void * data, uint32_t len)
+{
+	uint32_t		pos, first, space;
+	size_t			written = 0;
+	err_t			err;
+
+	if(NETSRV_OPEN != c->state)
+	{
+		return 0;
+	}
+
+	/* Nothing buffered: straight to the stack, without copying it here */
+	if(c->tx_head == c->tx_tail)
+	{
+		netsrv_evt[c->evt].wait_send = 1;
+		err = netconn_write_partly(c->conn, data, len, NETCONN_COPY | NETCONN_DONTBLOCK, &written);
+		if((ERR_OK != err) && (ERR_WOULDBLOCK != err))
+		{
+			c->state = NETSRV_CLOSED;
+			return 0;
+		}
+		if(ERR_OK != err)
+		{
+			written = 0;
+		}
+		netsrv_stats.tx_bytes += (uint32_t)written;
+		if(written == len)
+		{
+			netsrv_evt[c->evt].wait_send = 0;
+			return len;
+		}
+		data = (const uint8_t *)data + written;
+		len -= (uint32_t)written;
+	}
+
+	space = NETSRV_TX_SIZE - (c->tx_head - c->tx_tail);
+	if(len > space)
+	{
+		len = space;
+		netsrv_stats.tx_full++;
+	}
+
+	pos = c->tx_head & (NETSRV_TX_SIZE - 1);
+	first = NETSRV_TX_SIZE - pos;
+	if(len <= first)
+	{
+		memcpy(&c->tx[pos], data, len);
+	}
+	else
+	{
+		memcpy(&c->tx[pos], data, first);
+		memcpy(c->tx, (const uint8_t *)data + first, len - first);
+	}
+	c->tx_head += len;
+
+	return (uint32_t)written + len;
+}
+
+/* Bytes netsrv_write() takes at least */
+uint32_t netsrv_space(netsrv_conn_t * c)
+{
+	return (NETSRV_OPEN == c->state) ? NETSRV_TX_SIZE - (c->tx_head - c->tx_tail) : 0;
+}
+
+/* Closes c once its send buffer is sent. The held data is dropped. */
+void netsrv_close(netsrv_conn_t * c)
+{
+	if(NETSRV_OPEN == c->state)
+	{
+		c->state = NETSRV_DRAIN;
+	}
+}
+
+void netsrv_get_stats(netsrv_stats_t * stats)
+{
+	*stats = netsrv_stats;
+}
@@ -0,0 +1,131 @@
+#ifndef __SYS_NET_SERVER_H__
+#define __SYS_NET_SERVER_H__
+
+#include <stdint.h>
+
+#include "cmsis_os.h"
+#include "lwip/api.h"
+
+/*
+ * Event driven TCP server: one worker thread serves every connection of the
+ * ports given to netsrv_listen(), instead of a thread, or a blocking loop,
+ * per connection.
+ *
+ * The netconns are created with a callback that counts their events, as the
+ * socket layer does for select(), and signals the worker. The worker only
+ * calls netconn_accept() and netconn_recv_tcp_pbuf() when an event says they
+ * will not block, and writes with NETCONN_DONTBLOCK.
+ *
+ * Each connection is a state machine over a slot of NETSRV_CONN_MAX, with
+ * at most one received pbuf held and a NETSRV_TX_SIZE byte send buffer: a
+ * handler that cannot take more data (its replies do not fit) leaves the
+ * rest of the pbuf to the next call, made on the next event of the
+ * connection, and nothing more is received from it until then: the peer is
+ * slowed down by the TCP window.
+ * A connection accepted while every slot is in use is closed at once.
+ *
+ * The handlers run in the worker thread. netsrv_write(), netsrv_space() and
+ * netsrv_close() are only called from them.
+ */
+
+/* Connections served at once, set in lwipopts.h: MEMP_NUM_NETCONN is sized
+   after it */
+#ifndef NETSRV_CONN_MAX
+#error "NETSRV_CONN_MAX must be set in lwipopts.h"
+#endif
+
+/* Ports listened to */
+#ifndef NETSRV_LISTEN_MAX
+#define NETSRV_LISTEN_MAX		2
+#endif
+
+/* Bytes of the send buffer of a connection, a power of 2: what the handler
+   wrote and the stack had no room for yet */
+#ifndef NETSRV_TX_SIZE
+#define NETSRV_TX_SIZE			512
+#endif
+
+/* Netconns that can carry the callback: listeners, connections being served
+   and the ones waiting to be accepted. One per netconn of the pool, so that
+   no event is ever lost. */
+#ifndef NETSRV_EVT_MAX
+#define NETSRV_EVT_MAX			MEMP_NUM_NETCONN
+#endif
+
+#ifndef NETSRV_PRIORITY
+#define NETSRV_PRIORITY			osPriorityNormal
+#endif
+
+#ifndef NETSRV_STACK_SIZE
+#define NETSRV_STACK_SIZE		(configMINIMAL_STACK_SIZE * 3)
+#endif
+
+/* Signal flag set on the worker by the netconn callback */
+#define NETSRV_SIGNAL			0x0001
+
+#if (NETSRV_TX_SIZE & (NETSRV_TX_SIZE - 1)) != 0
+#error "NETSRV_TX_SIZE must be a power of 2"
+#endif
+
+typedef enum
+{
+	NETSRV_FREE = 0,
+	NETSRV_OPEN,						/* receiving and sending */
+	NETSRV_DRAIN,						/* closing: what is buffered is sent first */
+	NETSRV_CLOSED
+} netsrv_state_t;
+
+typedef struct netsrv_conn netsrv_conn_t;
+
+typedef struct
+{
+	/* Optional: a connection was accepted */
+	void		(* accept)(netsrv_conn_t * c);
+	/* Received data: returns the bytes taken, the rest is given again on
+	   the next call */
+	uint32_t	(* recv)(netsrv_conn_t * c, const uint8_t * data, uint32_t len);
+	/* Optional: the send buffer was emptied */
+	void		(* sent)(netsrv_conn_t * c);
+	/* Optional: the connection is closed, c is reused after this */
+	void		(* close)(netsrv_conn_t * c);
+} netsrv_handler_t;
+
+struct netsrv_conn
+{
+	netsrv_state_t				state;
+	struct netconn				* conn;
+	const netsrv_handler_t		* handler;
+	void						* user;			/* for the handler */
+	uint16_t					evt;			/* entry in the event table */
+	uint16_t					rx_off;			/* taken from rx by the handler */
+	struct pbuf					* rx;			/* received, not taken yet */
+	uint32_t					tx_head;
+	uint32_t					tx_tail;
+	uint8_t						tx[NETSRV_TX_SIZE];
+};
+
+typedef struct
+{
+	uint32_t	accepted;
+	uint32_t	refused;			/* accepted with every slot in use */
+	uint32_t	closed;
+	uint32_t	wakeups;			/* of the worker */
+	uint32_t	events;				/* netconn events counted */
+	uint32_t	rx_bytes;
+	uint32_t	tx_bytes;
+	uint32_t	tx_full;			/* netsrv_write() that did not fit whole */
+	uint32_t	rx_held;			/* receptions left to a later call */
+	uint16_t	used;				/* slots in use */
+	uint16_t	high_water;			/* most slots in use */
+} netsrv_stats_t;
+
+osThreadId netsrv_init(void);
+err_t netsrv_listen(uint16_t port, const netsrv_handler_t * handler);
+
+uint32_t netsrv_write(netsrv_conn_t * c, const void * data, uint32_t len);
+uint32_t netsrv_space(netsrv_conn_t * c);
+void netsrv_close(netsrv_conn_t * c);
+
+void netsrv_get_stats(netsrv_stats_t * stats);
+
+#endif
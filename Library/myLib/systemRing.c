@@ -0,0 +1,312 @@
+#include <string.h>
+
+#include "systemRing.h"
+
+/*
+ * Multi-producer, single-consumer byte ring, see systemRing.h.
+ *
+ * Positions are free running byte counts, only their difference wraps:
+ *
+ *   tail <= sent <= ready <= done, head
+ *
+ * head   reserved by the producers
+ * done   committed by the producers: when it equals head, every byte up to
+ *        there has been copied in
+ * ready  highest point seen with done == head, what the consumer may take
+ * sent   taken by the consumer
+ * tail   released by the consumer, the producers may reuse what is before
+ */
+
+#ifdef __CC_ARM
+#include "systemMyLib.h"
+
+/* Exclusive load/store of the Cortex-M3: no interrupt masking, a producer
+   interrupted between the two simply tries again */
+static __inline int ring_cas(volatile uint32_t * p, uint32_t expect, uint32_t value)
+{
+	do
+	{
+		if(__LDREXW(p) != expect)
+		{
+			__CLREX();
+			return 0;
+		}
+	} while(0 != __STREXW(value, p));
+
+	return 1;
+}
+
+static __inline uint32_t ring_add(volatile uint32_t * p, uint32_t value)
+{
+	uint32_t n;
+
+	do
+	{
+		n = __LDREXW(p) + value;
+	} while(0 != __STREXW(n, p));
+
+	return n;
+}
+
+#define RING_BARRIER()		__DMB()
+#else
+static inline int ring_cas(volatile uint32_t * p, uint32_t expect, uint32_t value)
+{
+	return __atomic_compare_exchange_n(p, &expect, value, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t ring_add(volatile uint32_t * p, uint32_t value)
+{
+	return __atomic_add_fetch(p, value, __ATOMIC_ACQ_REL);
+}
+
+#define RING_BARRIER()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/* Wakes the consumer. ring_detach() waits for the wakes in progress, so the
+   thread is still there when it is signalled. */
+static void ring_wake(ring_t * r)
+{
+	osThreadId sender;
+
+	ring_add(&r->waking, 1);
+	sender = r->sender;
+	if(NULL != sender)
+	{
+		osSignalSet(sender, RING_SIGNAL);
+		ring_add(&r->stats.wakeups, 1);
+	}
+	ring_add(&r->waking, (uint32_t)-1);
+}
+
+/**
+ * Appends one record, from any thread or interrupt.
+ * @return len, or 0 if the record was dropped for lack of space
+ */
+uint32_t ring_write(ring_t * r, const void * data, uint32_t len)
+{
+	uint32_t tail, head, pos, first, pending;
+
+	if(0 == len)
+	{
+		return 0;
+	}
+
+	/* tail is read first: it never passes a head read after it */
+	do
+	{
+		tail = r->tail;
+		head = r->head;
+		if(len > r->mask + 1 - (head - tail))
+		{
+			ring_add(&r->stats.dropped, 1);
+			ring_add(&r->stats.dropped_bytes, len);
+			/* The consumer may be able to give back space by now */
+			if(ring_cas(&r->starved, 0, 1))
+			{
+				ring_wake(r);
+			}
+			return 0;
+		}
+	} while(!ring_cas(&r->head, head, head + len));
+
+	pos = head & r->mask;
+	first = r->mask + 1 - pos;
+	if(len <= first)
+	{
+		memcpy(&r->buf[pos], data, len);
+	}
+	else
+	{
+		memcpy(&r->buf[pos], data, first);
+		memcpy(&r->buf[0], (const uint8_t *)data + first, len - first);
+	}
+
+	RING_BARRIER();
+	pending = ring_add(&r->done, len) - r->sent;
+	ring_add(&r->stats.records, 1);
+
+	/* The consumer sleeps on an empty ring and may wait for wake_level
+	   bytes: wake it on the first record, and when they are there */
+	if((pending == len) || ((pending >= r->wake_level) && (pending - len < r->wake_level)))
+	{
+		ring_wake(r);
+	}
+
+	return len;
+}
+
+/**
+ * Makes sender the consumer thread, notified with RING_SIGNAL. It is woken
+ * when the first record arrives and when wake_level bytes are waiting.
+ */
+void ring_attach(ring_t * r, osThreadId sender, uint32_t wake_level)
+{
+	r->wake_level = wake_level;
+	RING_BARRIER();
+	r->sender = sender;
+}
+
+/**
+ * Stops the notifications, called by the consumer before it goes away. What
+ * it has taken is given back but the last unacked bytes, as ring_release():
+ * they stay reserved until the next consumer releases them. The records not
+ * taken yet stay for it too.
+ */
+void ring_detach(ring_t * r, uint32_t unacked)
+{
+	r->sender = NULL;
+	RING_BARRIER();
+	while(0 != r->waking)
+	{
+		osDelay(1);
+	}
+	ring_release(r, unacked);
+}
+
+/* Whether a consumer is attached, the records are buffered meanwhile */
+int ring_attached(ring_t * r)
+{
+	return NULL != r->sender;
+}
+
+/**
+ * Bytes committed and not taken yet. Some may still be behind a record
+ * being written, see ring_peek().
+ */
+uint32_t ring_pending(ring_t * r)
+{
+	return r->done - r->sent;
+}
+
+/* Moves ready up to what the producers have completed */
+static uint32_t ring_ready(ring_t * r)
+{
+	uint32_t done, used;
+
+	done = r->done;
+	RING_BARRIER();
+	if(done == r->head)
+	{
+		r->ready = done;
+	}
+
+	used = r->head - r->tail;
+	if(used > r->stats.high_water)
+	{
+		r->stats.high_water = used;
+	}
+
+	return r->ready - r->sent;
+}
+
+/**
+ * Points data at the oldest bytes not taken yet, in place.
+ * @return how many of them are contiguous and complete, 0 while a producer
+ *         is still writing in front of them
+ */
+uint32_t ring_peek(ring_t * r, const uint8_t ** data)
+{
+	uint32_t pos, len;
+
+	ring_ready(r);
+	pos = r->sent & r->mask;
+	len = r->ready - r->sent;
+	if(len > r->mask + 1 - pos)
+	{
+		len = r->mask + 1 - pos;
+	}
+
+	*data = &r->buf[pos];
+	return len;
+}
+
+/**
+ * Points data[0] at the oldest bytes not taken yet, in place, and data[1]
+ * at the start of the buffer for the ones wrapped past its end.
+ * @return how many of them are complete, len[0] + len[1]; len[1] is 0 when
+ *         they do not wrap
+ */
+uint32_t ring_peekv(ring_t * r, const uint8_t * data[2], uint32_t len[2])
+{
+	uint32_t pos, total;
+
+	total = ring_ready(r);
+	pos = r->sent & r->mask;
+	len[0] = total;
+	len[1] = 0;
+	if(total > r->mask + 1 - pos)
+	{
+		len[0] = r->mask + 1 - pos;
+		len[1] = total - len[0];
+	}
+
+	data[0] = &r->buf[pos];
+	data[1] = &r->buf[0];
+	return total;
+}
+
+/**
+ * Copies out up to len of the oldest bytes not taken yet, across the end of
+ * the buffer, without taking them.
+ * @return how many were complete and copied
+ */
+uint32_t ring_read(ring_t * r, void * data, uint32_t len)
+{
+	uint32_t pos, first;
+
+	first = ring_ready(r);
+	if(len > first)
+	{
+		len = first;
+	}
+
+	pos = r->sent & r->mask;
+	first = r->mask + 1 - pos;
+	if(len <= first)
+	{
+		memcpy(data, &r->buf[pos], len);
+	}
+	else
+	{
+		memcpy(data, &r->buf[pos], first);
+		memcpy((uint8_t *)data + first, &r->buf[0], len - first);
+	}
+
+	return len;
+}
+
+/**
+ * The consumer has taken len bytes from ring_peek() or ring_read(). They
+ * stay in the ring until ring_release().
+ */
+void ring_consume(ring_t * r, uint32_t len)
+{
+	r->sent += len;
+	r->stats.segments++;
+}
+
+/**
+ * Gives back to the producers everything taken but the last unacked bytes,
+ * which the consumer still references (a network stack sending in place).
+ */
+void ring_release(ring_t * r, uint32_t unacked)
+{
+	if(unacked <= r->sent - r->tail)
+	{
+		r->tail = r->sent - unacked;
+	}
+	r->starved = 0;
+}
+
+/* Counts a hand-over refused downstream: backpressure */
+void ring_stall(ring_t * r)
+{
+	r->stats.stalls++;
+}
+
+void ring_get_stats(ring_t * r, ring_stats_t * stats)
+{
+	*stats = r->stats;
+	stats->bytes = r->done;
+}
@@ -0,0 +1,73 @@
+#ifndef __SYS_RING_H__
+#define __SYS_RING_H__
+
+#include <stdint.h>
+
+#include "cmsis_os.h"
+
+/*
+ * Byte ring for records from many producers to one consumer thread.
+ *
+ * Any thread or interrupt writes whole records with ring_write(): the
+ * space is reserved with a compare-and-swap, so producers never wait for
+ * each other nor for the consumer, and a record that does not fit is
+ * dropped and counted instead of overwriting older ones.
+ *
+ * The consumer takes the committed bytes in place with ring_peek(), or
+ * ring_peekv() for both sides of the end of the buffer, or copies them out
+ * with ring_read(), then ring_consume(). They stay in the ring until it
+ * gives them back with ring_release(), so that a network stack can send
+ * them without copying.
+ */
+
+/* Signal flag set on the consumer thread by ring_write() */
+#define RING_SIGNAL				0x0001
+
+/* Static initializer, buffer being an array of a power of 2 bytes */
+#define RING_INIT(buffer)		{ .buf = (buffer), .mask = sizeof(buffer) - 1 }
+
+typedef struct
+{
+	uint32_t	records;		/* records written */
+	uint32_t	bytes;			/* bytes written */
+	uint32_t	dropped;		/* records dropped, the ring being full */
+	uint32_t	dropped_bytes;	/* bytes of the dropped records */
+	uint32_t	segments;		/* hand-overs by the consumer */
+	uint32_t	stalls;			/* hand-overs refused downstream: backpressure */
+	uint32_t	wakeups;		/* notifications of the consumer */
+	uint32_t	high_water;		/* most bytes held by the ring */
+} ring_stats_t;
+
+typedef struct
+{
+	volatile uint32_t	head;
+	volatile uint32_t	done;
+	uint32_t			ready;
+	volatile uint32_t	sent;
+	volatile uint32_t	tail;
+	osThreadId volatile	sender;
+	uint32_t			wake_level;
+	volatile uint32_t	waking;		/* producers signalling the consumer */
+	volatile uint32_t	starved;	/* a record was dropped since the last release */
+	ring_stats_t		stats;
+	uint8_t				* buf;
+	uint32_t			mask;
+} ring_t;
+
+uint32_t ring_write(ring_t * r, const void * data, uint32_t len);
+
+void ring_attach(ring_t * r, osThreadId sender, uint32_t wake_level);
+void ring_detach(ring_t * r, uint32_t unacked);
+int ring_attached(ring_t * r);
+
+uint32_t ring_pending(ring_t * r);
+uint32_t ring_peek(ring_t * r, const uint8_t ** data);
+uint32_t ring_peekv(ring_t * r, const uint8_t * data[2], uint32_t len[2]);
+uint32_t ring_read(ring_t * r, void * data, uint32_t len);
+void ring_consume(ring_t * r, uint32_t len);
+void ring_release(ring_t * r, uint32_t unacked);
+void ring_stall(ring_t * r);
+
+void ring_get_stats(ring_t * r, ring_stats_t * stats);
+
+#endif
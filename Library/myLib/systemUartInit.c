@@ -21,27 +21,28 @@ void _sys_exit(int x)
 } 
 
 #ifdef PUT_CHAR_TO_NETWORK
-#include "test_lwip.h"
-#include "test_lwip_seq_api.h"
-extern struct TX_buffer_manage * txbuf;
+#include "systemNetLog.h"
 #endif
 
+/* Polled output of the debug UART */
+void uart_write(const char * data, uint32_t len)
+{
+	while(len--)
+	{
+		while((USARTx->SR&0X40)==0);
+		USARTx->DR=(uint8_t)*data++;
+	}
+}
+
 int fputc(int ch, FILE *f)
 { 	
 	while((USARTx->SR&0X40)==0);
 	USARTx->DR=(uint8_t)ch;   
 #ifdef PUT_CHAR_TO_NETWORK
-	uint32_t mask;
-	
-	mask = taskENTER_CRITICAL_FROM_ISR();
-
-	if(NULL != txbuf)
-	{
-		txbuf->tx_buffer[txbuf->p_write & TX_BUFFER_MASK] = ch;
-		++txbuf->p_write;
-	}
+	uint8_t c = (uint8_t)ch;
 
-	taskEXIT_CRITICAL_FROM_ISR(mask);
+	/* One byte record: whole lines go through printlog() */
+	netlog_write(&c, 1);
 #endif
 	return ch;
 }
@@ -36,5 +36,6 @@ extern UART_HandleTypeDef       UART1_Handler;
 extern uint8_t                  aRxBuffer[RXBUFFERSIZE];
 
 void uart_init(uint32_t bound);
+void uart_write(const char * data, uint32_t len);
 
 #endif
@@ -6,36 +6,290 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include "cmsis_os.h"
+
 #include "systemMyLib.h"
 #include "systemlog.h"
+#include "systemRing.h"
+#include "systemUartInit.h"
+#ifdef PUT_CHAR_TO_NETWORK
+#include "systemNetLog.h"
+#endif
 
+#define LOG_RECORD_MAX      160             /* longer lines are truncated */
+#define LOG_STRING_MAX      32              /* longer %s arguments are truncated */
+#define LOG_BUFFER_SIZE     (1U << 11)      /* binary records waiting for printlog_thread */
+#define LOG_CONVERSION      "-+ #0123456789.hl"
 
-void printlog(int level, const char * funcname, int linenum, const char * format, ...)
+/* Layout of the arguments of a site: LOG_ARG_BITS per argument from bit 0,
+   LOG_ARG_END after the last one, LOG_LAYOUT_PARSED once it is known */
+#define LOG_ARG_END         0U
+#define LOG_ARG_WORD        1U
+#define LOG_ARG_STRING      2U
+#define LOG_ARG_DOUBLE      3U
+#define LOG_ARG_BITS        2
+#define LOG_ARG_MASK        ((1U << LOG_ARG_BITS) - 1)
+#define LOG_ARG_MAX         15              /* further arguments are not recorded */
+#define LOG_LAYOUT_PARSED   (1UL << 31)
+
+
+/* What printlog_binary() writes: the arguments follow as 32 bit words, a
+   %s argument as its characters up to the NUL and padded to a word, a %f
+   one as the two words of the double */
+typedef struct
+{
+    const log_site_t *  site;
+    uint32_t            tick;
+    uint16_t            len;        /* of the whole record */
+    uint16_t            reserved;
+} log_record_t;
+
+static uint8_t  log_buf[LOG_BUFFER_SIZE];
+static ring_t   log_ring = RING_INIT(log_buf);
+
+
+static void printlog_output(const char * text, int len)
 {
-    /*if(inHandlerMode() != 0)
+    uart_write(text, (uint32_t)len);
+#ifdef PUT_CHAR_TO_NETWORK
+    netlog_write(text, (uint32_t)len);
+#endif
+}
+
+/* snprintf() returns what it would have written */
+static int printlog_clamp(int len, int n, int size)
+{
+    if (n > 0)
     {
-        taskDISABLE_INTERRUPTS();
-    }            
-    else
+        len += n;
+    }
+    return (len >= size) ? size - 1 : len;
+}
+
+/* Each line is formatted once and written as one record: to the UART, and
+   to the network log ring without a critical section per character */
+void printlog(int level, const char * funcname, int linenum, const char * format, ...)
+{
+    char record[LOG_RECORD_MAX];
+    int len;
+    va_list ap;
+
+    len = printlog_clamp(0, snprintf(record, sizeof(record), "In %s at %d line :", funcname, linenum),
+                         sizeof(record));
+    va_start(ap, format);
+    len = printlog_clamp(len, vsnprintf(record + len, sizeof(record) - len, format, ap), sizeof(record));
+    va_end(ap);
+
+    printlog_output(record, len);
+}
+
+/* The layout of the arguments format takes */
+static uint32_t printlog_parse(const char * format)
+{
+    uint32_t layout = LOG_LAYOUT_PARSED;
+    uint32_t kind;
+    int i = 0;
+    const char * p;
+
+    for (p = format; (*p != '\0') && (i < LOG_ARG_MAX); p++)
     {
-        while(HAL_UART_GetState(&huart1) == HAL_UART_STATE_BUSY_TX)
+        if (*p != '%')
+        {
+            continue;
+        }
+        while ((*++p != '\0') && (strchr(LOG_CONVERSION, *p) != NULL))
         {
-            osThreadYield();
-        }                    
-    }*/
+        }
+
+        switch (*p)
+        {
+        case '\0':
+            return layout;
+        case '%':
+            continue;
+        case 's':
+            kind = LOG_ARG_STRING;
+            break;
+        case 'f':
+        case 'e':
+        case 'g':
+        case 'E':
+        case 'G':
+            kind = LOG_ARG_DOUBLE;
+            break;
+        default:
+            kind = LOG_ARG_WORD;
+            break;
+        }
+        layout |= kind << (i++ * LOG_ARG_BITS);
+    }
+
+    return layout;
+}
+
+/**
+ * __PRINT_LOG__ of the binary mode: copies the arguments as the format of
+ * site says, nothing is formatted here. From any thread or interrupt.
+ */
+void printlog_binary(const log_site_t * site, ...)
+{
+    uint32_t rec[LOG_RECORD_MAX / 4];
+    log_record_t * hdr = (log_record_t *)rec;
+    uint32_t n = sizeof(log_record_t) / 4;
+    uint32_t layout;
+    const char * s;
+    uint32_t slen;
+    double d;
     va_list ap;
-    va_start(ap, format);    
-    if (level >= __LOG_LEVEL__)
+
+    layout = *site->layout;
+    if (0 == layout)
+    {
+        /* First call of the site: callers racing here store the same word */
+        layout = printlog_parse(site->format);
+        *site->layout = layout;
+    }
+    layout &= ~LOG_LAYOUT_PARSED;
+
+    va_start(ap, site);
+    for (; (layout & LOG_ARG_MASK) != LOG_ARG_END; layout >>= LOG_ARG_BITS)
     {
-        printf("In %s at %d line :", funcname, linenum);
-        vprintf(format, ap);
+        if (n + 2 > LOG_RECORD_MAX / 4)
+        {
+            break;
+        }
+
+        switch (layout & LOG_ARG_MASK)
+        {
+        case LOG_ARG_STRING:
+            s = va_arg(ap, const char *);
+            if (NULL == s)
+            {
+                /* What vsnprintf() of the text mode prints */
+                s = "(null)";
+            }
+            for (slen = 0; (slen < LOG_STRING_MAX) && (slen < (LOG_RECORD_MAX / 4 - n) * 4 - 1) && (s[slen] != '\0'); slen++)
+            {
+            }
+            memcpy(&rec[n], s, slen);
+            ((char *)&rec[n])[slen] = '\0';
+            n += (slen + 4) / 4;
+            break;
+        case LOG_ARG_DOUBLE:
+            d = va_arg(ap, double);
+            memcpy(&rec[n], &d, sizeof(d));
+            n += sizeof(d) / 4;
+            break;
+        default:
+            rec[n++] = va_arg(ap, uint32_t);
+            break;
+        }
     }
     va_end(ap);
-    
-    /*if(inHandlerMode() != 0)
+
+    hdr->site = site;
+    hdr->tick = HAL_GetTick();
+    hdr->len = (uint16_t)(n * 4);
+    ring_write(&log_ring, rec, n * 4);
+}
+
+/* Formats a record of printlog_binary() as printlog() would have */
+static int printlog_format(char * text, int size, const uint32_t * rec)
+{
+    const log_record_t * hdr = (const log_record_t *)rec;
+    const uint32_t * arg = rec + sizeof(log_record_t) / 4;
+    const uint32_t * end = rec + hdr->len / 4;
+    const char * p = hdr->site->format;
+    const char * spec;
+    char conv[16];
+    double d;
+    int len;
+
+    len = printlog_clamp(0, snprintf(text, size, "[%lu] In %s at %d line :", (unsigned long)hdr->tick,
+                         hdr->site->funcname, hdr->site->linenum), size);
+
+    while ((*p != '\0') && (len < size - 1))
+    {
+        if (*p != '%')
+        {
+            text[len++] = *p++;
+            continue;
+        }
+
+        spec = p;
+        while ((*++p != '\0') && (strchr(LOG_CONVERSION, *p) != NULL))
+        {
+        }
+        if ((*p == '\0') || (p - spec + 1 >= (int)sizeof(conv)))
+        {
+            break;
+        }
+        memcpy(conv, spec, p - spec + 1);
+        conv[p - spec + 1] = '\0';
+
+        if (*p == '%')
+        {
+            text[len++] = '%';
+        }
+        else if (arg >= end)
+        {
+            /* Truncated record */
+            break;
+        }
+        else if (*p == 's')
+        {
+            len = printlog_clamp(len, snprintf(text + len, size - len, conv, (const char *)arg), size);
+            arg += (strlen((const char *)arg) + 4) / 4;
+        }
+        else if (strchr("feEgG", *p) != NULL)
+        {
+            memcpy(&d, arg, sizeof(d));
+            arg += sizeof(d) / 4;
+            len = printlog_clamp(len, snprintf(text + len, size - len, conv, d), size);
+        }
+        else
+        {
+            len = printlog_clamp(len, snprintf(text + len, size - len, conv, *arg++), size);
+        }
+        p++;
+    }
+
+    return len;
+}
+
+/* Drains the binary records below every other task */
+static void printlog_thread(void const * argument)
+{
+    uint32_t rec[LOG_RECORD_MAX / 4];
+    char text[LOG_RECORD_MAX];
+    log_record_t hdr;
+
+    ring_attach(&log_ring, osThreadGetId(), 1);
+
+    for (;;)
     {
-        taskENABLE_INTERRUPTS();
-    }  */                      
+        if ((ring_read(&log_ring, &hdr, sizeof(hdr)) < sizeof(hdr)) ||
+            (ring_read(&log_ring, rec, hdr.len) < hdr.len))
+        {
+            /* Empty, or a record is being written in front */
+            osSignalWait(RING_SIGNAL, (0 == ring_pending(&log_ring)) ? osWaitForever : 1);
+            continue;
+        }
+        ring_consume(&log_ring, hdr.len);
+        ring_release(&log_ring, 0);
+
+        printlog_output(text, printlog_format(text, sizeof(text), rec));
+    }
+}
+
+/* Starts the formatting task of the binary mode, records written before
+   are kept until it runs */
+void printlog_init(void)
+{
+#if __LOG_BINARY__
+    osThreadDef(printlog_thread, printlog_thread, osPriorityLow, 0, configMINIMAL_STACK_SIZE * 3);
+    osThreadCreate(osThread(printlog_thread), NULL);
+#endif
 }
 
 #endif
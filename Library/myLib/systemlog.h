@@ -12,10 +12,44 @@
 #define         __CRITICAL_LEVEL__                      4
 #define         __LOG_LEVEL__                           __ERR_LEVEL__
 
-#define         __PRINT_LOG__(level, format, ...)       printlog(level, __func__, __LINE__, format, ##__VA_ARGS__)
+/* Lowest level logged by a module: define it before the first #include of
+   the file to change it there. The test is on constants, the calls below
+   it are not compiled in. */
+#ifndef LOG_MODULE_LEVEL
+#define         LOG_MODULE_LEVEL                        __LOG_LEVEL__
+#endif
 
-void printlog(int level, const char * funcname, int linenum, const char * format, ...);
+/* 1: __PRINT_LOG__ only records its call site, the raw arguments and the
+   tick, printlog_init() starts the low priority task that formats them.
+   0: the caller formats and writes the line itself. */
+#ifndef __LOG_BINARY__
+#define         __LOG_BINARY__                          1
+#endif
 
+/* A __PRINT_LOG__ call, in flash. Its address identifies the format. The
+   kinds of the arguments are parsed from the format on the first call and
+   kept in the word layout points to, 0 until then. */
+typedef struct
+{
+    const char *    format;
+    const char *    funcname;
+    uint32_t *      layout;
+    uint16_t        linenum;
+    uint8_t         level;
+} log_site_t;
+
+#if __LOG_BINARY__
+#define         __PRINT_LOG__(level, format, ...)       do { if ((level) >= LOG_MODULE_LEVEL) { \
+                    static uint32_t log_layout; \
+                    static const log_site_t log_site = { format, __func__, &log_layout, __LINE__, level }; \
+                    printlog_binary(&log_site, ##__VA_ARGS__); } } while (0)
+#else
+#define         __PRINT_LOG__(level, format, ...)       do { if ((level) >= LOG_MODULE_LEVEL) { \
+                    printlog(level, __func__, __LINE__, format, ##__VA_ARGS__); } } while (0)
 #endif
 
+void printlog(int level, const char * funcname, int linenum, const char * format, ...);
+void printlog_binary(const log_site_t * site, ...);
+void printlog_init(void);
 
+#endif
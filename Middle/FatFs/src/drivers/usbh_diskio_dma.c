@@ -48,13 +48,26 @@
 #include "usbh_diskio_dma.h"
 
 /* Private typedef -----------------------------------------------------------*/
+
+/**
+  * @brief  Where a FatFs physical drive lives on the USB tree
+  */
+typedef struct
+{
+  USBH_HandleTypeDef  *phost;   /*!< Root port handle, NULL when the slot is free  */
+  uint8_t             port;     /*!< 0: device on the root port, n: hub port n     */
+  uint8_t             lun;      /*!< SCSI logical unit on that device              */
+
+}USBH_DiskTypeDef;
+
 /* Private define ------------------------------------------------------------*/
 
 #define USB_DEFAULT_BLOCK_SIZE 512
 
 /* Private variables ---------------------------------------------------------*/
-static DWORD scratch[_MAX_SS / 4];
-extern USBH_HandleTypeDef  hUSBHost;
+static DWORD scratch[_MAX_SS / 4];  /* only used by cores with a DMA capable OTG */
+static USBH_DiskTypeDef usbh_disk[_VOLUMES];
+extern Disk_drvTypeDef disk;
 
 /* Private function prototypes -----------------------------------------------*/
 DSTATUS USBH_initialize (BYTE);
@@ -84,9 +97,103 @@ const Diskio_drvTypeDef  USBH_Driver =
 
 /* Private functions ---------------------------------------------------------*/
 
+/**
+  * @brief  Resolves a drive slot to the MSC handle currently on its port,
+  *         pinned until USBH_PutDisk
+  * @param  drv : slot given to FATFS_LinkDriverEx by USBH_LinkDisk
+  * @param  lun : returns the SCSI logical unit
+  * @retval MSC device handle, NULL when the device is absent or not ready
+  */
+static USBH_HandleTypeDef *USBH_GetDisk(BYTE drv, uint8_t *lun)
+{
+  if((drv >= _VOLUMES) || (usbh_disk[drv].phost == NULL))
+  {
+    return NULL;
+  }
+
+  *lun = usbh_disk[drv].lun;
+
+  /* Looked up on every call, and pinned: a hub child handle is freed on
+     unplug once nobody uses it any more */
+  return USBH_MSC_Pin(usbh_disk[drv].phost, usbh_disk[drv].port);
+}
+
+/**
+  * @brief  Releases a handle returned by USBH_GetDisk
+  * @param  phost : MSC device handle
+  * @retval None
+  */
+static void USBH_PutDisk(USBH_HandleTypeDef *phost)
+{
+  USBH_MSC_Unpin(phost);
+}
+
+/**
+  * @brief  Links a logical unit of an MSC device to a FatFs drive. Each
+  *         device has its own BOT pipes, so drives on different devices
+  *         transfer concurrently; LUNs of one device take turns.
+  * @param  phost : root port handle
+  * @param  port : 0 for the device on the root port, 1..USBH_MAX_NUM_CHILD
+  *         for a device behind a hub on the root port
+  * @param  lun : SCSI logical unit
+  * @param  path : returns the logical drive path, e.g. "1:/"
+  * @retval Returns 0 in case of success, otherwise 1.
+  */
+uint8_t USBH_LinkDisk(USBH_HandleTypeDef *phost, uint8_t port, uint8_t lun, char *path)
+{
+  uint8_t drv;
+
+  for(drv = 0; drv < _VOLUMES; drv++)
+  {
+    if(usbh_disk[drv].phost == NULL)
+    {
+      break;
+    }
+  }
+
+  if(drv == _VOLUMES)
+  {
+    return 1;
+  }
+
+  usbh_disk[drv].phost = phost;
+  usbh_disk[drv].port = port;
+  usbh_disk[drv].lun = lun;
+
+  if(FATFS_LinkDriverEx(&USBH_Driver, path, drv) != 0)
+  {
+    usbh_disk[drv].phost = NULL;
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Unlinks a drive linked by USBH_LinkDisk
+  * @param  path : logical drive path
+  * @retval Returns 0 in case of success, otherwise 1.
+  */
+uint8_t USBH_UnLinkDisk(char *path)
+{
+  uint8_t drv = disk.lun[path[0] - '0'];
+
+  if(FATFS_UnLinkDriver(path) != 0)
+  {
+    return 1;
+  }
+
+  if(drv < _VOLUMES)
+  {
+    usbh_disk[drv].phost = NULL;
+  }
+
+  return 0;
+}
+
 /**
   * @brief  Initializes a Drive
-  * @param  lun : lun id
+  * @param  lun : drive slot given by USBH_LinkDisk
   * @retval DSTATUS: Operation status
   */
 DSTATUS USBH_initialize(BYTE lun)
@@ -98,14 +205,20 @@ DSTATUS USBH_initialize(BYTE lun)
 
 /**
   * @brief  Gets Disk Status
-  * @param  lun : lun id
+  * @param  lun : drive slot given by USBH_LinkDisk
   * @retval DSTATUS: Operation status
   */
 DSTATUS USBH_status(BYTE lun)
 {
   DRESULT res = RES_ERROR;
+  USBH_HandleTypeDef *phost = USBH_GetDisk(lun, &lun);
+
+  if(phost == NULL)
+  {
+    return RES_ERROR;
+  }
 
-  if(USBH_MSC_UnitIsReady(&hUSBHost, lun))
+  if(USBH_MSC_UnitIsReady(phost, lun))
   {
     res = RES_OK;
   }
@@ -114,11 +227,12 @@ DSTATUS USBH_status(BYTE lun)
     res = RES_ERROR;
   }
 
+  USBH_PutDisk(phost);
   return res;
 }
 /**
   * @brief  Reads Sector(s)
-  * @param  lun : lun id
+  * @param  lun : drive slot given by USBH_LinkDisk
   * @param  *buff: Data buffer to store read data
   * @param  sector: Sector address (LBA)
   * @param  count: Number of sectors to read (1..128)
@@ -129,12 +243,18 @@ DRESULT USBH_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
   DRESULT res = RES_ERROR;
   MSC_LUNTypeDef info;
   USBH_StatusTypeDef  status = USBH_OK;
+  USBH_HandleTypeDef *phost = USBH_GetDisk(lun, &lun);
 
-  if (((DWORD)buff & 3) && (((HCD_HandleTypeDef *)hUSBHost.pData)->Init.dma_enable))
+  if(phost == NULL)
+  {
+    return RES_NOTRDY;
+  }
+
+  if (((DWORD)buff & 3) && (((HCD_HandleTypeDef *)phost->pData)->Init.dma_enable))
   {
     while ((count--)&&(status == USBH_OK))
     {
-      status = USBH_MSC_Read(&hUSBHost, lun, sector + count, (uint8_t *)scratch, 1);
+      status = USBH_MSC_Read(phost, lun, sector + count, (uint8_t *)scratch, 1);
 
       if(status == USBH_OK)
       {
@@ -148,7 +268,7 @@ DRESULT USBH_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
   }
   else
   {
-    status = USBH_MSC_Read(&hUSBHost, lun, sector, buff, count);
+    status = USBH_MSC_Read(phost, lun, sector, buff, count);
   }
 
   if(status == USBH_OK)
@@ -157,7 +277,7 @@ DRESULT USBH_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
   }
   else
   {
-    USBH_MSC_GetLUNInfo(&hUSBHost, lun, &info);
+    USBH_MSC_GetLUNInfo(phost, lun, &info);
 
     switch (info.sense.asc)
     {
@@ -174,12 +294,13 @@ DRESULT USBH_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
     }
   }
 
+  USBH_PutDisk(phost);
   return res;
 }
 
 /**
   * @brief  Writes Sector(s)
-  * @param  lun : lun id
+  * @param  lun : drive slot given by USBH_LinkDisk
   * @param  *buff: Data to be written
   * @param  sector: Sector address (LBA)
   * @param  count: Number of sectors to write (1..128)
@@ -191,15 +312,21 @@ DRESULT USBH_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
   DRESULT res = RES_ERROR;
   MSC_LUNTypeDef info;
   USBH_StatusTypeDef  status = USBH_OK;
+  USBH_HandleTypeDef *phost = USBH_GetDisk(lun, &lun);
+
+  if(phost == NULL)
+  {
+    return RES_NOTRDY;
+  }
 
-  if (((DWORD)buff & 3) && (((HCD_HandleTypeDef *)hUSBHost.pData)->Init.dma_enable))
+  if (((DWORD)buff & 3) && (((HCD_HandleTypeDef *)phost->pData)->Init.dma_enable))
   {
 
     while (count--)
     {
       memcpy (scratch, &buff[count * _MAX_SS], _MAX_SS);
 
-      status = USBH_MSC_Write(&hUSBHost, lun, sector + count, (BYTE *)scratch, 1) ;
+      status = USBH_MSC_Write(phost, lun, sector + count, (BYTE *)scratch, 1) ;
       if(status == USBH_FAIL)
       {
         break;
@@ -208,7 +335,7 @@ DRESULT USBH_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
   }
   else
   {
-    status = USBH_MSC_Write(&hUSBHost, lun, sector, (BYTE *)buff, count);
+    status = USBH_MSC_Write(phost, lun, sector, (BYTE *)buff, count);
   }
 
   if(status == USBH_OK)
@@ -217,7 +344,7 @@ DRESULT USBH_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
   }
   else
   {
-    USBH_MSC_GetLUNInfo(&hUSBHost, lun, &info);
+    USBH_MSC_GetLUNInfo(phost, lun, &info);
 
     switch (info.sense.asc)
     {
@@ -239,13 +366,14 @@ DRESULT USBH_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
     }
   }
 
+  USBH_PutDisk(phost);
   return res;
 }
 #endif /* _USE_WRITE == 1 */
 
 /**
   * @brief  I/O control operation
-  * @param  lun : lun id
+  * @param  lun : drive slot given by USBH_LinkDisk
   * @param  cmd: Control code
   * @param  *buff: Buffer to send/receive control data
   * @retval DRESULT: Operation result
@@ -255,6 +383,12 @@ DRESULT USBH_ioctl(BYTE lun, BYTE cmd, void *buff)
 {
   DRESULT res = RES_ERROR;
   MSC_LUNTypeDef info;
+  USBH_HandleTypeDef *phost = USBH_GetDisk(lun, &lun);
+
+  if(phost == NULL)
+  {
+    return RES_NOTRDY;
+  }
 
   switch (cmd)
   {
@@ -265,7 +399,7 @@ DRESULT USBH_ioctl(BYTE lun, BYTE cmd, void *buff)
 
   /* Get number of sectors on the disk (DWORD) */
   case GET_SECTOR_COUNT :
-    if(USBH_MSC_GetLUNInfo(&hUSBHost, lun, &info) == USBH_OK)
+    if(USBH_MSC_GetLUNInfo(phost, lun, &info) == USBH_OK)
     {
       *(DWORD*)buff = info.capacity.block_nbr;
       res = RES_OK;
@@ -278,7 +412,7 @@ DRESULT USBH_ioctl(BYTE lun, BYTE cmd, void *buff)
 
   /* Get R/W sector size (WORD) */
   case GET_SECTOR_SIZE :
-    if(USBH_MSC_GetLUNInfo(&hUSBHost, lun, &info) == USBH_OK)
+    if(USBH_MSC_GetLUNInfo(phost, lun, &info) == USBH_OK)
     {
       *(DWORD*)buff = info.capacity.block_size;
       res = RES_OK;
@@ -292,7 +426,7 @@ DRESULT USBH_ioctl(BYTE lun, BYTE cmd, void *buff)
     /* Get erase block size in unit of sector (DWORD) */
   case GET_BLOCK_SIZE :
 
-    if(USBH_MSC_GetLUNInfo(&hUSBHost, lun, &info) == USBH_OK)
+    if(USBH_MSC_GetLUNInfo(phost, lun, &info) == USBH_OK)
     {
       *(DWORD*)buff = info.capacity.block_size / USB_DEFAULT_BLOCK_SIZE;
       res = RES_OK;
@@ -307,6 +441,7 @@ DRESULT USBH_ioctl(BYTE lun, BYTE cmd, void *buff)
     res = RES_PARERR;
   }
 
+  USBH_PutDisk(phost);
   return res;
 }
 #endif /* _USE_IOCTL == 1 */
@@ -55,6 +55,9 @@
 /* Exported functions ------------------------------------------------------- */
 extern const Diskio_drvTypeDef  USBH_Driver;
 
+uint8_t USBH_LinkDisk(USBH_HandleTypeDef *phost, uint8_t port, uint8_t lun, char *path);
+uint8_t USBH_UnLinkDisk(char *path);
+
 #endif /* __USBH_DISKIO_H */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
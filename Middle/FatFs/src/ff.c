@@ -3546,6 +3546,11 @@ FRESULT f_read (
 			cc = btr / SS(fs);					/* When remaining bytes >= sector size, */
 			if (cc) {							/* Read maximum contiguous sectors directly */
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
+#if _FS_EXFAT
+					if (fp->obj.stat == 2) {	/* No FAT chain: the file is contiguous, read across clusters */
+						fp->clust += (csect + cc - 1) / fs->csize;	/* Cluster of the last sector read */
+					} else
+#endif
 					cc = fs->csize - csect;
 				}
 				if (disk_read(fs->drv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
@@ -4091,6 +4096,15 @@ FRESULT f_lseek (
 				fp->clust = clst;
 			}
 			if (clst != 0) {
+#if _FS_EXFAT
+				if (fp->obj.stat == 2 && fp->fptr + ofs <= fp->obj.objsize) {	/* No FAT chain: the file is contiguous, */
+					nsect = (DWORD)((ofs - 1) / bcs);	/* step to the target cluster directly */
+					clst += nsect;
+					ofs -= (FSIZE_t)nsect * bcs; fp->fptr += (FSIZE_t)nsect * bcs;
+					fp->clust = clst;
+					nsect = 0;
+				}
+#endif
 				while (ofs > bcs) {						/* Cluster following loop */
 					ofs -= bcs; fp->fptr += bcs;
 #if !_FS_READONLY
@@ -4417,9 +4431,15 @@ FRESULT f_getfree (
 					i = 0;
 					do {
 						if (i == 0 && (res = move_window(fs, sect++)) != FR_OK) break;
-						for (b = 8, bm = fs->win[i]; b && clst; b--, clst--) {
-							if (!(bm & 1)) nfree++;
-							bm >>= 1;
+						bm = fs->win[i];
+						if (clst >= 8 && (bm == 0x00 || bm == 0xFF)) {	/* Whole byte free or in use */
+							if (bm == 0x00) nfree += 8;
+							clst -= 8;
+						} else {
+							for (b = 8; b && clst; b--, clst--) {
+								if (!(bm & 1)) nfree++;
+								bm >>= 1;
+							}
 						}
 						i = (i + 1) % SS(fs);
 					} while (clst);
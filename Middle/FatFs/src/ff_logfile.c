@@ -0,0 +1,497 @@
+/**
+  ******************************************************************************
+  * @file    ff_logfile.c
+  * @brief   Append-only log files on a preallocated contiguous region.
+  *
+  *          flog_open() allocates the whole file up front with f_expand(), so
+  *          the cluster chain is contiguous and final. Appends are then written
+  *          with disk_write() straight into the region: no FAT lookup, no FAT
+  *          or directory update, one sector write per 512 bytes of log.
+  *
+  *          The last sector of the region holds a small tail index, refreshed
+  *          every FLOG_INDEX_INTERVAL sectors and by flog_sync(). After a power
+  *          loss the file still has its preallocated size and flog_open()
+  *          resumes from the index. flog_close() truncates the file to the
+  *          data actually written, which also drops the index sector.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "diskio.h"
+#include "ff_logfile.h"
+
+#if _USE_EXPAND && _USE_FASTSEEK && !_FS_READONLY
+
+#if _MAX_SS != _MIN_SS
+#error "ff_logfile needs a fixed sector size"
+#endif
+
+#if _FS_TINY
+#error "ff_logfile uses the private sector buffer of FIL"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  DWORD   magic;
+  DWORD   seq;
+  DWORD   tail;
+  DWORD   check;
+
+}FLOG_IndexTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define FLOG_SS             ((DWORD)_MAX_SS)
+#define FLOG_INDEX_MAGIC    0x474F4C46      /* "FLOG" */
+
+/* Private functions ---------------------------------------------------------*/
+
+static int flog_lock(FLOG *lf)
+{
+#if _FS_REENTRANT
+  /* direct sector I/O must not interleave with another task's FatFs call */
+  return ff_req_grant(lf->fil.obj.fs->sobj);
+#else
+  return 1;
+#endif
+}
+
+static void flog_unlock(FLOG *lf)
+{
+#if _FS_REENTRANT
+  ff_rel_grant(lf->fil.obj.fs->sobj);
+#endif
+}
+
+/**
+  * @brief  Writes the tail index into the last sector of the region
+  * @note   The index is staged in the FIL sector buffer, which is otherwise
+  *         only used by flog_read(); the cached sector is invalidated.
+  * @param  lf: log file
+  * @param  tail: number of bytes known to be on the media
+  * @retval FRESULT
+  */
+static FRESULT flog_put_index(FLOG *lf, DWORD tail)
+{
+  FLOG_IndexTypeDef idx;
+
+  idx.magic = FLOG_INDEX_MAGIC;
+  idx.seq = ++lf->seq;
+  idx.tail = tail;
+  idx.check = ~(idx.magic ^ idx.seq ^ idx.tail);
+
+  memset(lf->fil.buf, 0, FLOG_SS);
+  memcpy(lf->fil.buf, &idx, sizeof(idx));
+  lf->fil.sect = 0;
+
+  if(disk_write(lf->fil.obj.fs->drv, lf->fil.buf, lf->sect + lf->nsect, 1) != RES_OK)
+  {
+    return FR_DISK_ERR;
+  }
+
+  lf->dirty = 0;
+  return FR_OK;
+}
+
+/**
+  * @brief  Reads back the tail index of an unclosed log
+  * @param  lf: log file
+  * @retval FR_OK with lf->tail restored, FR_EXIST when there is no valid index
+  */
+static FRESULT flog_get_index(FLOG *lf)
+{
+  FLOG_IndexTypeDef idx;
+
+  lf->fil.sect = 0;
+  if(disk_read(lf->fil.obj.fs->drv, lf->fil.buf, lf->sect + lf->nsect, 1) != RES_OK)
+  {
+    return FR_DISK_ERR;
+  }
+  memcpy(&idx, lf->fil.buf, sizeof(idx));
+
+  if((idx.magic != FLOG_INDEX_MAGIC) ||
+     (idx.check != ~(idx.magic ^ idx.seq ^ idx.tail)) ||
+     (idx.tail > lf->nsect * FLOG_SS))
+  {
+    return FR_EXIST;
+  }
+
+  lf->seq = idx.seq;
+  lf->tail = idx.tail;
+
+  if(lf->tail % FLOG_SS)
+  {
+    if(disk_read(lf->fil.obj.fs->drv, lf->buf, lf->sect + lf->tail / FLOG_SS, 1) != RES_OK)
+    {
+      return FR_DISK_ERR;
+    }
+  }
+
+  return FR_OK;
+}
+
+/**
+  * @brief  Builds the fast seek link map and locates the region
+  * @param  lf: log file
+  * @retval FR_OK, or FR_DENIED when the file is not a single contiguous run
+  */
+static FRESULT flog_map(FLOG *lf)
+{
+  FATFS *fs = lf->fil.obj.fs;
+  FRESULT res;
+
+  lf->clmt[0] = FLOG_CLMT_SIZE;
+  lf->fil.cltbl = lf->clmt;
+  res = f_lseek(&lf->fil, CREATE_LINKMAP);
+  if(res == FR_NOT_ENOUGH_CORE)
+  {
+    res = FR_DENIED;
+  }
+  if(res != FR_OK)
+  {
+    lf->fil.cltbl = 0;
+    return res;
+  }
+
+  lf->sect = fs->database + (lf->clmt[2] - 2) * fs->csize;
+  lf->nsect = (DWORD)(f_size(&lf->fil) / FLOG_SS) - 1;
+
+  return FR_OK;
+}
+
+/**
+  * @brief  Writes the partially filled tail sector to the media
+  * @param  lf: log file
+  * @retval FRESULT
+  */
+static FRESULT flog_put_tail(FLOG *lf)
+{
+  if((lf->tail % FLOG_SS) == 0)
+  {
+    return FR_OK;
+  }
+
+  if(disk_write(lf->fil.obj.fs->drv, lf->buf, lf->sect + lf->tail / FLOG_SS, 1) != RES_OK)
+  {
+    return FR_DISK_ERR;
+  }
+
+  return FR_OK;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Opens a log file, creating and preallocating it when needed
+  * @note   An existing file is only accepted if it is an unclosed log with a
+  *         valid tail index; appending then resumes where the index points.
+  *         A file that was closed (truncated) returns FR_EXIST so that the
+  *         caller picks a new name instead of overwriting it.
+  * @param  lf: log file object
+  * @param  path: file name
+  * @param  size: data capacity in bytes, rounded up to whole sectors
+  * @retval FRESULT
+  */
+FRESULT flog_open(FLOG *lf, const TCHAR *path, FSIZE_t size)
+{
+  FRESULT res;
+
+  memset(lf, 0, sizeof(FLOG));
+
+  res = f_open(&lf->fil, path, FA_READ | FA_WRITE | FA_OPEN_ALWAYS);
+  if(res != FR_OK)
+  {
+    return res;
+  }
+
+  if(f_size(&lf->fil) == 0)
+  {
+    size = (size + FLOG_SS - 1) / FLOG_SS * FLOG_SS;
+    if(size == 0)
+    {
+      size = FLOG_SS;
+    }
+
+    /* data sectors plus the index sector, allocated as one contiguous run */
+    res = f_expand(&lf->fil, size + FLOG_SS, 1);
+    if(res == FR_OK)
+    {
+      res = f_sync(&lf->fil);
+    }
+    if(res == FR_OK)
+    {
+      res = flog_map(lf);
+    }
+    if(res == FR_OK)
+    {
+      if(flog_lock(lf))
+      {
+        res = flog_put_index(lf, 0);
+        flog_unlock(lf);
+      }
+      else
+      {
+        res = FR_TIMEOUT;
+      }
+    }
+  }
+  else
+  {
+    if((f_size(&lf->fil) % FLOG_SS) || (f_size(&lf->fil) < 2 * FLOG_SS))
+    {
+      res = FR_EXIST;
+    }
+    if(res == FR_OK)
+    {
+      res = flog_map(lf);
+      if(res == FR_DENIED)
+      {
+        res = FR_EXIST;
+      }
+    }
+    if(res == FR_OK)
+    {
+      if(flog_lock(lf))
+      {
+        res = flog_get_index(lf);
+        flog_unlock(lf);
+      }
+      else
+      {
+        res = FR_TIMEOUT;
+      }
+    }
+  }
+
+  if(res != FR_OK)
+  {
+    lf->fil.cltbl = 0;
+    f_close(&lf->fil);
+  }
+
+  return res;
+}
+
+/**
+  * @brief  Appends data to the log
+  * @note   Whole sectors are written from the caller's buffer, the remainder
+  *         is staged in lf->buf until the sector fills up or flog_sync().
+  * @param  lf: log file
+  * @param  buff: data to append
+  * @param  btw: number of bytes to append
+  * @param  bw: number of bytes appended
+  * @retval FR_OK, with *bw < btw once the region is full (as f_write on a
+  *         full volume), or a disk error
+  */
+FRESULT flog_write(FLOG *lf, const void *buff, UINT btw, UINT *bw)
+{
+  FRESULT res = FR_OK;
+  const BYTE *p = (const BYTE *)buff;
+  BYTE drv = lf->fil.obj.fs->drv;
+  DWORD ofs, cnt, n;
+
+  *bw = 0;
+
+  if(!flog_lock(lf))
+  {
+    return FR_TIMEOUT;
+  }
+
+  while(btw)
+  {
+    if(lf->tail / FLOG_SS >= lf->nsect)
+    {
+      break;
+    }
+
+    ofs = lf->tail % FLOG_SS;
+    if((ofs == 0) && (btw >= FLOG_SS))
+    {
+      cnt = btw / FLOG_SS;
+      if(cnt > lf->nsect - lf->tail / FLOG_SS)
+      {
+        cnt = lf->nsect - lf->tail / FLOG_SS;
+      }
+      if(disk_write(drv, p, lf->sect + lf->tail / FLOG_SS, (UINT)cnt) != RES_OK)
+      {
+        res = FR_DISK_ERR;
+        break;
+      }
+      n = cnt * FLOG_SS;
+      lf->dirty += cnt;
+    }
+    else
+    {
+      n = FLOG_SS - ofs;
+      if(n > btw)
+      {
+        n = btw;
+      }
+      memcpy(&lf->buf[ofs], p, n);
+      if(ofs + n == FLOG_SS)
+      {
+        if(disk_write(drv, lf->buf, lf->sect + lf->tail / FLOG_SS, 1) != RES_OK)
+        {
+          res = FR_DISK_ERR;
+          break;
+        }
+        lf->dirty++;
+      }
+    }
+
+    lf->tail += n;
+    p += n;
+    btw -= (UINT)n;
+    *bw += (UINT)n;
+
+    if(lf->dirty >= FLOG_INDEX_INTERVAL)
+    {
+      res = flog_put_index(lf, lf->tail - lf->tail % FLOG_SS);
+      if(res != FR_OK)
+      {
+        break;
+      }
+    }
+  }
+
+  flog_unlock(lf);
+
+  return res;
+}
+
+/**
+  * @brief  Commits the staged tail sector and the tail index
+  * @param  lf: log file
+  * @retval FRESULT
+  */
+FRESULT flog_sync(FLOG *lf)
+{
+  FRESULT res;
+
+  if(!flog_lock(lf))
+  {
+    return FR_TIMEOUT;
+  }
+
+  res = flog_put_tail(lf);
+  if(res == FR_OK)
+  {
+    res = flog_put_index(lf, lf->tail);
+  }
+  if(res == FR_OK && disk_ioctl(lf->fil.obj.fs->drv, CTRL_SYNC, 0) != RES_OK)
+  {
+    res = FR_DISK_ERR;
+  }
+
+  flog_unlock(lf);
+
+  return res;
+}
+
+/**
+  * @brief  Reads back logged data
+  * @note   Seeks go through the fast seek link map, so no FAT access is made.
+  * @param  lf: log file
+  * @param  ofs: offset in the log
+  * @param  buff: destination buffer
+  * @param  btr: number of bytes to read
+  * @param  br: number of bytes read
+  * @retval FRESULT
+  */
+FRESULT flog_read(FLOG *lf, FSIZE_t ofs, void *buff, UINT btr, UINT *br)
+{
+  FRESULT res;
+
+  *br = 0;
+  if(ofs >= lf->tail)
+  {
+    return FR_OK;
+  }
+  if(btr > lf->tail - ofs)
+  {
+    btr = (UINT)(lf->tail - ofs);
+  }
+
+  if(!flog_lock(lf))
+  {
+    return FR_TIMEOUT;
+  }
+  res = flog_put_tail(lf);
+  /* sectors were written behind FatFs, drop whatever FIL has cached */
+  lf->fil.sect = 0;
+  flog_unlock(lf);
+
+  if(res == FR_OK)
+  {
+    res = f_lseek(&lf->fil, ofs);
+  }
+  if(res == FR_OK)
+  {
+    res = f_read(&lf->fil, buff, btr, br);
+  }
+
+  return res;
+}
+
+/**
+  * @brief  Closes the log and truncates it to the data written
+  * @param  lf: log file
+  * @retval FRESULT
+  */
+FRESULT flog_close(FLOG *lf)
+{
+  FRESULT res;
+
+  if(!flog_lock(lf))
+  {
+    return FR_TIMEOUT;
+  }
+  res = flog_put_tail(lf);
+  lf->fil.sect = 0;
+  flog_unlock(lf);
+
+  /* position through the link map, then truncate on the plain FAT chain */
+  if(res == FR_OK)
+  {
+    res = f_lseek(&lf->fil, lf->tail);
+  }
+  lf->fil.cltbl = 0;
+  if(res == FR_OK)
+  {
+    res = f_truncate(&lf->fil);
+  }
+
+  if(res == FR_OK)
+  {
+    res = f_close(&lf->fil);
+  }
+  else
+  {
+    f_close(&lf->fil);
+  }
+
+  return res;
+}
+
+/**
+  * @brief  Closes the current log and opens a new one of the same capacity
+  * @param  lf: log file
+  * @param  path: name of the next log file
+  * @retval FRESULT
+  */
+FRESULT flog_rollover(FLOG *lf, const TCHAR *path)
+{
+  FRESULT res;
+  FSIZE_t size = (FSIZE_t)lf->nsect * FLOG_SS;
+
+  res = flog_close(lf);
+  if(res == FR_OK)
+  {
+    res = flog_open(lf, path, size);
+  }
+
+  return res;
+}
+
+#endif /* _USE_EXPAND && _USE_FASTSEEK && !_FS_READONLY */
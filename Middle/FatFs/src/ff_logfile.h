@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    ff_logfile.h
+  * @brief   Header for ff_logfile.c module.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FF_LOGFILE_H
+#define __FF_LOGFILE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "ff.h"
+
+#if _USE_EXPAND && _USE_FASTSEEK && !_FS_READONLY
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Number of data sectors written between two tail index updates. A crash
+   loses at most this many sectors of the log. */
+#define FLOG_INDEX_INTERVAL     64
+
+/* A contiguous file has exactly one fragment: size, length, top, terminator */
+#define FLOG_CLMT_SIZE          4
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+  * @brief  Append-only log file over a contiguous, preallocated region
+  */
+typedef struct
+{
+  FIL     fil;                    /*!< FatFs file owning the allocation             */
+  DWORD   sect;                   /*!< First sector of the region                   */
+  DWORD   nsect;                  /*!< Data sectors, the index sector follows them  */
+  DWORD   tail;                   /*!< Bytes appended so far                        */
+  DWORD   seq;                    /*!< Generation of the last index written         */
+  DWORD   dirty;                  /*!< Full sectors written since the last index    */
+  DWORD   clmt[FLOG_CLMT_SIZE];   /*!< Fast seek link map of the region             */
+  BYTE    buf[_MAX_SS];           /*!< Tail sector being filled                     */
+
+}FLOG;
+
+/* Exported functions ------------------------------------------------------- */
+FRESULT flog_open(FLOG *lf, const TCHAR *path, FSIZE_t size);
+FRESULT flog_write(FLOG *lf, const void *buff, UINT btw, UINT *bw);
+FRESULT flog_sync(FLOG *lf);
+FRESULT flog_read(FLOG *lf, FSIZE_t ofs, void *buff, UINT btr, UINT *br);
+FRESULT flog_close(FLOG *lf);
+FRESULT flog_rollover(FLOG *lf, const TCHAR *path);
+
+#define flog_size(lf)   ((lf)->tail)
+#define flog_space(lf)  ((lf)->nsect * (DWORD)_MAX_SS - (lf)->tail)
+
+#endif /* _USE_EXPAND && _USE_FASTSEEK && !_FS_READONLY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FF_LOGFILE_H */
@@ -67,8 +67,11 @@ int ff_cre_syncobj (	/* 1:Function succeeded, 0:Could not create the sync object
 
     int ret;
 
-    osSemaphoreDef(SEM);
-    *sobj = osSemaphoreCreate(osSemaphore(SEM), 1);
+    /* A mutex rather than a binary semaphore: the FreeRTOS mutex applies
+       priority inheritance, so a low priority task holding the volume is
+       boosted while a higher priority task waits in ff_req_grant(). */
+    osMutexDef(FS_MUTEX);
+    *sobj = osMutexCreate(osMutex(FS_MUTEX));
     ret = (*sobj != NULL);
 
     return ret;
@@ -88,7 +91,7 @@ int ff_del_syncobj (	/* 1:Function succeeded, 0:Could not delete due to any erro
 	_SYNC_t sobj		/* Sync object tied to the logical drive to be deleted */
 )
 {
-    osSemaphoreDelete (sobj);
+    osMutexDelete (sobj);
     return 1;
 }
 
@@ -107,7 +110,7 @@ int ff_req_grant (	/* 1:Got a grant to access the volume, 0:Could not get a gran
 {
   int ret = 0;
 
-  if(osSemaphoreWait(sobj, _FS_TIMEOUT) == osOK)
+  if(osMutexWait(sobj, _FS_TIMEOUT) == osOK)
   {
     ret = 1;
   }
@@ -127,7 +130,7 @@ void ff_rel_grant (
 	_SYNC_t sobj	/* Sync object to be signaled */
 )
 {
-  osSemaphoreRelease(sobj);
+  osMutexRelease(sobj);
 }
 
 #endif
@@ -55,7 +55,8 @@ CORE4FILES=$(LWIPDIR)/core/ipv4/autoip.c \
 	$(LWIPDIR)/core/ipv4/igmp.c \
 	$(LWIPDIR)/core/ipv4/ip4_frag.c \
 	$(LWIPDIR)/core/ipv4/ip4.c \
-	$(LWIPDIR)/core/ipv4/ip4_addr.c
+	$(LWIPDIR)/core/ipv4/ip4_addr.c \
+	$(LWIPDIR)/core/ipv4/ip4_napt.c
 
 CORE6FILES=$(LWIPDIR)/core/ipv6/dhcp6.c \
 	$(LWIPDIR)/core/ipv6/ethip6.c \
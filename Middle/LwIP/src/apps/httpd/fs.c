@@ -58,8 +58,8 @@ int fs_read_custom(struct fs_file *file, char *buffer, int count);
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
 
 /*-----------------------------------------------------------------------------------*/
-err_t
-fs_open(struct fs_file *file, const char *name)
+static err_t
+fs_open_file(struct fs_file *file, const char *name, u8_t skip_flags)
 {
   const struct fsdata_file *f;
 
@@ -67,6 +67,9 @@ fs_open(struct fs_file *file, const char *name)
      return ERR_ARG;
   }
 
+#if LWIP_HTTPD_ETAG
+  file->etag = NULL;
+#endif /* LWIP_HTTPD_ETAG */
 #if LWIP_HTTPD_CUSTOM_FILES
   if (fs_open_custom(file, name)) {
     file->is_custom_file = 1;
@@ -76,7 +79,7 @@ fs_open(struct fs_file *file, const char *name)
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
 
   for (f = FS_ROOT; f != NULL; f = f->next) {
-    if (!strcmp(name, (const char *)f->name)) {
+    if (!strcmp(name, (const char *)f->name) && !(f->flags & skip_flags)) {
       file->data = (const char *)f->data;
       file->len = f->len;
       file->index = f->len;
@@ -86,6 +89,9 @@ fs_open(struct fs_file *file, const char *name)
       file->chksum_count = f->chksum_count;
       file->chksum = f->chksum;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
+#if LWIP_HTTPD_ETAG
+      file->etag = f->etag;
+#endif /* LWIP_HTTPD_ETAG */
 #if LWIP_HTTPD_FILE_STATE
       file->state = fs_state_init(file, name);
 #endif /* #if LWIP_HTTPD_FILE_STATE */
@@ -96,6 +102,23 @@ fs_open(struct fs_file *file, const char *name)
   return ERR_VAL;
 }
 
+/*-----------------------------------------------------------------------------------*/
+err_t
+fs_open(struct fs_file *file, const char *name)
+{
+  return fs_open_file(file, name, 0);
+}
+
+#if LWIP_HTTPD_GZIP
+/*-----------------------------------------------------------------------------------*/
+/** Like fs_open(), but never the gzip-compressed copy of a file */
+err_t
+fs_open_identity(struct fs_file *file, const char *name)
+{
+  return fs_open_file(file, name, FS_FILE_FLAGS_GZIP);
+}
+#endif /* LWIP_HTTPD_GZIP */
+
 /*-----------------------------------------------------------------------------------*/
 void
 fs_close(struct fs_file *file)
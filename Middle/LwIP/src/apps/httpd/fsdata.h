@@ -45,6 +45,10 @@ struct fsdata_file {
   u16_t chksum_count;
   const struct fsdata_chksum *chksum;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
+#if LWIP_HTTPD_ETAG
+  /* quoted entity tag of the file, as in its ETag header; NULL if none */
+  const char *etag;
+#endif /* LWIP_HTTPD_ETAG */
 };
 
 #endif /* LWIP_FSDATA_H */
@@ -0,0 +1,769 @@
+#include "lwip/apps/fs.h"
+#include "lwip/def.h"
+#include "fsdata.h"
+
+
+#define file_NULL (struct fsdata_file *) NULL
+
+
+#ifndef FS_FILE_FLAGS_HEADER_INCLUDED
+#define FS_FILE_FLAGS_HEADER_INCLUDED 1
+#endif
+#ifndef FS_FILE_FLAGS_HEADER_PERSISTENT
+#define FS_FILE_FLAGS_HEADER_PERSISTENT 0
+#endif
+#ifndef FS_FILE_FLAGS_GZIP
+#define FS_FILE_FLAGS_GZIP 0
+#endif
+/* FSDATA_FILE_ALIGNMENT: 0=off, 1=by variable, 2=by include */
+#ifndef FSDATA_FILE_ALIGNMENT
+#define FSDATA_FILE_ALIGNMENT 0
+#endif
+#ifndef FSDATA_ALIGN_PRE
+#define FSDATA_ALIGN_PRE
+#endif
+#ifndef FSDATA_ALIGN_POST
+#define FSDATA_ALIGN_POST
+#endif
+#if FSDATA_FILE_ALIGNMENT==2
+#include "fsdata_alignment.h"
+#endif
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__img_sics_gif = 0;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__img_sics_gif[] FSDATA_ALIGN_POST = {
+/* /img/sics.gif (14 chars) */
+0x2f,0x69,0x6d,0x67,0x2f,0x73,0x69,0x63,0x73,0x2e,0x67,0x69,0x66,0x00,0x00,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 200 OK
+" (17 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 724
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x37,0x32,0x34,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "ETag: "221743ce-2d4"
+" (22 bytes) */
+0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x32,0x32,0x31,0x37,0x34,0x33,0x63,0x65,0x2d,
+0x32,0x64,0x34,0x22,0x0d,0x0a,
+/* "Cache-Control: no-cache
+" (25 bytes) */
+0x43,0x61,0x63,0x68,0x65,0x2d,0x43,0x6f,0x6e,0x74,0x72,0x6f,0x6c,0x3a,0x20,0x6e,
+0x6f,0x2d,0x63,0x61,0x63,0x68,0x65,0x0d,0x0a,
+/* "Content-type: image/gif
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x69,0x6d,
+0x61,0x67,0x65,0x2f,0x67,0x69,0x66,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (724 bytes) */
+0x47,0x49,0x46,0x38,0x39,0x61,0x46,0x00,0x22,0x00,0xa5,0x00,0x00,0xd9,0x2b,0x39,
+0x6a,0x6a,0x6a,0xbf,0xbf,0xbf,0x93,0x93,0x93,0x0f,0x0f,0x0f,0xb0,0xb0,0xb0,0xa6,
+0xa6,0xa6,0x80,0x80,0x80,0x76,0x76,0x76,0x1e,0x1e,0x1e,0x9d,0x9d,0x9d,0x2e,0x2e,
+0x2e,0x49,0x49,0x49,0x54,0x54,0x54,0x8a,0x8a,0x8a,0x60,0x60,0x60,0xc6,0xa6,0x99,
+0xbd,0xb5,0xb2,0xc2,0xab,0xa1,0xd9,0x41,0x40,0xd5,0x67,0x55,0xc0,0xb0,0xaa,0xd5,
+0x5e,0x4e,0xd6,0x50,0x45,0xcc,0x93,0x7d,0xc8,0xa1,0x90,0xce,0x8b,0x76,0xd2,0x7b,
+0x65,0xd1,0x84,0x6d,0xc9,0x99,0x86,0x3a,0x3a,0x3a,0x00,0x00,0x00,0xb8,0xb8,0xb8,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x2c,0x00,0x00,
+0x00,0x00,0x46,0x00,0x22,0x00,0x00,0x06,0xfe,0x40,0x90,0x70,0x48,0x2c,0x1a,0x8f,
+0xc8,0xa4,0x72,0xc9,0x6c,0x3a,0x9f,0xd0,0xa8,0x74,0x4a,0xad,0x5a,0xaf,0xd8,0xac,
+0x76,0xa9,0x40,0x04,0xbe,0x83,0xe2,0x60,0x3c,0x50,0x20,0x0d,0x8e,0x6f,0x00,0x31,
+0x28,0x1c,0x0d,0x07,0xb5,0xc3,0x60,0x75,0x24,0x3e,0xf8,0xfc,0x87,0x11,0x06,0xe9,
+0x3d,0x46,0x07,0x0b,0x7a,0x7a,0x7c,0x43,0x06,0x1e,0x84,0x78,0x0b,0x07,0x6e,0x51,
+0x01,0x8a,0x84,0x08,0x7e,0x79,0x80,0x87,0x89,0x91,0x7a,0x93,0x0a,0x04,0x99,0x78,
+0x96,0x4f,0x03,0x9e,0x79,0x01,0x94,0x9f,0x43,0x9c,0xa3,0xa4,0x05,0x77,0xa3,0xa0,
+0x4e,0x98,0x79,0x0b,0x1e,0x83,0xa4,0xa6,0x1f,0x96,0x05,0x9d,0xaa,0x78,0x01,0x07,
+0x84,0x04,0x1e,0x1e,0xbb,0xb8,0x51,0x84,0x0e,0x43,0x05,0x07,0x77,0xa5,0x7f,0x42,
+0xb1,0xb2,0x01,0x63,0x08,0x0d,0xbb,0x01,0x0c,0x7a,0x0d,0x44,0x0e,0xd8,0xaf,0x4c,
+0x05,0x7a,0x04,0x47,0x07,0x07,0xb7,0x80,0xa2,0xe1,0x7d,0x44,0x05,0x01,0x04,0x01,
+0xd0,0xea,0x87,0x93,0x4f,0xe0,0x9a,0x49,0xce,0xd8,0x79,0x04,0x66,0x20,0x15,0x10,
+0x10,0x11,0x92,0x29,0x80,0xb6,0xc0,0x91,0x15,0x45,0x1e,0x90,0x19,0x71,0x46,0xa8,
+0x5c,0x04,0x0e,0x00,0x22,0x4e,0xe8,0x40,0x24,0x9f,0x3e,0x04,0x06,0xa7,0x58,0xd4,
+0x93,0xa0,0x1c,0x91,0x3f,0xe8,0xf0,0x88,0x03,0xb1,0x21,0xa2,0x49,0x00,0x19,0x86,
+0xfc,0x52,0x44,0xe0,0x01,0x9d,0x29,0x21,0x15,0x25,0x50,0xf7,0x67,0x25,0x1e,0x06,
+0xfd,0x4e,0x9a,0xb4,0x90,0xac,0x15,0xfa,0xcb,0x52,0x53,0x1e,0x8c,0xf2,0xf8,0x07,
+0x92,0x2d,0x08,0x3a,0x4d,0x12,0x49,0x95,0x49,0xdb,0x14,0x04,0xc4,0x14,0x85,0x29,
+0xaa,0xe7,0x01,0x08,0xa4,0x49,0x01,0x14,0x51,0xe0,0x53,0x91,0xd5,0x29,0x06,0x1a,
+0x64,0x02,0xf4,0xc7,0x81,0x9e,0x05,0x20,0x22,0x64,0xa5,0x30,0xae,0xab,0x9e,0x97,
+0x53,0xd8,0xb9,0xfd,0x50,0xef,0x93,0x02,0x42,0x74,0x34,0xe8,0x9c,0x20,0x21,0xc9,
+0x01,0x68,0x78,0xe6,0x55,0x29,0x20,0x56,0x4f,0x4c,0x40,0x51,0x71,0x82,0xc0,0x70,
+0x21,0x22,0x85,0xbe,0x4b,0x1c,0x44,0x05,0xea,0xa4,0x01,0xbf,0x22,0xb5,0xf0,0x1c,
+0x06,0x51,0x38,0x8f,0xe0,0x22,0xec,0x18,0xac,0x39,0x22,0xd4,0xd6,0x93,0x44,0x01,
+0x32,0x82,0xc8,0xfc,0x61,0xb3,0x01,0x45,0x0c,0x2e,0x83,0x30,0xd0,0x0e,0x17,0x24,
+0x0f,0x70,0x85,0x94,0xee,0x05,0x05,0x53,0x4b,0x32,0x1b,0x3f,0x98,0xd3,0x1d,0x29,
+0x81,0xb0,0xae,0x1e,0x8c,0x7e,0x68,0xe0,0x60,0x5a,0x54,0x8f,0xb0,0x78,0x69,0x73,
+0x06,0xa2,0x00,0x6b,0x57,0xca,0x3d,0x11,0x50,0xbd,0x04,0x30,0x4b,0x3a,0xd4,0xab,
+0x5f,0x1f,0x9b,0x3d,0x13,0x74,0x27,0x88,0x3c,0x25,0xe0,0x17,0xbe,0x7a,0x79,0x45,
+0x0d,0x0c,0xb0,0x8b,0xda,0x90,0xca,0x80,0x06,0x5d,0x17,0x60,0x1c,0x22,0x4c,0xd8,
+0x57,0x22,0x06,0x20,0x00,0x98,0x07,0x08,0xe4,0x56,0x80,0x80,0x1c,0xc5,0xb7,0xc5,
+0x82,0x0c,0x36,0xe8,0xe0,0x83,0x10,0x46,0x28,0xe1,0x84,0x14,0x56,0x68,0xa1,0x10,
+0x41,0x00,0x00,0x3b,};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__img_sics_gif1 = 1;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__img_sics_gif1[] FSDATA_ALIGN_POST = {
+/* /img/sics.gif (14 chars) */
+0x2f,0x69,0x6d,0x67,0x2f,0x73,0x69,0x63,0x73,0x2e,0x67,0x69,0x66,0x00,0x00,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 200 OK
+" (17 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 677
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x36,0x37,0x37,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Content-Encoding: gzip
+" (24 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x45,0x6e,0x63,0x6f,0x64,0x69,0x6e,0x67,
+0x3a,0x20,0x67,0x7a,0x69,0x70,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "ETag: "29ab7dbf-2a5"
+" (22 bytes) */
+0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x32,0x39,0x61,0x62,0x37,0x64,0x62,0x66,0x2d,
+0x32,0x61,0x35,0x22,0x0d,0x0a,
+/* "Cache-Control: no-cache
+" (25 bytes) */
+0x43,0x61,0x63,0x68,0x65,0x2d,0x43,0x6f,0x6e,0x74,0x72,0x6f,0x6c,0x3a,0x20,0x6e,
+0x6f,0x2d,0x63,0x61,0x63,0x68,0x65,0x0d,0x0a,
+/* "Content-type: image/gif
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x69,0x6d,
+0x61,0x67,0x65,0x2f,0x67,0x69,0x66,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (677 bytes) */
+0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x73,0xf7,0x74,0xb3,0xb0,0x4c,
+0x74,0x63,0x50,0x62,0x58,0xca,0xc0,0x70,0x53,0xdb,0x32,0x2b,0x2b,0x6b,0xff,0xfe,
+0xfd,0x93,0x27,0x4f,0xe6,0xe7,0xe7,0xdf,0xb0,0x61,0xc3,0xb2,0x65,0xcb,0x1a,0x1a,
+0x1a,0xca,0xca,0xca,0xe4,0xe4,0xe4,0xe6,0xce,0x9d,0xab,0xa7,0xa7,0xe7,0xe9,0xe9,
+0x19,0x12,0x12,0xd2,0xd5,0xd5,0x95,0x90,0x90,0x70,0x6c,0xd9,0xcc,0xbd,0x5b,0x37,
+0x1d,0x5a,0xbd,0xf0,0xa6,0xa3,0xc3,0xd5,0xf4,0xd0,0x03,0x1b,0x56,0x5d,0x8d,0xf3,
+0xbb,0x16,0xe0,0x7a,0x66,0x72,0xed,0x89,0x85,0x13,0xce,0x75,0x97,0x5d,0xaa,0x4e,
+0xbd,0xd8,0x92,0x7b,0x72,0x66,0x9b,0x95,0x95,0x15,0x03,0x03,0xc3,0x8e,0x1d,0x3b,
+0xfe,0xd3,0x12,0xe8,0x00,0xed,0x60,0x00,0xf9,0x85,0x81,0xed,0x9f,0xc3,0x84,0x02,
+0x0f,0x1d,0xa9,0xfe,0x13,0x4b,0x8a,0x4e,0xe6,0x58,0xcd,0xbf,0xb0,0xa2,0xc4,0x6b,
+0x6d,0xd4,0xfa,0x1b,0x6b,0xca,0x56,0x3a,0xb0,0xec,0x6b,0x7e,0x94,0x60,0x13,0xa0,
+0xc0,0xdb,0x97,0xcf,0x60,0xa8,0x21,0xc3,0xcb,0xbe,0xf5,0x70,0x42,0xa9,0x8a,0xdd,
+0x8f,0x3f,0xed,0x82,0x6c,0x2f,0x6d,0xdd,0xd8,0xb9,0xab,0xaa,0x6a,0x9c,0xd9,0xe4,
+0x5a,0x2a,0xb8,0xd9,0xf3,0x02,0x19,0xbb,0x5a,0x38,0xea,0x2a,0x1b,0xda,0x3b,0x27,
+0x56,0x4d,0xe6,0x62,0x99,0x59,0x31,0xcd,0x9f,0x79,0x5e,0x25,0xe3,0x94,0xf9,0xce,
+0x73,0x16,0x2f,0x61,0x2d,0x5f,0xbc,0xc0,0x6f,0x46,0x25,0xb7,0x5c,0xf3,0x92,0x65,
+0xf2,0xd3,0x58,0xe7,0xae,0xaa,0x60,0x64,0x6f,0x61,0x91,0x93,0xdb,0xbd,0x23,0xb0,
+0x85,0xcf,0x99,0x95,0xbd,0x7c,0x69,0xbd,0xd3,0xc6,0x4d,0x8c,0xc9,0x1c,0xbc,0xbb,
+0x19,0x79,0xaa,0x78,0x5d,0xf8,0x6e,0xac,0xf7,0x61,0xad,0x62,0x71,0x67,0x67,0xdf,
+0xde,0xb0,0xe8,0x61,0xad,0x0b,0x2b,0x23,0x0b,0xe3,0x85,0x57,0xed,0x93,0xfd,0x1f,
+0xcc,0xf2,0x3c,0x77,0xa3,0x92,0x25,0x4d,0x41,0x54,0x40,0x40,0x70,0x92,0x66,0xc3,
+0xb6,0x03,0x13,0x45,0x5d,0xe5,0x26,0x48,0x16,0xba,0xad,0x88,0x61,0xe1,0x63,0x50,
+0xf2,0x7b,0xe1,0xa0,0x32,0xdf,0x8e,0x85,0x6d,0x79,0xc4,0x95,0xc9,0x0b,0x64,0x26,
+0xda,0xbf,0xf8,0xd0,0xc1,0xbc,0x51,0x71,0x91,0x27,0x83,0x64,0xdb,0x9f,0x20,0x97,
+0x07,0x8c,0x73,0x35,0x15,0x45,0x55,0x03,0xbe,0xa7,0xab,0xca,0xb1,0xfd,0xf5,0x9b,
+0xb5,0x65,0xc2,0x1a,0xd1,0x5f,0xa7,0x83,0x82,0xe5,0x7a,0x3e,0xfd,0x60,0x9f,0xa4,
+0xcb,0x61,0xe5,0x2b,0xe4,0x39,0xd5,0xf3,0xb6,0x08,0xcb,0x11,0x91,0x56,0xcd,0x55,
+0xcf,0x19,0x39,0x96,0x78,0x32,0x8a,0x04,0x3e,0x08,0x9e,0x78,0x55,0x93,0x4d,0x2a,
+0x85,0xe9,0xcb,0xf1,0xc6,0x79,0xac,0x0a,0x4a,0x29,0x4b,0x0d,0xd6,0xad,0x9e,0x37,
+0x3d,0xf8,0xc6,0xce,0xbf,0x01,0xef,0x27,0x33,0x39,0x95,0x98,0xbc,0x98,0xa3,0xa0,
+0x78,0x92,0x31,0xa3,0xe2,0x59,0xa8,0xa6,0x42,0x98,0xbf,0x8f,0x43,0x60,0x61,0xd3,
+0x81,0x02,0x45,0xa5,0xd6,0x7d,0xde,0x32,0x2e,0xac,0xaf,0x96,0x30,0xee,0x57,0xda,
+0xfa,0x41,0x86,0x2d,0xd0,0xa2,0xff,0x81,0xd2,0x1b,0x89,0x35,0x96,0x4a,0x57,0xae,
+0x4d,0x76,0x61,0x34,0x6a,0x3a,0xf1,0x27,0x71,0x33,0xa3,0x2b,0x8f,0x5e,0xb3,0xc1,
+0x05,0x3e,0x71,0x15,0xfe,0x82,0xd6,0x29,0xef,0x58,0x59,0x83,0xbd,0x8d,0xa4,0xed,
+0x67,0x5c,0x96,0xd5,0x6c,0xdc,0xb0,0x4e,0xae,0xa7,0x2e,0xe3,0x41,0x42,0x54,0x48,
+0xff,0x86,0x8a,0xcc,0x62,0xb6,0x45,0x0c,0xd9,0xe1,0xa7,0x6c,0x05,0x03,0xf6,0xb2,
+0x18,0x78,0x5b,0x5d,0x59,0x1d,0x2f,0x3f,0xdb,0x56,0xb8,0x44,0xbd,0xc3,0x46,0xf5,
+0x81,0xf8,0xbe,0xaa,0x4a,0x57,0x5e,0x9e,0x0d,0xdd,0xb7,0x26,0x9c,0x6a,0x60,0x8b,
+0x15,0x4f,0x90,0x51,0xf2,0xb9,0x11,0xae,0xc4,0xa6,0xc0,0x30,0x83,0x9d,0xe3,0x49,
+0x58,0x43,0x83,0xcc,0xd1,0xed,0x47,0x9b,0x78,0xcc,0x5e,0x3c,0x68,0x16,0x70,0xd3,
+0x78,0xd8,0x22,0x12,0x96,0xb1,0x50,0xc0,0x91,0x81,0xc1,0x1a,0x00,0xf7,0x39,0x87,
+0x6a,0xd4,0x02,0x00,0x00,};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__404_html = 2;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__404_html[] FSDATA_ALIGN_POST = {
+/* /404.html (10 chars) */
+0x2f,0x34,0x30,0x34,0x2e,0x68,0x74,0x6d,0x6c,0x00,0x00,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 404 File not found
+" (29 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x34,0x30,0x34,0x20,0x46,0x69,0x6c,
+0x65,0x20,0x6e,0x6f,0x74,0x20,0x66,0x6f,0x75,0x6e,0x64,0x0d,0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 544
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x35,0x34,0x34,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "Content-type: text/html
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (544 bytes) */
+0x3c,0x68,0x74,0x6d,0x6c,0x3e,0x0a,0x3c,0x68,0x65,0x61,0x64,0x3e,0x3c,0x74,0x69,
+0x74,0x6c,0x65,0x3e,0x6c,0x77,0x49,0x50,0x20,0x2d,0x20,0x41,0x20,0x4c,0x69,0x67,
+0x68,0x74,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x54,0x43,0x50,0x2f,0x49,0x50,0x20,
+0x53,0x74,0x61,0x63,0x6b,0x3c,0x2f,0x74,0x69,0x74,0x6c,0x65,0x3e,0x3c,0x2f,0x68,
+0x65,0x61,0x64,0x3e,0x0a,0x3c,0x62,0x6f,0x64,0x79,0x20,0x62,0x67,0x63,0x6f,0x6c,
+0x6f,0x72,0x3d,0x22,0x77,0x68,0x69,0x74,0x65,0x22,0x20,0x74,0x65,0x78,0x74,0x3d,
+0x22,0x62,0x6c,0x61,0x63,0x6b,0x22,0x3e,0x0a,0x0a,0x20,0x20,0x20,0x20,0x3c,0x74,
+0x61,0x62,0x6c,0x65,0x20,0x77,0x69,0x64,0x74,0x68,0x3d,0x22,0x31,0x30,0x30,0x25,
+0x22,0x3e,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x3c,0x74,0x72,0x20,0x76,0x61,0x6c,
+0x69,0x67,0x6e,0x3d,0x22,0x74,0x6f,0x70,0x22,0x3e,0x3c,0x74,0x64,0x20,0x77,0x69,
+0x64,0x74,0x68,0x3d,0x22,0x38,0x30,0x22,0x3e,0x09,0x20,0x20,0x0a,0x09,0x20,0x20,
+0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,
+0x77,0x77,0x77,0x2e,0x73,0x69,0x63,0x73,0x2e,0x73,0x65,0x2f,0x22,0x3e,0x3c,0x69,
+0x6d,0x67,0x20,0x73,0x72,0x63,0x3d,0x22,0x2f,0x69,0x6d,0x67,0x2f,0x73,0x69,0x63,
+0x73,0x2e,0x67,0x69,0x66,0x22,0x0a,0x09,0x20,0x20,0x62,0x6f,0x72,0x64,0x65,0x72,
+0x3d,0x22,0x30,0x22,0x20,0x61,0x6c,0x74,0x3d,0x22,0x53,0x49,0x43,0x53,0x20,0x6c,
+0x6f,0x67,0x6f,0x22,0x20,0x74,0x69,0x74,0x6c,0x65,0x3d,0x22,0x53,0x49,0x43,0x53,
+0x20,0x6c,0x6f,0x67,0x6f,0x22,0x3e,0x3c,0x2f,0x61,0x3e,0x0a,0x09,0x3c,0x2f,0x74,
+0x64,0x3e,0x3c,0x74,0x64,0x20,0x77,0x69,0x64,0x74,0x68,0x3d,0x22,0x35,0x30,0x30,
+0x22,0x3e,0x09,0x20,0x20,0x0a,0x09,0x20,0x20,0x3c,0x68,0x31,0x3e,0x6c,0x77,0x49,
+0x50,0x20,0x2d,0x20,0x41,0x20,0x4c,0x69,0x67,0x68,0x74,0x77,0x65,0x69,0x67,0x68,
+0x74,0x20,0x54,0x43,0x50,0x2f,0x49,0x50,0x20,0x53,0x74,0x61,0x63,0x6b,0x3c,0x2f,
+0x68,0x31,0x3e,0x0a,0x09,0x20,0x20,0x3c,0x68,0x32,0x3e,0x34,0x30,0x34,0x20,0x2d,
+0x20,0x50,0x61,0x67,0x65,0x20,0x6e,0x6f,0x74,0x20,0x66,0x6f,0x75,0x6e,0x64,0x3c,
+0x2f,0x68,0x32,0x3e,0x0a,0x09,0x20,0x20,0x3c,0x70,0x3e,0x0a,0x09,0x20,0x20,0x20,
+0x20,0x53,0x6f,0x72,0x72,0x79,0x2c,0x20,0x74,0x68,0x65,0x20,0x70,0x61,0x67,0x65,
+0x20,0x79,0x6f,0x75,0x20,0x61,0x72,0x65,0x20,0x72,0x65,0x71,0x75,0x65,0x73,0x74,
+0x69,0x6e,0x67,0x20,0x77,0x61,0x73,0x20,0x6e,0x6f,0x74,0x20,0x66,0x6f,0x75,0x6e,
+0x64,0x20,0x6f,0x6e,0x20,0x74,0x68,0x69,0x73,0x0a,0x09,0x20,0x20,0x20,0x20,0x73,
+0x65,0x72,0x76,0x65,0x72,0x2e,0x20,0x0a,0x09,0x20,0x20,0x3c,0x2f,0x70,0x3e,0x0a,
+0x09,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,0x3e,0x0a,0x09,0x20,0x20,0x26,0x6e,
+0x62,0x73,0x70,0x3b,0x0a,0x09,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,
+0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x3c,0x2f,0x74,0x61,0x62,0x6c,0x65,0x3e,0x0a,
+0x3c,0x2f,0x62,0x6f,0x64,0x79,0x3e,0x0a,0x3c,0x2f,0x68,0x74,0x6d,0x6c,0x3e,0x0a,
+};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__404_html1 = 3;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__404_html1[] FSDATA_ALIGN_POST = {
+/* /404.html (10 chars) */
+0x2f,0x34,0x30,0x34,0x2e,0x68,0x74,0x6d,0x6c,0x00,0x00,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 404 File not found
+" (29 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x34,0x30,0x34,0x20,0x46,0x69,0x6c,
+0x65,0x20,0x6e,0x6f,0x74,0x20,0x66,0x6f,0x75,0x6e,0x64,0x0d,0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 338
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x33,0x33,0x38,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Content-Encoding: gzip
+" (24 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x45,0x6e,0x63,0x6f,0x64,0x69,0x6e,0x67,
+0x3a,0x20,0x67,0x7a,0x69,0x70,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "Content-type: text/html
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (338 bytes) */
+0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x8d,0x92,0xcf,0x6a,0xc3,0x30,
+0x0c,0xc6,0xcf,0xcd,0x53,0x08,0xc3,0x76,0xda,0xea,0xb4,0x74,0x30,0x36,0x27,0x30,
+0x7a,0x2a,0xec,0x50,0xc8,0x5e,0xc0,0x69,0x54,0xdb,0xcc,0x8d,0x33,0x5b,0x6d,0xd6,
+0xb7,0x9f,0x92,0xd0,0x2d,0xc7,0x19,0xfc,0x07,0xe9,0xf7,0x99,0x4f,0x96,0x95,0xa5,
+0x93,0x2f,0x33,0x65,0x51,0x37,0xa5,0x22,0x47,0x1e,0x4b,0xdf,0xef,0xf6,0xf0,0x08,
+0x6f,0xf0,0xee,0x8c,0xa5,0x1e,0x87,0x15,0x3e,0xb6,0x7b,0xc9,0xe1,0x8a,0xf4,0xe1,
+0x53,0xc9,0x09,0x54,0x72,0x94,0x65,0xaa,0x0e,0xcd,0x15,0x6a,0x73,0x08,0x3e,0xc4,
+0x42,0xf4,0xd6,0x11,0x0a,0x20,0xfc,0xa6,0x42,0xd4,0x9e,0x05,0xa2,0xcc,0x32,0xe0,
+0xa1,0x48,0xd7,0x1e,0xa1,0x77,0x0d,0xd9,0x42,0xac,0xf2,0xfc,0x8e,0x33,0x00,0x53,
+0x2a,0xc2,0x45,0x7b,0x67,0xda,0x42,0x50,0xe8,0x04,0x9b,0x69,0x6e,0xe0,0x73,0x2e,
+0xca,0x05,0x40,0xc6,0x53,0x69,0xb0,0x11,0x8f,0x85,0xb0,0x44,0xdd,0x8b,0x94,0x7d,
+0xdf,0x2f,0x93,0x3b,0xa4,0x65,0x42,0xc9,0x1a,0x77,0x32,0x90,0xe2,0xa1,0x10,0x92,
+0x4f,0x72,0x4c,0x18,0x77,0x14,0x83,0xb2,0x0e,0xb1,0x41,0x76,0x97,0x0b,0xd0,0x9e,
+0x8d,0x55,0xbb,0x6d,0x05,0x3e,0x98,0xc0,0x4e,0x87,0x6a,0xe6,0x11,0xae,0x4c,0x97,
+0xd9,0x82,0xeb,0x6c,0xe6,0x3e,0x9e,0xf2,0x99,0x11,0xbb,0xfa,0xcf,0x43,0x31,0x35,
+0xd1,0xeb,0x72,0x93,0x6f,0x18,0xde,0x6b,0x83,0xd0,0x06,0x82,0x63,0x38,0xb7,0x0d,
+0x03,0xeb,0x09,0xe8,0xc6,0x0d,0xa0,0x0a,0x31,0x5e,0x1f,0x80,0x2c,0x42,0x37,0xa0,
+0xd7,0x70,0x06,0x1d,0x11,0x22,0x7e,0x9d,0x31,0x91,0x6b,0x0d,0xf4,0x3a,0xfd,0xdd,
+0x00,0xa1,0x65,0xd8,0xa5,0x49,0x9d,0x30,0x5e,0x30,0x2e,0x27,0x87,0xb2,0x9b,0xd5,
+0x30,0x5e,0x7f,0xdf,0xd6,0xa9,0x7b,0xbd,0x05,0x25,0xc5,0xdf,0xd7,0x97,0x63,0x67,
+0xb8,0x95,0x72,0xe8,0xe5,0xb0,0x4f,0x1f,0xe3,0x07,0x71,0x6d,0x25,0x1b,0x20,0x02,
+0x00,0x00,};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__index_html = 4;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__index_html[] FSDATA_ALIGN_POST = {
+/* /index.html (12 chars) */
+0x2f,0x69,0x6e,0x64,0x65,0x78,0x2e,0x68,0x74,0x6d,0x6c,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 200 OK
+" (17 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 1704
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x31,0x37,0x30,0x34,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "ETag: "95f2cdb9-6a8"
+" (22 bytes) */
+0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x39,0x35,0x66,0x32,0x63,0x64,0x62,0x39,0x2d,
+0x36,0x61,0x38,0x22,0x0d,0x0a,
+/* "Cache-Control: no-cache
+" (25 bytes) */
+0x43,0x61,0x63,0x68,0x65,0x2d,0x43,0x6f,0x6e,0x74,0x72,0x6f,0x6c,0x3a,0x20,0x6e,
+0x6f,0x2d,0x63,0x61,0x63,0x68,0x65,0x0d,0x0a,
+/* "Content-type: text/html
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (1704 bytes) */
+0x3c,0x68,0x74,0x6d,0x6c,0x3e,0x0a,0x3c,0x68,0x65,0x61,0x64,0x3e,0x3c,0x74,0x69,
+0x74,0x6c,0x65,0x3e,0x6c,0x77,0x49,0x50,0x20,0x2d,0x20,0x41,0x20,0x4c,0x69,0x67,
+0x68,0x74,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x54,0x43,0x50,0x2f,0x49,0x50,0x20,
+0x53,0x74,0x61,0x63,0x6b,0x3c,0x2f,0x74,0x69,0x74,0x6c,0x65,0x3e,0x3c,0x2f,0x68,
+0x65,0x61,0x64,0x3e,0x0a,0x3c,0x62,0x6f,0x64,0x79,0x20,0x62,0x67,0x63,0x6f,0x6c,
+0x6f,0x72,0x3d,0x22,0x77,0x68,0x69,0x74,0x65,0x22,0x20,0x74,0x65,0x78,0x74,0x3d,
+0x22,0x62,0x6c,0x61,0x63,0x6b,0x22,0x3e,0x0a,0x0a,0x20,0x20,0x20,0x20,0x3c,0x74,
+0x61,0x62,0x6c,0x65,0x20,0x77,0x69,0x64,0x74,0x68,0x3d,0x22,0x31,0x30,0x30,0x25,
+0x22,0x3e,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x3c,0x74,0x72,0x20,0x76,0x61,0x6c,
+0x69,0x67,0x6e,0x3d,0x22,0x74,0x6f,0x70,0x22,0x3e,0x3c,0x74,0x64,0x20,0x77,0x69,
+0x64,0x74,0x68,0x3d,0x22,0x38,0x30,0x22,0x3e,0x09,0x20,0x20,0x0a,0x09,0x20,0x20,
+0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,
+0x77,0x77,0x77,0x2e,0x73,0x69,0x63,0x73,0x2e,0x73,0x65,0x2f,0x22,0x3e,0x3c,0x69,
+0x6d,0x67,0x20,0x73,0x72,0x63,0x3d,0x22,0x2f,0x69,0x6d,0x67,0x2f,0x73,0x69,0x63,
+0x73,0x2e,0x67,0x69,0x66,0x22,0x0a,0x09,0x20,0x20,0x62,0x6f,0x72,0x64,0x65,0x72,
+0x3d,0x22,0x30,0x22,0x20,0x61,0x6c,0x74,0x3d,0x22,0x53,0x49,0x43,0x53,0x20,0x6c,
+0x6f,0x67,0x6f,0x22,0x20,0x74,0x69,0x74,0x6c,0x65,0x3d,0x22,0x53,0x49,0x43,0x53,
+0x20,0x6c,0x6f,0x67,0x6f,0x22,0x3e,0x3c,0x2f,0x61,0x3e,0x0a,0x09,0x3c,0x2f,0x74,
+0x64,0x3e,0x3c,0x74,0x64,0x20,0x77,0x69,0x64,0x74,0x68,0x3d,0x22,0x35,0x30,0x30,
+0x22,0x3e,0x09,0x20,0x20,0x0a,0x09,0x20,0x20,0x3c,0x68,0x31,0x3e,0x6c,0x77,0x49,
+0x50,0x20,0x2d,0x20,0x41,0x20,0x4c,0x69,0x67,0x68,0x74,0x77,0x65,0x69,0x67,0x68,
+0x74,0x20,0x54,0x43,0x50,0x2f,0x49,0x50,0x20,0x53,0x74,0x61,0x63,0x6b,0x3c,0x2f,
+0x68,0x31,0x3e,0x0a,0x09,0x20,0x20,0x3c,0x70,0x3e,0x0a,0x09,0x20,0x20,0x20,0x20,
+0x54,0x68,0x65,0x20,0x77,0x65,0x62,0x20,0x70,0x61,0x67,0x65,0x20,0x79,0x6f,0x75,
+0x20,0x61,0x72,0x65,0x20,0x77,0x61,0x74,0x63,0x68,0x69,0x6e,0x67,0x20,0x77,0x61,
+0x73,0x20,0x73,0x65,0x72,0x76,0x65,0x64,0x20,0x62,0x79,0x20,0x61,0x20,0x73,0x69,
+0x6d,0x70,0x6c,0x65,0x20,0x77,0x65,0x62,0x0a,0x09,0x20,0x20,0x20,0x20,0x73,0x65,
+0x72,0x76,0x65,0x72,0x20,0x72,0x75,0x6e,0x6e,0x69,0x6e,0x67,0x20,0x6f,0x6e,0x20,
+0x74,0x6f,0x70,0x20,0x6f,0x66,0x20,0x74,0x68,0x65,0x20,0x6c,0x69,0x67,0x68,0x74,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x54,0x43,0x50,0x2f,0x49,0x50,0x20,0x73,0x74,
+0x61,0x63,0x6b,0x20,0x3c,0x61,0x0a,0x09,0x20,0x20,0x20,0x20,0x68,0x72,0x65,0x66,
+0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x77,0x77,0x77,0x2e,0x73,0x69,0x63,
+0x73,0x2e,0x73,0x65,0x2f,0x7e,0x61,0x64,0x61,0x6d,0x2f,0x6c,0x77,0x69,0x70,0x2f,
+0x22,0x3e,0x6c,0x77,0x49,0x50,0x3c,0x2f,0x61,0x3e,0x2e,0x0a,0x09,0x20,0x20,0x3c,
+0x2f,0x70,0x3e,0x0a,0x09,0x20,0x20,0x3c,0x70,0x3e,0x0a,0x09,0x20,0x20,0x20,0x20,
+0x6c,0x77,0x49,0x50,0x20,0x69,0x73,0x20,0x61,0x6e,0x20,0x6f,0x70,0x65,0x6e,0x20,
+0x73,0x6f,0x75,0x72,0x63,0x65,0x20,0x69,0x6d,0x70,0x6c,0x65,0x6d,0x65,0x6e,0x74,
+0x61,0x74,0x69,0x6f,0x6e,0x20,0x6f,0x66,0x20,0x74,0x68,0x65,0x20,0x54,0x43,0x50,
+0x2f,0x49,0x50,0x0a,0x09,0x20,0x20,0x20,0x20,0x70,0x72,0x6f,0x74,0x6f,0x63,0x6f,
+0x6c,0x20,0x73,0x75,0x69,0x74,0x65,0x20,0x74,0x68,0x61,0x74,0x20,0x77,0x61,0x73,
+0x20,0x6f,0x72,0x69,0x67,0x69,0x6e,0x61,0x6c,0x6c,0x79,0x20,0x77,0x72,0x69,0x74,
+0x74,0x65,0x6e,0x20,0x62,0x79,0x20,0x3c,0x61,0x0a,0x09,0x20,0x20,0x20,0x20,0x68,
+0x72,0x65,0x66,0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x77,0x77,0x77,0x2e,
+0x73,0x69,0x63,0x73,0x2e,0x73,0x65,0x2f,0x7e,0x61,0x64,0x61,0x6d,0x2f,0x6c,0x77,
+0x69,0x70,0x2f,0x22,0x3e,0x41,0x64,0x61,0x6d,0x20,0x44,0x75,0x6e,0x6b,0x65,0x6c,
+0x73,0x0a,0x09,0x20,0x20,0x20,0x20,0x6f,0x66,0x20,0x74,0x68,0x65,0x20,0x53,0x77,
+0x65,0x64,0x69,0x73,0x68,0x20,0x49,0x6e,0x73,0x74,0x69,0x74,0x75,0x74,0x65,0x20,
+0x6f,0x66,0x20,0x43,0x6f,0x6d,0x70,0x75,0x74,0x65,0x72,0x20,0x53,0x63,0x69,0x65,
+0x6e,0x63,0x65,0x3c,0x2f,0x61,0x3e,0x20,0x62,0x75,0x74,0x20,0x6e,0x6f,0x77,0x20,
+0x69,0x73,0x0a,0x09,0x20,0x20,0x20,0x20,0x62,0x65,0x69,0x6e,0x67,0x20,0x61,0x63,
+0x74,0x69,0x76,0x65,0x6c,0x79,0x20,0x64,0x65,0x76,0x65,0x6c,0x6f,0x70,0x65,0x64,
+0x20,0x62,0x79,0x20,0x61,0x20,0x74,0x65,0x61,0x6d,0x20,0x6f,0x66,0x20,0x64,0x65,
+0x76,0x65,0x6c,0x6f,0x70,0x65,0x72,0x73,0x0a,0x09,0x20,0x20,0x20,0x20,0x64,0x69,
+0x73,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x64,0x20,0x77,0x6f,0x72,0x6c,0x64,0x2d,
+0x77,0x69,0x64,0x65,0x2e,0x20,0x53,0x69,0x6e,0x63,0x65,0x20,0x69,0x74,0x27,0x73,
+0x20,0x72,0x65,0x6c,0x65,0x61,0x73,0x65,0x2c,0x20,0x6c,0x77,0x49,0x50,0x20,0x68,
+0x61,0x73,0x0a,0x09,0x20,0x20,0x20,0x20,0x73,0x70,0x75,0x72,0x72,0x65,0x64,0x20,
+0x61,0x20,0x6c,0x6f,0x74,0x20,0x6f,0x66,0x20,0x69,0x6e,0x74,0x65,0x72,0x65,0x73,
+0x74,0x20,0x61,0x6e,0x64,0x20,0x68,0x61,0x73,0x20,0x62,0x65,0x65,0x6e,0x20,0x70,
+0x6f,0x72,0x74,0x65,0x64,0x20,0x74,0x6f,0x20,0x73,0x65,0x76,0x65,0x72,0x61,0x6c,
+0x0a,0x09,0x20,0x20,0x20,0x20,0x70,0x6c,0x61,0x74,0x66,0x6f,0x72,0x6d,0x73,0x20,
+0x61,0x6e,0x64,0x20,0x6f,0x70,0x65,0x72,0x61,0x74,0x69,0x6e,0x67,0x20,0x73,0x79,
+0x73,0x74,0x65,0x6d,0x73,0x2e,0x20,0x6c,0x77,0x49,0x50,0x20,0x63,0x61,0x6e,0x20,
+0x62,0x65,0x20,0x75,0x73,0x65,0x64,0x20,0x65,0x69,0x74,0x68,0x65,0x72,0x0a,0x09,
+0x20,0x20,0x20,0x20,0x77,0x69,0x74,0x68,0x20,0x6f,0x72,0x20,0x77,0x69,0x74,0x68,
+0x6f,0x75,0x74,0x20,0x61,0x6e,0x20,0x75,0x6e,0x64,0x65,0x72,0x6c,0x79,0x69,0x6e,
+0x67,0x20,0x4f,0x53,0x2e,0x0a,0x09,0x20,0x20,0x3c,0x2f,0x70,0x3e,0x0a,0x09,0x20,
+0x20,0x3c,0x70,0x3e,0x0a,0x09,0x20,0x20,0x20,0x20,0x54,0x68,0x65,0x20,0x66,0x6f,
+0x63,0x75,0x73,0x20,0x6f,0x66,0x20,0x74,0x68,0x65,0x20,0x6c,0x77,0x49,0x50,0x20,
+0x54,0x43,0x50,0x2f,0x49,0x50,0x20,0x69,0x6d,0x70,0x6c,0x65,0x6d,0x65,0x6e,0x74,
+0x61,0x74,0x69,0x6f,0x6e,0x20,0x69,0x73,0x20,0x74,0x6f,0x20,0x72,0x65,0x64,0x75,
+0x63,0x65,0x0a,0x09,0x20,0x20,0x20,0x20,0x74,0x68,0x65,0x20,0x52,0x41,0x4d,0x20,
+0x75,0x73,0x61,0x67,0x65,0x20,0x77,0x68,0x69,0x6c,0x65,0x20,0x73,0x74,0x69,0x6c,
+0x6c,0x20,0x68,0x61,0x76,0x69,0x6e,0x67,0x20,0x61,0x20,0x66,0x75,0x6c,0x6c,0x20,
+0x73,0x63,0x61,0x6c,0x65,0x20,0x54,0x43,0x50,0x2e,0x20,0x54,0x68,0x69,0x73,0x0a,
+0x09,0x20,0x20,0x20,0x20,0x6d,0x61,0x6b,0x65,0x73,0x20,0x6c,0x77,0x49,0x50,0x20,
+0x73,0x75,0x69,0x74,0x61,0x62,0x6c,0x65,0x20,0x66,0x6f,0x72,0x20,0x75,0x73,0x65,
+0x20,0x69,0x6e,0x20,0x65,0x6d,0x62,0x65,0x64,0x64,0x65,0x64,0x20,0x73,0x79,0x73,
+0x74,0x65,0x6d,0x73,0x20,0x77,0x69,0x74,0x68,0x20,0x74,0x65,0x6e,0x73,0x0a,0x09,
+0x20,0x20,0x20,0x20,0x6f,0x66,0x20,0x6b,0x69,0x6c,0x6f,0x62,0x79,0x74,0x65,0x73,
+0x20,0x6f,0x66,0x20,0x66,0x72,0x65,0x65,0x20,0x52,0x41,0x4d,0x20,0x61,0x6e,0x64,
+0x20,0x72,0x6f,0x6f,0x6d,0x20,0x66,0x6f,0x72,0x20,0x61,0x72,0x6f,0x75,0x6e,0x64,
+0x20,0x34,0x30,0x20,0x6b,0x69,0x6c,0x6f,0x62,0x79,0x74,0x65,0x73,0x0a,0x09,0x20,
+0x20,0x20,0x20,0x6f,0x66,0x20,0x63,0x6f,0x64,0x65,0x20,0x52,0x4f,0x4d,0x2e,0x0a,
+0x09,0x20,0x20,0x3c,0x2f,0x70,0x3e,0x0a,0x09,0x20,0x20,0x3c,0x70,0x3e,0x0a,0x09,
+0x20,0x20,0x20,0x20,0x4d,0x6f,0x72,0x65,0x20,0x69,0x6e,0x66,0x6f,0x72,0x6d,0x61,
+0x74,0x69,0x6f,0x6e,0x20,0x61,0x62,0x6f,0x75,0x74,0x20,0x6c,0x77,0x49,0x50,0x20,
+0x63,0x61,0x6e,0x20,0x62,0x65,0x20,0x66,0x6f,0x75,0x6e,0x64,0x20,0x61,0x74,0x20,
+0x74,0x68,0x65,0x20,0x6c,0x77,0x49,0x50,0x0a,0x09,0x20,0x20,0x20,0x20,0x68,0x6f,
+0x6d,0x65,0x70,0x61,0x67,0x65,0x20,0x61,0x74,0x20,0x3c,0x61,0x0a,0x09,0x20,0x20,
+0x20,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,
+0x61,0x76,0x61,0x6e,0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,
+0x72,0x67,0x2f,0x70,0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,
+0x2f,0x22,0x3e,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,0x6e,
+0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,0x72,
+0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x2f,0x3c,0x2f,0x61,0x3e,
+0x0a,0x09,0x20,0x20,0x20,0x20,0x6f,0x72,0x20,0x61,0x74,0x20,0x74,0x68,0x65,0x20,
+0x6c,0x77,0x49,0x50,0x20,0x77,0x69,0x6b,0x69,0x20,0x61,0x74,0x20,0x3c,0x61,0x0a,
+0x09,0x20,0x20,0x20,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x68,0x74,0x74,0x70,0x3a,
+0x2f,0x2f,0x6c,0x77,0x69,0x70,0x2e,0x77,0x69,0x6b,0x69,0x61,0x2e,0x63,0x6f,0x6d,
+0x2f,0x22,0x3e,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x6c,0x77,0x69,0x70,0x2e,0x77,
+0x69,0x6b,0x69,0x61,0x2e,0x63,0x6f,0x6d,0x2f,0x3c,0x2f,0x61,0x3e,0x2e,0x0a,0x09,
+0x20,0x20,0x3c,0x2f,0x70,0x3e,0x0a,0x09,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,
+0x3e,0x0a,0x09,0x20,0x20,0x26,0x6e,0x62,0x73,0x70,0x3b,0x0a,0x09,0x3c,0x2f,0x74,
+0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x3c,0x2f,
+0x74,0x61,0x62,0x6c,0x65,0x3e,0x0a,0x3c,0x2f,0x62,0x6f,0x64,0x79,0x3e,0x0a,0x3c,
+0x2f,0x68,0x74,0x6d,0x6c,0x3e,0x0a,0x0a,};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__index_html1 = 5;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__index_html1[] FSDATA_ALIGN_POST = {
+/* /index.html (12 chars) */
+0x2f,0x69,0x6e,0x64,0x65,0x78,0x2e,0x68,0x74,0x6d,0x6c,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 200 OK
+" (17 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Content-Length: 821
+" (18+ bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x4c,0x65,0x6e,0x67,0x74,0x68,0x3a,0x20,
+0x38,0x32,0x31,0x0d,0x0a,
+/* "Connection: keep-alive
+" (24 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x6b,0x65,0x65,0x70,
+0x2d,0x61,0x6c,0x69,0x76,0x65,0x0d,0x0a,
+/* "Content-Encoding: gzip
+" (24 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x45,0x6e,0x63,0x6f,0x64,0x69,0x6e,0x67,
+0x3a,0x20,0x67,0x7a,0x69,0x70,0x0d,0x0a,
+/* "Vary: Accept-Encoding
+" (23 bytes) */
+0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,
+0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+/* "ETag: "b8604469-335"
+" (22 bytes) */
+0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x62,0x38,0x36,0x30,0x34,0x34,0x36,0x39,0x2d,
+0x33,0x33,0x35,0x22,0x0d,0x0a,
+/* "Cache-Control: no-cache
+" (25 bytes) */
+0x43,0x61,0x63,0x68,0x65,0x2d,0x43,0x6f,0x6e,0x74,0x72,0x6f,0x6c,0x3a,0x20,0x6e,
+0x6f,0x2d,0x63,0x61,0x63,0x68,0x65,0x0d,0x0a,
+/* "Content-type: text/html
+
+" (27 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (821 bytes) */
+0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x95,0x55,0x5d,0x6f,0xdb,0x38,
+0x10,0x7c,0xae,0x7f,0xc5,0x42,0xc0,0xb5,0x2f,0x57,0xc9,0x05,0xae,0x40,0x71,0xb5,
+0x0d,0x04,0xe9,0x4b,0x80,0x06,0x2d,0xce,0xfd,0x03,0x94,0xb4,0x96,0x78,0xa6,0x48,
+0x81,0x5c,0x59,0xf5,0x4b,0x7f,0x7b,0x87,0xa4,0x9c,0xb8,0x69,0x0a,0xb4,0x01,0x12,
+0x29,0xe4,0x7e,0xcc,0xcc,0x0e,0xa9,0x4d,0x2f,0x83,0xd9,0xad,0x36,0x3d,0xab,0x76,
+0xb7,0x11,0x2d,0x86,0x77,0x66,0xbe,0xfb,0x4c,0xaf,0xe9,0x86,0x3e,0xea,0xae,0x97,
+0x99,0xe3,0x5f,0xfa,0x72,0xfb,0xb9,0xc2,0xf2,0x5e,0x54,0x73,0xdc,0x54,0x39,0x70,
+0x53,0xa5,0xb4,0xd5,0xa6,0x76,0xed,0x99,0xea,0xae,0x71,0xc6,0xf9,0x6d,0x31,0xf7,
+0x5a,0xb8,0x20,0xe1,0xaf,0xb2,0x2d,0x6a,0x83,0x84,0x62,0xb7,0x5a,0x11,0x7e,0x36,
+0xa2,0x6a,0xc3,0x34,0xeb,0x56,0xfa,0x6d,0xf1,0x66,0xbd,0xfe,0x0b,0x3b,0x44,0x79,
+0xcb,0xd3,0x49,0x19,0xdd,0xd9,0x6d,0x21,0x6e,0x2c,0x00,0xa6,0xbd,0x04,0xbe,0x5b,
+0x17,0xbb,0x17,0x44,0x2b,0xfc,0x6e,0x14,0xf5,0x9e,0x0f,0xdb,0xa2,0x17,0x19,0xff,
+0xad,0xaa,0x79,0x9e,0xcb,0xa0,0x9b,0x50,0x06,0xae,0x90,0xa3,0x87,0x8e,0x82,0x6f,
+0xb6,0x45,0x85,0xb7,0x2a,0x6d,0x74,0xfa,0x50,0xc4,0xcc,0xda,0xf9,0x96,0x81,0x6e,
+0x5d,0x90,0x32,0x00,0xb6,0xbf,0xbb,0xdd,0x93,0x71,0x9d,0x03,0xd2,0xc8,0xe6,0x7a,
+0x05,0xcc,0xd4,0x6e,0xf5,0x02,0x3c,0xdb,0x6b,0x1c,0x6f,0xd7,0x57,0x40,0xfa,0x37,
+0xbf,0x23,0x14,0xa2,0x52,0xf4,0x98,0x1e,0x44,0x5f,0x7a,0xd0,0xe7,0x9a,0x46,0xd5,
+0x31,0x9d,0xdd,0x44,0xca,0x63,0x41,0x49,0xd3,0x6b,0xdb,0xe1,0x25,0x50,0x60,0x7f,
+0xe2,0x96,0xea,0x33,0x29,0x0a,0x7a,0x18,0x4d,0x4a,0xc8,0xd9,0x69,0xcf,0x93,0x9f,
+0xac,0x8d,0xe1,0xce,0x12,0xa4,0x22,0x77,0x20,0x41,0x59,0xf3,0x33,0x88,0x10,0x41,
+0x40,0xb3,0x9c,0xfd,0x4b,0xe1,0xbe,0xa9,0x56,0x0d,0x95,0x99,0xf5,0x08,0x0d,0x23,
+0xa9,0x48,0xbf,0x4c,0xb8,0xab,0xf1,0x47,0xfc,0x89,0xb2,0x0e,0xa4,0x2c,0xb9,0x91,
+0x2d,0x05,0x37,0xf9,0x86,0x29,0xe1,0x1c,0xd8,0x8a,0x12,0x0d,0x54,0x0b,0xa2,0x8c,
+0x22,0x27,0x8e,0xde,0x89,0x83,0x41,0x28,0x4c,0x70,0x07,0xb6,0x95,0x24,0xba,0xce,
+0xeb,0x4e,0x5b,0x65,0xcc,0x99,0x66,0xaf,0x45,0x50,0x13,0xd4,0xff,0x0c,0xf2,0x0d,
+0xde,0xe9,0xc3,0x64,0x8f,0x6c,0x42,0xce,0x5b,0x00,0xec,0x67,0x6e,0x75,0xe8,0xe9,
+0xce,0x06,0xcc,0x78,0x42,0x5f,0x6c,0xdc,0xba,0x61,0xc4,0xab,0xa7,0x7d,0xa3,0xd9,
+0x36,0x1c,0xc9,0x52,0x3d,0x09,0x59,0x37,0x83,0x5a,0x2e,0x50,0x73,0x14,0x58,0x35,
+0xa2,0x4f,0x0c,0x68,0x2d,0xe3,0x01,0xc2,0xcb,0x5c,0x84,0xd1,0x10,0xa5,0x2e,0xcb,
+0x7e,0xc9,0x42,0x33,0xf1,0x1a,0xb5,0x10,0x38,0x3b,0x6f,0xda,0xd7,0x70,0x0e,0x97,
+0xb4,0xd7,0x36,0x8a,0x24,0xaf,0x02,0x79,0x36,0xac,0x02,0xff,0x9d,0x95,0xec,0xd5,
+0x92,0x19,0xc6,0xc9,0x7b,0x64,0x29,0x18,0x50,0x62,0x69,0x6d,0x01,0x91,0x83,0x40,
+0xe9,0x36,0x86,0x01,0x11,0xa4,0x19,0x9d,0x8f,0xb5,0xc5,0xc1,0x0a,0x70,0x82,0x32,
+0x8b,0xb8,0x46,0xc9,0xc1,0xf9,0x21,0xa4,0xe8,0x08,0x08,0x73,0x00,0xfe,0x70,0x0e,
+0xc2,0x43,0x28,0x73,0xb3,0x06,0x43,0xab,0x99,0xa6,0x80,0x0a,0xac,0xa1,0x8f,0xcf,
+0xd9,0x33,0xde,0x31,0x87,0xf4,0x74,0x53,0xec,0x48,0x93,0xc5,0x59,0x31,0xe7,0x58,
+0xe3,0xd3,0xfe,0x79,0x27,0x44,0x27,0x1f,0x5c,0x33,0x85,0x07,0xff,0xc5,0x1e,0x8b,
+0xf1,0x9e,0xf8,0x01,0x86,0x01,0x64,0xf0,0x9b,0x1a,0xce,0xd9,0x31,0xe1,0xbf,0x9b,
+0x7b,0x80,0x89,0x07,0x01,0x37,0x06,0x6c,0x8e,0x19,0x19,0x03,0xae,0xa7,0x24,0x3d,
+0x1d,0x26,0xfc,0x17,0x1a,0x65,0x92,0x91,0x4a,0x34,0xbc,0x0c,0x67,0x50,0x47,0x0e,
+0xb9,0x5f,0x74,0x53,0xba,0x53,0x40,0x3f,0x32,0x83,0x6e,0xc4,0x43,0xcd,0x6d,0x0b,
+0x92,0x0b,0xfd,0x4c,0x10,0xce,0x7a,0x34,0xc7,0x51,0x1b,0x57,0x9f,0x85,0x13,0xf8,
+0x83,0xe7,0x0c,0x26,0x8a,0xe7,0x9d,0x1b,0x52,0x31,0xe5,0x1d,0x54,0xa0,0x7f,0xd6,
+0x8f,0xc1,0x0f,0xe9,0x8d,0x6b,0x91,0xf1,0xe9,0xfe,0x79,0x65,0xee,0x9d,0x8f,0x38,
+0xe2,0x40,0x32,0x7d,0x55,0x47,0x59,0xaf,0x67,0x70,0x48,0xb5,0x71,0x04,0x2e,0xc2,
+0x2d,0x76,0x77,0x03,0xa7,0x9b,0x01,0x3b,0xcf,0x1e,0x81,0xa0,0x4e,0xca,0x5a,0xd5,
+0x97,0xd6,0xd9,0xce,0x4e,0xa5,0xf3,0x5d,0x85,0x93,0xf5,0x3f,0x37,0x12,0x2e,0xa7,
+0xe1,0xb7,0x43,0xf3,0x25,0x97,0x28,0xf9,0x6b,0x2c,0xd0,0xeb,0xa8,0x7f,0x09,0x21,
+0xa6,0x96,0x31,0x42,0x95,0x8d,0x1b,0x1e,0xfb,0x3d,0x59,0x7f,0x72,0x85,0x5c,0xae,
+0xd2,0xd4,0xf0,0xa5,0xad,0xc3,0xf8,0xfe,0xb2,0x58,0x89,0x7f,0xf8,0x08,0x54,0x69,
+0x98,0xf8,0xa2,0x54,0xf1,0x93,0x12,0x9f,0xf9,0xfb,0xb4,0xfa,0x0e,0x88,0x3e,0xbc,
+0xb9,0xa8,0x06,0x00,0x00,};
+
+#if FSDATA_FILE_ALIGNMENT==1
+static const unsigned int dummy_align__status_shtml = 6;
+#endif
+static const unsigned char FSDATA_ALIGN_PRE data__status_shtml[] FSDATA_ALIGN_POST = {
+/* /status.shtml (14 chars) */
+0x2f,0x73,0x74,0x61,0x74,0x75,0x73,0x2e,0x73,0x68,0x74,0x6d,0x6c,0x00,0x00,0x00,
+
+/* HTTP header */
+/* "HTTP/1.1 200 OK
+" (17 bytes) */
+0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+0x0a,
+/* "Server: lwIP/2.0.3 (http://savannah.nongnu.org/projects/lwip)
+" (63 bytes) */
+0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x32,0x2e,0x30,
+0x2e,0x33,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,0x6e,
+0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,0x70,
+0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+/* "Connection: Close
+" (19 bytes) */
+0x43,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x3a,0x20,0x43,0x6c,0x6f,0x73,
+0x65,0x0d,0x0a,
+/* "Content-type: text/html
+Expires: Fri, 10 Apr 2008 14:00:00 GMT
+Pragma: no-cache
+
+" (85 bytes) */
+0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x45,0x78,0x70,0x69,0x72,0x65,0x73,
+0x3a,0x20,0x46,0x72,0x69,0x2c,0x20,0x31,0x30,0x20,0x41,0x70,0x72,0x20,0x32,0x30,
+0x30,0x38,0x20,0x31,0x34,0x3a,0x30,0x30,0x3a,0x30,0x30,0x20,0x47,0x4d,0x54,0x0d,
+0x0a,0x50,0x72,0x61,0x67,0x6d,0x61,0x3a,0x20,0x6e,0x6f,0x2d,0x63,0x61,0x63,0x68,
+0x65,0x0d,0x0a,0x0d,0x0a,
+/* raw file data (764 bytes) */
+0x3c,0x68,0x74,0x6d,0x6c,0x3e,0x0a,0x3c,0x68,0x65,0x61,0x64,0x3e,0x3c,0x74,0x69,
+0x74,0x6c,0x65,0x3e,0x42,0x6f,0x61,0x72,0x64,0x20,0x73,0x74,0x61,0x74,0x75,0x73,
+0x3c,0x2f,0x74,0x69,0x74,0x6c,0x65,0x3e,0x3c,0x6d,0x65,0x74,0x61,0x20,0x68,0x74,
+0x74,0x70,0x2d,0x65,0x71,0x75,0x69,0x76,0x3d,0x22,0x72,0x65,0x66,0x72,0x65,0x73,
+0x68,0x22,0x20,0x63,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x3d,0x22,0x35,0x22,0x3e,0x3c,
+0x2f,0x68,0x65,0x61,0x64,0x3e,0x0a,0x3c,0x62,0x6f,0x64,0x79,0x20,0x62,0x67,0x63,
+0x6f,0x6c,0x6f,0x72,0x3d,0x22,0x77,0x68,0x69,0x74,0x65,0x22,0x20,0x74,0x65,0x78,
+0x74,0x3d,0x22,0x62,0x6c,0x61,0x63,0x6b,0x22,0x3e,0x0a,0x3c,0x68,0x31,0x3e,0x42,
+0x6f,0x61,0x72,0x64,0x20,0x73,0x74,0x61,0x74,0x75,0x73,0x3c,0x2f,0x68,0x31,0x3e,
+0x0a,0x3c,0x74,0x61,0x62,0x6c,0x65,0x20,0x62,0x6f,0x72,0x64,0x65,0x72,0x3d,0x22,
+0x31,0x22,0x20,0x63,0x65,0x6c,0x6c,0x70,0x61,0x64,0x64,0x69,0x6e,0x67,0x3d,0x22,
+0x34,0x22,0x3e,0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,0x55,0x70,0x74,0x69,
+0x6d,0x65,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,0x3e,0x3c,0x21,0x2d,0x2d,0x23,
+0x75,0x70,0x74,0x69,0x6d,0x65,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x2f,
+0x74,0x72,0x3e,0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,0x48,0x65,0x61,0x70,
+0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,0x3e,0x3c,0x21,0x2d,0x2d,0x23,0x68,0x65,
+0x61,0x70,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,
+0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,0x6c,0x77,0x49,0x50,0x20,0x70,0x6f,0x6f,
+0x6c,0x20,0x65,0x72,0x72,0x6f,0x72,0x73,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,
+0x3e,0x3c,0x21,0x2d,0x2d,0x23,0x6d,0x65,0x6d,0x65,0x72,0x72,0x2d,0x2d,0x3e,0x3c,
+0x2f,0x74,0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,
+0x64,0x3e,0x54,0x61,0x73,0x6b,0x73,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,0x3e,
+0x3c,0x21,0x2d,0x2d,0x23,0x74,0x61,0x73,0x6b,0x73,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,
+0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,
+0x45,0x74,0x68,0x65,0x72,0x6e,0x65,0x74,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,
+0x3e,0x3c,0x21,0x2d,0x2d,0x23,0x65,0x74,0x68,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,0x64,
+0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,0x4c,
+0x54,0x45,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,0x3e,0x3c,0x21,0x2d,0x2d,0x23,
+0x6c,0x74,0x65,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,
+0x0a,0x3c,0x74,0x72,0x3e,0x3c,0x74,0x64,0x3e,0x45,0x43,0x32,0x30,0x3c,0x2f,0x74,
+0x64,0x3e,0x3c,0x74,0x64,0x3e,0x3c,0x21,0x2d,0x2d,0x23,0x65,0x63,0x32,0x30,0x2d,
+0x2d,0x3e,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x3c,0x74,0x72,
+0x3e,0x3c,0x74,0x64,0x3e,0x55,0x53,0x42,0x3c,0x2f,0x74,0x64,0x3e,0x3c,0x74,0x64,
+0x3e,0x3c,0x21,0x2d,0x2d,0x23,0x75,0x73,0x62,0x2d,0x2d,0x3e,0x3c,0x2f,0x74,0x64,
+0x3e,0x3c,0x2f,0x74,0x72,0x3e,0x0a,0x3c,0x2f,0x74,0x61,0x62,0x6c,0x65,0x3e,0x0a,
+0x3c,0x70,0x3e,0x0a,0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x2f,0x73,0x74,
+0x61,0x74,0x73,0x2e,0x6a,0x73,0x6f,0x6e,0x22,0x3e,0x73,0x74,0x61,0x74,0x73,0x2e,
+0x6a,0x73,0x6f,0x6e,0x3c,0x2f,0x61,0x3e,0x20,0x7c,0x0a,0x3c,0x61,0x20,0x68,0x72,
+0x65,0x66,0x3d,0x22,0x2f,0x74,0x61,0x73,0x6b,0x73,0x2e,0x6a,0x73,0x6f,0x6e,0x22,
+0x3e,0x74,0x61,0x73,0x6b,0x73,0x2e,0x6a,0x73,0x6f,0x6e,0x3c,0x2f,0x61,0x3e,0x20,
+0x7c,0x0a,0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x2f,0x75,0x73,0x62,0x2e,
+0x6a,0x73,0x6f,0x6e,0x22,0x3e,0x75,0x73,0x62,0x2e,0x6a,0x73,0x6f,0x6e,0x3c,0x2f,
+0x61,0x3e,0x20,0x7c,0x0a,0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x2f,0x6c,
+0x69,0x6e,0x6b,0x2e,0x6a,0x73,0x6f,0x6e,0x22,0x3e,0x6c,0x69,0x6e,0x6b,0x2e,0x6a,
+0x73,0x6f,0x6e,0x3c,0x2f,0x61,0x3e,0x20,0x7c,0x0a,0x3c,0x61,0x20,0x68,0x72,0x65,
+0x66,0x3d,0x22,0x2f,0x65,0x76,0x65,0x6e,0x74,0x73,0x22,0x3e,0x65,0x76,0x65,0x6e,
+0x74,0x73,0x3c,0x2f,0x61,0x3e,0x0a,0x3c,0x2f,0x70,0x3e,0x0a,0x3c,0x2f,0x62,0x6f,
+0x64,0x79,0x3e,0x0a,0x3c,0x2f,0x68,0x74,0x6d,0x6c,0x3e,0x0a,};
+
+
+
+const struct fsdata_file file__img_sics_gif[] = { {
+file_NULL,
+data__img_sics_gif,
+data__img_sics_gif + 16,
+sizeof(data__img_sics_gif) - 16,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT,
+#if LWIP_HTTPD_ETAG
+#if HTTPD_PRECALCULATED_CHECKSUM
+0, NULL,
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+"\"221743ce-2d4\"",
+#endif /* LWIP_HTTPD_ETAG */
+}};
+
+const struct fsdata_file file__img_sics_gif1[] = { {
+file__img_sics_gif,
+data__img_sics_gif1,
+data__img_sics_gif1 + 16,
+sizeof(data__img_sics_gif1) - 16,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT | FS_FILE_FLAGS_GZIP,
+#if LWIP_HTTPD_ETAG
+#if HTTPD_PRECALCULATED_CHECKSUM
+0, NULL,
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+"\"29ab7dbf-2a5\"",
+#endif /* LWIP_HTTPD_ETAG */
+}};
+
+const struct fsdata_file file__404_html[] = { {
+file__img_sics_gif1,
+data__404_html,
+data__404_html + 12,
+sizeof(data__404_html) - 12,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT,
+}};
+
+const struct fsdata_file file__404_html1[] = { {
+file__404_html,
+data__404_html1,
+data__404_html1 + 12,
+sizeof(data__404_html1) - 12,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT | FS_FILE_FLAGS_GZIP,
+}};
+
+const struct fsdata_file file__index_html[] = { {
+file__404_html1,
+data__index_html,
+data__index_html + 12,
+sizeof(data__index_html) - 12,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT,
+#if LWIP_HTTPD_ETAG
+#if HTTPD_PRECALCULATED_CHECKSUM
+0, NULL,
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+"\"95f2cdb9-6a8\"",
+#endif /* LWIP_HTTPD_ETAG */
+}};
+
+const struct fsdata_file file__index_html1[] = { {
+file__index_html,
+data__index_html1,
+data__index_html1 + 12,
+sizeof(data__index_html1) - 12,
+FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT | FS_FILE_FLAGS_GZIP,
+#if LWIP_HTTPD_ETAG
+#if HTTPD_PRECALCULATED_CHECKSUM
+0, NULL,
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+"\"b8604469-335\"",
+#endif /* LWIP_HTTPD_ETAG */
+}};
+
+const struct fsdata_file file__status_shtml[] = { {
+file__index_html1,
+data__status_shtml,
+data__status_shtml + 16,
+sizeof(data__status_shtml) - 16,
+FS_FILE_FLAGS_HEADER_INCLUDED,
+}};
+
+#define FS_ROOT file__status_shtml
+#define FS_NUMFILES 4
+
@@ -104,6 +104,9 @@
 #include <string.h> /* memset */
 #include <stdlib.h> /* atoi */
 #include <stdio.h>
+#if LWIP_HTTPD_STREAM
+#include <stdarg.h>
+#endif /* LWIP_HTTPD_STREAM */
 
 #if LWIP_TCP && LWIP_CALLBACK_API
 
@@ -115,6 +118,23 @@
 #define HTTP11_CONNECTIONKEEPALIVE  "Connection: keep-alive"
 #define HTTP11_CONNECTIONKEEPALIVE2 "Connection: Keep-Alive"
 #endif
+#if LWIP_HTTPD_ETAG
+#define HTTP_IF_NONE_MATCH          "If-None-Match:"
+#define HTTP10_NOT_MODIFIED         "HTTP/1.0 304 Not Modified\r\n"
+#define HTTP11_NOT_MODIFIED         "HTTP/1.1 304 Not Modified\r\n"
+#endif /* LWIP_HTTPD_ETAG */
+#if LWIP_HTTPD_GZIP
+#define HTTP_ACCEPT_ENCODING        "Accept-Encoding:"
+#endif /* LWIP_HTTPD_GZIP */
+#if LWIP_HTTPD_STREAM
+/* The header of a streamed response, around its Content-Type: no length,
+   the end of the response is the end of the connection */
+#define HTTP_STREAM_HDR_HEAD        "HTTP/1.1 200 OK" CRLF "Server: " HTTPD_SERVER_AGENT CRLF "Content-Type: "
+#define HTTP_STREAM_HDR_TAIL        CRLF "Cache-Control: no-store" CRLF "Connection: close" CRLF CRLF
+#define NUM_STREAM_HDR_STRINGS      3
+/* tcp_poll() counts in ticks of the TCP slow timer (500 ms) */
+#define HTTP_STREAM_POLL_TICKS(ms)  ((u8_t)LWIP_MIN(255, LWIP_MAX(1, (ms) / 500)))
+#endif /* LWIP_HTTPD_STREAM */
 
 /** These defines check whether tcp_write has to copy data or not */
 
@@ -237,6 +257,9 @@ struct http_state {
   struct fs_file file_handle;
   struct fs_file *handle;
   const char *file;       /* Pointer to first unsent byte in buf. */
+#if LWIP_HTTPD_ETAG
+  const char *status;     /* Status line still to send ahead of file, or NULL */
+#endif /* LWIP_HTTPD_ETAG */
 
   struct tcp_pcb *pcb;
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
@@ -252,6 +275,9 @@ struct http_state {
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
   u8_t keepalive;
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if LWIP_HTTPD_GZIP
+  u8_t accept_gzip;       /* The request accepts Content-Encoding: gzip */
+#endif /* LWIP_HTTPD_GZIP */
 #if LWIP_HTTPD_SSI
   struct http_ssi_state *ssi;
 #endif /* LWIP_HTTPD_SSI */
@@ -269,6 +295,13 @@ struct http_state {
 #if LWIP_HTTPD_TIMING
   u32_t time_started;
 #endif /* LWIP_HTTPD_TIMING */
+#if LWIP_HTTPD_STREAM
+  const tStream *stream;  /* Stream serving the request, or NULL */
+  struct httpd_stream stream_state;
+  u16_t stream_hdr_pos;   /* Position in the header string being sent */
+  u8_t stream_hdr_index;  /* The header string being sent */
+  u8_t stream_wait;       /* The pass is complete, the next one starts at the next poll */
+#endif /* LWIP_HTTPD_STREAM */
 #if LWIP_HTTPD_SUPPORT_POST
   u32_t post_content_len_left;
 #if LWIP_HTTPD_POST_MANUAL_WND
@@ -301,6 +334,9 @@ static err_t http_close_conn(struct tcp_pcb *pcb, struct http_state *hs);
 static err_t http_close_or_abort_conn(struct tcp_pcb *pcb, struct http_state *hs, u8_t abort_conn);
 static err_t http_find_file(struct http_state *hs, const char *uri, int is_09);
 static err_t http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri, u8_t tag_check, char* params);
+#if LWIP_HTTPD_STREAM
+static err_t http_init_stream(struct http_state *hs, const tStream *stream, int is_09);
+#endif /* LWIP_HTTPD_STREAM */
 static err_t http_poll(void *arg, struct tcp_pcb *pcb);
 static u8_t http_check_eof(struct tcp_pcb *pcb, struct http_state *hs);
 #if LWIP_HTTPD_FS_ASYNC_READ
@@ -334,6 +370,12 @@ char *http_cgi_params[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Params extracted from t
 char *http_cgi_param_vals[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Values for each extracted param */
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_STREAM
+/* Stream handler information */
+const tStream *g_pStreams;
+int g_iNumStreams;
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
 /** global list of active HTTP connections, use to kill the oldest when
     running out of memory */
@@ -478,6 +520,9 @@ http_state_eof(struct http_state *hs)
     fs_close(hs->handle);
     hs->handle = NULL;
   }
+#if LWIP_HTTPD_STREAM
+  hs->stream = NULL;
+#endif /* LWIP_HTTPD_STREAM */
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
   if (hs->buf != NULL) {
     mem_free(hs->buf);
@@ -1507,6 +1552,132 @@ http_send_data_ssi(struct tcp_pcb *pcb, struct http_state *hs)
 }
 #endif /* LWIP_HTTPD_SSI */
 
+#if LWIP_HTTPD_ETAG
+/** Sub-function of http_send(): send the status line of a 304 response
+ *
+ * @returns: - 1: data has been written (so call tcp_ouput)
+ *           - 0: no data has been written (no need to call tcp_output)
+ */
+static u8_t
+http_send_status(struct tcp_pcb *pcb, struct http_state *hs)
+{
+  u16_t len = (u16_t)strlen(hs->status);
+
+  if (http_write(pcb, hs->status, &len, 0) != ERR_OK) {
+    return HTTP_NO_DATA_TO_SEND;
+  }
+  hs->status += len;
+  if (*hs->status == 0) {
+    hs->status = NULL;
+  }
+  return HTTP_DATA_TO_SEND_CONTINUE;
+}
+#endif /* LWIP_HTTPD_ETAG */
+
+#if LWIP_HTTPD_STREAM
+/** Sub-function of http_send(): send the header of a streamed response, then
+ * let its handler write as many records as there is room for.
+ *
+ * @returns: - 1: data has been written (so call tcp_ouput)
+ *           - 0: no data has been written (no need to call tcp_output)
+ */
+static u8_t
+http_send_stream(struct tcp_pcb *pcb, struct http_state *hs)
+{
+  u8_t data_to_send = HTTP_NO_DATA_TO_SEND;
+  u32_t record;
+  u8_t ret;
+
+  while (hs->stream_hdr_index < NUM_STREAM_HDR_STRINGS) {
+    const char *hdr;
+    u16_t len;
+    if (hs->stream_hdr_index == 0) {
+      hdr = HTTP_STREAM_HDR_HEAD;
+    } else if (hs->stream_hdr_index == 1) {
+      hdr = hs->stream->pcContentType;
+    } else {
+      hdr = HTTP_STREAM_HDR_TAIL;
+    }
+    hdr += hs->stream_hdr_pos;
+    len = (u16_t)strlen(hdr);
+    if (http_write(pcb, hdr, &len, 0) != ERR_OK) {
+      return data_to_send;
+    }
+    data_to_send = HTTP_DATA_TO_SEND_CONTINUE;
+    if (hdr[len] != 0) {
+      /* the send buffer is full, go on with the rest of this string later */
+      hs->stream_hdr_pos = (u16_t)(hs->stream_hdr_pos + len);
+      return data_to_send;
+    }
+    hs->stream_hdr_pos = 0;
+    hs->stream_hdr_index++;
+  }
+
+  if (hs->stream_wait) {
+    return data_to_send;
+  }
+  record = hs->stream_state.record;
+  ret = hs->stream->pfnHandler(&hs->stream_state);
+  if (hs->stream_state.record != record) {
+    data_to_send = HTTP_DATA_TO_SEND_CONTINUE;
+  }
+  if (ret == HTTPD_STREAM_DONE) {
+    /* The FIN goes right behind the last record */
+    LWIP_DEBUGF(HTTPD_DEBUG, ("End of stream.\n"));
+    http_eof(pcb, hs);
+    return 0;
+  }
+  if (ret == HTTPD_STREAM_WAIT) {
+    hs->stream_wait = 1;
+  }
+  return data_to_send;
+}
+
+/**
+ * Format one record of a streamed response and write it to the send buffer,
+ * whole or not at all. For the stream handlers.
+ *
+ * The record is copied behind the data already queued, so the records fill
+ * the segments up to the MSS without a buffer of their own.
+ *
+ * @param s the stream passed to the handler
+ * @param fmt printf format of the record, at most LWIP_HTTPD_STREAM_RECORD_LEN - 1
+ *        characters once formatted
+ * @return ERR_OK: the record is written and s->record advanced
+ *         ERR_MEM: no room for it: return HTTPD_STREAM_MORE and write it
+ *         again when called next
+ */
+err_t
+httpd_stream_printf(struct httpd_stream *s, const char *fmt, ...)
+{
+  char buf[LWIP_HTTPD_STREAM_RECORD_LEN];
+  va_list ap;
+  int len;
+  err_t err;
+
+  va_start(ap, fmt);
+  len = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  LWIP_ASSERT("record longer than LWIP_HTTPD_STREAM_RECORD_LEN", len < (int)sizeof(buf));
+  if (len >= (int)sizeof(buf)) {
+    len = (int)sizeof(buf) - 1;
+  }
+  if (len <= 0) {
+    s->record++;
+    return ERR_OK;
+  }
+
+  if ((tcp_sndbuf(s->pcb) < len) || (tcp_sndqueuelen(s->pcb) >= TCP_SND_QUEUELEN)) {
+    return ERR_MEM;
+  }
+  err = tcp_write(s->pcb, buf, (u16_t)len, TCP_WRITE_FLAG_COPY);
+  if (err == ERR_OK) {
+    s->record++;
+  }
+  return err;
+}
+#endif /* LWIP_HTTPD_STREAM */
+
 /**
  * Try to send more data on this pcb.
  *
@@ -1532,6 +1703,12 @@ http_send(struct tcp_pcb *pcb, struct http_state *hs)
     return 0;
   }
 
+#if LWIP_HTTPD_STREAM
+  if (hs->stream != NULL) {
+    return http_send_stream(pcb, hs);
+  }
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_FS_ASYNC_READ
   /* Check if we are allowed to read from this file.
      (e.g. SSI might want to delay sending until data is available) */
@@ -1540,6 +1717,16 @@ http_send(struct tcp_pcb *pcb, struct http_state *hs)
   }
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
+#if LWIP_HTTPD_ETAG
+  /* The status line goes ahead of the header taken from the file */
+  if (hs->status != NULL) {
+    data_to_send = http_send_status(pcb, hs);
+    if (hs->status != NULL) {
+      return data_to_send;
+    }
+  }
+#endif /* LWIP_HTTPD_ETAG */
+
 #if LWIP_HTTPD_DYNAMIC_HEADERS
   /* Do we have any more header data to send for this file? */
   if (hs->hdr_index < NUM_FILE_HDR_STRINGS) {
@@ -1579,6 +1766,24 @@ http_send(struct tcp_pcb *pcb, struct http_state *hs)
   return data_to_send;
 }
 
+/** Open a file for the connection: with LWIP_HTTPD_GZIP, the gzip-compressed
+ * copy only if the request accepts it
+ *
+ * @param hs http connection state
+ * @param name file name
+ * @return ERR_OK if the file was found
+ */
+static err_t
+http_fs_open(struct http_state *hs, const char *name)
+{
+#if LWIP_HTTPD_GZIP
+  if (!hs->accept_gzip) {
+    return fs_open_identity(&hs->file_handle, name);
+  }
+#endif /* LWIP_HTTPD_GZIP */
+  return fs_open(&hs->file_handle, name);
+}
+
 #if LWIP_HTTPD_SUPPORT_EXTSTATUS
 /** Initialize a http connection with a file to send for an error message
  *
@@ -1603,11 +1808,11 @@ http_find_error_file(struct http_state *hs, u16_t error_nr)
     uri2 = "/400.htm";
     uri3 = "/400.shtml";
   }
-  err = fs_open(&hs->file_handle, uri1);
+  err = http_fs_open(hs, uri1);
   if (err != ERR_OK) {
-    err = fs_open(&hs->file_handle, uri2);
+    err = http_fs_open(hs, uri2);
     if (err != ERR_OK) {
-      err = fs_open(&hs->file_handle, uri3);
+      err = http_fs_open(hs, uri3);
       if (err != ERR_OK) {
         LWIP_DEBUGF(HTTPD_DEBUG, ("Error page for error %"U16_F" not found\n",
           error_nr));
@@ -1634,15 +1839,15 @@ http_get_404_file(struct http_state *hs, const char **uri)
   err_t err;
 
   *uri = "/404.html";
-  err = fs_open(&hs->file_handle, *uri);
+  err = http_fs_open(hs, *uri);
   if (err != ERR_OK) {
     /* 404.html doesn't exist. Try 404.htm instead. */
     *uri = "/404.htm";
-    err = fs_open(&hs->file_handle, *uri);
+    err = http_fs_open(hs, *uri);
     if (err != ERR_OK) {
       /* 404.htm doesn't exist either. Try 404.shtml instead. */
       *uri = "/404.shtml";
-      err = fs_open(&hs->file_handle, *uri);
+      err = http_fs_open(hs, *uri);
       if (err != ERR_OK) {
         /* 404.htm doesn't exist either. Indicate to the caller that it should
          * send back a default 404 page.
@@ -1889,6 +2094,168 @@ http_continue(void *connection)
 }
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
+#if LWIP_HTTPD_GZIP || LWIP_HTTPD_ETAG
+/** Find a header field of a request. Field names are case-insensitive:
+ * a proxy may well send "accept-encoding:".
+ *
+ * @param fields the header fields of the request, from the CRLF ending its
+ *        request line
+ * @param fields_len length of fields
+ * @param name the field name with its colon
+ * @param value_len returns the length of the value
+ * @return the value, leading whitespace skipped, or NULL if there is no such
+ *         field before the end of the header
+ */
+static const char *
+http_find_field(const char *fields, u16_t fields_len, const char *name, u16_t *value_len)
+{
+  const char *end = fields + fields_len;
+  const char *line = fields;
+  const char *eol;
+  size_t name_len = strlen(name);
+
+  if ((end - line >= 2) && !strncmp(line, CRLF, 2)) {
+    line += 2;
+  }
+  while (line < end) {
+    eol = lwip_strnstr(line, CRLF, (size_t)(end - line));
+    if ((eol == NULL) || (eol == line)) {
+      /* incomplete line or end of the header */
+      return NULL;
+    }
+    if (((size_t)(eol - line) >= name_len) && !lwip_strnicmp(line, name, name_len)) {
+      line += name_len;
+      while ((line < eol) && ((*line == ' ') || (*line == '\t'))) {
+        line++;
+      }
+      *value_len = (u16_t)(eol - line);
+      return line;
+    }
+    line = eol + 2;
+  }
+  return NULL;
+}
+#endif /* LWIP_HTTPD_GZIP || LWIP_HTTPD_ETAG */
+
+#if LWIP_HTTPD_GZIP
+/** Check whether the Accept-Encoding field of a request accepts gzip: the
+ * coding "gzip", or else "*", is listed without a quality value of 0
+ * ("gzip;q=0" refuses it). Codings are compared as whole tokens,
+ * case-insensitively, so "x-gzip" or "gzipfoo" do not count.
+ *
+ * @param fields the header fields of the request
+ * @param fields_len length of fields
+ * @return 1 if gzip is accepted, 0 otherwise
+ */
+static u8_t
+http_accepts_gzip(const char *fields, u16_t fields_len)
+{
+  const char *p;
+  const char *end;
+  const char *coding;
+  u16_t len;
+  u8_t q;
+  u8_t any = 0;
+
+  p = http_find_field(fields, fields_len, HTTP_ACCEPT_ENCODING, &len);
+  if (p == NULL) {
+    return 0;
+  }
+  end = p + len;
+  while (p < end) {
+    /* coding: up to its parameters or the next one */
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == ','))) {
+      p++;
+    }
+    coding = p;
+    while ((p < end) && (*p != ',') && (*p != ';') && (*p != ' ') && (*p != '\t')) {
+      p++;
+    }
+    len = (u16_t)(p - coding);
+    /* parameters: only the quality value matters */
+    q = 1;
+    while ((p < end) && (*p != ',')) {
+      if ((*p == ';') || (*p == ' ') || (*p == '\t')) {
+        p++;
+      } else if ((end - p >= 2) && ((*p == 'q') || (*p == 'Q')) && (p[1] == '=')) {
+        p += 2;
+        if ((p < end) && (*p == '0')) {
+          q = 0;
+          p++;
+          if ((p < end) && (*p == '.')) {
+            p++;
+            while ((p < end) && (*p >= '0') && (*p <= '9')) {
+              if (*p != '0') {
+                q = 1;
+              }
+              p++;
+            }
+          }
+        }
+      } else {
+        while ((p < end) && (*p != ';') && (*p != ',')) {
+          p++;
+        }
+      }
+    }
+    if ((len == 4) && !lwip_strnicmp(coding, "gzip", 4)) {
+      return q;
+    }
+    if ((len == 1) && (*coding == '*')) {
+      any = q;
+    }
+  }
+  return any;
+}
+#endif /* LWIP_HTTPD_GZIP */
+
+#if LWIP_HTTPD_ETAG
+/** Check whether the If-None-Match field of a request lists an entity tag.
+ * Weak comparison, as for a GET: a "W/" in front of the tag is ignored.
+ *
+ * @param fields the header fields of the request
+ * @param fields_len length of fields
+ * @param etag the quoted entity tag of the file
+ * @return 1 if the field lists etag or is "*", 0 otherwise
+ */
+static int
+http_etag_matches(const char *fields, u16_t fields_len, const char *etag)
+{
+  const char *field;
+  u16_t len;
+
+  field = http_find_field(fields, fields_len, HTTP_IF_NONE_MATCH, &len);
+  if (field == NULL) {
+    return 0;
+  }
+  return (lwip_strnstr(field, etag, len) != NULL) || (lwip_strnstr(field, "*", len) != NULL);
+}
+
+/** Answer "304 Not Modified" instead of sending the file: its header fields
+ * without their status line are those of the 304 response (a 304 may carry
+ * the Content-Length of the 200 it stands for), so the file now ends with
+ * them and is still sent from the file system.
+ *
+ * @param hs http connection state, initialized with a file with a header
+ */
+static void
+http_not_modified(struct http_state *hs)
+{
+  const char *fields = lwip_strnstr(hs->file, CRLF, hs->left);
+  const char *body = lwip_strnstr(hs->file, CRLF CRLF, hs->left);
+
+  if ((fields == NULL) || (body == NULL)) {
+    return;
+  }
+  hs->status = strncmp(hs->file, "HTTP/1.1", 8) ? HTTP10_NOT_MODIFIED : HTTP11_NOT_MODIFIED;
+  hs->file = fields + 2;
+  hs->handle->len = (int)(body + 4 - hs->handle->data);
+  hs->handle->index = hs->handle->len;
+  hs->left = (u32_t)(body + 4 - hs->file);
+  LWIP_DEBUGF(HTTPD_DEBUG, ("Not modified\n"));
+}
+#endif /* LWIP_HTTPD_ETAG */
+
 /**
  * When data has been received in the correct state, try to parse it
  * as a HTTP request.
@@ -1918,7 +2285,11 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct tcp_pcb *pcb)
   LWIP_ASSERT("p != NULL", p != NULL);
   LWIP_ASSERT("hs != NULL", hs != NULL);
 
-  if ((hs->handle != NULL) || (hs->file != NULL)) {
+  if ((hs->handle != NULL) || (hs->file != NULL)
+#if LWIP_HTTPD_STREAM
+      || (hs->stream != NULL)
+#endif /* LWIP_HTTPD_STREAM */
+     ) {
     LWIP_DEBUGF(HTTPD_DEBUG, ("Received data while sending a file\n"));
     /* already sending a file */
     /* @todo: abort? */
@@ -2021,6 +2392,9 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct tcp_pcb *pcb)
             hs->keepalive = 0;
           }
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if LWIP_HTTPD_GZIP
+          hs->accept_gzip = http_accepts_gzip(crlf, (u16_t)(data_len - (crlf - data)));
+#endif /* LWIP_HTTPD_GZIP */
           /* null-terminate the METHOD (pbuf is freed anyway wen returning) */
           *sp1 = 0;
           uri[uri_len] = 0;
@@ -2047,7 +2421,16 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct tcp_pcb *pcb)
           } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
           {
+#if LWIP_HTTPD_ETAG
+            err_t find_err = http_find_file(hs, uri, is_09);
+            if ((find_err == ERR_OK) && (hs->handle != NULL) && (hs->handle->etag != NULL) &&
+                http_etag_matches(crlf, (u16_t)(data_len - (crlf - data)), hs->handle->etag)) {
+              http_not_modified(hs);
+            }
+            return find_err;
+#else /* LWIP_HTTPD_ETAG */
             return http_find_file(hs, uri, is_09);
+#endif /* LWIP_HTTPD_ETAG */
           }
         }
       } else {
@@ -2131,7 +2514,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
         file_name = g_psDefaultFilenames[loop].name;
       }
       LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Looking for %s...\n", file_name));
-      err = fs_open(&hs->file_handle, file_name);
+      err = http_fs_open(hs, file_name);
       if(err == ERR_OK) {
         uri = file_name;
         file = &hs->file_handle;
@@ -2153,6 +2536,15 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
       params++;
     }
 
+#if LWIP_HTTPD_STREAM
+    /* Is the base URI that of a stream? */
+    for (loop = 0; loop < (size_t)g_iNumStreams; loop++) {
+      if (strcmp(uri, g_pStreams[loop].pcURI) == 0) {
+        return http_init_stream(hs, &g_pStreams[loop], is_09);
+      }
+    }
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_CGI
     http_cgi_paramcount = -1;
     /* Does the base URI we have isolated correspond to a CGI handler? */
@@ -2174,7 +2566,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
 
     LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Opening %s\n", uri));
 
-    err = fs_open(&hs->file_handle, uri);
+    err = http_fs_open(hs, uri);
     if (err == ERR_OK) {
        file = &hs->file_handle;
     } else {
@@ -2217,6 +2609,37 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
   return http_init_file(hs, file, is_09, uri, tag_check, params);
 }
 
+#if LWIP_HTTPD_STREAM
+/** Initialize a http connection with a stream to send.
+ * Called by http_find_file.
+ *
+ * @param hs http connection state
+ * @param stream the stream registered for the URI
+ * @param is_09 1 if the request is HTTP/0.9 (no HTTP headers in response)
+ * @return ERR_OK
+ */
+static err_t
+http_init_stream(struct http_state *hs, const tStream *stream, int is_09)
+{
+  LWIP_DEBUGF(HTTPD_DEBUG, ("Streaming %s\n", stream->pcURI));
+  hs->stream = stream;
+  memset(&hs->stream_state, 0, sizeof(hs->stream_state));
+  hs->stream_state.pcb = hs->pcb;
+  hs->stream_hdr_pos = 0;
+  hs->stream_hdr_index = is_09 ? NUM_STREAM_HDR_STRINGS : 0;
+  hs->stream_wait = 0;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  /* No Content-Length: the connection ends the response */
+  hs->keepalive = 0;
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+  if (stream->interval != 0) {
+    /* The poll of an event stream starts its events */
+    tcp_poll(hs->pcb, http_poll, HTTP_STREAM_POLL_TICKS(stream->interval));
+  }
+  return ERR_OK;
+}
+#endif /* LWIP_HTTPD_STREAM */
+
 /** Initialize a http connection with a file to send (if found).
  * Called by http_find_file and http_find_error_file.
  *
@@ -2412,10 +2835,23 @@ http_poll(void *arg, struct tcp_pcb *pcb)
       return ERR_OK;
     }
 
+#if LWIP_HTTPD_STREAM
+    if ((hs->stream != NULL) && hs->stream_wait) {
+      /* The last pass of the stream is complete, start the next one */
+      hs->stream_wait = 0;
+      hs->stream_state.record = 0;
+      hs->stream_state.pass++;
+    }
+#endif /* LWIP_HTTPD_STREAM */
+
     /* If this connection has a file open, try to send some more data. If
      * it has not yet received a GET request, don't do this since it will
      * cause the connection to close immediately. */
-    if(hs && (hs->handle)) {
+    if(hs && (hs->handle
+#if LWIP_HTTPD_STREAM
+              || hs->stream
+#endif /* LWIP_HTTPD_STREAM */
+             )) {
       LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_poll: try to send more data\n"));
       if(http_send(pcb, hs)) {
         /* If we wrote anything to be sent, go ahead and send it now. */
@@ -2631,4 +3067,22 @@ http_set_cgi_handlers(const tCGI *cgis, int num_handlers)
 }
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_STREAM
+/**
+ * Set an array of stream URIs/handler functions
+ *
+ * @param streams an array of stream URIs/handler functions
+ * @param num_streams number of elements in the 'streams' array
+ */
+void
+http_set_stream_handlers(const tStream *streams, int num_streams)
+{
+  LWIP_ASSERT("no streams given", streams != NULL);
+  LWIP_ASSERT("invalid number of streams", num_streams > 0);
+
+  g_pStreams = streams;
+  g_iNumStreams = num_streams;
+}
+#endif /* LWIP_HTTPD_STREAM */
+
 #endif /* LWIP_TCP && LWIP_CALLBACK_API */
@@ -16,10 +16,15 @@
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
 #include "windows.h"
+#include <dos.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
 #else
 #include <dir.h>
-#endif
 #include <dos.h>
+#endif
 #include <string.h>
 #include <time.h>
 #include <sys/stat.h>
@@ -65,6 +70,27 @@ int deflate_level = 10; /* default compression level, can be changed via command
 #define USAGE_ARG_DEFLATE ""
 #endif /* MAKEFS_SUPPORT_DEFLATE */
 
+/** Makefsdata can generate all non-SSI files gzip-compressed instead (where
+ * file size shrinks): "Content-Encoding: gzip" is what every browser accepts.
+ * To compress the files, zlib is needed (link with -lz).
+ */
+#ifndef MAKEFS_SUPPORT_GZIP
+#define MAKEFS_SUPPORT_GZIP 0
+#endif
+
+#if MAKEFS_SUPPORT_GZIP
+#include <zlib.h>
+
+int gzip_level = 9; /* default compression level, can be changed via command line */
+#define USAGE_ARG_GZIP " [-gzip<:compr_level>]"
+#else /* MAKEFS_SUPPORT_GZIP */
+#define USAGE_ARG_GZIP ""
+#endif /* MAKEFS_SUPPORT_GZIP */
+
+/* is_compressed of the file data */
+#define COMPRESSED_DEFLATE  1
+#define COMPRESSED_GZIP     2
+
 /* Compatibility defines Win32 vs. DOS */
 #ifdef WIN32
 
@@ -83,6 +109,55 @@ int deflate_level = 10; /* default compression level, can be changed via command
 #define CHDIR(path)                   SetCurrentDirectoryA(path)
 #define CHDIR_SUCCEEDED(ret)          (ret == TRUE)
 
+#elif defined(__unix__) || defined(__APPLE__)
+
+/* findfirst()/findnext() over the current directory, the pattern is always "*" */
+struct posix_find
+{
+  DIR *dir;
+  const char *name;
+  int is_dir;
+};
+
+static int posix_findnext(struct posix_find *f)
+{
+  struct dirent *entry;
+  struct stat st;
+  while ((entry = readdir(f->dir)) != NULL) {
+    if (stat(entry->d_name, &st) == 0) {
+      f->name = entry->d_name;
+      f->is_dir = S_ISDIR(st.st_mode);
+      return 0;
+    }
+  }
+  closedir(f->dir);
+  return -1;
+}
+
+static int posix_findfirst(struct posix_find *f)
+{
+  f->dir = opendir(".");
+  if (f->dir == NULL) {
+    return -1;
+  }
+  return posix_findnext(f);
+}
+
+#define FIND_T                        struct posix_find
+#define FIND_T_FILENAME(fInfo)        (fInfo.name)
+#define FIND_T_IS_DIR(fInfo)          (fInfo.is_dir)
+#define FIND_T_IS_FILE(fInfo)         (!fInfo.is_dir)
+#define FIND_RET_T                    int
+#define FINDFIRST_FILE(path, result)  posix_findfirst(result)
+#define FINDFIRST_DIR(path, result)   posix_findfirst(result)
+#define FINDNEXT(ff_res, result)      posix_findnext(result)
+#define FINDFIRST_SUCCEEDED(ret)      (ret == 0)
+#define FINDNEXT_SUCCEEDED(ret)       (ret == 0)
+
+#define GETCWD(path, len)             getcwd(path, len)
+#define CHDIR(path)                   chdir(path)
+#define CHDIR_SUCCEEDED(ret)          (ret == 0)
+
 #else
 
 #define FIND_T                        struct ffblk
@@ -140,7 +215,8 @@ struct file_entry
 int process_sub(FILE *data_file, FILE *struct_file);
 int process_file(FILE *data_file, FILE *struct_file, const char *filename);
 int file_write_http_header(FILE *data_file, const char *filename, int file_size, u16_t *http_hdr_len,
-                           u16_t *http_hdr_chksum, u8_t provide_content_len, int is_compressed);
+                           u16_t *http_hdr_chksum, u8_t provide_content_len, int is_compressed,
+                           u8_t vary, const char *etag, const char *cache_control);
 int file_put_ascii(FILE *file, const char *ascii_string, int len, int *i);
 int s_put_ascii(char *buf, const char *ascii_string, int len, int *i);
 void concat_files(const char *file1, const char *file2, const char *targetfile);
@@ -159,9 +235,17 @@ unsigned char useHttp11 = 0;
 unsigned char supportSsi = 1;
 unsigned char precalcChksum = 0;
 unsigned char includeLastModified = 0;
+unsigned char includeEtag = 0;
+char cacheControl[64];
 #if MAKEFS_SUPPORT_DEFLATE
 unsigned char deflateNonSsiFiles = 0;
 size_t deflatedBytesReduced = 0;
+#endif
+#if MAKEFS_SUPPORT_GZIP
+unsigned char gzipNonSsiFiles = 0;
+size_t gzippedBytesReduced = 0;
+#endif
+#if MAKEFS_SUPPORT_DEFLATE || MAKEFS_SUPPORT_GZIP
 size_t overallDataBytes = 0;
 #endif
 
@@ -170,7 +254,8 @@ struct file_entry* last_file = NULL;
 
 static void print_usage(void)
 {
-  printf(" Usage: htmlgen [targetdir] [-s] [-e] [-i] [-11] [-nossi] [-c] [-f:<filename>] [-m] [-svr:<name>]" USAGE_ARG_DEFLATE NEWLINE NEWLINE);
+  printf(" Usage: htmlgen [targetdir] [-s] [-e] [-i] [-11] [-nossi] [-c] [-f:<filename>] [-m] [-svr:<name>]"
+         " [-etag] [-cache:<seconds>]" USAGE_ARG_DEFLATE USAGE_ARG_GZIP NEWLINE NEWLINE);
   printf("   targetdir: relative or absolute path to files to convert" NEWLINE);
   printf("   switch -s: toggle processing of subdirectories (default is on)" NEWLINE);
   printf("   switch -e: exclude HTTP header from file (header is created at runtime, default is off)" NEWLINE);
@@ -180,9 +265,17 @@ static void print_usage(void)
   printf("   switch -f: target filename (default is \"fsdata.c\")" NEWLINE);
   printf("   switch -m: include \"Last-Modified\" header based on file time" NEWLINE);
   printf("   switch -svr: server identifier sent in HTTP response header ('Server' field)" NEWLINE);
+  printf("   switch -etag: include \"ETag\" header (hash of the file as stored) for all non-SSI files," NEWLINE);
+  printf("                 httpd answers a matching \"If-None-Match\" with 304 (LWIP_HTTPD_ETAG)" NEWLINE);
+  printf("   switch -cache: include \"Cache-Control: max-age\" header for all non-SSI files" NEWLINE);
+  printf("                  (with -etag only, \"Cache-Control: no-cache\": revalidate every time)" NEWLINE);
 #if MAKEFS_SUPPORT_DEFLATE
   printf("   switch -defl: deflate-compress all non-SSI files (with opt. compr.-level, default=10)" NEWLINE);
   printf("                 ATTENTION: browser has to support \"Content-Encoding: deflate\"!" NEWLINE);
+#endif
+#if MAKEFS_SUPPORT_GZIP
+  printf("   switch -gzip: gzip-compress all non-SSI files (with opt. compr.-level, default=9)" NEWLINE);
+  printf("                 ATTENTION: browser has to support \"Content-Encoding: gzip\"!" NEWLINE);
 #endif
   printf("   if targetdir not specified, htmlgen will attempt to" NEWLINE);
   printf("   process files in subdirectory 'fs'" NEWLINE);
@@ -218,12 +311,16 @@ int main(int argc, char *argv[])
         printf("Using Server-ID: \"%s\"\n", serverID);
       } else if (strstr(argv[i], "-s") == argv[i]) {
         processSubs = 0;
+      } else if (strstr(argv[i], "-etag") == argv[i]) {
+        includeEtag = 1;
       } else if (strstr(argv[i], "-e") == argv[i]) {
         includeHttpHeader = 0;
       } else if (strstr(argv[i], "-11") == argv[i]) {
         useHttp11 = 1;
       } else if (strstr(argv[i], "-nossi") == argv[i]) {
         supportSsi = 0;
+      } else if (strstr(argv[i], "-cache:") == argv[i]) {
+        snprintf(cacheControl, sizeof(cacheControl), "Cache-Control: max-age=%d\r\n", atoi(&argv[i][7]));
       } else if (strstr(argv[i], "-c") == argv[i]) {
         precalcChksum = 1;
       } else if (strstr(argv[i], "-f:") == argv[i]) {
@@ -250,6 +347,25 @@ int main(int argc, char *argv[])
         printf("Deflating all non-SSI files with level %d (but only if size is reduced)" NEWLINE, deflate_level);
 #else
         printf("WARNING: Deflate support is disabled\n");
+#endif
+      } else if (strstr(argv[i], "-gzip") == argv[i]) {
+#if MAKEFS_SUPPORT_GZIP
+        char* colon = strstr(argv[i], ":");
+        if (colon) {
+          if (colon[1] != 0) {
+            int level = atoi(&colon[1]);
+            if ((level >= 0) && (level <= 9)) {
+              gzip_level = level;
+            } else {
+              printf("ERROR: gzip level must be [0..9]" NEWLINE);
+              exit(0);
+            }
+          }
+        }
+        gzipNonSsiFiles = 1;
+        printf("Gzipping all non-SSI files with level %d (but only if size is reduced)" NEWLINE, gzip_level);
+#else
+        printf("WARNING: Gzip support is disabled\n");
 #endif
       } else if ((strstr(argv[i], "-?")) || (strstr(argv[i], "-h"))) {
         print_usage();
@@ -264,6 +380,18 @@ int main(int argc, char *argv[])
     }
   }
 
+#if MAKEFS_SUPPORT_DEFLATE && MAKEFS_SUPPORT_GZIP
+  if (deflateNonSsiFiles && gzipNonSsiFiles) {
+    printf("WARNING: -defl and -gzip given, using gzip" NEWLINE);
+    deflateNonSsiFiles = 0;
+  }
+#endif
+
+  if (includeEtag && (cacheControl[0] == 0)) {
+    /* cached, but always revalidated: the 304 costs a header */
+    strcpy(cacheControl, "Cache-Control: no-cache\r\n");
+  }
+
   if (!check_path(path, sizeof(path))) {
     printf("Invalid path: \"%s\"." NEWLINE, path);
     exit(-1);
@@ -314,6 +442,12 @@ int main(int argc, char *argv[])
   fprintf(data_file, "#ifndef FS_FILE_FLAGS_HEADER_INCLUDED" NEWLINE "#define FS_FILE_FLAGS_HEADER_INCLUDED 1" NEWLINE "#endif" NEWLINE);
   /* define FS_FILE_FLAGS_HEADER_PERSISTENT to 0 if not defined (compatibility with older httpd/fs: wasn't supported back then) */
   fprintf(data_file, "#ifndef FS_FILE_FLAGS_HEADER_PERSISTENT" NEWLINE "#define FS_FILE_FLAGS_HEADER_PERSISTENT 0" NEWLINE "#endif" NEWLINE);
+#if MAKEFS_SUPPORT_GZIP
+  /* define FS_FILE_FLAGS_GZIP to 0 if not defined (compatibility with older httpd/fs: the gzip copy is found first) */
+  if (gzipNonSsiFiles) {
+    fprintf(data_file, "#ifndef FS_FILE_FLAGS_GZIP" NEWLINE "#define FS_FILE_FLAGS_GZIP 0" NEWLINE "#endif" NEWLINE);
+  }
+#endif
 
   /* define alignment defines */
 #if ALIGN_PAYLOAD
@@ -357,6 +491,12 @@ int main(int argc, char *argv[])
     printf("(Deflated total byte reduction: %d bytes -> %d bytes (%.02f%%)" NEWLINE,
       (int)overallDataBytes, (int)deflatedBytesReduced, (float)((deflatedBytesReduced*100.0)/overallDataBytes));
   }
+#endif
+#if MAKEFS_SUPPORT_GZIP
+  if (gzipNonSsiFiles) {
+    printf("(Gzipped total byte reduction: %d bytes -> %d bytes (%.02f%%)" NEWLINE,
+      (int)overallDataBytes, (int)gzippedBytesReduced, (float)((gzippedBytesReduced*100.0)/overallDataBytes));
+  }
 #endif
   printf(NEWLINE);
 
@@ -478,7 +618,63 @@ int process_sub(FILE *data_file, FILE *struct_file)
   return filesProcessed;
 }
 
-u8_t* get_file_data(const char* filename, int* file_size, int can_be_compressed, int* is_compressed)
+#if MAKEFS_SUPPORT_GZIP
+/* Returns the data gzip-compressed, or NULL if that is not smaller */
+static u8_t* gzip_file_data(const u8_t* data, size_t size, size_t* out_size)
+{
+  z_stream strm;
+  u8_t* out;
+  u8_t* check;
+  uLong bound;
+  int ret;
+
+  memset(&strm, 0, sizeof(strm));
+  /* windowBits 15 + 16: gzip wrapper (no file name, no time stamp) instead of zlib's */
+  ret = deflateInit2(&strm, gzip_level, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY);
+  if (ret != Z_OK) {
+    printf("deflateInit2() failed: %d\n", ret);
+    exit(-1);
+  }
+  bound = deflateBound(&strm, (uLong)size);
+  out = (u8_t*)malloc(bound);
+  LWIP_ASSERT("out != NULL", out != NULL);
+  strm.next_in = (Bytef*)data;
+  strm.avail_in = (uInt)size;
+  strm.next_out = out;
+  strm.avail_out = (uInt)bound;
+  ret = deflate(&strm, Z_FINISH);
+  if (ret != Z_STREAM_END) {
+    printf("gzip failed: %d\n", ret);
+    exit(-1);
+  }
+  *out_size = strm.total_out;
+  deflateEnd(&strm);
+  if (*out_size >= size) {
+    free(out);
+    return NULL;
+  }
+
+  /* sanity-check compression by inflating and comparing to the original */
+  check = (u8_t*)malloc(size);
+  LWIP_ASSERT("check != NULL", check != NULL);
+  memset(&strm, 0, sizeof(strm));
+  ret = inflateInit2(&strm, 15 + 16);
+  LWIP_ASSERT("inflateInit2 failed", ret == Z_OK);
+  strm.next_in = out;
+  strm.avail_in = (uInt)*out_size;
+  strm.next_out = check;
+  strm.avail_out = (uInt)size;
+  ret = inflate(&strm, Z_FINISH);
+  LWIP_ASSERT("inflate failed", ret == Z_STREAM_END);
+  LWIP_ASSERT("inflate size mismatch", strm.total_out == size);
+  LWIP_ASSERT("inflated memcmp failed", !memcmp(check, data, size));
+  inflateEnd(&strm);
+  free(check);
+  return out;
+}
+#endif /* MAKEFS_SUPPORT_GZIP */
+
+static u8_t* read_file_data(const char* filename, size_t* file_size)
 {
   FILE *inFile;
   size_t fsize = 0;
@@ -501,10 +697,45 @@ u8_t* get_file_data(const char* filename, int* file_size, int can_be_compressed,
   buf = (u8_t*)malloc(fsize);
   LWIP_ASSERT("buf != NULL", buf != NULL);
   r = fread(buf, 1, fsize, inFile);
+  LWIP_UNUSED_ARG(r);
+  fclose(inFile);
+  *file_size = fsize;
+  return buf;
+}
+
+u8_t* get_file_data(const char* filename, int* file_size, int can_be_compressed, int* is_compressed)
+{
+  size_t fsize;
+  u8_t* buf;
+
+  buf = read_file_data(filename, &fsize);
   *file_size = fsize;
   *is_compressed = 0;
-#if MAKEFS_SUPPORT_DEFLATE
+#if MAKEFS_SUPPORT_DEFLATE || MAKEFS_SUPPORT_GZIP
   overallDataBytes += fsize;
+#endif
+#if MAKEFS_SUPPORT_GZIP
+  if (gzipNonSsiFiles) {
+    if (can_be_compressed) {
+      size_t out_bytes;
+      u8_t* ret_buf = gzip_file_data(buf, fsize, &out_bytes);
+      if (ret_buf != NULL) {
+        /* free original buffer, use compressed data + size */
+        free(buf);
+        buf = ret_buf;
+        *file_size = out_bytes;
+        printf(" - gzip: %d bytes -> %d bytes (%.02f%%)" NEWLINE, (int)fsize, (int)out_bytes, (float)((out_bytes*100.0)/fsize));
+        gzippedBytesReduced += (size_t)(fsize - out_bytes);
+        *is_compressed = COMPRESSED_GZIP;
+      } else {
+        printf(" - uncompressed: (would not be smaller using gzip)" NEWLINE);
+      }
+    } else {
+      printf(" - SSI file, cannot be compressed" NEWLINE);
+    }
+  }
+#endif
+#if MAKEFS_SUPPORT_DEFLATE
   if (deflateNonSsiFiles) {
     if (can_be_compressed) {
       if (fsize < OUT_BUF_SIZE) {
@@ -556,7 +787,7 @@ u8_t* get_file_data(const char* filename, int* file_size, int can_be_compressed,
           *file_size = out_bytes;
           printf(" - deflate: %d bytes -> %d bytes (%.02f%%)" NEWLINE, (int)fsize, (int)out_bytes, (float)((out_bytes*100.0)/fsize));
           deflatedBytesReduced += (size_t)(fsize - out_bytes);
-          *is_compressed = 1;
+          *is_compressed = COMPRESSED_DEFLATE;
         } else {
           printf(" - uncompressed: (would be %d bytes larger using deflate)" NEWLINE, (int)(out_bytes - fsize));
         }
@@ -567,10 +798,10 @@ u8_t* get_file_data(const char* filename, int* file_size, int can_be_compressed,
       printf(" - SSI file, cannot be compressed" NEWLINE);
     }
   }
-#else
+#endif
+#if !MAKEFS_SUPPORT_DEFLATE && !MAKEFS_SUPPORT_GZIP
   LWIP_UNUSED_ARG(can_be_compressed);
 #endif
-  fclose(inFile);
   return buf;
 }
 
@@ -709,20 +940,40 @@ int is_ssi_file(const char* filename)
   return 0;
 }
 
-int process_file(FILE *data_file, FILE *struct_file, const char *filename)
+static int is_error_file(const char* filename)
+{
+  return (strstr(filename, "404") == filename) || (strstr(filename, "400") == filename) ||
+         (strstr(filename, "501") == filename);
+}
+
+/* FNV-1a over the file as stored: the entity tag changes with its compression, too */
+static u32_t etag_hash(const u8_t* data, size_t size)
+{
+  u32_t hash = 0x811c9dc5UL;
+  size_t i;
+  for (i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x01000193UL;
+  }
+  return hash;
+}
+
+/* Writes the data of a file and its struct fsdata_file, after the one
+   written before it. vary: the file is stored both gzipped and not. */
+static int write_file(FILE *data_file, FILE *struct_file, const char *filename, u8_t* file_data, int file_size,
+                      int is_compressed, u8_t vary)
 {
   char varname[MAX_PATH_LEN];
   int i = 0;
   char qualifiedName[MAX_PATH_LEN];
-  int file_size;
   u16_t http_hdr_chksum = 0;
   u16_t http_hdr_len = 0;
   int chksum_count = 0;
   u8_t flags = 0;
-  const char* flags_str;
+  char flags_str[128];
   u8_t has_content_len;
-  u8_t* file_data;
-  int is_compressed = 0;
+  u8_t cacheable;
+  char etag[32];
 
   /* create qualified name (@todo: prepend slash or not?) */
   sprintf(qualifiedName,"%s/%s", curSubdir, filename);
@@ -751,14 +1002,23 @@ int process_file(FILE *data_file, FILE *struct_file, const char *filename)
   fprintf(data_file, NEWLINE);
 
   has_content_len = !is_ssi_file(filename);
-  file_data = get_file_data(filename, &file_size, includeHttpHeader && has_content_len, &is_compressed);
+  /* the same response every time: only the 200 of a non-SSI file */
+  cacheable = includeHttpHeader && has_content_len && !is_error_file(filename);
+  etag[0] = 0;
+  if (includeEtag && cacheable) {
+    sprintf(etag, "%08x-%x", (unsigned)etag_hash(file_data, file_size), (unsigned)file_size);
+  }
   if (includeHttpHeader) {
-    file_write_http_header(data_file, filename, file_size, &http_hdr_len, &http_hdr_chksum, has_content_len, is_compressed);
+    file_write_http_header(data_file, filename, file_size, &http_hdr_len, &http_hdr_chksum, has_content_len, is_compressed,
+                           vary, etag[0] ? etag : NULL, (cacheable && cacheControl[0]) ? cacheControl : NULL);
     flags = FS_FILE_FLAGS_HEADER_INCLUDED;
     if (has_content_len) {
       flags |= FS_FILE_FLAGS_HEADER_PERSISTENT;
     }
   }
+  if (is_compressed == COMPRESSED_GZIP) {
+    flags |= FS_FILE_FLAGS_GZIP;
+  }
   if (precalcChksum) {
     chksum_count = write_checksums(struct_file, varname, http_hdr_len, http_hdr_chksum, file_data, file_size);
   }
@@ -769,27 +1029,32 @@ int process_file(FILE *data_file, FILE *struct_file, const char *filename)
   fprintf(struct_file, "data_%s," NEWLINE, varname);
   fprintf(struct_file, "data_%s + %d," NEWLINE, varname, i);
   fprintf(struct_file, "sizeof(data_%s) - %d," NEWLINE, varname, i);
-  switch(flags)
-  {
-  case(FS_FILE_FLAGS_HEADER_INCLUDED):
-     flags_str = "FS_FILE_FLAGS_HEADER_INCLUDED";
-     break;
-  case(FS_FILE_FLAGS_HEADER_PERSISTENT):
-     flags_str = "FS_FILE_FLAGS_HEADER_PERSISTENT";
-     break;
-  case(FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT):
-     flags_str = "FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT";
-     break;
-  default:
-     flags_str = "0";
-     break;
-  }
-  fprintf(struct_file, "%s," NEWLINE, flags_str);
+  flags_str[0] = 0;
+  if (flags & FS_FILE_FLAGS_HEADER_INCLUDED) {
+     strcat(flags_str, " | FS_FILE_FLAGS_HEADER_INCLUDED");
+  }
+  if (flags & FS_FILE_FLAGS_HEADER_PERSISTENT) {
+     strcat(flags_str, " | FS_FILE_FLAGS_HEADER_PERSISTENT");
+  }
+  if (flags & FS_FILE_FLAGS_GZIP) {
+     strcat(flags_str, " | FS_FILE_FLAGS_GZIP");
+  }
+  fprintf(struct_file, "%s," NEWLINE, flags_str[0] ? &flags_str[3] : "0");
   if (precalcChksum) {
     fprintf(struct_file, "#if HTTPD_PRECALCULATED_CHECKSUM" NEWLINE);
     fprintf(struct_file, "%d, chksums_%s," NEWLINE, chksum_count, varname);
     fprintf(struct_file, "#endif /* HTTPD_PRECALCULATED_CHECKSUM */" NEWLINE);
   }
+  if (etag[0]) {
+    fprintf(struct_file, "#if LWIP_HTTPD_ETAG" NEWLINE);
+    if (!precalcChksum) {
+      fprintf(struct_file, "#if HTTPD_PRECALCULATED_CHECKSUM" NEWLINE);
+      fprintf(struct_file, "0, NULL," NEWLINE);
+      fprintf(struct_file, "#endif /* HTTPD_PRECALCULATED_CHECKSUM */" NEWLINE);
+    }
+    fprintf(struct_file, "\"\\\"%s\\\"\"," NEWLINE, etag);
+    fprintf(struct_file, "#endif /* LWIP_HTTPD_ETAG */" NEWLINE);
+  }
   fprintf(struct_file, "}};" NEWLINE NEWLINE);
   strcpy(lastFileVar, varname);
 
@@ -798,12 +1063,41 @@ int process_file(FILE *data_file, FILE *struct_file, const char *filename)
   fprintf(data_file, NEWLINE "/* raw file data (%d bytes) */" NEWLINE, file_size);
   process_file_data(data_file, file_data, file_size);
   fprintf(data_file, "};" NEWLINE NEWLINE);
-  free(file_data);
   return 0;
 }
 
+int process_file(FILE *data_file, FILE *struct_file, const char *filename)
+{
+  int file_size;
+  u8_t* file_data;
+  int is_compressed = 0;
+  int ret;
+
+  file_data = get_file_data(filename, &file_size, includeHttpHeader && !is_ssi_file(filename), &is_compressed);
+#if MAKEFS_SUPPORT_GZIP
+  if (is_compressed == COMPRESSED_GZIP) {
+    /* Keep the file as it is for the clients that do not accept gzip. The
+       list is built backwards: fs_open() finds the gzipped copy first,
+       fs_open_identity() skips it for this one. */
+    size_t plain_size;
+    u8_t* plain = read_file_data(filename, &plain_size);
+    ret = write_file(data_file, struct_file, filename, plain, (int)plain_size, 0, 1);
+    free(plain);
+    if (ret < 0) {
+      free(file_data);
+      return ret;
+    }
+  }
+#endif
+  ret = write_file(data_file, struct_file, filename, file_data, file_size, is_compressed,
+                   is_compressed == COMPRESSED_GZIP);
+  free(file_data);
+  return ret;
+}
+
 int file_write_http_header(FILE *data_file, const char *filename, int file_size, u16_t *http_hdr_len,
-                           u16_t *http_hdr_chksum, u8_t provide_content_len, int is_compressed)
+                           u16_t *http_hdr_chksum, u8_t provide_content_len, int is_compressed,
+                           u8_t vary, const char *etag, const char *cache_control)
 {
   int i = 0;
   int response_type = HTTP_HDR_OK;
@@ -900,8 +1194,7 @@ int file_write_http_header(FILE *data_file, const char *filename, int file_size,
       hdr_len += cur_len;
     }
 
-    _itoa(content_len, intbuf, 10);
-    strcat(intbuf, "\r\n");
+    sprintf(intbuf, "%d\r\n", content_len);
     cur_len = strlen(intbuf);
     written += file_put_ascii(data_file, intbuf, cur_len, &i);
     i = 0;
@@ -966,19 +1259,61 @@ int file_write_http_header(FILE *data_file, const char *filename, int file_size,
     }
   }
 
-#if MAKEFS_SUPPORT_DEFLATE
   if (is_compressed) {
-    /* tell the client about the deflate encoding */
-    LWIP_ASSERT("error", deflateNonSsiFiles);
-    cur_string = "Content-Encoding: deflate\r\n";
+    /* tell the client about the encoding */
+    if (is_compressed == COMPRESSED_GZIP) {
+      cur_string = "Content-Encoding: gzip\r\n";
+    } else {
+      cur_string = "Content-Encoding: deflate\r\n";
+    }
     cur_len = strlen(cur_string);
     fprintf(data_file, NEWLINE "/* \"%s\" (%d bytes) */" NEWLINE, cur_string, cur_len);
     written += file_put_ascii(data_file, cur_string, cur_len, &i);
     i = 0;
+    if (precalcChksum) {
+      memcpy(&hdr_buf[hdr_len], cur_string, cur_len);
+      hdr_len += cur_len;
+    }
+  }
+
+  if (vary) {
+    /* the response depends on Accept-Encoding: caches keep both */
+    cur_string = "Vary: Accept-Encoding\r\n";
+    cur_len = strlen(cur_string);
+    fprintf(data_file, NEWLINE "/* \"%s\" (%d bytes) */" NEWLINE, cur_string, cur_len);
+    written += file_put_ascii(data_file, cur_string, cur_len, &i);
+    i = 0;
+    if (precalcChksum) {
+      memcpy(&hdr_buf[hdr_len], cur_string, cur_len);
+      hdr_len += cur_len;
+    }
+  }
+
+  if (etag != NULL) {
+    char etagbuf[64];
+    cur_string = etagbuf;
+    snprintf(etagbuf, sizeof(etagbuf), "ETag: \"%s\"\r\n", etag);
+    cur_len = strlen(cur_string);
+    fprintf(data_file, NEWLINE "/* \"%s\" (%d bytes) */" NEWLINE, cur_string, cur_len);
+    written += file_put_ascii(data_file, cur_string, cur_len, &i);
+    i = 0;
+    if (precalcChksum) {
+      memcpy(&hdr_buf[hdr_len], cur_string, cur_len);
+      hdr_len += cur_len;
+    }
+  }
+
+  if (cache_control != NULL) {
+    cur_string = cache_control;
+    cur_len = strlen(cur_string);
+    fprintf(data_file, NEWLINE "/* \"%s\" (%d bytes) */" NEWLINE, cur_string, cur_len);
+    written += file_put_ascii(data_file, cur_string, cur_len, &i);
+    i = 0;
+    if (precalcChksum) {
+      memcpy(&hdr_buf[hdr_len], cur_string, cur_len);
+      hdr_len += cur_len;
+    }
   }
-#else
-  LWIP_UNUSED_ARG(is_compressed);
-#endif
 
   /* write content-type, ATTENTION: this includes the double-CRLF! */
   cur_string = file_type;
@@ -183,7 +183,7 @@ lwip_strnicmp(const char* str1, const char* str2, size_t len)
         return 1;
       }
     }
-  } while (len-- && c1 != 0);
+  } while (--len && c1 != 0);
   return 0;
 }
 #endif
@@ -57,6 +57,7 @@
 #include "lwip/nd6.h"
 #include "lwip/mld6.h"
 #include "lwip/api.h"
+#include "lwip/ip4_napt.h"
 
 #include "netif/ppp/ppp_opts.h"
 #include "netif/ppp/ppp_impl.h"
@@ -101,6 +102,9 @@ PACK_STRUCT_END
 #if (!LWIP_UDP && LWIP_DNS)
   #error "If you want to use DNS, you have to define LWIP_UDP=1 in your lwipopts.h"
 #endif
+#if (!IP_FORWARD && IP_NAPT)
+  #error "If you want to use NAPT, you have to define IP_FORWARD=1 in your lwipopts.h"
+#endif
 #if !MEMP_MEM_MALLOC /* MEMP_NUM_* checks are disabled when not using the pool allocator */
 #if (LWIP_ARP && ARP_QUEUEING && (MEMP_NUM_ARP_QUEUE<=0))
   #error "If you want to use ARP Queueing, you have to define MEMP_NUM_ARP_QUEUE>=1 in your lwipopts.h"
@@ -359,6 +363,9 @@ lwip_init(void)
 #if LWIP_ARP
   etharp_init();
 #endif /* LWIP_ARP */
+#if IP_NAPT
+  ip4_napt_init();
+#endif /* IP_NAPT */
 #endif /* LWIP_IPV4 */
 #if LWIP_RAW
   raw_init();
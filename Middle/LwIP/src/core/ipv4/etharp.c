@@ -76,6 +76,11 @@
  */
 #define ARP_MAXPENDING 5
 
+#if ETHARP_REFRESH_USED
+/** seconds between the requests confirming a used entry before it expires */
+#define ARP_REFRESH_INTERVAL 5
+#endif /* ETHARP_REFRESH_USED */
+
 /** ARP states */
 enum etharp_state {
   ETHARP_STATE_EMPTY = 0,
@@ -101,12 +106,31 @@ struct etharp_entry {
   struct eth_addr ethaddr;
   u16_t ctime;
   u8_t state;
+#if ETHARP_REFRESH_USED
+  /** a packet was sent through the entry since its last update */
+  u8_t used;
+#endif /* ETHARP_REFRESH_USED */
+#if ARP_HASH_SIZE
+  /** 1 + index of the next entry in the bucket or free list, 0 at the end */
+  u16_t next;
+#endif /* ARP_HASH_SIZE */
 };
 
 static struct etharp_entry arp_table[ARP_TABLE_SIZE];
 
+#if ARP_HASH_SIZE
+/** 1 + index of the first entry of each bucket, 0 if it is empty */
+static u16_t arp_hash[ARP_HASH_SIZE];
+/** 1 + index of the last entry freed, 0 if none */
+static u16_t arp_free;
+/** the entries from this one on have never been used */
+static u16_t arp_unused;
+
+#define ETHARP_HASH(ipaddr) etharp_hash_index(ip4_addr_get_u32(ipaddr))
+#endif /* ARP_HASH_SIZE */
+
 #if !LWIP_NETIF_HWADDRHINT
-static u8_t etharp_cached_entry;
+static u16_t etharp_cached_entry;
 #endif /* !LWIP_NETIF_HWADDRHINT */
 
 /** Try hard to create a new entry - we want the IP address to appear in
@@ -119,15 +143,21 @@ static u8_t etharp_cached_entry;
 
 #if LWIP_NETIF_HWADDRHINT
 #define ETHARP_SET_HINT(netif, hint)  if (((netif) != NULL) && ((netif)->addr_hint != NULL))  \
-                                      *((netif)->addr_hint) = (hint);
+                                      *((netif)->addr_hint) = (u8_t)(hint);
 #else /* LWIP_NETIF_HWADDRHINT */
 #define ETHARP_SET_HINT(netif, hint)  (etharp_cached_entry = (hint))
 #endif /* LWIP_NETIF_HWADDRHINT */
 
 
 /* Some checks, instead of etharp_init(): */
-#if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7f))
-  #error "ARP_TABLE_SIZE must fit in an s8_t, you have to reduce it in your lwipopts.h"
+#if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7fff))
+  #error "ARP_TABLE_SIZE must fit in an s16_t, you have to reduce it in your lwipopts.h"
+#endif
+#if (LWIP_ARP && LWIP_NETIF_HWADDRHINT && (ARP_TABLE_SIZE > 0xff))
+  #error "ARP_TABLE_SIZE must fit in the u8_t netif->addr_hint, you have to reduce it in your lwipopts.h"
+#endif
+#if (LWIP_ARP && ARP_HASH_SIZE && ((ARP_HASH_SIZE & (ARP_HASH_SIZE - 1)) != 0))
+  #error "ARP_HASH_SIZE must be a power of 2, you have to change it in your lwipopts.h"
 #endif
 
 
@@ -165,10 +195,84 @@ free_etharp_q(struct etharp_q_entry *q)
 
 #endif /* ARP_QUEUEING */
 
+#if ARP_HASH_SIZE
+/** Bucket of an IPv4 address: the host part varies most, in the last byte */
+static u16_t
+etharp_hash_index(u32_t addr)
+{
+  addr ^= addr >> 16;
+  addr ^= addr >> 8;
+  return (u16_t)(addr & (ARP_HASH_SIZE - 1));
+}
+
+/**
+ * Search the bucket of an IP address for its pending or stable entry.
+ *
+ * @return the entry index, -1 if there is none
+ */
+static s16_t
+etharp_hash_find(const ip4_addr_t *ipaddr, struct netif *netif)
+{
+  u16_t n;
+
+  for (n = arp_hash[ETHARP_HASH(ipaddr)]; n != 0; n = arp_table[n - 1].next) {
+    if (ip4_addr_cmp(ipaddr, &arp_table[n - 1].ipaddr)
+#if ETHARP_TABLE_MATCH_NETIF
+        && ((netif == NULL) || (netif == arp_table[n - 1].netif))
+#endif /* ETHARP_TABLE_MATCH_NETIF */
+        ) {
+      return (s16_t)(n - 1);
+    }
+  }
+  LWIP_UNUSED_ARG(netif);
+  return -1;
+}
+
+/** Take an empty entry: the last one freed, or one never used yet.
+ *
+ * @return the entry index, ARP_TABLE_SIZE if all are in use
+ */
+static s16_t
+etharp_hash_alloc(void)
+{
+  s16_t i;
+
+  if (arp_free != 0) {
+    i = (s16_t)(arp_free - 1);
+    arp_free = arp_table[i].next;
+  } else if (arp_unused < ARP_TABLE_SIZE) {
+    i = (s16_t)arp_unused++;
+  } else {
+    return ARP_TABLE_SIZE;
+  }
+  LWIP_ASSERT("allocated entry is empty", arp_table[i].state == ETHARP_STATE_EMPTY);
+  return i;
+}
+
+/** Remove an entry from the bucket of its address and give it back */
+static void
+etharp_hash_free(int i)
+{
+  u16_t *n;
+
+  for (n = &arp_hash[ETHARP_HASH(&arp_table[i].ipaddr)]; *n != 0; n = &arp_table[*n - 1].next) {
+    if (*n == i + 1) {
+      *n = arp_table[i].next;
+      break;
+    }
+  }
+  arp_table[i].next = arp_free;
+  arp_free = (u16_t)(i + 1);
+}
+#endif /* ARP_HASH_SIZE */
+
 /** Clean up ARP table entries */
 static void
 etharp_free_entry(int i)
 {
+#if ARP_HASH_SIZE
+  etharp_hash_free(i);
+#endif /* ARP_HASH_SIZE */
   /* remove from SNMP ARP index tree */
   mib2_remove_arp_entry(arp_table[i].netif, &arp_table[i].ipaddr);
   /* and empty packet queue */
@@ -198,7 +302,7 @@ etharp_free_entry(int i)
 void
 etharp_tmr(void)
 {
-  u8_t i;
+  u16_t i;
 
   LWIP_DEBUGF(ETHARP_DEBUG, ("etharp_timer\n"));
   /* remove expired entries from the ARP table */
@@ -228,6 +332,17 @@ etharp_tmr(void)
       } else if (arp_table[i].state == ETHARP_STATE_PENDING) {
         /* still pending, resend an ARP query */
         etharp_request(arp_table[i].netif, &arp_table[i].ipaddr);
+#if ETHARP_REFRESH_USED
+      } else if (arp_table[i].used && (arp_table[i].ctime >= ARP_AGE_REREQUEST_USED_UNICAST) &&
+                 (((arp_table[i].ctime - ARP_AGE_REREQUEST_USED_UNICAST) % ARP_REFRESH_INTERVAL) == 0)) {
+        /* in use: confirm it before it expires, asking the cached address
+           first so as not to bother the other hosts */
+        if (arp_table[i].ctime >= ARP_AGE_REREQUEST_USED_BROADCAST) {
+          etharp_request(arp_table[i].netif, &arp_table[i].ipaddr);
+        } else {
+          etharp_request_dst(arp_table[i].netif, &arp_table[i].ipaddr, &arp_table[i].ethaddr);
+        }
+#endif /* ETHARP_REFRESH_USED */
       }
     }
   }
@@ -254,14 +369,14 @@ etharp_tmr(void)
  * @return The ARP entry index that matched or is created, ERR_MEM if no
  * entry is found or could be recycled.
  */
-static s8_t
+static s16_t
 etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
 {
-  s8_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
-  s8_t empty = ARP_TABLE_SIZE;
-  u8_t i = 0;
+  s16_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
+  s16_t empty = ARP_TABLE_SIZE;
+  s16_t i = 0;
   /* oldest entry with packets on queue */
-  s8_t old_queue = ARP_TABLE_SIZE;
+  s16_t old_queue = ARP_TABLE_SIZE;
   /* its age */
   u16_t age_queue = 0, age_pending = 0, age_stable = 0;
 
@@ -280,8 +395,24 @@ etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
    * 4) remember the oldest pending entry with queued packets (if any)
    * 5) search for a matching IP entry, either pending or stable
    *    until 5 matches, or all entries are searched for.
+   *
+   * With ARP_HASH_SIZE, the match is looked up in its bucket and an empty
+   * entry taken from the free ones: the sweep only runs to recycle one.
    */
 
+#if ARP_HASH_SIZE
+  if (ipaddr != NULL) {
+    i = etharp_hash_find(ipaddr, netif);
+    if (i >= 0) {
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %"U16_F"\n", (u16_t)i));
+      return i;
+    }
+  }
+  if ((flags & ETHARP_FLAG_FIND_ONLY) == 0) {
+    empty = etharp_hash_alloc();
+  }
+  if (((flags & ETHARP_FLAG_TRY_HARD) != 0) && (empty == ARP_TABLE_SIZE))
+#endif /* ARP_HASH_SIZE */
   for (i = 0; i < ARP_TABLE_SIZE; ++i) {
     u8_t state = arp_table[i].state;
     /* no empty entry found yet and now we do find one? */
@@ -341,7 +472,7 @@ etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
       /* or no empty entry found and not allowed to recycle? */
       ((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_FLAG_TRY_HARD) == 0))) {
     LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
-    return (s8_t)ERR_MEM;
+    return (s16_t)ERR_MEM;
   }
 
   /* b) choose the least destructive entry to recycle:
@@ -378,12 +509,16 @@ etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
       /* no empty or recyclable entries found */
     } else {
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty or recyclable entries found\n"));
-      return (s8_t)ERR_MEM;
+      return (s16_t)ERR_MEM;
     }
 
     /* { empty or recyclable entry found } */
     LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
     etharp_free_entry(i);
+#if ARP_HASH_SIZE
+    /* take it back from the free ones, it is first there */
+    i = etharp_hash_alloc();
+#endif /* ARP_HASH_SIZE */
   }
 
   LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
@@ -394,12 +529,19 @@ etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
   if (ipaddr != NULL) {
     /* set IP address */
     ip4_addr_copy(arp_table[i].ipaddr, *ipaddr);
+#if ARP_HASH_SIZE
+    arp_table[i].next = arp_hash[ETHARP_HASH(ipaddr)];
+    arp_hash[ETHARP_HASH(ipaddr)] = (u16_t)(i + 1);
+#endif /* ARP_HASH_SIZE */
   }
   arp_table[i].ctime = 0;
+#if ETHARP_REFRESH_USED
+  arp_table[i].used = 0;
+#endif /* ETHARP_REFRESH_USED */
 #if ETHARP_TABLE_MATCH_NETIF
   arp_table[i].netif = netif;
 #endif /* ETHARP_TABLE_MATCH_NETIF*/
-  return (err_t)i;
+  return i;
 }
 
 /**
@@ -423,7 +565,7 @@ etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif* netif)
 static err_t
 etharp_update_arp_entry(struct netif *netif, const ip4_addr_t *ipaddr, struct eth_addr *ethaddr, u8_t flags)
 {
-  s8_t i;
+  s16_t i;
   LWIP_ASSERT("netif->hwaddr_len == ETH_HWADDR_LEN", netif->hwaddr_len == ETH_HWADDR_LEN);
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_update_arp_entry: %"U16_F".%"U16_F".%"U16_F".%"U16_F" - %02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F"\n",
     ip4_addr1_16(ipaddr), ip4_addr2_16(ipaddr), ip4_addr3_16(ipaddr), ip4_addr4_16(ipaddr),
@@ -467,6 +609,9 @@ etharp_update_arp_entry(struct netif *netif, const ip4_addr_t *ipaddr, struct et
   ETHADDR32_COPY(&arp_table[i].ethaddr, ethaddr);
   /* reset time stamp */
   arp_table[i].ctime = 0;
+#if ETHARP_REFRESH_USED
+  arp_table[i].used = 0;
+#endif /* ETHARP_REFRESH_USED */
   /* this is where we will send out queued packets! */
 #if ARP_QUEUEING
   while (arp_table[i].q != NULL) {
@@ -529,7 +674,7 @@ etharp_add_static_entry(const ip4_addr_t *ipaddr, struct eth_addr *ethaddr)
 err_t
 etharp_remove_static_entry(const ip4_addr_t *ipaddr)
 {
-  s8_t i;
+  s16_t i;
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_remove_static_entry: %"U16_F".%"U16_F".%"U16_F".%"U16_F"\n",
     ip4_addr1_16(ipaddr), ip4_addr2_16(ipaddr), ip4_addr3_16(ipaddr), ip4_addr4_16(ipaddr)));
 
@@ -558,7 +703,7 @@ etharp_remove_static_entry(const ip4_addr_t *ipaddr)
 void
 etharp_cleanup_netif(struct netif *netif)
 {
-  u8_t i;
+  u16_t i;
 
   for (i = 0; i < ARP_TABLE_SIZE; ++i) {
     u8_t state = arp_table[i].state;
@@ -579,11 +724,11 @@ etharp_cleanup_netif(struct netif *netif)
  * @param ip_ret points to return pointer
  * @return table index if found, -1 otherwise
  */
-s8_t
+s16_t
 etharp_find_addr(struct netif *netif, const ip4_addr_t *ipaddr,
          struct eth_addr **eth_ret, const ip4_addr_t **ip_ret)
 {
-  s8_t i;
+  s16_t i;
 
   LWIP_ASSERT("eth_ret != NULL && ip_ret != NULL",
     eth_ret != NULL && ip_ret != NULL);
@@ -609,7 +754,7 @@ etharp_find_addr(struct netif *netif, const ip4_addr_t *ipaddr,
  * @return 1 on valid index, 0 otherwise
  */
 u8_t
-etharp_get_entry(u8_t i, ip4_addr_t **ipaddr, struct netif **netif, struct eth_addr **eth_ret)
+etharp_get_entry(u16_t i, ip4_addr_t **ipaddr, struct netif **netif, struct eth_addr **eth_ret)
 {
   LWIP_ASSERT("ipaddr != NULL", ipaddr != NULL);
   LWIP_ASSERT("netif != NULL", netif != NULL);
@@ -743,10 +888,14 @@ etharp_input(struct pbuf *p, struct netif *netif)
  * in the arp_table specified by the index 'arp_idx'.
  */
 static err_t
-etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u8_t arp_idx)
+etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u16_t arp_idx)
 {
   LWIP_ASSERT("arp_table[arp_idx].state >= ETHARP_STATE_STABLE",
               arp_table[arp_idx].state >= ETHARP_STATE_STABLE);
+#if ETHARP_REFRESH_USED
+  /* etharp_tmr() re-requests it before it expires */
+  arp_table[arp_idx].used = 1;
+#else /* ETHARP_REFRESH_USED */
   /* if arp table entry is about to expire: re-request it,
      but only if its state is ETHARP_STATE_STABLE to prevent flooding the
      network with ARP requests if this address is used frequently. */
@@ -763,6 +912,7 @@ etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u8_t arp_idx)
       }
     }
   }
+#endif /* ETHARP_REFRESH_USED */
 
   return ethernet_output(netif, q, (struct eth_addr*)(netif->hwaddr), &arp_table[arp_idx].ethaddr, ETHTYPE_IP);
 }
@@ -816,7 +966,7 @@ etharp_output(struct netif *netif, struct pbuf *q, const ip4_addr_t *ipaddr)
     dest = &mcastaddr;
   /* unicast destination IP address? */
   } else {
-    s8_t i;
+    s16_t i;
     /* outside local network? if so, this can neither be a global broadcast nor
        a subnet broadcast. */
     if (!ip4_addr_netcmp(ipaddr, netif_ip4_addr(netif), netif_ip4_netmask(netif)) &&
@@ -871,6 +1021,14 @@ etharp_output(struct netif *netif, struct pbuf *q, const ip4_addr_t *ipaddr)
 
     /* find stable entry: do this here since this is a critical path for
        throughput and etharp_find_entry() is kind of slow */
+#if ARP_HASH_SIZE
+    i = etharp_hash_find(dst_addr, netif);
+    if ((i >= 0) && (arp_table[i].state >= ETHARP_STATE_STABLE)) {
+      /* found an existing, stable entry */
+      ETHARP_SET_HINT(netif, i);
+      return etharp_output_to_arp_index(netif, q, i);
+    }
+#else /* ARP_HASH_SIZE */
     for (i = 0; i < ARP_TABLE_SIZE; i++) {
       if ((arp_table[i].state >= ETHARP_STATE_STABLE) &&
 #if ETHARP_TABLE_MATCH_NETIF
@@ -882,6 +1040,7 @@ etharp_output(struct netif *netif, struct pbuf *q, const ip4_addr_t *ipaddr)
         return etharp_output_to_arp_index(netif, q, i);
       }
     }
+#endif /* ARP_HASH_SIZE */
     /* no stable entry found, use the (slower) query function:
        queue on destination Ethernet address belonging to ipaddr */
     return etharp_query(netif, dst_addr, q);
@@ -932,7 +1091,7 @@ etharp_query(struct netif *netif, const ip4_addr_t *ipaddr, struct pbuf *q)
   struct eth_addr * srcaddr = (struct eth_addr *)netif->hwaddr;
   err_t result = ERR_MEM;
   int is_new_entry = 0;
-  s8_t i; /* ARP entry index */
+  s16_t i; /* ARP entry index */
 
   /* non-unicast address? */
   if (ip4_addr_isbroadcast(ipaddr, netif) ||
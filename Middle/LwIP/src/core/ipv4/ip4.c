@@ -46,6 +46,7 @@
 #include "lwip/def.h"
 #include "lwip/mem.h"
 #include "lwip/ip4_frag.h"
+#include "lwip/ip4_napt.h"
 #include "lwip/inet_chksum.h"
 #include "lwip/netif.h"
 #include "lwip/icmp.h"
@@ -323,6 +324,25 @@ ip4_forward(struct pbuf *p, struct ip_hdr *iphdr, struct netif *inp)
     IPH_CHKSUM_SET(iphdr, IPH_CHKSUM(iphdr) + PP_HTONS(0x100));
   }
 
+  /* Too big with DF set: answered before NAPT translates the packet, so the
+     error quotes it as the sender sent it and goes back to the sender */
+  if (netif->mtu && (p->tot_len > netif->mtu) && ((IPH_OFFSET(iphdr) & PP_NTOHS(IP_DF)) != 0)) {
+#if LWIP_ICMP
+    /* send ICMP Destination Unreachable code 4: "Fragmentation Needed and DF Set" */
+    icmp_dest_unreach(p, ICMP_DUR_FRAG);
+#endif /* LWIP_ICMP */
+    return;
+  }
+
+#if IP_NAPT
+  /* From the inside to another interface: leave with its address */
+  if (inp->napt && !netif->napt && (ip4_napt_output(p, iphdr, netif) != ERR_OK)) {
+    IP_STATS_INC(ip.drop);
+    MIB2_STATS_INC(mib2.ipoutdiscards);
+    return;
+  }
+#endif /* IP_NAPT */
+
   LWIP_DEBUGF(IP_DEBUG, ("ip4_forward: forwarding packet to %"U16_F".%"U16_F".%"U16_F".%"U16_F"\n",
     ip4_addr1_16(ip4_current_dest_addr()), ip4_addr2_16(ip4_current_dest_addr()),
     ip4_addr3_16(ip4_current_dest_addr()), ip4_addr4_16(ip4_current_dest_addr())));
@@ -334,18 +354,12 @@ ip4_forward(struct pbuf *p, struct ip_hdr *iphdr, struct netif *inp)
   PERF_STOP("ip4_forward");
   /* don't fragment if interface has mtu set to 0 [loopif] */
   if (netif->mtu && (p->tot_len > netif->mtu)) {
-    if ((IPH_OFFSET(iphdr) & PP_NTOHS(IP_DF)) == 0) {
+    /* DF is clear, checked above */
 #if IP_FRAG
-      ip4_frag(p, netif, ip4_current_dest_addr());
+    ip4_frag(p, netif, ip4_current_dest_addr());
 #else /* IP_FRAG */
-      /* @todo: send ICMP Destination Unreachable code 13 "Communication administratively prohibited"? */
+    /* @todo: send ICMP Destination Unreachable code 13 "Communication administratively prohibited"? */
 #endif /* IP_FRAG */
-    } else {
-#if LWIP_ICMP
-      /* send ICMP Destination Unreachable code 4: "Fragmentation Needed and DF Set" */
-      icmp_dest_unreach(p, ICMP_DUR_FRAG);
-#endif /* LWIP_ICMP */
-    }
     return;
   }
   /* transmit pbuf on chosen interface */
@@ -633,6 +647,16 @@ ip4_input(struct pbuf *p, struct netif *inp)
 #endif /* IP_REASSEMBLY */
   }
 
+#if IP_NAPT
+  /* A reply to a translated packet goes on to the inside host */
+  if (ip4_napt_input(p, iphdr, inp)) {
+    ip_addr_copy_from_ip4(ip_data.current_iphdr_dest, iphdr->dest);
+    ip4_forward(p, iphdr, inp);
+    pbuf_free(p);
+    return ERR_OK;
+  }
+#endif /* IP_NAPT */
+
 #if IP_OPTIONS_ALLOWED == 0 /* no support for IP options in the IP header? */
 
 #if LWIP_IGMP
@@ -958,7 +982,13 @@ ip4_output_if_opt_src(struct pbuf *p, const ip4_addr_t *src, const ip4_addr_t *d
 #endif /* IP_FRAG */
 
   LWIP_DEBUGF(IP_DEBUG, ("ip4_output_if: call netif->output()\n"));
-  return netif->output(netif, p, dest);
+  {
+    err_t err;
+    PERF_START;
+    err = netif->output(netif, p, dest);
+    PERF_STOP("ip4_output");
+    return err;
+  }
 }
 
 /**
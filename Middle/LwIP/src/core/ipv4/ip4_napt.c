@@ -0,0 +1,574 @@
+/**
+ * @file
+ * Network address and port translation of forwarded IPv4 packets
+ *
+ * A packet forwarded from an interface enabled with ip4_napt_enable() (the
+ * inside, the Ethernet LAN) to another one (an uplink) leaves with the
+ * address of the uplink and an outside port, or ICMP echo identifier, taken
+ * from IP_NAPT_PORT_FIRST..IP_NAPT_PORT_LAST. The replies to that address
+ * and port from the same remote host and port are translated back in
+ * ip4_input() and forwarded to the inside host.
+ *
+ * The translations are found through two hash tables: by the whole tuple
+ * for the packets from the inside, by the outside port for the replies.
+ * They expire after being idle for the timeout of their protocol (see
+ * IP_NAPT_TMOT_*), which is only checked when they are looked up: when the
+ * table is full, the one idle the longest is recycled.
+ *
+ * The headers are rewritten in place in the first pbuf and the IP and
+ * transport checksums updated incrementally (RFC 1624), nothing is copied
+ * nor summed again. Fragments after the first one of a datagram carry no
+ * port and are not forwarded from the inside; the replies are translated
+ * once reassembled.
+ */
+
+#include "lwip/opt.h"
+
+#if LWIP_IPV4 && IP_NAPT /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/ip4_napt.h"
+#include "lwip/def.h"
+#include "lwip/sys.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/prot/udp.h"
+#include "lwip/prot/icmp.h"
+
+#include <stddef.h>
+
+#if (IP_NAPT_HASH_SIZE & (IP_NAPT_HASH_SIZE - 1)) != 0
+#error "IP_NAPT_HASH_SIZE must be a power of 2"
+#endif
+#if (IP_NAPT_MAX < 1) || (IP_NAPT_MAX > 0xfffe)
+#error "IP_NAPT_MAX must be in 1..0xfffe"
+#endif
+#if IP_NAPT_PORT_LAST - IP_NAPT_PORT_FIRST < IP_NAPT_MAX
+#error "IP_NAPT_PORT_FIRST..IP_NAPT_PORT_LAST must hold more ports than IP_NAPT_MAX"
+#endif
+
+/** A 16 bit field of a packed header, aligned as the packet is */
+#define NAPT_FIELD(h, type, member) ((u16_t *)(void *)((u8_t *)(h) + offsetof(struct type, member)))
+
+/** End of a chain */
+#define NAPT_NONE       0xffff
+
+#define NAPT_FIN_OUT    0x01    /* FIN from the inside host */
+#define NAPT_FIN_IN     0x02    /* FIN from the remote host */
+#define NAPT_RST        0x04
+#define NAPT_REPLIED    0x08    /* a packet came back */
+
+/** A translation. Addresses and ports are in network order. */
+struct napt_entry {
+  u16_t next_in;    /* in the bucket of napt_in, or the free list */
+  u16_t next_out;   /* in the bucket of napt_out */
+  u32_t src;        /* inside host */
+  u32_t dest;       /* remote host */
+  u16_t sport;      /* port or echo identifier of the inside host */
+  u16_t dport;      /* remote port, 0 for ICMP */
+  u16_t mport;      /* outside port or echo identifier */
+  u8_t proto;
+  u8_t flags;
+  u32_t last;       /* sys_now() of the last packet */
+};
+
+static struct napt_entry napt_table[IP_NAPT_MAX];
+static u16_t napt_in[IP_NAPT_HASH_SIZE];    /* by inside tuple */
+static u16_t napt_out[IP_NAPT_HASH_SIZE];   /* by outside port */
+static u16_t napt_free;
+static u16_t napt_next_port;                /* host order */
+static struct ip4_napt_stats napt_stats;
+
+/* RFC 1624 eqn. 3: checksum after a 16 bit word of the data it covers was
+   replaced. Every value as read from the packet, the sum does not depend on
+   the byte order. */
+static u16_t
+napt_chksum_adjust(u16_t chksum, u16_t from, u16_t to)
+{
+  u32_t sum = (u32_t)(u16_t)~chksum + (u16_t)~from + to;
+
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return (u16_t)~sum;
+}
+
+static u16_t
+napt_chksum_adjust32(u16_t chksum, u32_t from, u32_t to)
+{
+  chksum = napt_chksum_adjust(chksum, (u16_t)(from >> 16), (u16_t)(to >> 16));
+  return napt_chksum_adjust(chksum, (u16_t)from, (u16_t)to);
+}
+
+static u16_t
+napt_hash_in(u8_t proto, u32_t src, u16_t sport, u32_t dest, u16_t dport)
+{
+  u32_t h = src ^ dest ^ (((u32_t)sport << 16) | dport) ^ proto;
+
+  h ^= h >> 16;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 16;
+  return (u16_t)(h & (IP_NAPT_HASH_SIZE - 1));
+}
+
+/* The outside ports are handed out in sequence */
+#define napt_hash_out(mport) ((u16_t)(lwip_ntohs(mport) & (IP_NAPT_HASH_SIZE - 1)))
+
+static u32_t
+napt_timeout(const struct napt_entry *e)
+{
+  switch (e->proto) {
+    case IP_PROTO_TCP:
+      if ((e->flags & NAPT_RST) || !(e->flags & NAPT_REPLIED) ||
+          ((e->flags & (NAPT_FIN_OUT | NAPT_FIN_IN)) == (NAPT_FIN_OUT | NAPT_FIN_IN))) {
+        return IP_NAPT_TMOT_TCP_CLOSED;
+      }
+      return IP_NAPT_TMOT_TCP;
+    case IP_PROTO_UDP:
+      return IP_NAPT_TMOT_UDP;
+    default:
+      return IP_NAPT_TMOT_ICMP;
+  }
+}
+
+#define napt_expired(e, now) ((u32_t)((now) - (e)->last) > napt_timeout(e))
+
+/* Unlinks entry i from both tables and puts it on the free list */
+static void
+napt_remove(u16_t i)
+{
+  struct napt_entry *e = &napt_table[i];
+  u16_t *pos;
+
+  for (pos = &napt_in[napt_hash_in(e->proto, e->src, e->sport, e->dest, e->dport)];
+       *pos != i; pos = &napt_table[*pos].next_in) {
+  }
+  *pos = e->next_in;
+  for (pos = &napt_out[napt_hash_out(e->mport)]; *pos != i; pos = &napt_table[*pos].next_out) {
+  }
+  *pos = e->next_out;
+
+  e->next_in = napt_free;
+  napt_free = i;
+  napt_stats.used--;
+}
+
+/* The translation of a packet from the inside, NAPT_NONE if there is none
+   or it expired */
+static u16_t
+napt_find_in(u8_t proto, u32_t src, u16_t sport, u32_t dest, u16_t dport, u32_t now)
+{
+  struct napt_entry *e;
+  u16_t i;
+
+  for (i = napt_in[napt_hash_in(proto, src, sport, dest, dport)]; i != NAPT_NONE; i = e->next_in) {
+    e = &napt_table[i];
+    if ((e->src == src) && (e->dest == dest) && (e->sport == sport) && (e->dport == dport) && (e->proto == proto)) {
+      if (napt_expired(e, now)) {
+        napt_stats.expired++;
+        napt_remove(i);
+        return NAPT_NONE;
+      }
+      return i;
+    }
+  }
+  return NAPT_NONE;
+}
+
+/* The translation holding an outside port, NAPT_NONE if there is none or
+   it expired */
+static u16_t
+napt_find_out(u8_t proto, u16_t mport, u32_t now)
+{
+  struct napt_entry *e;
+  u16_t i;
+
+  for (i = napt_out[napt_hash_out(mport)]; i != NAPT_NONE; i = e->next_out) {
+    e = &napt_table[i];
+    if ((e->mport == mport) && (e->proto == proto)) {
+      if (napt_expired(e, now)) {
+        napt_stats.expired++;
+        napt_remove(i);
+        return NAPT_NONE;
+      }
+      return i;
+    }
+  }
+  return NAPT_NONE;
+}
+
+/* A free entry, the one idle the longest if the table is full */
+static u16_t
+napt_alloc(u32_t now)
+{
+  u16_t i, oldest = 0;
+  u32_t age, max_age = 0;
+
+  if (napt_free == NAPT_NONE) {
+    for (i = 0; i < IP_NAPT_MAX; i++) {
+      age = now - napt_table[i].last;
+      if (age > napt_timeout(&napt_table[i])) {
+        oldest = i;
+        napt_stats.expired++;
+        break;
+      }
+      if (age >= max_age) {
+        max_age = age;
+        oldest = i;
+      }
+    }
+    if (i == IP_NAPT_MAX) {
+      napt_stats.recycled++;
+    }
+    napt_remove(oldest);
+  }
+
+  i = napt_free;
+  napt_free = napt_table[i].next_in;
+  return i;
+}
+
+/* An outside port no translation of proto holds. There is always one: the
+   range is larger than the table. */
+static u16_t
+napt_port(u8_t proto, u32_t now)
+{
+  u16_t port;
+
+  do {
+    port = lwip_htons(napt_next_port);
+    napt_next_port = (napt_next_port == IP_NAPT_PORT_LAST) ? IP_NAPT_PORT_FIRST : (u16_t)(napt_next_port + 1);
+  } while (napt_find_out(proto, port, now) != NAPT_NONE);
+  return port;
+}
+
+void
+ip4_napt_init(void)
+{
+  u16_t i;
+
+  for (i = 0; i < IP_NAPT_HASH_SIZE; i++) {
+    napt_in[i] = NAPT_NONE;
+    napt_out[i] = NAPT_NONE;
+  }
+  for (i = 0; i < IP_NAPT_MAX; i++) {
+    napt_table[i].next_in = (u16_t)(i + 1);
+  }
+  napt_table[IP_NAPT_MAX - 1].next_in = NAPT_NONE;
+  napt_free = 0;
+  napt_next_port = IP_NAPT_PORT_FIRST;
+}
+
+/**
+ * The hosts behind inside reach the other interfaces with their address,
+ * e.g. the LAN through the LTE uplink. Call from the tcpip thread.
+ */
+void
+ip4_napt_enable(struct netif *inside, u8_t enable)
+{
+  inside->napt = (u8_t)(enable != 0);
+}
+
+void
+ip4_napt_get_stats(struct ip4_napt_stats *stats)
+{
+  *stats = napt_stats;
+}
+
+/**
+ * Translates a packet from the inside that ip4_forward() sends out of outp:
+ * its source becomes the address of outp and an outside port.
+ *
+ * @return ERR_OK, ERR_VAL if the packet can't be translated and must be
+ *         dropped
+ */
+err_t
+ip4_napt_output(struct pbuf *p, struct ip_hdr *iphdr, struct netif *outp)
+{
+  u16_t hlen = (u16_t)(IPH_HL(iphdr) * 4);
+  u8_t proto = IPH_PROTO(iphdr);
+  u8_t *th = (u8_t *)iphdr + hlen;
+  u16_t *sport, *chksum;
+  u16_t dport = 0;
+  u32_t src, dest, now;
+  struct napt_entry *e;
+  u16_t i, h;
+
+  if (ip4_addr_isany_val(*netif_ip4_addr(outp)) || ((IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK)) != 0)) {
+    goto drop;
+  }
+
+  switch (proto) {
+    case IP_PROTO_TCP:
+      if (p->len < hlen + TCP_HLEN) {
+        goto drop;
+      }
+      sport = NAPT_FIELD(th, tcp_hdr, src);
+      dport = ((struct tcp_hdr *)th)->dest;
+      chksum = NAPT_FIELD(th, tcp_hdr, chksum);
+      break;
+    case IP_PROTO_UDP:
+      if (p->len < hlen + UDP_HLEN) {
+        goto drop;
+      }
+      sport = NAPT_FIELD(th, udp_hdr, src);
+      dport = ((struct udp_hdr *)th)->dest;
+      chksum = NAPT_FIELD(th, udp_hdr, chksum);
+      break;
+    case IP_PROTO_ICMP:
+      if ((p->len < hlen + sizeof(struct icmp_echo_hdr)) || (ICMPH_TYPE((struct icmp_echo_hdr *)th) != ICMP_ECHO)) {
+        /* Errors from the inside would give its address away */
+        goto drop;
+      }
+      sport = NAPT_FIELD(th, icmp_echo_hdr, id);
+      chksum = NAPT_FIELD(th, icmp_echo_hdr, chksum);
+      break;
+    default:
+      goto drop;
+  }
+
+  src = iphdr->src.addr;
+  dest = iphdr->dest.addr;
+  now = sys_now();
+
+  i = napt_find_in(proto, src, *sport, dest, dport, now);
+  if (i == NAPT_NONE) {
+    i = napt_alloc(now);
+    e = &napt_table[i];
+    e->src = src;
+    e->dest = dest;
+    e->sport = *sport;
+    e->dport = dport;
+    e->proto = proto;
+    e->flags = 0;
+    e->mport = napt_port(proto, now);
+
+    h = napt_hash_in(proto, src, e->sport, dest, dport);
+    e->next_in = napt_in[h];
+    napt_in[h] = i;
+    h = napt_hash_out(e->mport);
+    e->next_out = napt_out[h];
+    napt_out[h] = i;
+
+    napt_stats.created++;
+    if (++napt_stats.used > napt_stats.max) {
+      napt_stats.max = napt_stats.used;
+    }
+  }
+  e = &napt_table[i];
+  e->last = now;
+
+  if (proto == IP_PROTO_TCP) {
+    u8_t flags = TCPH_FLAGS((struct tcp_hdr *)th);
+    if ((flags & (TCP_SYN | TCP_ACK)) == TCP_SYN) {
+      /* The inside host reuses the ports of a closed connection */
+      e->flags = 0;
+    }
+    e->flags |= ((flags & TCP_FIN) ? NAPT_FIN_OUT : 0) | ((flags & TCP_RST) ? NAPT_RST : 0);
+  }
+
+  /* Rewrite in place: the IP header sums the address, TCP and UDP the
+     address in their pseudo header and the port, ICMP the identifier */
+  IPH_CHKSUM_SET(iphdr, napt_chksum_adjust32(IPH_CHKSUM(iphdr), src, netif_ip4_addr(outp)->addr));
+  if ((proto != IP_PROTO_UDP) || (*chksum != 0)) {
+    if (proto != IP_PROTO_ICMP) {
+      *chksum = napt_chksum_adjust32(*chksum, src, netif_ip4_addr(outp)->addr);
+    }
+    *chksum = napt_chksum_adjust(*chksum, *sport, e->mport);
+    if ((proto == IP_PROTO_UDP) && (*chksum == 0)) {
+      *chksum = 0xffff;
+    }
+  }
+  ip4_addr_copy(iphdr->src, *netif_ip4_addr(outp));
+  *sport = e->mport;
+
+  napt_stats.out++;
+  return ERR_OK;
+
+drop:
+  napt_stats.dropped++;
+  return ERR_VAL;
+}
+
+/* An ICMP error about a translated packet: the packet it quotes goes back
+   to the inside host's address and port, and its sums with it. Rare
+   enough to sum the message again. */
+static u8_t
+napt_input_icmp_error(struct pbuf *p, struct ip_hdr *iphdr, struct netif *inp, u8_t *th, u32_t now)
+{
+  struct ip_hdr *inner = (struct ip_hdr *)(th + sizeof(struct icmp_echo_hdr));
+  u16_t hlen = (u16_t)(IPH_HL(iphdr) * 4);
+  u16_t ihlen, ilen, *port;
+  u16_t *inner_chksum = NULL;
+  u8_t *ith;
+  struct napt_entry *e;
+  u16_t i;
+
+  if (p->len < hlen + sizeof(struct icmp_echo_hdr) + IP_HLEN) {
+    return 0;
+  }
+  ihlen = (u16_t)(IPH_HL(inner) * 4);
+  ilen = (u16_t)(lwip_ntohs(IPH_LEN(iphdr)) - hlen);
+  if ((p->len < hlen + sizeof(struct icmp_echo_hdr) + ihlen + 8) || (p->len < hlen + ilen) ||
+      (inner->src.addr != netif_ip4_addr(inp)->addr)) {
+    return 0;
+  }
+  ith = (u8_t *)inner + ihlen;
+
+  switch (IPH_PROTO(inner)) {
+    case IP_PROTO_TCP:
+      port = NAPT_FIELD(ith, tcp_hdr, src);
+      /* Most routers quote the first 8 bytes only, the sum is after them */
+      if (hlen + sizeof(struct icmp_echo_hdr) + ihlen + offsetof(struct tcp_hdr, chksum) + 2 <= hlen + ilen) {
+        inner_chksum = NAPT_FIELD(ith, tcp_hdr, chksum);
+      }
+      break;
+    case IP_PROTO_UDP:
+      port = NAPT_FIELD(ith, udp_hdr, src);
+      inner_chksum = NAPT_FIELD(ith, udp_hdr, chksum);
+      if (*inner_chksum == 0) {
+        inner_chksum = NULL;
+      }
+      break;
+    case IP_PROTO_ICMP:
+      if (ICMPH_TYPE((struct icmp_echo_hdr *)ith) != ICMP_ECHO) {
+        return 0;
+      }
+      port = NAPT_FIELD(ith, icmp_echo_hdr, id);
+      inner_chksum = NAPT_FIELD(ith, icmp_echo_hdr, chksum);
+      break;
+    default:
+      return 0;
+  }
+
+  i = napt_find_out(IPH_PROTO(inner), *port, now);
+  if ((i == NAPT_NONE) || (napt_table[i].dest != inner->dest.addr)) {
+    return 0;
+  }
+  e = &napt_table[i];
+
+  /* The quoted transport sum covers the port and, but for ICMP, the
+     address through the pseudo header */
+  if (inner_chksum != NULL) {
+    if (IPH_PROTO(inner) != IP_PROTO_ICMP) {
+      *inner_chksum = napt_chksum_adjust32(*inner_chksum, inner->src.addr, e->src);
+    }
+    *inner_chksum = napt_chksum_adjust(*inner_chksum, *port, e->sport);
+    if ((IPH_PROTO(inner) == IP_PROTO_UDP) && (*inner_chksum == 0)) {
+      *inner_chksum = 0xffff;
+    }
+  }
+  *port = e->sport;
+  IPH_CHKSUM_SET(inner, napt_chksum_adjust32(IPH_CHKSUM(inner), inner->src.addr, e->src));
+  inner->src.addr = e->src;
+
+  ((struct icmp_echo_hdr *)th)->chksum = 0;
+  ((struct icmp_echo_hdr *)th)->chksum = inet_chksum(th, ilen);
+
+  IPH_CHKSUM_SET(iphdr, napt_chksum_adjust32(IPH_CHKSUM(iphdr), iphdr->dest.addr, e->src));
+  iphdr->dest.addr = e->src;
+
+  napt_stats.in++;
+  return 1;
+}
+
+/**
+ * Translates back a packet for us that came in on inp, reassembled: if it
+ * answers a translation, its destination becomes the inside host's
+ * address and port, and ip4_input() forwards it.
+ *
+ * @return 1 if the packet was translated, 0 if it is for us
+ */
+u8_t
+ip4_napt_input(struct pbuf *p, struct ip_hdr *iphdr, struct netif *inp)
+{
+  u16_t hlen = (u16_t)(IPH_HL(iphdr) * 4);
+  u8_t proto = IPH_PROTO(iphdr);
+  u8_t *th = (u8_t *)iphdr + hlen;
+  u16_t *dport, *chksum;
+  u16_t sport = 0;
+  u32_t now;
+  struct napt_entry *e;
+  u16_t i;
+
+  if (inp->napt || (iphdr->dest.addr != netif_ip4_addr(inp)->addr)) {
+    return 0;
+  }
+
+  switch (proto) {
+    case IP_PROTO_TCP:
+      if (p->len < hlen + TCP_HLEN) {
+        return 0;
+      }
+      sport = ((struct tcp_hdr *)th)->src;
+      dport = NAPT_FIELD(th, tcp_hdr, dest);
+      chksum = NAPT_FIELD(th, tcp_hdr, chksum);
+      break;
+    case IP_PROTO_UDP:
+      if (p->len < hlen + UDP_HLEN) {
+        return 0;
+      }
+      sport = ((struct udp_hdr *)th)->src;
+      dport = NAPT_FIELD(th, udp_hdr, dest);
+      chksum = NAPT_FIELD(th, udp_hdr, chksum);
+      break;
+    case IP_PROTO_ICMP:
+      if (p->len < hlen + sizeof(struct icmp_echo_hdr)) {
+        return 0;
+      }
+      switch (ICMPH_TYPE((struct icmp_echo_hdr *)th)) {
+        case ICMP_ER:
+          dport = NAPT_FIELD(th, icmp_echo_hdr, id);
+          chksum = NAPT_FIELD(th, icmp_echo_hdr, chksum);
+          break;
+        case ICMP_DUR:
+        case ICMP_TE:
+          return napt_input_icmp_error(p, iphdr, inp, th, sys_now());
+        default:
+          return 0;
+      }
+      break;
+    default:
+      return 0;
+  }
+
+  /* The local connections have ports outside of the range */
+  if ((lwip_ntohs(*dport) < IP_NAPT_PORT_FIRST) || (lwip_ntohs(*dport) > IP_NAPT_PORT_LAST)) {
+    return 0;
+  }
+
+  now = sys_now();
+  i = napt_find_out(proto, *dport, now);
+  if (i == NAPT_NONE) {
+    return 0;
+  }
+  e = &napt_table[i];
+  if ((e->dest != iphdr->src.addr) || (e->dport != sport)) {
+    /* Only the remote host and port it was opened to may answer */
+    return 0;
+  }
+  e->last = now;
+  e->flags |= NAPT_REPLIED;
+  if (proto == IP_PROTO_TCP) {
+    u8_t flags = TCPH_FLAGS((struct tcp_hdr *)th);
+    e->flags |= ((flags & TCP_FIN) ? NAPT_FIN_IN : 0) | ((flags & TCP_RST) ? NAPT_RST : 0);
+  }
+
+  IPH_CHKSUM_SET(iphdr, napt_chksum_adjust32(IPH_CHKSUM(iphdr), iphdr->dest.addr, e->src));
+  if ((proto != IP_PROTO_UDP) || (*chksum != 0)) {
+    if (proto != IP_PROTO_ICMP) {
+      *chksum = napt_chksum_adjust32(*chksum, iphdr->dest.addr, e->src);
+    }
+    *chksum = napt_chksum_adjust(*chksum, *dport, e->sport);
+    if ((proto == IP_PROTO_UDP) && (*chksum == 0)) {
+      *chksum = 0xffff;
+    }
+  }
+  iphdr->dest.addr = e->src;
+  *dport = e->sport;
+
+  napt_stats.in++;
+  return 1;
+}
+
+#endif /* LWIP_IPV4 && IP_NAPT */
@@ -129,6 +129,13 @@ struct tcp_pcb *tcp_tw_pcbs;
 struct tcp_pcb ** const tcp_pcb_lists[] = {&tcp_listen_pcbs.pcbs, &tcp_bound_pcbs,
   &tcp_active_pcbs, &tcp_tw_pcbs};
 
+#if TCP_PCB_HASH_SIZE
+/** tcp_active_pcbs and tcp_tw_pcbs by address and ports */
+struct tcp_pcb *tcp_pcb_hash[TCP_PCB_HASH_SIZE];
+/** tcp_listen_pcbs by local port */
+union tcp_listen_pcbs_t tcp_listen_hash[TCP_PCB_HASH_SIZE];
+#endif /* TCP_PCB_HASH_SIZE */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -149,6 +156,74 @@ tcp_init(void)
 #endif /* LWIP_RANDOMIZE_INITIAL_LOCAL_PORTS && defined(LWIP_RAND) */
 }
 
+#if TCP_PCB_HASH_SIZE
+/**
+ * Bucket of tcp_pcb_hash for a connection. The remote address is enough to
+ * spread them: a device has few local addresses.
+ */
+u16_t
+tcp_pcb_hash_index(const ip_addr_t *remote_ip, u16_t remote_port, u16_t local_port)
+{
+  u32_t h = ((u32_t)remote_port << 16) | local_port;
+
+#if LWIP_IPV6
+  if (IP_IS_V6(remote_ip)) {
+    h ^= ip_2_ip6(remote_ip)->addr[3];
+  } else
+#endif /* LWIP_IPV6 */
+  {
+#if LWIP_IPV4
+    h ^= ip4_addr_get_u32(ip_2_ip4(remote_ip));
+#endif /* LWIP_IPV4 */
+  }
+  h ^= h >> 16;
+  h ^= h >> 8;
+  return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+/** The bucket a PCB of the list pcbs goes to, NULL for tcp_bound_pcbs */
+static struct tcp_pcb **
+tcp_hash_bucket(struct tcp_pcb **pcbs, const struct tcp_pcb *pcb)
+{
+  if (pcbs == &tcp_listen_pcbs.pcbs) {
+    return &tcp_listen_hash[TCP_LISTEN_HASH(pcb->local_port)].pcbs;
+  }
+  if ((pcbs == &tcp_active_pcbs) || (pcbs == &tcp_tw_pcbs)) {
+    return &tcp_pcb_hash[tcp_pcb_hash_index(&pcb->remote_ip, pcb->remote_port, pcb->local_port)];
+  }
+  return NULL;
+}
+
+/** Called by TCP_REG once pcb is on the list pcbs */
+void
+tcp_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **bucket = tcp_hash_bucket(pcbs, pcb);
+
+  if (bucket != NULL) {
+    pcb->hash_next = *bucket;
+    *bucket = pcb;
+  }
+}
+
+/** Called by TCP_RMV and wherever a PCB is unlinked from pcbs by hand */
+void
+tcp_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **bucket = tcp_hash_bucket(pcbs, pcb);
+
+  if (bucket != NULL) {
+    for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+      if (*bucket == pcb) {
+        *bucket = pcb->hash_next;
+        break;
+      }
+    }
+  }
+  pcb->hash_next = NULL;
+}
+#endif /* TCP_PCB_HASH_SIZE */
+
 /**
  * Called periodically to dispatch TCP timers.
  */
@@ -1053,30 +1128,34 @@ tcp_slowtmr_start:
                                       " pcb->rto %"S16_F"\n",
                                       pcb->rtime, pcb->rto));
 
-          /* Double retransmission time-out unless we are trying to
-           * connect to somebody (i.e., we are in SYN_SENT). */
-          if (pcb->state != SYN_SENT) {
-            u8_t backoff_idx = LWIP_MIN(pcb->nrtx, sizeof(tcp_backoff)-1);
-            pcb->rto = ((pcb->sa >> 3) + pcb->sv) << tcp_backoff[backoff_idx];
-          }
+          /* Requeue the unacked segments first: if the netif driver still
+             holds one, nothing changes and the next tick tries again */
+          if (tcp_rexmit_rto_prepare(pcb) == ERR_OK) {
+            /* Double retransmission time-out unless we are trying to
+             * connect to somebody (i.e., we are in SYN_SENT). */
+            if (pcb->state != SYN_SENT) {
+              u8_t backoff_idx = LWIP_MIN(pcb->nrtx, sizeof(tcp_backoff)-1);
+              pcb->rto = ((pcb->sa >> 3) + pcb->sv) << tcp_backoff[backoff_idx];
+            }
 
-          /* Reset the retransmission timer. */
-          pcb->rtime = 0;
+            /* Reset the retransmission timer. */
+            pcb->rtime = 0;
 
-          /* Reduce congestion window and ssthresh. */
-          eff_wnd = LWIP_MIN(pcb->cwnd, pcb->snd_wnd);
-          pcb->ssthresh = eff_wnd >> 1;
-          if (pcb->ssthresh < (tcpwnd_size_t)(pcb->mss << 1)) {
-            pcb->ssthresh = (pcb->mss << 1);
+            /* Reduce congestion window and ssthresh. */
+            eff_wnd = LWIP_MIN(pcb->cwnd, pcb->snd_wnd);
+            pcb->ssthresh = eff_wnd >> 1;
+            if (pcb->ssthresh < (tcpwnd_size_t)(pcb->mss << 1)) {
+              pcb->ssthresh = (pcb->mss << 1);
+            }
+            pcb->cwnd = pcb->mss;
+            LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %"TCPWNDSIZE_F
+                                         " ssthresh %"TCPWNDSIZE_F"\n",
+                                         pcb->cwnd, pcb->ssthresh));
+
+            /* The following needs to be called AFTER cwnd is set to one
+               mss - STJ */
+            tcp_rexmit_rto_commit(pcb);
           }
-          pcb->cwnd = pcb->mss;
-          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %"TCPWNDSIZE_F
-                                       " ssthresh %"TCPWNDSIZE_F"\n",
-                                       pcb->cwnd, pcb->ssthresh));
-
-          /* The following needs to be called AFTER cwnd is set to one
-             mss - STJ */
-          tcp_rexmit_rto(pcb);
         }
       }
     }
@@ -1156,6 +1235,7 @@ tcp_slowtmr_start:
       void *err_arg;
       enum tcp_state last_state;
       tcp_pcb_purge(pcb);
+      TCP_HASH_RMV(&tcp_active_pcbs, pcb);
       /* Remove PCB from tcp_active_pcbs list. */
       if (prev != NULL) {
         LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_active_pcbs", pcb != tcp_active_pcbs);
@@ -1222,6 +1302,7 @@ tcp_slowtmr_start:
     if (pcb_remove) {
       struct tcp_pcb *pcb2;
       tcp_pcb_purge(pcb);
+      TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
       /* Remove PCB from tcp_tw_pcbs list. */
       if (prev != NULL) {
         LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_tw_pcbs", pcb != tcp_tw_pcbs);
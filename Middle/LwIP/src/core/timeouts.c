@@ -348,7 +348,11 @@ sys_check_timeouts(void)
              timeout handler function. */
           LOCK_TCPIP_CORE();
 #endif /* !NO_SYS */
-          handler(arg);
+          {
+            PERF_START;
+            handler(arg);
+            PERF_STOP("timers");
+          }
 #if !NO_SYS
           UNLOCK_TCPIP_CORE();
 #endif /* !NO_SYS */
@@ -80,6 +80,43 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
 
+#if UDP_PCB_HASH_SIZE
+/* udp_pcbs by local port: a PCB is in the bucket of its port while it is
+   on the list */
+static struct udp_pcb *udp_pcb_hash[UDP_PCB_HASH_SIZE];
+
+#define UDP_PCB_HASH(port)      ((u16_t)((port) ^ ((port) >> 8)) & (UDP_PCB_HASH_SIZE - 1))
+
+static void
+udp_hash_reg(struct udp_pcb *pcb)
+{
+  struct udp_pcb **bucket = &udp_pcb_hash[UDP_PCB_HASH(pcb->local_port)];
+
+  pcb->hash_next = *bucket;
+  *bucket = pcb;
+}
+
+static void
+udp_hash_rmv(struct udp_pcb *pcb)
+{
+  struct udp_pcb **bucket;
+
+  for (bucket = &udp_pcb_hash[UDP_PCB_HASH(pcb->local_port)]; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+    if (*bucket == pcb) {
+      *bucket = pcb->hash_next;
+      break;
+    }
+  }
+  pcb->hash_next = NULL;
+}
+
+#define UDP_HASH_REG(pcb)       udp_hash_reg(pcb)
+#define UDP_HASH_RMV(pcb)       udp_hash_rmv(pcb)
+#else /* UDP_PCB_HASH_SIZE */
+#define UDP_HASH_REG(pcb)
+#define UDP_HASH_RMV(pcb)
+#endif /* UDP_PCB_HASH_SIZE */
+
 /**
  * Initialize this module.
  */
@@ -236,7 +273,11 @@ udp_input(struct pbuf *p, struct netif *inp)
    * 'Perfect match' pcbs (connected to the remote port & ip address) are
    * preferred. If no perfect match is found, the first unconnected pcb that
    * matches the local port and ip address gets the datagram. */
+#if UDP_PCB_HASH_SIZE
+  for (pcb = udp_pcb_hash[UDP_PCB_HASH(dest)]; pcb != NULL; pcb = pcb->hash_next) {
+#else /* UDP_PCB_HASH_SIZE */
   for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* UDP_PCB_HASH_SIZE */
     /* print the PCB local and remote address */
     LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
     ip_addr_debug_print(UDP_DEBUG, &pcb->local_ip);
@@ -264,11 +305,13 @@ udp_input(struct pbuf *p, struct netif *inp)
           ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
         /* the first fully matching PCB */
         if (prev != NULL) {
+#if !UDP_PCB_HASH_SIZE
           /* move the pcb to the front of udp_pcbs so that is
              found faster next time */
           prev->next = pcb->next;
           pcb->next = udp_pcbs;
           udp_pcbs = pcb;
+#endif /* !UDP_PCB_HASH_SIZE */
         } else {
           UDP_STATS_INC(udp.cachehit);
         }
@@ -945,7 +988,12 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
   ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+  if (rebind) {
+    /* to the bucket of the new port */
+    UDP_HASH_RMV(pcb);
+  }
   pcb->local_port = port;
+  UDP_HASH_REG(pcb);
   mib2_udp_bind(pcb);
   /* pcb not active yet? */
   if (rebind == 0) {
@@ -1012,6 +1060,7 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
   /* PCB not yet on the list, add PCB now */
   pcb->next = udp_pcbs;
   udp_pcbs = pcb;
+  UDP_HASH_REG(pcb);
   return ERR_OK;
 }
 
@@ -1072,6 +1121,7 @@ udp_remove(struct udp_pcb *pcb)
   struct udp_pcb *pcb2;
 
   mib2_udp_unbind(pcb);
+  UDP_HASH_RMV(pcb);
   /* pcb to be removed is first in list? */
   if (udp_pcbs == pcb) {
     /* make list start at 2nd pcb */
@@ -52,6 +52,8 @@ struct fsdata_chksum {
 
 #define FS_FILE_FLAGS_HEADER_INCLUDED     0x01
 #define FS_FILE_FLAGS_HEADER_PERSISTENT   0x02
+/** Stored gzip-compressed by makefsdata -gzip, next to an identity copy */
+#define FS_FILE_FLAGS_GZIP                0x04
 
 struct fs_file {
   const char *data;
@@ -63,6 +65,9 @@ struct fs_file {
   u16_t chksum_count;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
   u8_t flags;
+#if LWIP_HTTPD_ETAG
+  const char *etag;
+#endif /* LWIP_HTTPD_ETAG */
 #if LWIP_HTTPD_CUSTOM_FILES
   u8_t is_custom_file;
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
@@ -76,6 +81,9 @@ typedef void (*fs_wait_cb)(void *arg);
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
 err_t fs_open(struct fs_file *file, const char *name);
+#if LWIP_HTTPD_GZIP
+err_t fs_open_identity(struct fs_file *file, const char *name);
+#endif /* LWIP_HTTPD_GZIP */
 void fs_close(struct fs_file *file);
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
 #if LWIP_HTTPD_FS_ASYNC_READ
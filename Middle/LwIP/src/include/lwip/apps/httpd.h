@@ -226,6 +226,63 @@ void httpd_post_data_recved(void *connection, u16_t recved_len);
 
 #endif /* LWIP_HTTPD_SUPPORT_POST */
 
+#if LWIP_HTTPD_STREAM
+
+struct tcp_pcb;
+
+/** State of a streamed response, passed to its handler */
+struct httpd_stream {
+  struct tcp_pcb *pcb;
+  /** Index of the next record to write, advanced by httpd_stream_printf()
+   * (or by the handler to skip one). A handler writes the records from here on and picks up at the same
+   * record when called again. */
+  u32_t record;
+  /** Number of passes completed: the id of the current event of an event
+   * stream */
+  u32_t pass;
+};
+
+/** Return values of a stream handler */
+/** The send buffer is full: call again from the same record once data has
+ * been acknowledged */
+#define HTTPD_STREAM_MORE  0
+/** The response is complete: close the connection */
+#define HTTPD_STREAM_DONE  1
+/** This pass is complete: start the next one (record 0) after the interval
+ * of the stream */
+#define HTTPD_STREAM_WAIT  2
+
+/*
+ * Function pointer for a stream handler.
+ *
+ * Called in the tcpip thread once the request for its URI is parsed and
+ * every time there is room in the send buffer until it returns
+ * HTTPD_STREAM_DONE. It writes the records from s->record on with
+ * httpd_stream_printf() and returns HTTPD_STREAM_MORE as soon as one of them
+ * does not fit.
+ */
+typedef u8_t (*tStreamHandler)(struct httpd_stream *s);
+
+/*
+ * Structure defining the URI of a stream, the Content-Type of its response
+ * and the handler writing it. A non-zero interval makes it an event stream:
+ * the handler returns HTTPD_STREAM_WAIT after each event and is called for
+ * the next one that many ms later (rounded to the 500 ms TCP timer). A
+ * client acknowledging nothing for HTTPD_MAX_RETRIES intervals is dropped.
+ */
+typedef struct
+{
+    const char *pcURI;
+    const char *pcContentType;
+    tStreamHandler pfnHandler;
+    u16_t interval;
+} tStream;
+
+void http_set_stream_handlers(const tStream *pStreams, int iNumStreams);
+err_t httpd_stream_printf(struct httpd_stream *s, const char *fmt, ...);
+
+#endif /* LWIP_HTTPD_STREAM */
+
 void httpd_init(void);
 
 
@@ -302,6 +302,37 @@
 #define HTTPD_PRECALCULATED_CHECKSUM  0
 #endif
 
+/** LWIP_HTTPD_ETAG==1: answer a GET whose If-None-Match lists the ETag
+ * makefsdata computed for the file (switch -etag) with "304 Not Modified".
+ * The response is the file's own header behind a 304 status line, sent
+ * from the file system like the file itself. */
+#if !defined LWIP_HTTPD_ETAG || defined __DOXYGEN__
+#define LWIP_HTTPD_ETAG               0
+#endif
+
+/** LWIP_HTTPD_STREAM==1: serve the URIs registered with
+ * http_set_stream_handlers() from a handler that writes its response record
+ * by record (httpd_stream_printf) straight into the TCP send buffer: JSON
+ * documents or server-sent events, of any length, without a file or a
+ * response buffer. */
+#if !defined LWIP_HTTPD_STREAM || defined __DOXYGEN__
+#define LWIP_HTTPD_STREAM             0
+#endif
+
+/** The longest record httpd_stream_printf() formats, on the stack of the
+ * tcpip thread */
+#if !defined LWIP_HTTPD_STREAM_RECORD_LEN || defined __DOXYGEN__
+#define LWIP_HTTPD_STREAM_RECORD_LEN  128
+#endif
+
+/** LWIP_HTTPD_GZIP==1: of a file makefsdata stored both gzip-compressed and
+ * as is (switch -gzip), send the compressed copy only if the request's
+ * Accept-Encoding lists gzip. Otherwise the first copy found is sent, the
+ * compressed one. */
+#if !defined LWIP_HTTPD_GZIP || defined __DOXYGEN__
+#define LWIP_HTTPD_GZIP               0
+#endif
+
 /** LWIP_HTTPD_FS_ASYNC_READ==1: support asynchronous read operations
  * (fs_read_async returns FS_READ_DELAYED and calls a callback when finished).
  */
@@ -4,13 +4,47 @@
 
 #include "lwip/err.h"
 #include "lwip/netif.h"
+#include "lwip/prot/ethernet.h"
 #include "cmsis_os.h"
 
 /* Exported types ------------------------------------------------------------*/
+/* Batched receive counters, see ETHIF_RX_BATCH */
+typedef struct
+{
+  uint32_t batches;     /* batch messages processed by the tcpip thread */
+  uint32_t frames;      /* frames delivered through them */
+  uint32_t max_batch;   /* most frames delivered by one message */
+  uint32_t mbox_full;   /* posts refused because the tcpip mailbox was full */
+}ethernetif_rx_stats_t;
+
+/* Frame filter counters, see ETHIF_MAC_FILTER_MAX and ETHIF_BCAST_LIMIT */
+typedef struct
+{
+  uint32_t broadcast;     /* broadcast frames received */
+  uint32_t multicast;     /* multicast frames the MAC filter let through */
+  uint32_t bcast_dropped; /* broadcasts dropped over ETHIF_BCAST_LIMIT */
+  uint32_t bcast_blocked; /* seconds in which the MAC discarded broadcasts */
+  uint32_t groups;        /* multicast addresses programmed in the MAC */
+  uint32_t hashed;        /* of which in the hash table rather than perfect */
+  uint32_t spilled;       /* of which past ETHIF_MAC_FILTER_MAX, hashed */
+}ethernetif_filter_stats_t;
+
 /* Exported functions ------------------------------------------------------- */
 err_t ethernetif_init(struct netif *netif);
 
 void ethernetif_update_config(struct netif *netif);
 void ethernetif_notify_conn_changed(struct netif *netif);
+void ethernetif_phy_irq(void);
+void ethernetif_get_rx_stats(ethernetif_rx_stats_t *stats);
+void ethernetif_get_filter_stats(ethernetif_filter_stats_t *stats);
+err_t ethernetif_mac_filter(const struct eth_addr *addr, enum netif_mac_filter_action action);
+#if LWIP_IGMP
+err_t ethernetif_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group,
+                                 enum netif_mac_filter_action action);
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+err_t ethernetif_mld_mac_filter(struct netif *netif, const ip6_addr_t *group,
+                                enum netif_mac_filter_action action);
+#endif
 
 #endif
@@ -0,0 +1,48 @@
+/**
+ * @file
+ * Network address and port translation of forwarded IPv4 packets
+ */
+
+#ifndef LWIP_HDR_IP4_NAPT_H
+#define LWIP_HDR_IP4_NAPT_H
+
+#include "lwip/opt.h"
+
+#if LWIP_IPV4 && IP_NAPT /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/prot/ip4.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Counters of the translation table */
+struct ip4_napt_stats {
+  u32_t out;        /* packets translated from the inside */
+  u32_t in;         /* replies translated back */
+  u32_t created;    /* translations */
+  u32_t expired;    /* translations idle for longer than their timeout */
+  u32_t recycled;   /* translations still in use taken for a new one, the table being full */
+  u32_t dropped;    /* packets forwarded from the inside that could not be translated */
+  u16_t used;       /* translations in the table */
+  u16_t max;        /* high-water mark of used */
+};
+
+void ip4_napt_init(void);
+void ip4_napt_enable(struct netif *inside, u8_t enable);
+void ip4_napt_get_stats(struct ip4_napt_stats *stats);
+
+/* Called by ip4_forward() and ip4_input() */
+err_t ip4_napt_output(struct pbuf *p, struct ip_hdr *iphdr, struct netif *outp);
+u8_t  ip4_napt_input(struct pbuf *p, struct ip_hdr *iphdr, struct netif *inp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_IPV4 && IP_NAPT */
+
+#endif /* LWIP_HDR_IP4_NAPT_H */
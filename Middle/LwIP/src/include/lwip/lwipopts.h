@@ -58,20 +58,37 @@
    byte alignment -> define MEM_ALIGNMENT to 2. */
 #define MEM_ALIGNMENT           4
 
-/* MEM_SIZE: the size of the heap memory. If the application will send
-a lot of data that needs to be copied, this should be set high. */
-#define MEM_SIZE                (4*1024)
+/* MEM_USE_POOLS==1: mem_malloc() takes its memory from the size classes
+   listed in lwippools.h instead of a MEM_SIZE heap. Allocation is O(1) and
+   copied TCP segments can no longer fragment the heap into pieces too small
+   for the next one. */
+#define MEM_USE_POOLS           1
+#define MEMP_USE_CUSTOM_POOLS   1
+/* MEM_USE_POOLS_TRY_BIGGER_POOL==1: an exhausted class borrows from the
+   next bigger one. */
+#define MEM_USE_POOLS_TRY_BIGGER_POOL 1
 
 /* MEMP_NUM_PBUF: the number of memp struct pbufs. If the application
    sends a lot of data out of ROM (or other static memory), this
-   should be set high. */
-#define MEMP_NUM_PBUF           4
+   should be set high. The log stream is sent in place from its ring
+   (Library/myLib/systemNetLog.c): up to one per queued segment. */
+#define MEMP_NUM_PBUF           TCP_SND_QUEUELEN
 /* MEMP_NUM_UDP_PCB: the number of UDP protocol control blocks. One
    per active UDP "connection". */
 #define MEMP_NUM_UDP_PCB        6
 /* MEMP_NUM_TCP_PCB: the number of simulatenously active TCP
    connections. */
 #define MEMP_NUM_TCP_PCB        10
+/* NETSRV_CONN_MAX: connections served at once by the connection server
+   (Library/myLib/systemNetServer.h). */
+#ifndef NETSRV_CONN_MAX
+#define NETSRV_CONN_MAX         4
+#endif
+/* MEMP_NUM_NETCONN: the number of struct netconns: the UDP echo server,
+   the log sender, the echo listener, NETSRV_CONN_MAX connections of the
+   connection server and TCP_DEFAULT_LISTEN_BACKLOG more waiting to be
+   accepted, each of which holds one from the SYN on. */
+#define MEMP_NUM_NETCONN        (3 + NETSRV_CONN_MAX + TCP_DEFAULT_LISTEN_BACKLOG)
 /* MEMP_NUM_TCP_PCB_LISTEN: the number of listening TCP
    connections. */
 #define MEMP_NUM_TCP_PCB_LISTEN 5
@@ -79,19 +96,94 @@ a lot of data that needs to be copied, this should be set high. */
    segments. */
 #define MEMP_NUM_TCP_SEG        8
 /* MEMP_NUM_SYS_TIMEOUT: the number of simulateously active
-   timeouts. */
-#define MEMP_NUM_SYS_TIMEOUT    10
-
+   timeouts: the stack's, 6 for the PPP link and 1 for the link manager. */
+#define MEMP_NUM_SYS_TIMEOUT    16
+/* TCP_PCB_HASH_SIZE, UDP_PCB_HASH_SIZE: tcp_input() and udp_input() find
+   the PCB of a segment in a bucket instead of walking every PCB, so the
+   cost does not grow with MEMP_NUM_TCP_PCB/MEMP_NUM_UDP_PCB. One pointer
+   per bucket and per PCB. */
+#define TCP_PCB_HASH_SIZE       16
+#define UDP_PCB_HASH_SIZE       8
+
+
+/* ---------- Ethernet driver options ---------- */
+/* ETHIF_RX_ZERO_COPY==1: received frames are passed to the stack in the DMA
+   buffer they landed in, wrapped in a custom pbuf. The buffer goes back to the
+   descriptor ring when the pbuf is freed. */
+#define ETHIF_RX_ZERO_COPY      1
+/* ETHIF_RX_REFILL_NB: spare DMA buffers used to re-arm a descriptor while the
+   stack still holds its frame. Past that many frames held (recvmboxes,
+   reassembly, netsrv), the driver copies into PBUF_POOL and re-arms the
+   descriptor with the frame's own buffer: the ring never waits on the
+   stack, a full pool drops frames instead (link.memerr). */
+#define ETHIF_RX_REFILL_NB      4
+/* ETHIF_TX_ZERO_COPY==1: the Tx descriptors point straight at the pbufs of
+   an outgoing frame, which stay referenced until the DMA has sent them.
+   Frames are queued while all descriptors are in use. */
+#define ETHIF_TX_ZERO_COPY      1
+/* ETHIF_TX_QUEUE_LEN: frames queued waiting for free Tx descriptors. */
+#define ETHIF_TX_QUEUE_LEN      8
+/* ETHIF_RX_BATCH==1: the interface thread drains every ready frame and hands
+   them to the tcpip thread in one mailbox message instead of one each. */
+#define ETHIF_RX_BATCH          1
+/* ETHIF_RX_BATCH_MAX: most frames per message, a power of two. */
+#define ETHIF_RX_BATCH_MAX      8
+/* ETHIF_LINK_POLL_MS: period at which the interface thread reads the PHY
+   status. The link comes up, and the MAC follows the negotiated mode, at the
+   first check after the negotiation ends; nothing ever waits for it. */
+#define ETHIF_LINK_POLL_MS      250
+/* ETHIF_LINK_PHY_IRQ==1: the PHY nINT pin is wired to an EXTI line whose
+   handler calls ethernetif_phy_irq(), link changes are seen at once. */
+#define ETHIF_LINK_PHY_IRQ      0
+/* ETHIF_MAC_FILTER_MAX: multicast MAC addresses the driver keeps for the
+   groups lwIP joins. Three go in the perfect filters, the rest in the hash
+   table; past the limit a join is only counted by its hash index, still in
+   the hash table. */
+#define ETHIF_MAC_FILTER_MAX    16
+/* ETHIF_BCAST_LIMIT: broadcast frames accepted per second, the MAC discards
+   the others until the second is over. 0 accepts them all. */
+#define ETHIF_BCAST_LIMIT       0
+
+#if ETHIF_RX_ZERO_COPY
+#define LWIP_SUPPORT_CUSTOM_PBUF 1
+#endif
 
 /* ---------- Pbuf options ---------- */
-/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
+/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. In zero-copy mode
+   received frames only use the pool while ETHIF_RX_REFILL_NB frames are
+   held, the refill pool takes the rest of its RAM. */
+#if ETHIF_RX_ZERO_COPY
+#define PBUF_POOL_SIZE          4
+#else
 #define PBUF_POOL_SIZE          8
+#endif
 
 /* PBUF_POOL_BUFSIZE: the size of each pbuf in the pbuf pool. */
 #define PBUF_POOL_BUFSIZE       1524
 
 /* ---------- IPv4 options ---------- */
 #define LWIP_IPV4                1
+/* IP_FORWARD, IP_NAPT: the hosts on the Ethernet port reach the internet
+   through the LTE uplink with its address (ip4_napt_enable() in
+   User/test_lwip_seq_api.c). 64 translations of 24 bytes. */
+#define IP_FORWARD               1
+#define IP_NAPT                  1
+#define IP_NAPT_MAX              64
+#define IP_NAPT_HASH_SIZE        32
+
+/* ---------- ARP options ---------- */
+/* ARP_TABLE_SIZE: neighbours cached, 24 bytes each, the hosts of the
+   Ethernet port and the gateway. ARP_HASH_SIZE: buckets
+   they are looked up in by IP address, sending and receiving do not scan
+   the table; only recycling an entry when it is full does. */
+#define ARP_TABLE_SIZE          64
+#define ARP_HASH_SIZE           32
+/* ETHARP_REFRESH_USED==1: the entries in use are confirmed by unicast before
+   they expire, the peers of a steady connection never go unresolved. */
+#define ETHARP_REFRESH_USED     1
+/* ETHARP_SUPPORT_STATIC_ENTRIES==1: etharp_add_static_entry() pins the
+   address of a critical peer, it is never aged nor recycled. */
+#define ETHARP_SUPPORT_STATIC_ENTRIES 1
 
 /* ---------- TCP options ---------- */
 #define LWIP_TCP                1
@@ -115,10 +207,22 @@ a lot of data that needs to be copied, this should be set high. */
 /* TCP receive window. */
 #define TCP_WND                 (2*TCP_MSS)
 
+/* TCP_LISTEN_BACKLOG: a listener answers no more SYNs than it has netconns
+   left for (MEMP_NUM_NETCONN), below what its accept mailbox holds: the
+   connections of a burst beyond it are retried by their clients instead of
+   being aborted once established. */
+#define TCP_LISTEN_BACKLOG      1
+#define TCP_DEFAULT_LISTEN_BACKLOG 2
+
 
 /* ---------- ICMP options ---------- */
 #define LWIP_ICMP                       1
 
+/* ---------- RAW options ---------- */
+/* LWIP_RAW==1: the link manager probes the uplinks with its own echo
+   requests (User/app_linkmgr.c). */
+#define LWIP_RAW                        1
+
 
 /* ---------- DHCP options ---------- */
 #define LWIP_DHCP               1
@@ -129,8 +233,37 @@ a lot of data that needs to be copied, this should be set high. */
 #define UDP_TTL                 255
 
 
+/* ---------- Profiling options ---------- */
+/* LWIP_PERF==1: instrumented build. PERF_START/PERF_STOP time the input,
+   output, TCP and timer paths on the DWT cycle counter (arch/perf.h) and
+   every protocol keeps its LWIP_STATS counters. Set LWIP_PERF=1 in the
+   compiler defines of the target to build it. */
+#ifndef LWIP_PERF
+#define LWIP_PERF               0
+#endif
+/* LWIP_PERF_DUMP_INTERVAL: ms between two dumps of the perf histograms and
+   stats_display() to the log, started by perf_dump_start() */
+#define LWIP_PERF_DUMP_INTERVAL 10000
+
 /* ---------- Statistics options ---------- */
-#define LWIP_STATS 0
+#define LWIP_STATS              1
+#define LWIP_STATS_DISPLAY      1
+#if !LWIP_PERF
+/* Pool statistics only: used, high-water mark (max) and failures of every
+   memp pool, the lwippools.h size classes included. stats_display() prints
+   them to the log. */
+#define MEM_STATS               0
+#define MEMP_STATS              1
+#define LINK_STATS              0
+#define ETHARP_STATS            0
+#define IP_STATS                0
+#define IPFRAG_STATS            0
+#define ICMP_STATS              0
+#define IGMP_STATS              0
+#define UDP_STATS               0
+#define TCP_STATS               0
+#define SYS_STATS               0
+#endif /* !LWIP_PERF */
 
 /* ---------- link callback options ---------- */
 /* LWIP_NETIF_LINK_CALLBACK==1: Support a callback function from an interface
@@ -152,37 +285,36 @@ The STM32F7xx allows computing and verifying the IP, UDP, TCP and ICMP checksums
 #define CHECKSUM_BY_HARDWARE 
 
 
-#ifdef CHECKSUM_BY_HARDWARE
-  /* CHECKSUM_GEN_IP==0: Generate checksums by hardware for outgoing IP packets.*/
-  #define CHECKSUM_GEN_IP                 0
-  /* CHECKSUM_GEN_UDP==0: Generate checksums by hardware for outgoing UDP packets.*/
-  #define CHECKSUM_GEN_UDP                0
-  /* CHECKSUM_GEN_TCP==0: Generate checksums by hardware for outgoing TCP packets.*/
-  #define CHECKSUM_GEN_TCP                0 
-  /* CHECKSUM_CHECK_IP==0: Check checksums by hardware for incoming IP packets.*/
-  #define CHECKSUM_CHECK_IP               0
-  /* CHECKSUM_CHECK_UDP==0: Check checksums by hardware for incoming UDP packets.*/
-  #define CHECKSUM_CHECK_UDP              0
-  /* CHECKSUM_CHECK_TCP==0: Check checksums by hardware for incoming TCP packets.*/
-  #define CHECKSUM_CHECK_TCP              0
-  /* CHECKSUM_CHECK_ICMP==0: Check checksums by hardware for incoming ICMP packets.*/
-  #define CHECKSUM_GEN_ICMP               0
-#else
-  /* CHECKSUM_GEN_IP==1: Generate checksums in software for outgoing IP packets.*/
-  #define CHECKSUM_GEN_IP                 1
-  /* CHECKSUM_GEN_UDP==1: Generate checksums in software for outgoing UDP packets.*/
-  #define CHECKSUM_GEN_UDP                1
-  /* CHECKSUM_GEN_TCP==1: Generate checksums in software for outgoing TCP packets.*/
-  #define CHECKSUM_GEN_TCP                1
-  /* CHECKSUM_CHECK_IP==1: Check checksums in software for incoming IP packets.*/
-  #define CHECKSUM_CHECK_IP               1
-  /* CHECKSUM_CHECK_UDP==1: Check checksums in software for incoming UDP packets.*/
-  #define CHECKSUM_CHECK_UDP              1
-  /* CHECKSUM_CHECK_TCP==1: Check checksums in software for incoming TCP packets.*/
-  #define CHECKSUM_CHECK_TCP              1
-  /* CHECKSUM_CHECK_ICMP==1: Check checksums by hardware for incoming ICMP packets.*/
-  #define CHECKSUM_GEN_ICMP               1
-#endif
+/* Checksums are generated and checked in software, except on the netifs
+   that clear the matching NETIF_CHECKSUM_* flag because their hardware does
+   it (see NETIF_SET_CHECKSUM_CTRL in ethernetif.c). */
+#define LWIP_CHECKSUM_CTRL_PER_NETIF    1
+
+/* CHECKSUM_GEN_IP==1: Generate checksums in software for outgoing IP packets.*/
+#define CHECKSUM_GEN_IP                 1
+/* CHECKSUM_GEN_UDP==1: Generate checksums in software for outgoing UDP packets.*/
+#define CHECKSUM_GEN_UDP                1
+/* CHECKSUM_GEN_TCP==1: Generate checksums in software for outgoing TCP packets.*/
+#define CHECKSUM_GEN_TCP                1
+/* CHECKSUM_GEN_ICMP==1: Generate checksums in software for outgoing ICMP packets.*/
+#define CHECKSUM_GEN_ICMP               1
+/* CHECKSUM_CHECK_IP==1: Check checksums in software for incoming IP packets.*/
+#define CHECKSUM_CHECK_IP               1
+/* CHECKSUM_CHECK_UDP==1: Check checksums in software for incoming UDP packets.*/
+#define CHECKSUM_CHECK_UDP              1
+/* CHECKSUM_CHECK_TCP==1: Check checksums in software for incoming TCP packets.*/
+#define CHECKSUM_CHECK_TCP              1
+/* CHECKSUM_CHECK_ICMP==1: Check checksums in software for incoming ICMP packets.*/
+#define CHECKSUM_CHECK_ICMP             1
+
+/* LWIP_CHKSUM_ALGORITHM 4: 32-bit loads into a 64-bit accumulator. */
+#define LWIP_CHKSUM_ALGORITHM           4
+/* LWIP_CHECKSUM_ON_COPY==1: data copied from the application by
+   netconn_write() and udp_sendto_chksum() is summed while it is copied, so
+   software-checksum netifs don't read the payload a second time. */
+#define LWIP_CHECKSUM_ON_COPY           1
+/* LWIP_CHKSUM_COPY_ALGORITHM 2: word copy and sum in one pass. */
+#define LWIP_CHKSUM_COPY_ALGORITHM      2
 
 
 /*
@@ -214,6 +346,28 @@ The STM32F7xx allows computing and verifying the IP, UDP, TCP and ICMP checksums
  * file system (to prevent changing the file included in CVS) */
 #define HTTPD_USE_CUSTOM_FSDATA   1
 
+/* fsdata_custom.c is generated by makefsdata -11 -gzip -etag: gzipped files
+   and their identity copies, each with its header and ETag in flash. The
+   gzipped one goes to the requests whose Accept-Encoding lists gzip, and a
+   matching If-None-Match is answered with a 304, on the same connection. */
+#define LWIP_HTTPD_GZIP                 1
+#define LWIP_HTTPD_ETAG                 1
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 1
+
+/* The files are written to TCP in place from flash: enqueue as much of them
+   as the send buffer takes instead of 2 MSS per acknowledgement */
+#define HTTPD_LIMIT_SENDING_TO_2MSS     0
+
+/* Telemetry of the board (User/app_telemetry.c): JSON documents and an
+   event stream written by handlers record by record into the send buffer,
+   and the tags of a status page (.shtml) */
+#define LWIP_HTTPD_STREAM               1
+#define LWIP_HTTPD_SSI                  1
+/* The tag itself is not sent, and a value of at most 48 characters keeps
+   the SSI state of a connection in the SMALL pool */
+#define LWIP_HTTPD_SSI_INCLUDE_TAG      0
+#define LWIP_HTTPD_MAX_TAG_INSERT_LEN   48
+
 #define LWIP_SO_RCVTIMEO                1
 
 /*
@@ -228,9 +382,29 @@ The STM32F7xx allows computing and verifying the IP, UDP, TCP and ICMP checksums
 #define DEFAULT_UDP_RECVMBOX_SIZE       6
 #define DEFAULT_TCP_RECVMBOX_SIZE       6
 #define DEFAULT_ACCEPTMBOX_SIZE         6
+#if TCP_DEFAULT_LISTEN_BACKLOG > DEFAULT_ACCEPTMBOX_SIZE
+#error "TCP_DEFAULT_LISTEN_BACKLOG must fit in the accept mailbox"
+#endif
 #define DEFAULT_THREAD_STACKSIZE        500
 #define TCPIP_THREAD_PRIO               osPriorityHigh
 
+/* netconn/socket calls run in the caller's thread under the core lock
+   instead of a round trip through the tcpip_thread mailbox */
+#define LWIP_TCPIP_CORE_LOCKING         1
+
+/* ---------- PPP options ---------- */
+/* PPP_SUPPORT==1: once the EC20 has dialled, IP runs over PPP on its AT
+   port and the LTE uplink is a netif of the stack (User/app_ec20.c). */
+#define PPP_SUPPORT                     1
+#define PPPOS_SUPPORT                   1
+#define PAP_SUPPORT                     1
+#define VJ_SUPPORT                      0
+#define LWIP_PPP_API                    0
+
+/* ---------- Hooks ---------- */
+/* The link manager picks the uplink a packet leaves through */
+#define LWIP_HOOK_FILENAME              "app_linkmgr.h"
+#define LWIP_HOOK_IP4_ROUTE_SRC(dest, src)  linkmgr_route(dest, src)
 
 
 #endif /* __LWIPOPTS_H__ */
@@ -307,6 +307,10 @@ struct netif {
   char name[2];
   /** number of this interface */
   u8_t num;
+#if IP_NAPT
+  /** the packets forwarded from this interface are translated (@see ip4_napt_enable) */
+  u8_t napt;
+#endif /* IP_NAPT */
 #if MIB2_STATS
   /** link type (from "snmp_ifType" enum from snmp_mib2.h) */
   u8_t link_type;
@@ -543,12 +543,21 @@
 #endif
 
 /**
- * ARP_TABLE_SIZE: Number of active MAC-IP address pairs cached.
+ * ARP_TABLE_SIZE: Number of active MAC-IP address pairs cached, up to 0x7fff.
  */
 #if !defined ARP_TABLE_SIZE || defined __DOXYGEN__
 #define ARP_TABLE_SIZE                  10
 #endif
 
+/**
+ * ARP_HASH_SIZE: Number of buckets, a power of 2, the ARP table entries are
+ * looked up in by IP address. 0 scans the whole table for every lookup,
+ * which only suits a few entries.
+ */
+#if !defined ARP_HASH_SIZE || defined __DOXYGEN__
+#define ARP_HASH_SIZE                   0
+#endif
+
 /** the time an ARP entry stays valid after its last update,
  *  for ARP_TMR_INTERVAL = 1000, this is
  *  (60 * 5) seconds = 5 minutes.
@@ -557,6 +566,17 @@
 #define ARP_MAXAGE                      300
 #endif
 
+/**
+ * ETHARP_REFRESH_USED==1: etharp_tmr() confirms the entries packets were sent
+ * through since their last update before they expire: by unicast requests to
+ * the cached address from 30 seconds before, by broadcast ones in the last 15.
+ * Otherwise an entry is only re-requested when a packet is sent in that time,
+ * and the traffic stalls if it does not come back.
+ */
+#if !defined ETHARP_REFRESH_USED || defined __DOXYGEN__
+#define ETHARP_REFRESH_USED             0
+#endif
+
 /**
  * ARP_QUEUEING==1: Multiple outgoing packets are queued during hardware address
  * resolution. By default, only the most recent packet is queued per IP address.
@@ -740,6 +760,63 @@
 #define IP_FORWARD_ALLOW_TX_ON_RX_NETIF 0
 #endif
 
+/**
+ * IP_NAPT==1: Translate the address and port of the packets forwarded from
+ * an interface enabled with ip4_napt_enable() to another one, so that the
+ * hosts behind it share the address of the other one (see ip4_napt.c).
+ * Requires IP_FORWARD.
+ */
+#if !defined IP_NAPT || defined __DOXYGEN__
+#define IP_NAPT                         0
+#endif
+
+/**
+ * IP_NAPT_MAX: Number of translations, up to 0xfffe. When they are all in
+ * use, the one idle the longest is recycled.
+ */
+#if !defined IP_NAPT_MAX || defined __DOXYGEN__
+#define IP_NAPT_MAX                     64
+#endif
+
+/**
+ * IP_NAPT_HASH_SIZE: Number of buckets, a power of 2, of each of the two
+ * tables the translations are looked up in.
+ */
+#if !defined IP_NAPT_HASH_SIZE || defined __DOXYGEN__
+#define IP_NAPT_HASH_SIZE               32
+#endif
+
+/**
+ * IP_NAPT_PORT_FIRST, IP_NAPT_PORT_LAST: Outside ports and ICMP echo
+ * identifiers of the translations, apart from the local ports of the stack
+ * (0xc000..0xffff).
+ */
+#if !defined IP_NAPT_PORT_FIRST || defined __DOXYGEN__
+#define IP_NAPT_PORT_FIRST              0x8000
+#endif
+#if !defined IP_NAPT_PORT_LAST || defined __DOXYGEN__
+#define IP_NAPT_PORT_LAST               0xbfff
+#endif
+
+/**
+ * IP_NAPT_TMOT_TCP, IP_NAPT_TMOT_TCP_CLOSED, IP_NAPT_TMOT_UDP,
+ * IP_NAPT_TMOT_ICMP: Milliseconds a translation may stay idle. The TCP one
+ * is IP_NAPT_TMOT_TCP_CLOSED until the remote host answers and once the
+ * connection is reset or closed both ways.
+ */
+#if !defined IP_NAPT_TMOT_TCP || defined __DOXYGEN__
+#define IP_NAPT_TMOT_TCP                (30 * 60 * 1000)
+#endif
+#if !defined IP_NAPT_TMOT_TCP_CLOSED || defined __DOXYGEN__
+#define IP_NAPT_TMOT_TCP_CLOSED         (10 * 1000)
+#endif
+#if !defined IP_NAPT_TMOT_UDP || defined __DOXYGEN__
+#define IP_NAPT_TMOT_UDP                (60 * 1000)
+#endif
+#if !defined IP_NAPT_TMOT_ICMP || defined __DOXYGEN__
+#define IP_NAPT_TMOT_ICMP               (10 * 1000)
+#endif
+
 /**
  * LWIP_RANDOMIZE_INITIAL_LOCAL_PORTS==1: randomize the local port for the first
  * local TCP/UDP pcb (default==0). This can prevent creating predictable port
@@ -1111,6 +1188,15 @@
 #if !defined LWIP_NETBUF_RECVINFO || defined __DOXYGEN__
 #define LWIP_NETBUF_RECVINFO            0
 #endif
+
+/**
+ * UDP_PCB_HASH_SIZE: number of buckets, a power of 2, of the table that
+ * udp_input() looks the pcbs up in by local port. 0 walks the whole list of
+ * UDP pcbs for every datagram instead.
+ */
+#if !defined UDP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define UDP_PCB_HASH_SIZE               0
+#endif
 /**
  * @}
  */
@@ -1262,6 +1348,15 @@
 #define TCP_DEFAULT_LISTEN_BACKLOG      0xff
 #endif
 
+/**
+ * TCP_PCB_HASH_SIZE: number of buckets, a power of 2, of the tables that
+ * tcp_input() looks the pcbs up in: connections (active and TIME-WAIT) by
+ * address and ports, listeners by local port. 0 walks the lists instead.
+ */
+#if !defined TCP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define TCP_PCB_HASH_SIZE               0
+#endif
+
 /**
  * TCP_OVERSIZE: The maximum number of bytes that tcp_write may
  * allocate ahead of time in an attempt to create shorter pbuf chains
@@ -79,7 +79,9 @@ void             tcp_input   (struct pbuf *p, struct netif *inp);
 struct tcp_pcb * tcp_alloc   (u8_t prio);
 void             tcp_abandon (struct tcp_pcb *pcb, int reset);
 err_t            tcp_send_empty_ack(struct tcp_pcb *pcb);
-void             tcp_rexmit  (struct tcp_pcb *pcb);
+err_t            tcp_rexmit  (struct tcp_pcb *pcb);
+err_t            tcp_rexmit_rto_prepare(struct tcp_pcb *pcb);
+void             tcp_rexmit_rto_commit(struct tcp_pcb *pcb);
 void             tcp_rexmit_rto  (struct tcp_pcb *pcb);
 void             tcp_rexmit_fast (struct tcp_pcb *pcb);
 u32_t            tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
@@ -334,6 +336,27 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
    3) All PCBs in the tcp_listen_pcbs list is in LISTEN state.
    4) All PCBs in the tcp_tw_pcbs list is in TIME-WAIT state.
 */
+
+#if TCP_PCB_HASH_SIZE
+/* Buckets of the lists for tcp_input(): the PCBs of tcp_active_pcbs and
+   tcp_tw_pcbs by address and ports, those of tcp_listen_pcbs by local port.
+   TCP_REG and TCP_RMV keep a PCB in the bucket of its list, so it must not
+   change these fields while on the list. */
+extern struct tcp_pcb *tcp_pcb_hash[TCP_PCB_HASH_SIZE];
+extern union tcp_listen_pcbs_t tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
+#define TCP_LISTEN_HASH(port)   ((u16_t)((port) ^ ((port) >> 8)) & (TCP_PCB_HASH_SIZE - 1))
+
+u16_t tcp_pcb_hash_index(const ip_addr_t *remote_ip, u16_t remote_port, u16_t local_port);
+void  tcp_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+void  tcp_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+#define TCP_HASH_REG(pcbs, npcb)  tcp_hash_reg(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)  tcp_hash_rmv(pcbs, npcb)
+#else /* TCP_PCB_HASH_SIZE */
+#define TCP_HASH_REG(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif /* TCP_PCB_HASH_SIZE */
+
 /* Define two macros, TCP_REG and TCP_RMV that registers a TCP PCB
    with a PCB list or removes a PCB from a list, respectively. */
 #ifndef TCP_DEBUG_PCB_LISTS
@@ -352,6 +375,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                             (npcb)->next = *(pcbs); \
                             LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
                             *(pcbs) = (npcb); \
+                            TCP_HASH_REG(pcbs, npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
               tcp_timer_needed(); \
                             } while(0)
@@ -359,6 +383,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                             struct tcp_pcb *tcp_tmp_pcb; \
                             LWIP_ASSERT("TCP_RMV: pcbs != NULL", *(pcbs) != NULL); \
                             LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removing %p from %p\n", (npcb), *(pcbs))); \
+                            TCP_HASH_RMV(pcbs, npcb); \
                             if(*(pcbs) == (npcb)) { \
                                *(pcbs) = (*pcbs)->next; \
                             } else for (tcp_tmp_pcb = *(pcbs); tcp_tmp_pcb != NULL; tcp_tmp_pcb = tcp_tmp_pcb->next) { \
@@ -378,11 +403,13 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
   do {                                             \
     (npcb)->next = *pcbs;                          \
     *(pcbs) = (npcb);                              \
+    TCP_HASH_REG(pcbs, npcb);                      \
     tcp_timer_needed();                            \
   } while (0)
 
 #define TCP_RMV(pcbs, npcb)                        \
   do {                                             \
+    TCP_HASH_RMV(pcbs, npcb);                      \
     if(*(pcbs) == (npcb)) {                        \
       (*(pcbs)) = (*pcbs)->next;                   \
     }                                              \
@@ -165,11 +165,18 @@ enum tcp_state {
   TIME_WAIT   = 10
 };
 
+#if TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_NEXT(type) type *hash_next; /* for the bucket of tcp_input() */
+#else
+#define TCP_PCB_HASH_NEXT(type)
+#endif
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
 #define TCP_PCB_COMMON(type) \
   type *next; /* for the linked list */ \
+  TCP_PCB_HASH_NEXT(type) \
   void *callback_arg; \
   enum tcp_state state; /* TCP state */ \
   u8_t prio; \
@@ -177,7 +177,9 @@ ethernet_input(struct pbuf *p, struct netif *netif)
         goto free_and_return;
       } else {
         /* pass to IP layer */
+        PERF_START;
         ip4_input(p, netif);
+        PERF_STOP("ip4_input");
       }
       break;
 
@@ -302,7 +304,13 @@ ethernet_output(struct netif* netif, struct pbuf* p,
     ("ethernet_output: sending packet %p\n", (void *)p));
 
   /* send the packet */
-  return netif->linkoutput(netif, p);
+  {
+    err_t err;
+    PERF_START;
+    err = netif->linkoutput(netif, p);
+    PERF_STOP("link_output");
+    return err;
+  }
 
 pbuf_header_failed:
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_SERIOUS,
@@ -50,13 +50,88 @@
 #include "netif/ethernet.h"
 #include "netif/etharp.h"
 #include "lwip/ethernetif.h"
+#include "lwip/tcpip.h"
 #include <string.h>
 #include "cmsis_os.h"
 
 /* Private typedef -----------------------------------------------------------*/
+#if ETHIF_RX_ZERO_COPY
+/* Custom pbuf handed to the stack in place of a copy of one receive buffer */
+typedef struct
+{
+  struct pbuf_custom pc;
+  uint8_t index;          /* Rx_Buff row wrapped by this pbuf */
+}eth_rx_pbuf_t;
+#endif
+
+/* PHY link as seen by the link manager, see eth_link_poll() */
+typedef enum
+{
+  ETH_LINK_DOWN = 0,      /* no link yet, the PHY is negotiating on its own */
+  ETH_LINK_UP             /* negotiated, the MAC runs at the agreed mode */
+}eth_link_state_t;
+
+/* Multicast address passed by the MAC, see eth_filter_apply() */
+typedef struct
+{
+  struct eth_addr addr;
+  uint8_t ref;            /* groups mapping to addr, 0 for a free entry */
+}eth_filter_entry_t;
+
 /* Private define ------------------------------------------------------------*/
-/* The time to block waiting for input. */
-#define TIME_WAITING_FOR_INPUT                 ( osWaitForever )
+#ifndef ETHIF_RX_ZERO_COPY
+#define ETHIF_RX_ZERO_COPY                     0
+#endif
+
+#if ETHIF_RX_ZERO_COPY
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "ETHIF_RX_ZERO_COPY needs LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+/* Receive buffers: one per descriptor plus the refill pool */
+#define ETH_RX_BUFFERS_NB                      ( ETH_RXBUFNB + ETHIF_RX_REFILL_NB )
+#else
+#define ETH_RX_BUFFERS_NB                      ( ETH_RXBUFNB )
+#endif
+
+#ifndef ETHIF_TX_ZERO_COPY
+#define ETHIF_TX_ZERO_COPY                     0
+#endif
+
+#ifndef ETHIF_RX_BATCH
+#define ETHIF_RX_BATCH                         0
+#endif
+
+#if ETHIF_RX_BATCH
+#if (ETHIF_RX_BATCH_MAX & (ETHIF_RX_BATCH_MAX - 1)) != 0
+#error "ETHIF_RX_BATCH_MAX must be a power of two"
+#endif
+#endif
+
+#ifndef ETHIF_LINK_POLL_MS
+#define ETHIF_LINK_POLL_MS                     250
+#endif
+
+#ifndef ETHIF_LINK_PHY_IRQ
+#define ETHIF_LINK_PHY_IRQ                     0
+#endif
+
+#ifndef ETHIF_MAC_FILTER_MAX
+#define ETHIF_MAC_FILTER_MAX                   16
+#endif
+
+#ifndef ETHIF_BCAST_LIMIT
+#define ETHIF_BCAST_LIMIT                      0
+#endif
+
+/* Perfect filters besides the station address: MACA1 to MACA3 */
+#define ETH_PERFECT_FILTERS                    3
+/* Bits of the multicast hash table (MACHTHR:MACHTLR) */
+#define ETH_HASH_BITS                          64
+/* Broadcast rate limit window */
+#define ETH_BCAST_WINDOW_MS                    1000
+
+/* The time to block waiting for input, the link is checked in between. */
+#define TIME_WAITING_FOR_INPUT                 ( ETHIF_LINK_POLL_MS )
 /* Stack size of the interface thread */
 #define INTERFACE_THREAD_STACK_SIZE            ( 350 )
 
@@ -89,12 +164,14 @@ __ALIGN_BEGIN ETH_DMADescTypeDef  DMATxDscrTab[ETH_TXBUFNB] __ALIGN_END;/* Ether
 #if defined ( __ICCARM__ ) /*!< IAR Compiler */
   #pragma data_alignment=4   
 #endif
-__ALIGN_BEGIN uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] __ALIGN_END; /* Ethernet Receive Buffer */
+__ALIGN_BEGIN uint8_t Rx_Buff[ETH_RX_BUFFERS_NB][ETH_RX_BUF_SIZE] __ALIGN_END; /* Ethernet Receive Buffer */
 
+#if !ETHIF_TX_ZERO_COPY
 #if defined ( __ICCARM__ ) /*!< IAR Compiler */
   #pragma data_alignment=4   
 #endif
 __ALIGN_BEGIN uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] __ALIGN_END; /* Ethernet Transmit Buffer */
+#endif
 
 #if 0
 
@@ -132,8 +209,92 @@ osSemaphoreId s_xSemaphore = NULL;
 /* Global Ethernet handle*/
 ETH_HandleTypeDef EthHandle;
 
+#if ETHIF_RX_ZERO_COPY
+static eth_rx_pbuf_t eth_rx_pbuf[ETH_RX_BUFFERS_NB];
+/* Buffers owned neither by a descriptor nor by the stack */
+static uint8_t eth_rx_free[ETH_RX_BUFFERS_NB];
+static uint8_t eth_rx_free_cnt = 0;
+/* Descriptors harvested by low_level_input() still waiting for a buffer,
+   starting at eth_rx_refill_desc and ending just before EthHandle.RxDesc */
+static ETH_DMADescTypeDef *eth_rx_refill_desc = NULL;
+static uint8_t eth_rx_pending = 0;
+#endif
+
+#if ETHIF_TX_ZERO_COPY
+/* Frame to release when the descriptor holding its last segment completes */
+static struct pbuf *eth_tx_pbuf[ETH_TXBUFNB];
+/* Descriptors given to the DMA, starting at eth_tx_reclaim_desc and ending
+   just before EthHandle.TxDesc */
+static ETH_DMADescTypeDef *eth_tx_reclaim_desc = NULL;
+static uint8_t eth_tx_busy = 0;
+/* Frames waiting for free descriptors, in transmit order */
+static struct pbuf *eth_tx_queue[ETHIF_TX_QUEUE_LEN];
+static uint8_t eth_tx_queue_head = 0;
+static uint8_t eth_tx_queue_cnt = 0;
+#endif
+
+#if ETHIF_RX_BATCH
+/* Frames handed from the interface thread to the tcpip thread: the first
+   only moves eth_rx_ring_head, the second only eth_rx_ring_tail */
+static struct pbuf *eth_rx_ring[ETHIF_RX_BATCH_MAX];
+static volatile uint32_t eth_rx_ring_head = 0;
+static volatile uint32_t eth_rx_ring_tail = 0;
+/* Preallocated message delivering the ring in one go, and whether it is
+   sitting in the tcpip mailbox */
+static struct tcpip_callback_msg *eth_rx_batch_msg = NULL;
+static volatile uint8_t eth_rx_batch_queued = 0;
+static ethernetif_rx_stats_t eth_rx_stats;
+#endif
+
+/* Link manager state, only changed by the interface thread. The message
+   tells the tcpip thread about eth_link_state, eth_link_changed is set until
+   it has been posted. */
+static eth_link_state_t eth_link_state = ETH_LINK_DOWN;
+static uint32_t eth_link_polled = 0;
+static uint8_t eth_link_changed = 0;
+static struct tcpip_callback_msg *eth_link_msg = NULL;
+#if ETHIF_LINK_PHY_IRQ
+static volatile uint8_t eth_link_irq = 0;
+#endif
+
+/* Multicast addresses joined through igmp_mac_filter/mld_mac_filter, changed
+   by the tcpip thread only. Joins that don't fit in eth_filter are counted
+   by their hash index in eth_filter_spill and passed by the hash table
+   until they are left. */
+static eth_filter_entry_t eth_filter[ETHIF_MAC_FILTER_MAX];
+static uint8_t eth_filter_spill[ETH_HASH_BITS];
+/* MACFFR without the broadcast disable bit, which the interface thread sets
+   while broadcasts are over ETHIF_BCAST_LIMIT */
+static uint32_t eth_filter_ffr = 0;
+static uint8_t eth_bcast_blocked = 0;
+#if ETHIF_BCAST_LIMIT
+static uint32_t eth_bcast_window = 0;
+static uint32_t eth_bcast_count = 0;
+#endif
+static ethernetif_filter_stats_t eth_filter_stats;
+
 /* Private function prototypes -----------------------------------------------*/
 static void ethernetif_input( void const * argument );
+#if ETHIF_RX_ZERO_COPY
+static void eth_rx_init(void);
+static void eth_rx_refill(void);
+static void eth_rx_pbuf_free(struct pbuf *p);
+#endif
+#if ETHIF_TX_ZERO_COPY
+static err_t eth_tx_submit(struct pbuf *p);
+static void eth_tx_reclaim(void);
+#endif
+#if ETHIF_RX_BATCH
+static void eth_rx_batch_deliver(void *ctx);
+static void eth_rx_batch_post(void);
+static void eth_rx_batch_loop(struct netif *netif);
+#endif
+static void eth_link_report(void *ctx);
+static void eth_link_poll(struct netif *netif);
+static void eth_filter_init(void);
+static void eth_filter_apply(void);
+static uint8_t eth_filter_input(struct pbuf *p);
+static void eth_filter_poll(void);
 
 /* Private functions ---------------------------------------------------------*/
 /*******************************************************************************
@@ -231,6 +392,19 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
   osSemaphoreRelease(s_xSemaphore);
 }
 
+#if ETHIF_TX_ZERO_COPY
+/**
+  * @brief  Ethernet Tx Transfer completed callback
+  * @param  heth: ETH handle
+  * @retval None
+  */
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+  /* The interface thread reclaims the finished descriptors */
+  osSemaphoreRelease(s_xSemaphore);
+}
+#endif
+
 
 
 /*******************************************************************************
@@ -246,7 +420,9 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
 static int low_level_init(struct netif *netif)
 {
   uint8_t macaddress[6]= { MAC_ADDR0, MAC_ADDR1, MAC_ADDR2, MAC_ADDR3, MAC_ADDR4, MAC_ADDR5 };
+#if ETHIF_LINK_PHY_IRQ
   uint32_t regvalue = 0;
+#endif
   uint32_t ret;
 
   /*HAL_GPIO_WritePin(GPIOB,GPIO_PIN_14,GPIO_PIN_RESET);
@@ -256,20 +432,25 @@ static int low_level_init(struct netif *netif)
   
   EthHandle.Instance = ETH;  
   EthHandle.Init.MACAddr = macaddress;
-  EthHandle.Init.AutoNegotiation = ETH_AUTONEGOTIATION_ENABLE;
+  /* HAL_ETH_Init() would wait for the link and the end of the negotiation:
+     start in a fixed mode, eth_link_poll() follows the negotiation instead */
+  EthHandle.Init.AutoNegotiation = ETH_AUTONEGOTIATION_DISABLE;
   EthHandle.Init.Speed = ETH_SPEED_100M;
   EthHandle.Init.DuplexMode = ETH_MODE_FULLDUPLEX;
   EthHandle.Init.MediaInterface = ETH_MEDIA_INTERFACE_RMII;
   EthHandle.Init.RxMode = ETH_RXINTERRUPT_MODE;
+#ifdef CHECKSUM_BY_HARDWARE
   EthHandle.Init.ChecksumMode = ETH_CHECKSUM_BY_HARDWARE;
+#else
+  EthHandle.Init.ChecksumMode = ETH_CHECKSUM_BY_SOFTWARE;
+#endif
   EthHandle.Init.PhyAddress = LAN8742A_PHY_ADDRESS;
   
   /* configure ethernet peripheral (GPIOs, clocks, MAC, DMA) */
   if ((ret = HAL_ETH_Init(&EthHandle)) == HAL_OK)
   {
-    /* Set netif link flag */
-    netif->flags |= NETIF_FLAG_LINK_UP;
-	printf("HAL_ETH_Init success ethernet link up!\r\n");
+    /* The link comes up later, from eth_link_poll() */
+	printf("HAL_ETH_Init success, waiting for the link\r\n");
   }
   else
   {
@@ -278,10 +459,21 @@ static int low_level_init(struct netif *netif)
   }
   
   /* Initialize Tx Descriptors list: Chain Mode */
+#if ETHIF_TX_ZERO_COPY
+  /* No Tx buffers: eth_tx_submit() points the descriptors at pbuf payloads */
+  HAL_ETH_DMATxDescListInit(&EthHandle, DMATxDscrTab, NULL, ETH_TXBUFNB);
+  eth_tx_reclaim_desc = EthHandle.TxDesc;
+#else
   HAL_ETH_DMATxDescListInit(&EthHandle, DMATxDscrTab, &Tx_Buff[0][0], ETH_TXBUFNB);
+#endif
      
   /* Initialize Rx Descriptors list: Chain Mode  */
   HAL_ETH_DMARxDescListInit(&EthHandle, DMARxDscrTab, &Rx_Buff[0][0], ETH_RXBUFNB);
+
+#if ETHIF_RX_ZERO_COPY
+  /* The rows past ETH_RXBUFNB form the refill pool */
+  eth_rx_init();
+#endif
   
   /* set netif MAC hardware address length */
   netif->hwaddr_len = ETH_HWADDR_LEN;
@@ -300,6 +492,30 @@ static int low_level_init(struct netif *netif)
   /* Accept broadcast address and ARP traffic */
   netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
 
+#ifdef CHECKSUM_BY_HARDWARE
+  /* The MAC inserts and verifies the IP, UDP, TCP and ICMP checksums */
+  NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_DISABLE_ALL);
+#endif
+
+  /* Multicast filtering follows the groups joined by lwIP */
+  eth_filter_init();
+#if LWIP_IGMP
+  netif->flags |= NETIF_FLAG_IGMP;
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+  netif->flags |= NETIF_FLAG_MLD6;
+#endif
+
+  /* Let the PHY negotiate in the background */
+  HAL_ETH_WritePHYRegister(&EthHandle, PHY_BCR, PHY_AUTONEGOTIATION | PHY_RESTART_AUTONEGOTIATION);
+#if ETHIF_LINK_PHY_IRQ
+  /* Interrupt on link down and on the end of the negotiation (link up) */
+  HAL_ETH_ReadPHYRegister(&EthHandle, PHY_IMR, &regvalue);
+  regvalue |= (PHY_ISFR_INT4 | PHY_ISFR_INT6);
+  HAL_ETH_WritePHYRegister(&EthHandle, PHY_IMR, regvalue);
+#endif
+  eth_link_polled = HAL_GetTick();
+
   /* create a binary semaphore used for informing ethernetif of frame reception */
   osSemaphoreDef(SEM);
   s_xSemaphore = osSemaphoreCreate(osSemaphore(SEM) , 1 );
@@ -310,20 +526,212 @@ static int low_level_init(struct netif *netif)
 
   /* Enable MAC and DMA transmission and reception */
   HAL_ETH_Start(&EthHandle);
-  /* Read Register Configuration */
-  HAL_ETH_ReadPHYRegister(&EthHandle, PHY_ISFR, &regvalue);
-  regvalue |= (PHY_ISFR_INT4);
-
-  /* Enable Interrupt on change of link status */ 
-  HAL_ETH_WritePHYRegister(&EthHandle, PHY_ISFR , regvalue );
-  
-  /* Read Register Configuration */
-  HAL_ETH_ReadPHYRegister(&EthHandle, PHY_ISFR , &regvalue);
+#if ETHIF_TX_ZERO_COPY
+  /* Transmit complete interrupt, raised by descriptors with IC set */
+  __HAL_ETH_DMA_ENABLE_IT(&EthHandle, ETH_DMA_IT_T);
+#endif
 
   return ret;
 }
 
 
+#if ETHIF_TX_ZERO_COPY
+/**
+  * @brief Points one free Tx descriptor at each pbuf of a frame and gives them
+  * to the DMA, first segment last so it never starts on a partial frame.
+  * Must be called with SYS_ARCH_PROTECT held, p already referenced: the
+  * reference is dropped by eth_tx_reclaim() once the frame is sent.
+  *
+  * @param p the MAC packet to send, at most ETH_TXBUFNB non-empty pbufs
+  * @return ERR_OK if the frame was handed to the DMA
+  *         ERR_USE if there are not enough free descriptors
+  */
+static err_t eth_tx_submit(struct pbuf *p)
+{
+  struct pbuf *q;
+  ETH_DMADescTypeDef *first, *last, *desc;
+  uint32_t segs = 0;
+
+  for(q = p; q != NULL; q = q->next)
+  {
+    if(q->len > 0)
+    {
+      segs++;
+    }
+  }
+  if(segs > (uint32_t)(ETH_TXBUFNB - eth_tx_busy))
+  {
+    return ERR_USE;
+  }
+
+  first = last = desc = EthHandle.TxDesc;
+  for(q = p; q != NULL; q = q->next)
+  {
+    if(q->len == 0)
+    {
+      continue;
+    }
+    desc->Buffer1Addr = (uint32_t)q->payload;
+    desc->ControlBufferSize = q->len & ETH_DMATXDESC_TBS1;
+    /* Keep chaining and checksum insertion, drop the previous frame's status */
+    desc->Status = (desc->Status & (ETH_DMATXDESC_TCH | ETH_DMATXDESC_CIC)) |
+                   ((desc == first) ? ETH_DMATXDESC_FS : 0U);
+    last = desc;
+    desc = (ETH_DMADescTypeDef *)(desc->Buffer2NextDescAddr);
+  }
+  last->Status |= ETH_DMATXDESC_LS | ETH_DMATXDESC_IC;
+  eth_tx_pbuf[last - DMATxDscrTab] = p;
+
+  /* Give the DMA every segment but the first, then the first */
+  for(last = (ETH_DMADescTypeDef *)(first->Buffer2NextDescAddr); last != desc;
+      last = (ETH_DMADescTypeDef *)(last->Buffer2NextDescAddr))
+  {
+    last->Status |= ETH_DMATXDESC_OWN;
+  }
+  __DMB();
+  first->Status |= ETH_DMATXDESC_OWN;
+
+  EthHandle.TxDesc = desc;
+  eth_tx_busy += segs;
+
+  /* When Tx Buffer unavailable flag is set: clear it and resume transmission */
+  if ((EthHandle.Instance->DMASR & ETH_DMASR_TBUS) != (uint32_t)RESET)
+  {
+    /* Clear TBUS ETHERNET DMA flag */
+    EthHandle.Instance->DMASR = ETH_DMASR_TBUS;
+  }
+  /* Resume DMA transmission */
+  EthHandle.Instance->DMATPDR = 0;
+
+  return ERR_OK;
+}
+
+/**
+  * @brief Releases the frames the DMA has finished sending, then moves queued
+  * frames onto the descriptors freed. Called from the interface thread on
+  * Tx complete and before every transmission.
+  */
+static void eth_tx_reclaim(void)
+{
+  struct pbuf *done[ETH_TXBUFNB];
+  uint32_t ndone = 0;
+  uint32_t i;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  SYS_ARCH_PROTECT(old_level);
+
+  while((eth_tx_busy > 0) && ((eth_tx_reclaim_desc->Status & ETH_DMATXDESC_OWN) == (uint32_t)RESET))
+  {
+    i = eth_tx_reclaim_desc - DMATxDscrTab;
+    if(eth_tx_pbuf[i] != NULL)
+    {
+      done[ndone++] = eth_tx_pbuf[i];
+      eth_tx_pbuf[i] = NULL;
+    }
+    eth_tx_reclaim_desc = (ETH_DMADescTypeDef *)(eth_tx_reclaim_desc->Buffer2NextDescAddr);
+    eth_tx_busy--;
+  }
+
+  while((eth_tx_queue_cnt > 0) && (eth_tx_submit(eth_tx_queue[eth_tx_queue_head]) == ERR_OK))
+  {
+    eth_tx_queue_head = (eth_tx_queue_head + 1) % ETHIF_TX_QUEUE_LEN;
+    eth_tx_queue_cnt--;
+  }
+
+  /* When Transmit Underflow flag is set, clear it and issue a Transmit Poll Demand to resume transmission */
+  if ((EthHandle.Instance->DMASR & ETH_DMASR_TUS) != (uint32_t)RESET)
+  {
+    /* Clear TUS ETHERNET DMA flag */
+    EthHandle.Instance->DMASR = ETH_DMASR_TUS;
+
+    /* Resume DMA transmission*/
+    EthHandle.Instance->DMATPDR = 0;
+  }
+
+  SYS_ARCH_UNPROTECT(old_level);
+
+  /* pbuf_free() takes SYS_ARCH_PROTECT itself */
+  for(i = 0; i < ndone; i++)
+  {
+    pbuf_free(done[i]);
+  }
+}
+
+/**
+  * @brief Sends the packet without copying it: the Tx descriptors point at
+  * the pbuf payloads and the chain stays referenced until the DMA is done.
+  * When the descriptors are all in use the frame is queued behind the ones
+  * in flight rather than dropped.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
+  * @return ERR_OK if the packet was sent or queued
+  *         ERR_MEM if the queue is full or a flattened copy couldn't be allocated
+  */
+static err_t low_level_output(struct netif *netif, struct pbuf *p)
+{
+  err_t errval = ERR_OK;
+  struct pbuf *q;
+  uint32_t segs = 0;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  for(q = p; q != NULL; q = q->next)
+  {
+    if(q->len > 0)
+    {
+      segs++;
+    }
+  }
+
+  if(segs == 0)
+  {
+    return ERR_ARG;
+  }
+
+  if(segs > ETH_TXBUFNB)
+  {
+    /* More segments than descriptors: flatten the frame once */
+    q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+    if(q == NULL)
+    {
+      return ERR_MEM;
+    }
+    pbuf_copy(q, p);
+    p = q;
+  }
+  else
+  {
+    /* Held until the DMA is done with the payload */
+    pbuf_ref(p);
+  }
+
+  eth_tx_reclaim();
+
+  SYS_ARCH_PROTECT(old_level);
+  /* Frames already queued go first */
+  if((eth_tx_queue_cnt == 0) && (eth_tx_submit(p) == ERR_OK))
+  {
+    p = NULL;
+  }
+  else if(eth_tx_queue_cnt < ETHIF_TX_QUEUE_LEN)
+  {
+    eth_tx_queue[(eth_tx_queue_head + eth_tx_queue_cnt) % ETHIF_TX_QUEUE_LEN] = p;
+    eth_tx_queue_cnt++;
+    p = NULL;
+  }
+  else
+  {
+    errval = ERR_MEM;
+  }
+  SYS_ARCH_UNPROTECT(old_level);
+
+  if(p != NULL)
+  {
+    pbuf_free(p);
+  }
+  return errval;
+}
+#else
 /**
   * @brief This function should do the actual transmission of the packet. The packet is
   * contained in the pbuf that is passed to the function. This pbuf
@@ -417,6 +825,170 @@ error:
   return errval;
 }
 
+#endif /* ETHIF_TX_ZERO_COPY */
+
+#if ETHIF_RX_ZERO_COPY
+/**
+  * @brief Sets up the custom pbufs and the refill pool after the Rx descriptor
+  * list has been initialized on the first ETH_RXBUFNB rows of Rx_Buff.
+  */
+static void eth_rx_init(void)
+{
+  uint32_t i;
+
+  for(i = 0; i < ETH_RX_BUFFERS_NB; i++)
+  {
+    eth_rx_pbuf[i].pc.custom_free_function = eth_rx_pbuf_free;
+    eth_rx_pbuf[i].index = i;
+  }
+
+  eth_rx_free_cnt = 0;
+  for(i = ETH_RXBUFNB; i < ETH_RX_BUFFERS_NB; i++)
+  {
+    eth_rx_free[eth_rx_free_cnt++] = i;
+  }
+
+  eth_rx_refill_desc = EthHandle.RxDesc;
+  eth_rx_pending = 0;
+}
+
+/**
+  * @brief Gives free buffers to the harvested descriptors, oldest first, and
+  * resumes reception if the DMA ran out of descriptors.
+  * Must be called with SYS_ARCH_PROTECT held.
+  */
+static void eth_rx_refill(void)
+{
+  while((eth_rx_pending > 0) && (eth_rx_free_cnt > 0))
+  {
+    eth_rx_refill_desc->Buffer1Addr = (uint32_t)Rx_Buff[eth_rx_free[--eth_rx_free_cnt]];
+    /* The buffer address must be visible before the DMA owns the descriptor */
+    __DMB();
+    eth_rx_refill_desc->Status = ETH_DMARXDESC_OWN;
+    eth_rx_refill_desc = (ETH_DMADescTypeDef *)(eth_rx_refill_desc->Buffer2NextDescAddr);
+    eth_rx_pending--;
+  }
+
+  /* When Rx Buffer unavailable flag is set: clear it and resume reception */
+  if ((EthHandle.Instance->DMASR & ETH_DMASR_RBUS) != (uint32_t)RESET)
+  {
+    /* Clear RBUS ETHERNET DMA flag */
+    EthHandle.Instance->DMASR = ETH_DMASR_RBUS;
+    /* Resume DMA reception */
+    EthHandle.Instance->DMARPDR = 0;
+  }
+}
+
+/**
+  * @brief Custom pbuf free function: the stack is done with a received frame,
+  * its buffer goes back to the pool and on to the next descriptor waiting.
+  *
+  * @param p the custom pbuf built by low_level_input()
+  */
+static void eth_rx_pbuf_free(struct pbuf *p)
+{
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  SYS_ARCH_PROTECT(old_level);
+  eth_rx_free[eth_rx_free_cnt++] = ((eth_rx_pbuf_t *)p)->index;
+  eth_rx_refill();
+  SYS_ARCH_UNPROTECT(old_level);
+}
+
+/**
+  * @brief Hands the next received frame to the stack without copying it: the
+  * pbuf points into the DMA buffer the frame landed in. The descriptor is
+  * given a spare buffer from the refill pool right away. Once the stack
+  * holds so many frames that the pool can't re-arm every harvested
+  * descriptor, frames are copied into PBUF_POOL instead and their buffer
+  * goes straight back to the ring, which never stalls on the stack.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @return a custom or PBUF_POOL pbuf holding the received packet
+  *         (including MAC header), NULL if no frame is ready
+  */
+static struct pbuf * low_level_input(struct netif *netif)
+{
+  struct pbuf *p = NULL;
+  ETH_DMADescTypeDef *dmarxdesc;
+  eth_rx_pbuf_t *rx;
+  eth_rx_pbuf_t *copy;
+  uint32_t status;
+  uint16_t len = 0;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  /* A frame the pool has no pbuf to copy into is dropped, try the next */
+  do
+  {
+    copy = NULL;
+    SYS_ARCH_PROTECT(old_level);
+
+    /* All descriptors waiting for a buffer: nothing left for the DMA to fill */
+    while((p == NULL) && (copy == NULL) && (eth_rx_pending < ETH_RXBUFNB))
+    {
+      dmarxdesc = EthHandle.RxDesc;
+      status = dmarxdesc->Status;
+      if((status & ETH_DMARXDESC_OWN) != (uint32_t)RESET)
+      {
+        break;
+      }
+
+      EthHandle.RxDesc = (ETH_DMADescTypeDef *)(dmarxdesc->Buffer2NextDescAddr);
+      eth_rx_pending++;
+      rx = &eth_rx_pbuf[(dmarxdesc->Buffer1Addr - (uint32_t)&Rx_Buff[0][0]) / ETH_RX_BUF_SIZE];
+
+      /* A buffer holds a whole frame, anything spanning descriptors or flagged
+         in error is dropped and its buffer recycled */
+      if(((status & (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) == (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) &&
+         ((status & ETH_DMARXDESC_ES) == (uint32_t)RESET))
+      {
+        /* Frame length without the CRC */
+        len = ((status & ETH_DMARXDESC_FL) >> ETH_DMARXDESC_FRAMELENGTHSHIFT) - 4;
+        if(eth_rx_free_cnt >= eth_rx_pending)
+        {
+          p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx->pc, Rx_Buff[rx->index], ETH_RX_BUF_SIZE);
+        }
+        else
+        {
+          /* Lending the buffer would leave a descriptor without one */
+          copy = rx;
+          break;
+        }
+      }
+
+      if(p == NULL)
+      {
+        eth_rx_free[eth_rx_free_cnt++] = rx->index;
+      }
+      eth_rx_refill();
+    }
+
+    SYS_ARCH_UNPROTECT(old_level);
+
+    if(copy != NULL)
+    {
+      /* The descriptor stays with the CPU until the buffer is put back, the
+         copy needs no lock */
+      p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+      if(p != NULL)
+      {
+        pbuf_take(p, Rx_Buff[copy->index], len);
+      }
+      else
+      {
+        LINK_STATS_INC(link.memerr);
+        LINK_STATS_INC(link.drop);
+      }
+
+      SYS_ARCH_PROTECT(old_level);
+      eth_rx_free[eth_rx_free_cnt++] = copy->index;
+      eth_rx_refill();
+      SYS_ARCH_UNPROTECT(old_level);
+    }
+  } while((p == NULL) && (copy != NULL));
+  return p;
+}
+#else
 /**
   * @brief Should allocate a pbuf and transfer the bytes of the incoming
   * packet from the interface into the pbuf.
@@ -506,6 +1078,8 @@ static struct pbuf * low_level_input(struct netif *netif)
   return p;
 }
 
+#endif /* ETHIF_RX_ZERO_COPY */
+
 /**
   * @brief This function is the ethernetif_input task, it is processed when a packet 
   * is ready to be read from the interface. It uses the function low_level_input() 
@@ -519,15 +1093,32 @@ void ethernetif_input( void const * argument )
 {
   struct pbuf *p;
   struct netif *netif = (struct netif *) argument;
+
+#if ETHIF_RX_BATCH
+  eth_rx_batch_msg = tcpip_callbackmsg_new(eth_rx_batch_deliver, netif);
+  if (eth_rx_batch_msg != NULL)
+  {
+    /* Never returns */
+    eth_rx_batch_loop(netif);
+  }
+  printf("ethernetif: batched input unavailable, delivering frame by frame\r\n");
+#endif
   
   for( ;; )
   {
     if (osSemaphoreWait( s_xSemaphore, TIME_WAITING_FOR_INPUT)==osOK)
     {
+#if ETHIF_TX_ZERO_COPY
+      eth_tx_reclaim();
+#endif
       do
       {
         p = low_level_input( netif );
-        if (p != NULL)
+        if ((p != NULL) && !eth_filter_input(p))
+        {
+          pbuf_free(p);
+        }
+        else if (p != NULL)
         {
           if (netif->input( p, netif) != ERR_OK )
           {
@@ -536,9 +1127,441 @@ void ethernetif_input( void const * argument )
         }
       }while(p!=NULL);
     }
+    eth_filter_poll();
+    eth_link_poll(netif);
   }
 }
 
+#if ETHIF_RX_BATCH
+/**
+  * @brief Runs in the tcpip thread: passes every frame in the ring to
+  * ethernet_input(), so a burst costs one mailbox message instead of one
+  * per frame.
+  *
+  * @param ctx the lwip network interface structure for this ethernetif
+  */
+static void eth_rx_batch_deliver(void *ctx)
+{
+  struct netif *netif = (struct netif *)ctx;
+  struct pbuf *p;
+  err_t err;
+  uint32_t n = 0;
+
+  /* Cleared before reading the ring: frames added from now on are either
+     seen below or posted again by the interface thread */
+  eth_rx_batch_queued = 0;
+
+  while (eth_rx_ring_tail != eth_rx_ring_head)
+  {
+    p = eth_rx_ring[eth_rx_ring_tail & (ETHIF_RX_BATCH_MAX - 1)];
+    eth_rx_ring_tail++;
+    PERF_START;
+    err = ethernet_input(p, netif);
+    PERF_STOP("ethernet_input");
+    if (err != ERR_OK)
+    {
+      pbuf_free(p);
+    }
+    n++;
+  }
+
+  eth_rx_stats.batches++;
+  eth_rx_stats.frames += n;
+  if (n > eth_rx_stats.max_batch)
+  {
+    eth_rx_stats.max_batch = n;
+  }
+
+  /* The interface thread stopped draining descriptors on a full ring and
+     no further Rx interrupt may come for the frames left behind */
+  if (n >= ETHIF_RX_BATCH_MAX)
+  {
+    osSemaphoreRelease(s_xSemaphore);
+  }
+}
+
+/**
+  * @brief Queues the batch message unless it is already waiting in the
+  * tcpip mailbox. A full mailbox is counted and retried by the caller.
+  */
+static void eth_rx_batch_post(void)
+{
+  if ((eth_rx_ring_head != eth_rx_ring_tail) && (eth_rx_batch_queued == 0))
+  {
+    eth_rx_batch_queued = 1;
+    if (tcpip_trycallback(eth_rx_batch_msg) != ERR_OK)
+    {
+      eth_rx_batch_queued = 0;
+      eth_rx_stats.mbox_full++;
+    }
+  }
+}
+
+/**
+  * @brief Interface thread body in batched mode: drains all ready
+  * descriptors into the ring, then posts it to the tcpip thread.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  */
+static void eth_rx_batch_loop(struct netif *netif)
+{
+  struct pbuf *p;
+
+  for( ;; )
+  {
+    /* A post refused by a full mailbox is retried on the next tick */
+    osSemaphoreWait(s_xSemaphore, ((eth_rx_ring_head != eth_rx_ring_tail) && (eth_rx_batch_queued == 0)) ?
+                                  1 : TIME_WAITING_FOR_INPUT);
+#if ETHIF_TX_ZERO_COPY
+    eth_tx_reclaim();
+#endif
+    /* Frames the ring has no room for stay in their descriptors */
+    while ((eth_rx_ring_head - eth_rx_ring_tail) < ETHIF_RX_BATCH_MAX)
+    {
+      p = low_level_input(netif);
+      if (p == NULL)
+      {
+        break;
+      }
+      if (!eth_filter_input(p))
+      {
+        pbuf_free(p);
+        continue;
+      }
+      eth_rx_ring[eth_rx_ring_head & (ETHIF_RX_BATCH_MAX - 1)] = p;
+      eth_rx_ring_head++;
+    }
+    eth_rx_batch_post();
+    eth_filter_poll();
+    eth_link_poll(netif);
+  }
+}
+
+/**
+  * @brief Returns a snapshot of the batched receive counters.
+  *
+  * @param stats filled with the counters
+  */
+void ethernetif_get_rx_stats(ethernetif_rx_stats_t *stats)
+{
+  *stats = eth_rx_stats;
+}
+#endif /* ETHIF_RX_BATCH */
+
+/*******************************************************************************
+                       MAC address filtering
+*******************************************************************************/
+/**
+  * @brief Takes over the frame filter HAL_ETH_Init() left in MACFFR: perfect
+  * filtering of unicast and multicast frames, no multicast address yet.
+  */
+static void eth_filter_init(void)
+{
+  memset(eth_filter, 0, sizeof(eth_filter));
+  memset(eth_filter_spill, 0, sizeof(eth_filter_spill));
+  eth_filter_ffr = EthHandle.Instance->MACFFR & ~(ETH_MACFFR_HPF | ETH_MACFFR_BFD | ETH_MACFFR_PAM | ETH_MACFFR_HM);
+  eth_filter_apply();
+}
+
+/**
+  * @brief Index of a MAC address in the 64 bit hash table: upper 6 bits of
+  * the complemented, bit reversed CRC-32 of the address.
+  */
+static uint32_t eth_filter_hash(const struct eth_addr *addr)
+{
+  uint32_t crc = 0xFFFFFFFFU;
+  uint32_t index = 0;
+  int i, j;
+
+  for (i = 0; i < ETH_HWADDR_LEN; i++)
+  {
+    crc ^= addr->addr[i];
+    for (j = 0; j < 8; j++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320U : 0U);
+    }
+  }
+  /* The 6 low bits of ~crc, reversed */
+  crc = ~crc;
+  for (i = 0; i < 6; i++)
+  {
+    index = (index << 1) | ((crc >> i) & 1U);
+  }
+  return index;
+}
+
+/**
+  * @brief Programs the MAC with the multicast addresses in eth_filter: the
+  * first ones in the perfect filters, the others in the hash table, which
+  * may let a few other groups through. The hash table also passes the
+  * joins counted in eth_filter_spill. Everything is recomputed from the
+  * current groups, the filter shrinks back as they are left.
+  * Runs in the tcpip thread.
+  */
+static void eth_filter_apply(void)
+{
+  uint32_t ht[2] = { 0, 0 };
+  uint32_t ffr = eth_filter_ffr & ~(ETH_MACFFR_HPF | ETH_MACFFR_PAM | ETH_MACFFR_HM);
+  uint32_t perfect = 0;
+  uint32_t hashed = 0;
+  uint32_t spilled = 0;
+  uint32_t index;
+  int i;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  for (i = 0; i < ETHIF_MAC_FILTER_MAX; i++)
+  {
+    const uint8_t *a = eth_filter[i].addr.addr;
+
+    if (eth_filter[i].ref == 0)
+    {
+      continue;
+    }
+    if (perfect < ETH_PERFECT_FILTERS)
+    {
+      /* Same layout as ETH_MACAddressConfig(), plus the address enable bit */
+      perfect++;
+      (*(__IO uint32_t *)(ETH_MAC_ADDR_HBASE + ETH_MAC_ADDRESS1 * perfect)) =
+        ETH_MACA1HR_AE | ((uint32_t)a[5] << 8) | (uint32_t)a[4];
+      (*(__IO uint32_t *)(ETH_MAC_ADDR_LBASE + ETH_MAC_ADDRESS1 * perfect)) =
+        ((uint32_t)a[3] << 24) | ((uint32_t)a[2] << 16) | ((uint32_t)a[1] << 8) | a[0];
+    }
+    else
+    {
+      index = eth_filter_hash(&eth_filter[i].addr);
+      ht[index >> 5] |= 1U << (index & 31U);
+      hashed++;
+    }
+  }
+  /* Unused perfect filters compare against nothing */
+  for (i = (int)perfect + 1; i <= ETH_PERFECT_FILTERS; i++)
+  {
+    (*(__IO uint32_t *)(ETH_MAC_ADDR_HBASE + ETH_MAC_ADDRESS1 * i)) = 0;
+  }
+  for (i = 0; i < ETH_HASH_BITS; i++)
+  {
+    if (eth_filter_spill[i] != 0)
+    {
+      ht[i >> 5] |= 1U << (i & 31);
+      spilled += eth_filter_spill[i];
+    }
+  }
+
+  EthHandle.Instance->MACHTHR = ht[1];
+  EthHandle.Instance->MACHTLR = ht[0];
+  if ((hashed != 0) || (spilled != 0))
+  {
+    ffr |= ETH_MACFFR_HPF | ETH_MACFFR_HM;
+  }
+
+  SYS_ARCH_PROTECT(lev);
+  eth_filter_ffr = ffr;
+  EthHandle.Instance->MACFFR = ffr | (eth_bcast_blocked ? ETH_MACFFR_BFD : 0);
+  SYS_ARCH_UNPROTECT(lev);
+
+  eth_filter_stats.groups = perfect + hashed + spilled;
+  eth_filter_stats.hashed = hashed + spilled;
+  eth_filter_stats.spilled = spilled;
+}
+
+/**
+  * @brief Lets the frames sent to a multicast MAC address through, or stops
+  * them. Several groups may map to one address: it is counted.
+  * Must be called from the tcpip thread.
+  *
+  * @param addr multicast MAC address
+  * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+  * @return ERR_OK, or ERR_MEM if the join could not be counted
+  */
+err_t ethernetif_mac_filter(const struct eth_addr *addr, enum netif_mac_filter_action action)
+{
+  eth_filter_entry_t *free_entry = NULL;
+  uint32_t index;
+  int i;
+
+  for (i = 0; i < ETHIF_MAC_FILTER_MAX; i++)
+  {
+    if (eth_filter[i].ref == 0)
+    {
+      if (free_entry == NULL)
+      {
+        free_entry = &eth_filter[i];
+      }
+    }
+    else if (eth_addr_cmp(&eth_filter[i].addr, addr))
+    {
+      break;
+    }
+  }
+
+  if (action == NETIF_ADD_MAC_FILTER)
+  {
+    if (i < ETHIF_MAC_FILTER_MAX)
+    {
+      eth_filter[i].ref++;
+      return ERR_OK;
+    }
+    if (free_entry == NULL)
+    {
+      /* Table full (ETHIF_MAC_FILTER_MAX too small): the address is only
+         known by its hash index until it is left */
+      index = eth_filter_hash(addr);
+      if (eth_filter_spill[index] == 0xFF)
+      {
+        return ERR_MEM;
+      }
+      eth_filter_spill[index]++;
+    }
+    else
+    {
+      memcpy(&free_entry->addr, addr, ETH_HWADDR_LEN);
+      free_entry->ref = 1;
+    }
+  }
+  else if (i < ETHIF_MAC_FILTER_MAX)
+  {
+    if (--eth_filter[i].ref != 0)
+    {
+      return ERR_OK;
+    }
+  }
+  else
+  {
+    /* Not in the table: one of the joins that didn't fit, if any */
+    index = eth_filter_hash(addr);
+    if (eth_filter_spill[index] == 0)
+    {
+      return ERR_OK;
+    }
+    eth_filter_spill[index]--;
+  }
+  eth_filter_apply();
+  return ERR_OK;
+}
+
+#if LWIP_IGMP
+/**
+  * @brief netif->igmp_mac_filter: maps an IPv4 group to 01:00:5e plus its
+  * low 23 bits.
+  */
+err_t ethernetif_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group,
+                                 enum netif_mac_filter_action action)
+{
+  struct eth_addr addr;
+  uint32_t ip = lwip_ntohl(ip4_addr_get_u32(group));
+
+  LWIP_UNUSED_ARG(netif);
+
+  addr.addr[0] = 0x01;
+  addr.addr[1] = 0x00;
+  addr.addr[2] = 0x5e;
+  addr.addr[3] = (uint8_t)((ip >> 16) & 0x7f);
+  addr.addr[4] = (uint8_t)(ip >> 8);
+  addr.addr[5] = (uint8_t)ip;
+  return ethernetif_mac_filter(&addr, action);
+}
+#endif /* LWIP_IGMP */
+
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+/**
+  * @brief netif->mld_mac_filter: maps an IPv6 group to 33:33 plus its low
+  * 32 bits.
+  */
+err_t ethernetif_mld_mac_filter(struct netif *netif, const ip6_addr_t *group,
+                                enum netif_mac_filter_action action)
+{
+  struct eth_addr addr;
+  uint32_t ip = lwip_ntohl(group->addr[3]);
+
+  LWIP_UNUSED_ARG(netif);
+
+  addr.addr[0] = 0x33;
+  addr.addr[1] = 0x33;
+  addr.addr[2] = (uint8_t)(ip >> 24);
+  addr.addr[3] = (uint8_t)(ip >> 16);
+  addr.addr[4] = (uint8_t)(ip >> 8);
+  addr.addr[5] = (uint8_t)ip;
+  return ethernetif_mac_filter(&addr, action);
+}
+#endif /* LWIP_IPV6 && LWIP_IPV6_MLD */
+
+/**
+  * @brief Counts the group frames the MAC let through, and past
+  * ETHIF_BCAST_LIMIT broadcasts in a second drops them and has the MAC
+  * discard the following ones until the second is over. Runs in the
+  * interface thread, before the frame costs the tcpip thread anything.
+  *
+  * @return 0 to drop the frame
+  */
+static uint8_t eth_filter_input(struct pbuf *p)
+{
+  const struct eth_addr *dst = (const struct eth_addr *)p->payload;
+
+  if ((dst->addr[0] & 0x01) == 0)
+  {
+    return 1;
+  }
+  if (!eth_addr_cmp(dst, &ethbroadcast))
+  {
+    eth_filter_stats.multicast++;
+    return 1;
+  }
+  eth_filter_stats.broadcast++;
+#if ETHIF_BCAST_LIMIT
+  if (++eth_bcast_count > ETHIF_BCAST_LIMIT)
+  {
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    eth_filter_stats.bcast_dropped++;
+    if (!eth_bcast_blocked)
+    {
+      SYS_ARCH_PROTECT(lev);
+      eth_bcast_blocked = 1;
+      EthHandle.Instance->MACFFR = eth_filter_ffr | ETH_MACFFR_BFD;
+      SYS_ARCH_UNPROTECT(lev);
+      eth_filter_stats.bcast_blocked++;
+    }
+    return 0;
+  }
+#endif
+  return 1;
+}
+
+/**
+  * @brief Opens a new broadcast window when the current one is over, from
+  * the interface thread. Broadcasts are accepted by the MAC again.
+  */
+static void eth_filter_poll(void)
+{
+#if ETHIF_BCAST_LIMIT
+  uint32_t now = HAL_GetTick();
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  if ((now - eth_bcast_window) < ETH_BCAST_WINDOW_MS)
+  {
+    return;
+  }
+  eth_bcast_window = now;
+  eth_bcast_count = 0;
+  if (eth_bcast_blocked)
+  {
+    SYS_ARCH_PROTECT(lev);
+    eth_bcast_blocked = 0;
+    EthHandle.Instance->MACFFR = eth_filter_ffr;
+    SYS_ARCH_UNPROTECT(lev);
+  }
+#endif
+}
+
+/**
+  * @brief Copies the frame filter counters.
+  * @param stats where to copy them
+  */
+void ethernetif_get_filter_stats(ethernetif_filter_stats_t *stats)
+{
+  *stats = eth_filter_stats;
+}
+
 /**
   * @brief Should be called at the beginning of the program to set up the
   * network interface. It calls the function low_level_init() to do the
@@ -569,6 +1592,12 @@ err_t ethernetif_init(struct netif *netif)
    * is available...) */
   netif->output = etharp_output;
   netif->linkoutput = low_level_output;
+#if LWIP_IGMP
+  netif_set_igmp_mac_filter(netif, ethernetif_igmp_mac_filter);
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+  netif_set_mld_mac_filter(netif, ethernetif_mld_mac_filter);
+#endif
 
   /* initialize the hardware */
   if(HAL_OK != low_level_init(netif))
@@ -589,36 +1618,108 @@ u32_t sys_now(void)
 }
 
 
-#if 0
 /**
-  * @brief  This function sets the netif link status.
-  * @param  netif: the network interface
-  * @retval None
+  * @brief Runs in the tcpip thread: passes the state of the link manager
+  * to lwIP, which calls the link callback (ethernetif_update_config()).
+  *
+  * @param ctx the lwip network interface structure for this ethernetif
   */
-void ethernetif_set_link(struct netif *netif)
+static void eth_link_report(void *ctx)
 {
+  struct netif *netif = (struct netif *)ctx;
+
+  if (eth_link_state == ETH_LINK_UP)
+  {
+    netif_set_link_up(netif);
+  }
+  else
+  {
+    netif_set_link_down(netif);
+  }
+}
+
+/**
+  * @brief Link manager, called by the interface thread after every wake up.
+  * Every ETHIF_LINK_POLL_MS, or at once after a PHY interrupt, it reads the
+  * PHY status: a few MDIO transfers, never a wait. The PHY negotiates by
+  * itself and is simply looked at again on the next step. When the link
+  * comes up the MAC is set to the negotiated speed and duplex before the
+  * tcpip thread is told, so nothing is sent in the wrong mode.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  */
+static void eth_link_poll(struct netif *netif)
+{
+  uint32_t now = HAL_GetTick();
   uint32_t regvalue = 0;
-  
-  /* Read PHY_MISR*/
-  HAL_ETH_ReadPHYRegister(&EthHandle, PHY_MISR, &regvalue);
-  
-  /* Check whether the link interrupt has occurred or not */
-  if((regvalue & PHY_LINK_INTERRUPT) != (uint16_t)RESET)
+  uint8_t up;
+
+#if ETHIF_LINK_PHY_IRQ
+  if (eth_link_irq)
+  {
+    eth_link_irq = 0;
+    /* Reading the source flags acknowledges the interrupt */
+    HAL_ETH_ReadPHYRegister(&EthHandle, PHY_ISFR, &regvalue);
+  }
+  else
+#endif
+  if ((now - eth_link_polled) < ETHIF_LINK_POLL_MS)
+  {
+    return;
+  }
+  eth_link_polled = now;
+
+  if (HAL_ETH_ReadPHYRegister(&EthHandle, PHY_BSR, &regvalue) != HAL_OK)
   {
-    /* Read PHY_SR*/
+    return;
+  }
+  up = ((regvalue & (PHY_LINKED_STATUS | PHY_AUTONEGO_COMPLETE)) == (PHY_LINKED_STATUS | PHY_AUTONEGO_COMPLETE));
+
+  if (up && (eth_link_state == ETH_LINK_DOWN))
+  {
+    /* Read the result of the auto-negotiation */
     HAL_ETH_ReadPHYRegister(&EthHandle, PHY_SR, &regvalue);
-    
-    /* Check whether the link is up or down*/
-    if((regvalue & PHY_LINK_STATUS)!= (uint16_t)RESET)
+    EthHandle.Init.DuplexMode = (regvalue & PHY_DUPLEX_STATUS) ? ETH_MODE_FULLDUPLEX : ETH_MODE_HALFDUPLEX;
+    EthHandle.Init.Speed = (regvalue & PHY_SPEED_STATUS) ? ETH_SPEED_10M : ETH_SPEED_100M;
+
+    /* ETHERNET MAC Re-Configuration, the link is still down for lwIP */
+    HAL_ETH_ConfigMAC(&EthHandle, (ETH_MACInitTypeDef *) NULL);
+    eth_link_state = ETH_LINK_UP;
+    eth_link_changed = 1;
+  }
+  else if (!up && (eth_link_state == ETH_LINK_UP))
+  {
+    /* The PHY restarts the negotiation by itself */
+    eth_link_state = ETH_LINK_DOWN;
+    eth_link_changed = 1;
+  }
+
+  if (eth_link_changed)
+  {
+    if (eth_link_msg == NULL)
     {
-      netif_set_link_up(netif);
+      eth_link_msg = tcpip_callbackmsg_new(eth_link_report, netif);
     }
-    else
+    /* A full mailbox is retried on the next step */
+    if ((eth_link_msg != NULL) && (tcpip_trycallback(eth_link_msg) == ERR_OK))
     {
-      netif_set_link_down(netif);
+      eth_link_changed = 0;
     }
   }
 }
+
+#if ETHIF_LINK_PHY_IRQ
+/**
+  * @brief  Call from the handler of the EXTI line the PHY nINT pin is wired
+  *         to: the interface thread checks the link at once.
+  * @param  None
+  * @retval None
+  */
+void ethernetif_phy_irq(void)
+{
+  eth_link_irq = 1;
+  osSemaphoreRelease(s_xSemaphore);
+}
 #endif
 
 /**
@@ -635,93 +1736,13 @@ __weak void ethernetif_notify_conn_changed(struct netif *netif)
 
 
 /**
-  * @brief  Link callback function, this function is called on change of link status
-  *         to update low level driver configuration.
+  * @brief  Link callback function, this function is called on change of link status.
+  *         The MAC already runs at the negotiated speed and duplex, see eth_link_poll().
   * @param  netif: The network interface
   * @retval None
   */
 void ethernetif_update_config(struct netif *netif)
 {
-  __IO uint32_t tickstart = 0;
-  uint32_t regvalue = 0;
-
-#if 0
-  
-  if(netif_is_link_up(netif))
-  { 
-    /* Restart the auto-negotiation */
-    if(EthHandle.Init.AutoNegotiation != ETH_AUTONEGOTIATION_DISABLE)
-    {
-      /* Enable Auto-Negotiation */
-      HAL_ETH_WritePHYRegister(&EthHandle, PHY_BCR, PHY_AUTONEGOTIATION);
-      
-      /* Get tick */
-      tickstart = HAL_GetTick();
-      
-      /* Wait until the auto-negotiation will be completed */
-      do
-      {
-        HAL_ETH_ReadPHYRegister(&EthHandle, PHY_BSR, &regvalue);
-        
-        /* Check for the Timeout ( 1s ) */
-        if((HAL_GetTick() - tickstart ) > 1000)
-        {
-          /* In case of timeout */
-          goto error;
-        }
-        
-      } while (((regvalue & PHY_AUTONEGO_COMPLETE) != PHY_AUTONEGO_COMPLETE));
-      
-      /* Read the result of the auto-negotiation */
-      HAL_ETH_ReadPHYRegister(&EthHandle, PHY_SR, &regvalue);
-      
-      /* Configure the MAC with the Duplex Mode fixed by the auto-negotiation process */
-      if((regvalue & PHY_DUPLEX_STATUS) != (uint32_t)RESET)
-      {
-        /* Set Ethernet duplex mode to Full-duplex following the auto-negotiation */
-        EthHandle.Init.DuplexMode = ETH_MODE_FULLDUPLEX;  
-      }
-      else
-      {
-        /* Set Ethernet duplex mode to Half-duplex following the auto-negotiation */
-        EthHandle.Init.DuplexMode = ETH_MODE_HALFDUPLEX;           
-      }
-      /* Configure the MAC with the speed fixed by the auto-negotiation process */
-      if(regvalue & PHY_SPEED_STATUS)
-      {  
-        /* Set Ethernet speed to 10M following the auto-negotiation */
-        EthHandle.Init.Speed = ETH_SPEED_10M; 
-      }
-      else
-      {   
-        /* Set Ethernet speed to 100M following the auto-negotiation */ 
-        EthHandle.Init.Speed = ETH_SPEED_100M;
-      }
-    }
-    else /* AutoNegotiation Disable */
-    {
-    error :
-      /* Check parameters */
-      assert_param(IS_ETH_SPEED(EthHandle.Init.Speed));
-      assert_param(IS_ETH_DUPLEX_MODE(EthHandle.Init.DuplexMode));
-      
-      /* Set MAC Speed and Duplex Mode to PHY */
-      HAL_ETH_WritePHYRegister(&EthHandle, PHY_BCR, ((uint16_t)(EthHandle.Init.DuplexMode >> 3) |
-                                                     (uint16_t)(EthHandle.Init.Speed >> 1))); 
-    }
-
-    /* ETHERNET MAC Re-Configuration */
-    HAL_ETH_ConfigMAC(&EthHandle, (ETH_MACInitTypeDef *) NULL);
-
-    /* Restart MAC interface */
-    HAL_ETH_Start(&EthHandle);   
-  }
-  else
-  {
-    /* Stop MAC interface */
-    HAL_ETH_Stop(&EthHandle);
-  }
-#endif
   ethernetif_notify_conn_changed(netif);
 }
 
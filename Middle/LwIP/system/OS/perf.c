@@ -0,0 +1,182 @@
+/*
+ * Histograms of the PERF_START/PERF_STOP sites of the stack, see arch/perf.h.
+ */
+#include <string.h>
+
+#include "lwip/opt.h"
+
+#if LWIP_PERF /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/def.h"
+#include "lwip/sys.h"
+#include "lwip/stats.h"
+#include "lwip/timeouts.h"
+
+static struct perf_site perf_sites[PERF_MAX_SITES];
+static int perf_nsites;
+static u32_t perf_dump_interval;
+
+/**
+ * Starts the clock. Called from sys_init(), before any site runs.
+ */
+void perf_init(void)
+{
+  PERF_CLOCK_INIT();
+}
+
+/* Site called name, created on first use. Sites beyond PERF_MAX_SITES are
+   not recorded. */
+static struct perf_site *perf_site_of(const char *name)
+{
+  int i;
+
+  for (i = 0; i < perf_nsites; i++) {
+    if (strcmp(perf_sites[i].name, name) == 0) {
+      return &perf_sites[i];
+    }
+  }
+  if (perf_nsites == PERF_MAX_SITES) {
+    return NULL;
+  }
+  perf_sites[perf_nsites].name = name;
+  perf_sites[perf_nsites].min = 0xffffffffUL;
+  return &perf_sites[perf_nsites++];
+}
+
+static int perf_bucket(u32_t elapsed)
+{
+  int i = 0;
+
+  while ((elapsed > 1) && (i < PERF_HIST_BUCKETS - 1)) {
+    elapsed >>= 1;
+    i++;
+  }
+  return i;
+}
+
+/**
+ * Adds a sample to a site. The site is looked up by name on the first call
+ * from a PERF_STOP and cached in *site after that, so the PERF_STOPs of one
+ * function with the same name share a histogram.
+ */
+void perf_record(struct perf_site **site, const char *name, u32_t elapsed)
+{
+  struct perf_site *s;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  if (*site == NULL) {
+    *site = perf_site_of(name);
+  }
+  s = *site;
+  if (s != NULL) {
+    s->count++;
+    s->total += elapsed;
+    if (elapsed < s->min) {
+      s->min = elapsed;
+    }
+    if (elapsed > s->max) {
+      s->max = elapsed;
+    }
+    s->hist[perf_bucket(elapsed)]++;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+}
+
+/**
+ * Copies the site at index, in order of first use.
+ * @return 0, or -1 past the last site
+ */
+int perf_get(int index, struct perf_site *site)
+{
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  if ((index < 0) || (index >= perf_nsites)) {
+    return -1;
+  }
+  SYS_ARCH_PROTECT(lev);
+  *site = perf_sites[index];
+  SYS_ARCH_UNPROTECT(lev);
+  return 0;
+}
+
+/**
+ * Upper bound of the duration under which percent % of the samples of a
+ * site fall, to the resolution of the histogram.
+ */
+u32_t perf_percentile(const struct perf_site *site, u32_t percent)
+{
+  u32_t rank = (u32_t)(((unsigned long long)site->count * percent + 99) / 100);
+  u32_t seen = 0;
+  int i;
+
+  for (i = 0; i < PERF_HIST_BUCKETS; i++) {
+    seen += site->hist[i];
+    if ((seen >= rank) && (seen != 0)) {
+      return (i == PERF_HIST_BUCKETS - 1) ? site->max : LWIP_MIN((2UL << i) - 1, site->max);
+    }
+  }
+  return site->max;
+}
+
+/**
+ * Clears the samples of every site, the sites themselves stay.
+ */
+void perf_reset(void)
+{
+  int i;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  for (i = 0; i < perf_nsites; i++) {
+    const char *name = perf_sites[i].name;
+    memset(&perf_sites[i], 0, sizeof(perf_sites[i]));
+    perf_sites[i].name = name;
+    perf_sites[i].min = 0xffffffffUL;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+}
+
+/**
+ * Prints one line per site with LWIP_PLATFORM_DIAG.
+ */
+void perf_dump(void)
+{
+  struct perf_site s;
+  int i;
+
+  for (i = 0; perf_get(i, &s) == 0; i++) {
+    if (s.count == 0) {
+      continue;
+    }
+    LWIP_PLATFORM_DIAG(("perf %s n=%"U32_F" min=%"U32_F" avg=%"U32_F" p50=%"U32_F" p99=%"U32_F" max=%"U32_F" %s\n",
+                        s.name, s.count, s.min, (u32_t)(s.total / s.count), perf_percentile(&s, 50),
+                        perf_percentile(&s, 99), s.max, PERF_CLOCK_UNIT));
+  }
+}
+
+static void perf_dump_timer(void *arg)
+{
+  LWIP_UNUSED_ARG(arg);
+
+  perf_dump();
+#if LWIP_STATS_DISPLAY
+  stats_display();
+#endif /* LWIP_STATS_DISPLAY */
+  sys_timeout(perf_dump_interval, perf_dump_timer, NULL);
+}
+
+/**
+ * Dumps the sites, and the lwIP statistics, every interval_ms. 0 stops.
+ * Must be called from the tcpip thread (or with the core locked).
+ */
+void perf_dump_start(u32_t interval_ms)
+{
+  sys_untimeout(perf_dump_timer, NULL);
+  perf_dump_interval = interval_ms;
+  if (interval_ms != 0) {
+    sys_timeout(interval_ms, perf_dump_timer, NULL);
+  }
+}
+
+#endif /* LWIP_PERF */
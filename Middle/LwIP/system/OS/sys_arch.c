@@ -45,24 +45,47 @@
 int errno;
 #endif
 
+/*-----------------------------------------------------------------------------------*/
+/*
+  Mailboxes, semaphores and mutexes sit directly on FreeRTOS queues rather
+  than on the CMSIS-RTOS wrappers: the wrappers add a handler-mode test, an
+  osEvent copy and a tick conversion to every call, and osMessagePut cannot
+  tell a full queue from an error. Calls made from an interrupt handler are
+  detected and take the FromISR path.
+*/
+/* Milliseconds to ticks, never 0 so that a short timeout still blocks */
+static TickType_t sys_ms_to_ticks(u32_t ms)
+{
+  TickType_t ticks = (TickType_t)(ms / portTICK_PERIOD_MS);
+
+  return (ticks == 0) ? 1 : ticks;
+}
+
+static u32_t sys_ticks_to_ms(TickType_t ticks)
+{
+  return (u32_t)ticks * portTICK_PERIOD_MS;
+}
+
 /*-----------------------------------------------------------------------------------*/
 //  Creates an empty mailbox.
 err_t sys_mbox_new(sys_mbox_t *mbox, int size)
 {
-  osMessageQDef(QUEUE, size, void *);
-  
-  *mbox = osMessageCreate(osMessageQ(QUEUE), NULL);
+  *mbox = xQueueCreate((UBaseType_t)size, sizeof(void *));
+  if (*mbox == NULL)
+  {
+#if SYS_STATS
+    ++lwip_stats.sys.mbox.err;
+#endif /* SYS_STATS */
+    return ERR_MEM;
+  }
 
 #if SYS_STATS
-      ++lwip_stats.sys.mbox.used;
-      if (lwip_stats.sys.mbox.max < lwip_stats.sys.mbox.used) {
-         lwip_stats.sys.mbox.max = lwip_stats.sys.mbox.used;
-	  }
+  ++lwip_stats.sys.mbox.used;
+  if (lwip_stats.sys.mbox.max < lwip_stats.sys.mbox.used) {
+    lwip_stats.sys.mbox.max = lwip_stats.sys.mbox.used;
+  }
 #endif /* SYS_STATS */
- if (*mbox == NULL)
-  return ERR_MEM;
- 
- return ERR_OK;
+  return ERR_OK;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -73,53 +96,66 @@ err_t sys_mbox_new(sys_mbox_t *mbox, int size)
 */
 void sys_mbox_free(sys_mbox_t *mbox)
 {
-	if( osMessageWaiting(*mbox) )
-	{
-		/* Line for breakpoint.  Should never break here! */
-		portNOP();
+  if (uxQueueMessagesWaiting(*mbox) != 0)
+  {
+    /* Line for breakpoint.  Should never break here! */
+    portNOP();
 #if SYS_STATS
-	    lwip_stats.sys.mbox.err++;
+    lwip_stats.sys.mbox.err++;
 #endif /* SYS_STATS */
-			
-		// TODO notify the user of failure.
-	}
+  }
 
-	osMessageDelete(*mbox);
+  vQueueDelete(*mbox);
 
 #if SYS_STATS
-     --lwip_stats.sys.mbox.used;
+  --lwip_stats.sys.mbox.used;
 #endif /* SYS_STATS */
 }
 
 /*-----------------------------------------------------------------------------------*/
-//   Posts the "msg" to the mailbox.
+//   Posts the "msg" to the mailbox, blocking while it is full.
 void sys_mbox_post(sys_mbox_t *mbox, void *data)
 {
-  while(osMessagePut(*mbox, (uint32_t)data, osWaitForever) != osOK);
+  while (xQueueSendToBack(*mbox, &data, portMAX_DELAY) != pdTRUE);
 }
 
-
 /*-----------------------------------------------------------------------------------*/
 //   Try to post the "msg" to the mailbox.
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
 {
-err_t result;
-
-   if ( osMessagePut(*mbox, (uint32_t)msg, 0) == osOK)
-   {
-      result = ERR_OK;
-   }
-   else {
-      // could not post, queue must be full
-      result = ERR_MEM;
-			
+  if (xPortIsInsideInterrupt())
+  {
+    return sys_mbox_trypost_fromisr(mbox, msg);
+  }
+
+  if (xQueueSendToBack(*mbox, &msg, 0) == pdTRUE)
+  {
+    return ERR_OK;
+  }
+
+  // could not post, queue must be full
+#if SYS_STATS
+  lwip_stats.sys.mbox.err++;
+#endif /* SYS_STATS */
+  return ERR_MEM;
+}
+
+/*-----------------------------------------------------------------------------------*/
+//   Try to post the "msg" to the mailbox from an interrupt handler.
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg)
+{
+  BaseType_t woken = pdFALSE;
+
+  if (xQueueSendToBackFromISR(*mbox, &msg, &woken) != pdTRUE)
+  {
 #if SYS_STATS
-      lwip_stats.sys.mbox.err++;
+    lwip_stats.sys.mbox.err++;
 #endif /* SYS_STATS */
-			
-   }
+    return ERR_MEM;
+  }
 
-   return result;
+  portYIELD_FROM_ISR(woken);
+  return ERR_OK;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -140,29 +176,28 @@ err_t result;
 */
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
 {
-  osEvent event;
-  uint32_t starttime = osKernelSysTick();;
-  
-  if(timeout != 0)
-  { 
-    event = osMessageGet (*mbox, timeout);
-    
-    if(event.status == osEventMessage)
-    {
-      *msg = (void *)event.value.v;
-      return (osKernelSysTick() - starttime);
-    }
-    else
+  void *dummy;
+  TickType_t starttime = xTaskGetTickCount();
+
+  if (msg == NULL)
+  {
+    msg = &dummy;
+  }
+
+  if (timeout != 0)
+  {
+    if (xQueueReceive(*mbox, msg, sys_ms_to_ticks(timeout)) != pdTRUE)
     {
+      *msg = NULL;
       return SYS_ARCH_TIMEOUT;
-    } 
+    }
   }
   else
   {
-    event = osMessageGet (*mbox, osWaitForever);
-    *msg = (void *)event.value.v;
-    return (osKernelSysTick() - starttime);
+    while (xQueueReceive(*mbox, msg, portMAX_DELAY) != pdTRUE);
   }
+
+  return sys_ticks_to_ms(xTaskGetTickCount() - starttime);
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -172,64 +207,68 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
 */
 u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
 {
-  osEvent event;
-  
-  event = osMessageGet (*mbox, 0);
-  
-  if(event.status == osEventMessage)
+  void *dummy;
+  BaseType_t ok;
+
+  if (msg == NULL)
   {
-    *msg = (void *)event.value.v;
-    return ERR_OK;
+    msg = &dummy;
+  }
+
+  if (xPortIsInsideInterrupt())
+  {
+    BaseType_t woken = pdFALSE;
+
+    ok = xQueueReceiveFromISR(*mbox, msg, &woken);
+    portYIELD_FROM_ISR(woken);
   }
   else
   {
-    return SYS_MBOX_EMPTY;
+    ok = xQueueReceive(*mbox, msg, 0);
   }
+
+  return (ok == pdTRUE) ? 0 : SYS_MBOX_EMPTY;
 }
 /*----------------------------------------------------------------------------------*/
-int sys_mbox_valid(sys_mbox_t *mbox)          
-{      
-  if (*mbox == SYS_MBOX_NULL) 
+int sys_mbox_valid(sys_mbox_t *mbox)
+{
+  if (*mbox == SYS_MBOX_NULL)
     return 0;
   else
     return 1;
-}                                             
-/*-----------------------------------------------------------------------------------*/                                              
-void sys_mbox_set_invalid(sys_mbox_t *mbox)   
-{                                             
-  *mbox = SYS_MBOX_NULL;                      
-}                                             
+}
+/*-----------------------------------------------------------------------------------*/
+void sys_mbox_set_invalid(sys_mbox_t *mbox)
+{
+  *mbox = SYS_MBOX_NULL;
+}
 
 /*-----------------------------------------------------------------------------------*/
 //  Creates a new semaphore. The "count" argument specifies
 //  the initial state of the semaphore.
 err_t sys_sem_new(sys_sem_t *sem, u8_t count)
 {
-  osSemaphoreDef(SEM);
-
-  *sem = osSemaphoreCreate (osSemaphore(SEM), 1);
-	
-  if(*sem == NULL)
+  *sem = xSemaphoreCreateBinary();
+  if (*sem == NULL)
   {
 #if SYS_STATS
-      ++lwip_stats.sys.sem.err;
-#endif /* SYS_STATS */	
-		return ERR_MEM;
+    ++lwip_stats.sys.sem.err;
+#endif /* SYS_STATS */
+    return ERR_MEM;
   }
-	
-  if(count == 0)	// Means it can't be taken
+
+  if (count != 0)
   {
-    osSemaphoreWait(*sem,0);
+    xSemaphoreGive(*sem);
   }
 
 #if SYS_STATS
-	++lwip_stats.sys.sem.used;
- 	if (lwip_stats.sys.sem.max < lwip_stats.sys.sem.used) {
-		lwip_stats.sys.sem.max = lwip_stats.sys.sem.used;
-	}
+  ++lwip_stats.sys.sem.used;
+  if (lwip_stats.sys.sem.max < lwip_stats.sys.sem.used) {
+    lwip_stats.sys.sem.max = lwip_stats.sys.sem.used;
+  }
 #endif /* SYS_STATS */
-		
-	return ERR_OK;
+  return ERR_OK;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -250,31 +289,38 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count)
 */
 u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
 {
-  uint32_t starttime = osKernelSysTick();
-  
-  if(timeout != 0)
-  {    
-    if(osSemaphoreWait (*sem, timeout) == osOK)
-    {
-      return (osKernelSysTick() - starttime);
-    }
-    else
+  TickType_t starttime = xTaskGetTickCount();
+
+  if (timeout != 0)
+  {
+    if (xSemaphoreTake(*sem, sys_ms_to_ticks(timeout)) != pdTRUE)
     {
       return SYS_ARCH_TIMEOUT;
-    } 
+    }
   }
   else
   {
-    while(osSemaphoreWait (*sem, osWaitForever) != osOK);
-    return (osKernelSysTick() - starttime);
+    while (xSemaphoreTake(*sem, portMAX_DELAY) != pdTRUE);
   }
+
+  return sys_ticks_to_ms(xTaskGetTickCount() - starttime);
 }
 
 /*-----------------------------------------------------------------------------------*/
-// Signals a semaphore
+// Signals a semaphore, from a thread or an interrupt handler
 void sys_sem_signal(sys_sem_t *sem)
 {
-  osSemaphoreRelease(*sem);
+  if (xPortIsInsideInterrupt())
+  {
+    BaseType_t woken = pdFALSE;
+
+    xSemaphoreGiveFromISR(*sem, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+  else
+  {
+    xSemaphoreGive(*sem);
+  }
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -284,54 +330,51 @@ void sys_sem_free(sys_sem_t *sem)
 #if SYS_STATS
   --lwip_stats.sys.sem.used;
 #endif /* SYS_STATS */
-  
-  osSemaphoreDelete(*sem);
+
+  vSemaphoreDelete(*sem);
 }
 /*-----------------------------------------------------------------------------------*/
-int sys_sem_valid(sys_sem_t *sem)                                               
+int sys_sem_valid(sys_sem_t *sem)
 {
   if (*sem == SYS_SEM_NULL)
     return 0;
   else
-    return 1;                                       
+    return 1;
 }
 
-/*-----------------------------------------------------------------------------------*/                                                                                                                                                                
-void sys_sem_set_invalid(sys_sem_t *sem)                                        
-{                                                                               
-  *sem = SYS_SEM_NULL;                                                          
-} 
+/*-----------------------------------------------------------------------------------*/
+void sys_sem_set_invalid(sys_sem_t *sem)
+{
+  *sem = SYS_SEM_NULL;
+}
 
-/*-----------------------------------------------------------------------------------*/ 
-osMutexId lwip_sys_mutex;
-osMutexDef(lwip_sys_mutex);
+/*-----------------------------------------------------------------------------------*/
 // Initialize sys arch
 void sys_init(void)
 {
-  lwip_sys_mutex = osMutexCreate(osMutex(lwip_sys_mutex));
+#if LWIP_PERF
+  perf_init();
+#endif /* LWIP_PERF */
 }
 /*-----------------------------------------------------------------------------------*/
                                       /* Mutexes*/
 /*-----------------------------------------------------------------------------------*/
 /*-----------------------------------------------------------------------------------*/
 #if LWIP_COMPAT_MUTEX == 0
-/* Create a new mutex*/
+/* Create a new mutex. FreeRTOS mutexes inherit priority: a low priority
+   thread holding the core lock (LWIP_TCPIP_CORE_LOCKING) is raised to the
+   priority of the highest thread waiting for it, tcpip_thread included. */
 err_t sys_mutex_new(sys_mutex_t *mutex) {
-  
-  osMutexDef(MUTEX);
-  
-  *mutex = osMutexCreate(osMutex(MUTEX));
-  
-  
-  //*mutex = xSemaphoreCreateMutex();
+
+  *mutex = xSemaphoreCreateMutex();
   if(*mutex == NULL)
   {
 #if SYS_STATS
     ++lwip_stats.sys.mutex.err;
-#endif /* SYS_STATS */	
+#endif /* SYS_STATS */
     return ERR_MEM;
   }
-  
+
 #if SYS_STATS
   ++lwip_stats.sys.mutex.used;
   if (lwip_stats.sys.mutex.max < lwip_stats.sys.mutex.used) {
@@ -345,23 +388,23 @@ err_t sys_mutex_new(sys_mutex_t *mutex) {
 void sys_mutex_free(sys_mutex_t *mutex)
 {
 #if SYS_STATS
-      --lwip_stats.sys.mutex.used;
+  --lwip_stats.sys.mutex.used;
 #endif /* SYS_STATS */
-			
-  osMutexDelete(*mutex);
+
+  vSemaphoreDelete(*mutex);
 }
 /*-----------------------------------------------------------------------------------*/
 /* Lock a mutex*/
 void sys_mutex_lock(sys_mutex_t *mutex)
 {
-  osMutexWait (*mutex, osWaitForever);
+  while (xSemaphoreTake(*mutex, portMAX_DELAY) != pdTRUE);
 }
 
 /*-----------------------------------------------------------------------------------*/
 /* Unlock a mutex*/
 void sys_mutex_unlock(sys_mutex_t *mutex)
 {
-  osMutexRelease(*mutex);
+  xSemaphoreGive(*mutex);
 }
 #endif /*LWIP_COMPAT_MUTEX*/
 /*-----------------------------------------------------------------------------------*/
@@ -397,8 +440,13 @@ sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread , void *arg,
 */
 sys_prot_t sys_arch_protect(void)
 {
-  osMutexWait(lwip_sys_mutex, osWaitForever);
-  return (sys_prot_t)1;
+  if (xPortIsInsideInterrupt())
+  {
+    return (sys_prot_t)portSET_INTERRUPT_MASK_FROM_ISR();
+  }
+
+  taskENTER_CRITICAL();
+  return (sys_prot_t)0;
 }
 
 
@@ -413,8 +461,14 @@ sys_prot_t sys_arch_protect(void)
 */
 void sys_arch_unprotect(sys_prot_t pval)
 {
-  ( void ) pval;
-  osMutexRelease(lwip_sys_mutex);
+  if (xPortIsInsideInterrupt())
+  {
+    portCLEAR_INTERRUPT_MASK_FROM_ISR((UBaseType_t)pval);
+  }
+  else
+  {
+    taskEXIT_CRITICAL();
+  }
 }
 
 #endif /* !NO_SYS */
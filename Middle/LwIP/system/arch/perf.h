@@ -32,7 +32,58 @@
 #ifndef __PERF_H__
 #define __PERF_H__
 
-#define PERF_START    /* null definition */
-#define PERF_STOP(x)  /* null definition */
+/*
+ * Profiling of the stack (LWIP_PERF==1, see lwipopts.h).
+ *
+ * PERF_START/PERF_STOP(name) bracket a code path and add its duration to
+ * the histogram of the site "name". Durations are inclusive: a tcp_input
+ * sample is also part of the ip4_input and ethernet_input ones around it.
+ *
+ * The clock is the DWT cycle counter of the Cortex-M3. A host build defines
+ * PERF_CLOCK, PERF_CLOCK_INIT and PERF_CLOCK_UNIT in its cc.h instead.
+ */
+
+#ifndef PERF_CLOCK
+#define PERF_DEMCR          (*(volatile u32_t *)0xE000EDFCUL)   /* CoreDebug->DEMCR */
+#define PERF_DWT_CTRL       (*(volatile u32_t *)0xE0001000UL)   /* DWT->CTRL */
+#define PERF_DWT_CYCCNT     (*(volatile u32_t *)0xE0001004UL)   /* DWT->CYCCNT */
+
+#define PERF_CLOCK_INIT()   do { PERF_DEMCR |= (1UL << 24);      /* TRCENA */ \
+                                 PERF_DWT_CYCCNT = 0;                         \
+                                 PERF_DWT_CTRL |= 1UL; } while (0) /* CYCCNTENA */
+#define PERF_CLOCK()        PERF_DWT_CYCCNT
+#define PERF_CLOCK_UNIT     "cycles"
+#endif /* PERF_CLOCK */
+
+/* Most sites, each one costs sizeof(struct perf_site) of RAM */
+#ifndef PERF_MAX_SITES
+#define PERF_MAX_SITES      16
+#endif
+
+/* Histogram bucket i counts the samples in [2^i, 2^(i+1)) */
+#define PERF_HIST_BUCKETS   24
+
+struct perf_site
+{
+  const char         *name;
+  u32_t               count;
+  u32_t               min;
+  u32_t               max;
+  unsigned long long  total;
+  u32_t               hist[PERF_HIST_BUCKETS];
+};
+
+#define PERF_START    u32_t perf_start_time = PERF_CLOCK()
+#define PERF_STOP(x)  do { static struct perf_site *perf_site_cache;                    \
+                           perf_record(&perf_site_cache, (x), PERF_CLOCK() - perf_start_time); \
+                      } while (0)
+
+void  perf_init(void);
+void  perf_record(struct perf_site **site, const char *name, u32_t elapsed);
+int   perf_get(int index, struct perf_site *site);
+u32_t perf_percentile(const struct perf_site *site, u32_t percent);
+void  perf_reset(void);
+void  perf_dump(void);
+void  perf_dump_start(u32_t interval_ms);
 
 #endif /* __PERF_H__ */
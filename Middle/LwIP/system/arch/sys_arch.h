@@ -34,14 +34,14 @@
 
 #include "cmsis_os.h"
 
-#define SYS_MBOX_NULL (osMessageQId)0
-#define SYS_SEM_NULL  (osSemaphoreId)0
+#define SYS_MBOX_NULL (QueueHandle_t)0
+#define SYS_SEM_NULL  (SemaphoreHandle_t)0
 #define SYS_DEFAULT_THREAD_STACK_DEPTH	configMINIMAL_STACK_SIZE
 
-typedef osSemaphoreId sys_sem_t;
-typedef osSemaphoreId sys_mutex_t;
-typedef osMessageQId  sys_mbox_t;
-typedef osThreadId    sys_thread_t;
+typedef SemaphoreHandle_t sys_sem_t;
+typedef SemaphoreHandle_t sys_mutex_t;
+typedef QueueHandle_t     sys_mbox_t;
+typedef osThreadId        sys_thread_t;
 
 typedef struct _sys_arch_state_t
 {
@@ -53,6 +53,10 @@ typedef struct _sys_arch_state_t
 
 
 
+/* sys_mbox_trypost() for interrupt handlers, e.g. a driver handing frames
+   to tcpip_thread without a deferred task */
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg);
+
 //extern sys_arch_state_t s_sys_arch_state;
 
 //void sys_set_default_state();
@@ -0,0 +1,49 @@
+/*
+ * Size classes of mem_malloc() with MEM_USE_POOLS (see lwipopts.h).
+ *
+ * Every heap allocation is served from the smallest class it fits in, in
+ * constant time and without fragmentation. With MEM_USE_POOLS_TRY_BIGGER_POOL
+ * an exhausted class borrows from the next one up.
+ *
+ * Sizes are given as the data after a PBUF_RAM pbuf header (struct pbuf,
+ * link, IP and TCP headers: 72 bytes on this target), counts come from the
+ * traffic recorded on the virtual wire (Middle/LwIP/test/vwire). Run the
+ * harness, or replay a capture of the real network with -r, and check the
+ * "MALLOC_*" lines of stats_display() for the high-water marks.
+ *
+ * This file is included several times by memp_std.h: no include guard.
+ */
+
+#ifndef LWIP_POOL_HDR_LEN
+#define LWIP_POOL_HDR_LEN       (LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) + \
+                                 LWIP_MEM_ALIGN_SIZE(PBUF_LINK_ENCAPSULATION_HLEN + PBUF_LINK_HLEN + \
+                                                     PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN))
+#define LWIP_POOL_SMALL_SIZE    (LWIP_POOL_HDR_LEN + 88)
+#define LWIP_POOL_MEDIUM_SIZE   (LWIP_POOL_HDR_LEN + 440)
+#define LWIP_POOL_LARGE_SIZE    (LWIP_POOL_HDR_LEN + TCP_MSS)
+#endif
+
+/* Small: ARP, pure ACKs and SYNs, headers in front of PBUF_REF/PBUF_ROM
+   data (the log stream), ICMP and segments of up to 88 bytes. Peak seen: 6 */
+#ifndef LWIP_POOL_SMALL_NUM
+#define LWIP_POOL_SMALL_NUM     8
+#endif
+
+/* Medium: DHCP messages (308 bytes of data) and struct dhcp. Peak seen: 1 */
+#ifndef LWIP_POOL_MEDIUM_NUM
+#define LWIP_POOL_MEDIUM_NUM    2
+#endif
+
+/* Large: full TCP segments copied by netconn_write. A
+   connection never holds more than TCP_SND_BUF/TCP_MSS of them. Peak seen:
+   4 for the echo server, the log stream is sent in place and takes none */
+#ifndef LWIP_POOL_LARGE_NUM
+#define LWIP_POOL_LARGE_NUM     4
+#endif
+
+/* Classes in increasing size */
+LWIP_MALLOC_MEMPOOL_START
+LWIP_MALLOC_MEMPOOL(LWIP_POOL_SMALL_NUM, LWIP_POOL_SMALL_SIZE)
+LWIP_MALLOC_MEMPOOL(LWIP_POOL_MEDIUM_NUM, LWIP_POOL_MEDIUM_SIZE)
+LWIP_MALLOC_MEMPOOL(LWIP_POOL_LARGE_NUM, LWIP_POOL_LARGE_SIZE)
+LWIP_MALLOC_MEMPOOL_END
@@ -0,0 +1,36 @@
+/*
+ * Compiler and platform definitions for running the lwIP stack of this
+ * firmware on a Linux host (virtual wire harness).
+ */
+#ifndef LWIP_VWIRE_CC_H
+#define LWIP_VWIRE_CC_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+typedef int sys_prot_t;
+
+#define LWIP_TIMEVAL_PRIVATE 0
+#define LWIP_ERRNO_INCLUDE <errno.h>
+
+#define PACK_STRUCT_BEGIN
+#define PACK_STRUCT_STRUCT __attribute__ ((__packed__))
+#define PACK_STRUCT_END
+#define PACK_STRUCT_FIELD(x) x
+
+#define LWIP_PLATFORM_DIAG(x)   do { printf x; } while(0)
+#define LWIP_PLATFORM_ASSERT(x) do { printf("Assertion \"%s\" failed at line %d in %s\n", \
+                                     x, __LINE__, __FILE__); fflush(NULL); abort(); } while(0)
+
+#define LWIP_RAND() ((u32_t)random())
+
+/* arch/perf.h of the firmware, on CLOCK_MONOTONIC instead of the DWT */
+uint32_t sys_perf_clock(void);
+#define PERF_CLOCK_INIT()
+#define PERF_CLOCK()        sys_perf_clock()
+#define PERF_CLOCK_UNIT     "ns"
+
+#endif /* LWIP_VWIRE_CC_H */
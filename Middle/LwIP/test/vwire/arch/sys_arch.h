@@ -0,0 +1,23 @@
+/*
+ * OS abstraction types for the virtual wire harness, backed by pthreads.
+ */
+#ifndef LWIP_VWIRE_SYS_ARCH_H
+#define LWIP_VWIRE_SYS_ARCH_H
+
+/* As on the target: lwipopts.h names thread priorities from CMSIS-RTOS */
+#include "cmsis_os.h"
+
+#define SYS_MBOX_NULL NULL
+#define SYS_SEM_NULL  NULL
+
+struct sys_sem;
+struct sys_mutex;
+struct sys_mbox;
+struct sys_thread;
+
+typedef struct sys_sem    *sys_sem_t;
+typedef struct sys_mutex  *sys_mutex_t;
+typedef struct sys_mbox   *sys_mbox_t;
+typedef struct sys_thread *sys_thread_t;
+
+#endif /* LWIP_VWIRE_SYS_ARCH_H */
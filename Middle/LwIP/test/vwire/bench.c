@@ -0,0 +1,2442 @@
+/*
+ * Network benchmarks on the virtual wire.
+ *
+ * The firmware side runs the User/ tests unmodified: start_lwip_thread_seq()
+ * brings its netif up over DHCP and streams the log ring to TARGET_SERVER,
+ * start_lwip_echo_thread() serves the TCP and UDP echo ports. The other end
+ * of the wire plays the PC at TARGET_SERVER: DHCP server, log sink and the
+ * benchmark clients.
+ *
+ * Results are printed one per line as "bench <name> key=value ...". The exit
+ * status is non-zero if any benchmark failed or corrupted data.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <sched.h>
+#include <time.h>
+
+#include "lwip/api.h"
+#include "lwip/apps/httpd.h"
+#include "lwip/dhcp.h"
+#include "lwip/etharp.h"
+#include "lwip/icmp.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/ip4.h"
+#include "lwip/ip4_napt.h"
+#include "lwip/memp.h"
+#include "lwip/netif.h"
+#include "lwip/raw.h"
+#include "lwip/stats.h"
+#include "lwip/sys.h"
+#include "lwip/tcpip.h"
+#include "lwip/udp.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/prot/udp.h"
+#include "lwip/prot/icmp.h"
+
+#include "main.h"
+#include "app_linkmgr.h"
+#include "systemNetLog.h"
+#include "systemNetServer.h"
+#include "systemUartInit.h"
+#include "test_lwip_seq_api.h"
+#include "test_lwip_tcp_udp_echo_server.h"
+#include "test_lwip_chksum.h"
+
+#include "dhcpd.h"
+#include "vwire.h"
+
+#define BENCH_NETMASK           "255.255.255.0"
+#define BENCH_LEASE_HOST        100             /* first address handed out */
+#define BENCH_RTT_SIZE          64
+#define BENCH_CHUNK             TCP_MSS
+#define BENCH_CONNECT_TIMEOUT   10000           /* ms, the echo server starts after DHCP */
+#define BENCH_RECV_TIMEOUT      10000           /* ms without progress before giving up */
+#define BENCH_UDP_TIMEOUT       500             /* ms before a datagram counts as lost */
+#define BENCH_DISCARD_PORT      9               /* nothing listens: datagrams are dropped by the target */
+#define BENCH_LOG_RECORD        80              /* bytes, a typical __PRINT_LOG__ line */
+#define BENCH_DEMUX_MAX         64              /* PCBs of pcb_demux, see lwipopts.h */
+#define BENCH_DEMUX_PORT        502             /* Modbus/TCP: the connections share the local port */
+#define BENCH_DEMUX_CLIENT      0xc000          /* first remote port */
+#define BENCH_DEMUX_PACKETS     20000           /* per round */
+#define BENCH_DEMUX_ROUNDS      4
+#define BENCH_DEMUX_SIZE        (IP_HLEN + TCP_HLEN + 16)
+#define BENCH_ARP_MAX           120             /* neighbours of arp_lookup, below ARP_TABLE_SIZE */
+#define BENCH_ARP_HOST          130             /* first one, above the DHCP leases */
+#define BENCH_ARP_LOOKUPS       200000          /* per round */
+#define BENCH_NAPT_MAX          IP_NAPT_MAX     /* flows of napt */
+#define BENCH_NAPT_LAN          "10.1.0.1"      /* the board on the LAN link, hosts from .2 */
+#define BENCH_NAPT_WAN          "100.64.0.2"    /* the board on the WAN link, as given by the operator */
+#define BENCH_NAPT_SERVER       "198.51.100.1"  /* remote hosts from there */
+#define BENCH_NAPT_PAYLOAD      16
+#define BENCH_NAPT_SIZE         (IP_HLEN + TCP_HLEN + BENCH_NAPT_PAYLOAD)
+#define BENCH_NAPT_ERROR_SIZE   (IP_HLEN + 8 + BENCH_NAPT_SIZE) /* ICMP error quoting a whole packet */
+#define BENCH_NAPT_PORT         30000           /* first inside port of the napt_* cases */
+#define BENCH_LTE_ADDR          "100.64.1.2"    /* the board on the LTE uplink of linkmgr */
+#define BENCH_LTE_PINNED        "203.0.113.7"   /* pinned on LTE with linkmgr_route_add() */
+#define BENCH_LTE_REMOTE        "192.0.2.7"     /* on no subnet: through the default netif */
+#define BENCH_LINK_TIMEOUT      5000            /* ms for linkmgr to bring an uplink up or move to it */
+#define BENCH_NETSRV_MAX        NETSRV_CONN_MAX /* clients of netsrv at most */
+#define BENCH_HTTPD_URI         "/index.html"
+#define BENCH_HTTPD_RESPONSE    4096            /* bytes, header and body */
+#define BENCH_STREAM_RECORD     64              /* bytes of a record of httpd_stream */
+#define BENCH_STREAM_EVENTS     4               /* events of httpd_stream, 3 at least */
+#define BENCH_STREAM_INTERVAL   500             /* ms between two events */
+#define BENCH_STREAM_BUF        (2 * TCP_WND)   /* response header and what came with it */
+#define BENCH_DEFAULT_TESTS     "tcp_echo,tcp_rtt,udp_rtt,netsrv,log_stream,log_binary,httpd,httpd_stream,api_call,pcb_demux,arp_lookup,napt,linkmgr,chksum"
+
+static struct netif pc_netif;                   /* the PC at TARGET_SERVER */
+static ip_addr_t pc_addr;
+static ip_addr_t dut_addr;
+static sys_sem_t pc_ready;
+static volatile u32_t sink_bytes;
+
+static uint64_t bench_now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static u8_t bench_pattern(u32_t offset)
+{
+  return (u8_t)(offset % 251);
+}
+
+/*---------------------------------------------------------------------------*/
+/* The PC side */
+
+static void pc_add(void *arg)
+{
+  ip4_addr_t mask, gw, lease;
+
+  LWIP_UNUSED_ARG(arg);
+
+  ip4addr_aton(BENCH_NETMASK, &mask);
+  ip4_addr_set_zero(&gw);
+  netif_add(&pc_netif, ip_2_ip4(&pc_addr), &mask, &gw, NULL, vwire_netif_init, tcpip_input);
+  netif_set_up(&pc_netif);
+
+  ip4_addr_set_u32(&lease, (ip4_addr_get_u32(ip_2_ip4(&pc_addr)) & ip4_addr_get_u32(&mask)) |
+                   lwip_htonl(BENCH_LEASE_HOST));
+  dhcpd_start(&pc_netif, &lease);
+
+  sys_sem_signal(&pc_ready);
+}
+
+/* The firmware attaches first: bring the PC up before it sends DHCPDISCOVER */
+static void bench_attach(struct netif *netif, int port)
+{
+  LWIP_UNUSED_ARG(netif);
+
+  if (port == 0) {
+    tcpip_callback(pc_add, NULL);
+    sys_arch_sem_wait(&pc_ready, 0);
+  }
+}
+
+/* Receives what the seq-API client streams to TARGET_PORT */
+static void sink_thread(void *arg)
+{
+  struct netconn *conn, *newconn;
+  struct netbuf *buf;
+
+  LWIP_UNUSED_ARG(arg);
+
+  conn = netconn_new(NETCONN_TCP);
+  netconn_bind(conn, &pc_addr, TARGET_PORT);
+  netconn_listen(conn);
+
+  for (;;) {
+    if (netconn_accept(conn, &newconn) != ERR_OK) {
+      continue;
+    }
+    while (netconn_recv(newconn, &buf) == ERR_OK) {
+      __atomic_add_fetch(&sink_bytes, netbuf_len(buf), __ATOMIC_RELAXED);
+      netbuf_delete(buf);
+    }
+    netconn_close(newconn);
+    netconn_delete(newconn);
+  }
+}
+
+static struct netconn *bench_connect(enum netconn_type type, u16_t port)
+{
+  struct netconn *conn;
+  u32_t start = sys_now();
+
+  do {
+    conn = netconn_new(type);
+    if (conn == NULL) {
+      return NULL;
+    }
+    netconn_bind(conn, &pc_addr, 0);
+    if (netconn_connect(conn, &dut_addr, port) == ERR_OK) {
+      netconn_set_recvtimeout(conn, BENCH_RECV_TIMEOUT);
+      return conn;
+    }
+    netconn_delete(conn);
+    sys_msleep(100);
+  } while (sys_now() - start < BENCH_CONNECT_TIMEOUT);
+
+  return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Benchmarks */
+
+static int cmp_u32(const void *a, const void *b)
+{
+  u32_t x = *(const u32_t *)a, y = *(const u32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void report_rtt(const char *name, u32_t *rtt, u32_t n, u32_t sent)
+{
+  uint64_t sum = 0;
+  u32_t i;
+
+  if (n == 0) {
+    printf("bench %s sent=%u lost=%u\n", name, (unsigned)sent, (unsigned)sent);
+    return;
+  }
+  qsort(rtt, n, sizeof(u32_t), cmp_u32);
+  for (i = 0; i < n; i++) {
+    sum += rtt[i];
+  }
+  printf("bench %s sent=%u lost=%u min_us=%u avg_us=%u p50_us=%u p99_us=%u max_us=%u\n",
+         name, (unsigned)sent, (unsigned)(sent - n), (unsigned)rtt[0], (unsigned)(sum / n),
+         (unsigned)rtt[n / 2], (unsigned)rtt[(n * 99) / 100], (unsigned)rtt[n - 1]);
+}
+
+struct tcp_writer
+{
+  struct netconn *conn;
+  u32_t           total;
+  sys_sem_t       done;
+  err_t           err;
+};
+
+static void tcp_writer_thread(void *arg)
+{
+  struct tcp_writer *w = (struct tcp_writer *)arg;
+  static u8_t chunk[BENCH_CHUNK];
+  u32_t sent = 0, n, i;
+
+  w->err = ERR_OK;
+  while ((sent < w->total) && (w->err == ERR_OK)) {
+    n = LWIP_MIN(BENCH_CHUNK, w->total - sent);
+    for (i = 0; i < n; i++) {
+      chunk[i] = bench_pattern(sent + i);
+    }
+    w->err = netconn_write(w->conn, chunk, n, NETCONN_COPY);
+    sent += n;
+  }
+  sys_sem_signal(&w->done);
+}
+
+/* Bulk data through the TCP echo server: both directions loaded */
+static int bench_tcp_echo(u32_t total)
+{
+  struct tcp_writer w;
+  struct netbuf *buf;
+  void *data;
+  u16_t len, i;
+  u32_t rcvd = 0;
+  uint64_t start, elapsed;
+  const char *error = NULL;
+
+  w.conn = bench_connect(NETCONN_TCP, TCP_ECHO_PORT);
+  if (w.conn == NULL) {
+    printf("bench tcp_echo error=connect\n");
+    return 0;
+  }
+  w.total = total;
+  sys_sem_new(&w.done, 0);
+
+  start = bench_now_us();
+  sys_thread_new("bench_writer", tcp_writer_thread, &w, DEFAULT_THREAD_STACKSIZE, DEFAULT_THREAD_PRIO);
+
+  while ((error == NULL) && (rcvd < total)) {
+    if (netconn_recv(w.conn, &buf) != ERR_OK) {
+      error = "recv";
+      break;
+    }
+    do {
+      netbuf_data(buf, &data, &len);
+      for (i = 0; i < len; i++) {
+        if (((u8_t *)data)[i] != bench_pattern(rcvd + i)) {
+          error = "data";
+          break;
+        }
+      }
+      rcvd += len;
+    } while ((error == NULL) && (netbuf_next(buf) >= 0));
+    netbuf_delete(buf);
+  }
+  elapsed = bench_now_us() - start;
+
+  sys_arch_sem_wait(&w.done, 0);
+  sys_sem_free(&w.done);
+  netconn_close(w.conn);
+  netconn_delete(w.conn);
+
+  if ((error == NULL) && (w.err != ERR_OK)) {
+    error = "write";
+  }
+  if (error != NULL) {
+    printf("bench tcp_echo error=%s bytes=%u\n", error, (unsigned)rcvd);
+    return 0;
+  }
+  printf("bench tcp_echo bytes=%u ms=%u kbit_s=%u\n", (unsigned)total, (unsigned)(elapsed / 1000),
+         (unsigned)(elapsed ? ((uint64_t)total * 8U * 1000U) / elapsed : 0));
+  return 1;
+}
+
+/* Request/response latency through the TCP echo server */
+static int bench_tcp_rtt(u32_t count)
+{
+  struct netconn *conn;
+  struct netbuf *buf;
+  u8_t req[BENCH_RTT_SIZE];
+  u32_t *rtt, n = 0, got;
+  uint64_t start;
+  int ok = 1;
+
+  conn = bench_connect(NETCONN_TCP, TCP_ECHO_PORT);
+  rtt = (u32_t *)calloc(count, sizeof(u32_t));
+  if ((conn == NULL) || (rtt == NULL)) {
+    printf("bench tcp_rtt error=connect\n");
+    free(rtt);
+    return 0;
+  }
+  while (ok && (n < count)) {
+    memset(req, (int)n, sizeof(req));
+    start = bench_now_us();
+    if (netconn_write(conn, req, sizeof(req), NETCONN_COPY) != ERR_OK) {
+      ok = 0;
+      break;
+    }
+    for (got = 0; ok && (got < sizeof(req)); ) {
+      if (netconn_recv(conn, &buf) != ERR_OK) {
+        ok = 0;
+        break;
+      }
+      got += netbuf_len(buf);
+      netbuf_delete(buf);
+    }
+    rtt[n++] = (u32_t)(bench_now_us() - start);
+  }
+
+  netconn_close(conn);
+  netconn_delete(conn);
+  if (ok) {
+    report_rtt("tcp_rtt", rtt, n, count);
+  } else {
+    printf("bench tcp_rtt error=recv done=%u\n", (unsigned)n);
+  }
+  free(rtt);
+  return ok;
+}
+
+/* Clients of netsrv: raw PCBs in the tcpip thread, so that as many of them
+   as the server takes are served at once without a thread each */
+struct netsrv_client {
+  struct tcp_pcb *pcb;
+  struct netsrv_run *run;
+  u32_t sent;
+  u32_t rcvd;
+  u32_t requests;                               /* answered */
+  uint64_t start;                               /* of the request in flight */
+  u8_t done;
+};
+
+struct netsrv_run {
+  u32_t clients;
+  u32_t bytes;                                  /* per client, 0: requests of BENCH_RTT_SIZE */
+  u32_t count;                                  /* requests per client */
+  u32_t *rtt;
+  u32_t n;
+  u32_t finished;
+  const char *error;
+  uint64_t start;
+  uint64_t elapsed;
+  struct netsrv_client client[BENCH_NETSRV_MAX];
+  sys_sem_t done;
+};
+
+static void netsrv_client_end(struct netsrv_client *c, const char *error)
+{
+  struct netsrv_run *run = c->run;
+
+  if (c->pcb != NULL) {
+    tcp_arg(c->pcb, NULL);
+    if ((error != NULL) || (tcp_close(c->pcb) != ERR_OK)) {
+      tcp_abort(c->pcb);
+    }
+    c->pcb = NULL;
+  }
+  if ((error != NULL) && (run->error == NULL)) {
+    run->error = error;
+  }
+  c->done = 1;
+  if (++run->finished == run->clients) {
+    run->elapsed = bench_now_us() - run->start;
+    sys_sem_signal(&run->done);
+  }
+}
+
+static void netsrv_client_send(struct netsrv_client *c)
+{
+  struct netsrv_run *run = c->run;
+  u8_t chunk[BENCH_CHUNK];
+  u32_t n, i;
+
+  if (run->bytes == 0) {
+    /* One request at a time */
+    if ((c->sent != c->rcvd) || (c->requests == run->count)) {
+      return;
+    }
+    n = BENCH_RTT_SIZE;
+    c->start = bench_now_us();
+  } else {
+    n = LWIP_MIN(LWIP_MIN(BENCH_CHUNK, run->bytes - c->sent), tcp_sndbuf(c->pcb));
+  }
+  if (n == 0) {
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    chunk[i] = bench_pattern(c->sent + i);
+  }
+  if (tcp_write(c->pcb, chunk, (u16_t)n, TCP_WRITE_FLAG_COPY) == ERR_OK) {
+    c->sent += n;
+    tcp_output(c->pcb);
+  }
+}
+
+static err_t netsrv_client_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+  struct netsrv_client *c = (struct netsrv_client *)arg;
+  struct netsrv_run *run;
+  struct pbuf *q;
+  u16_t i;
+
+  if (c == NULL) {
+    if (p != NULL) {
+      pbuf_free(p);
+    }
+    return ERR_OK;
+  }
+  run = c->run;
+  if ((p == NULL) || (err != ERR_OK)) {
+    netsrv_client_end(c, "closed");
+    return ERR_ABRT;
+  }
+
+  for (q = p; q != NULL; q = q->next) {
+    for (i = 0; i < q->len; i++) {
+      if (((u8_t *)q->payload)[i] != bench_pattern(c->rcvd + i)) {
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+        netsrv_client_end(c, "data");
+        return ERR_ABRT;
+      }
+    }
+    c->rcvd += q->len;
+  }
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+
+  if (run->bytes == 0) {
+    if (c->rcvd == c->sent) {
+      run->rtt[run->n++] = (u32_t)(bench_now_us() - c->start);
+      if (++c->requests == run->count) {
+        netsrv_client_end(c, NULL);
+        return ERR_ABRT;
+      }
+    }
+  } else if (c->rcvd == run->bytes) {
+    netsrv_client_end(c, NULL);
+    return ERR_ABRT;
+  }
+  netsrv_client_send(c);
+  return ERR_OK;
+}
+
+static err_t netsrv_client_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(len);
+
+  if (arg != NULL) {
+    netsrv_client_send((struct netsrv_client *)arg);
+  }
+  return ERR_OK;
+}
+
+/* A write the pools refused is tried again */
+static err_t netsrv_client_poll(void *arg, struct tcp_pcb *pcb)
+{
+  LWIP_UNUSED_ARG(pcb);
+
+  if (arg != NULL) {
+    netsrv_client_send((struct netsrv_client *)arg);
+  }
+  return ERR_OK;
+}
+
+static void netsrv_client_err(void *arg, err_t err)
+{
+  struct netsrv_client *c = (struct netsrv_client *)arg;
+
+  LWIP_UNUSED_ARG(err);
+
+  if (c != NULL) {
+    c->pcb = NULL;
+    netsrv_client_end(c, "reset");
+  }
+}
+
+static err_t netsrv_client_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(err);
+
+  netsrv_client_send((struct netsrv_client *)arg);
+  return ERR_OK;
+}
+
+/* In tcpip_thread: every client connects at once */
+static void netsrv_start(void *arg)
+{
+  struct netsrv_run *run = (struct netsrv_run *)arg;
+  struct netsrv_client *c;
+  u32_t i;
+
+  run->start = bench_now_us();
+  for (i = 0; i < run->clients; i++) {
+    c = &run->client[i];
+    memset(c, 0, sizeof(*c));
+    c->run = run;
+    c->pcb = tcp_new();
+    if (c->pcb == NULL) {
+      netsrv_client_end(c, "pcb");
+      continue;
+    }
+    tcp_arg(c->pcb, c);
+    tcp_recv(c->pcb, netsrv_client_recv);
+    tcp_sent(c->pcb, netsrv_client_sent);
+    tcp_err(c->pcb, netsrv_client_err);
+    tcp_poll(c->pcb, netsrv_client_poll, 1);
+    tcp_nagle_disable(c->pcb);
+    tcp_bind(c->pcb, &pc_addr, 0);
+    if (tcp_connect(c->pcb, &dut_addr, TCP_ECHO_PORT, netsrv_client_connected) != ERR_OK) {
+      netsrv_client_end(c, "connect");
+    }
+  }
+}
+
+/* In tcpip_thread: the clients that did not finish in time */
+static void netsrv_stop(void *arg)
+{
+  struct netsrv_run *run = (struct netsrv_run *)arg;
+  u32_t i;
+
+  for (i = 0; i < run->clients; i++) {
+    if (!run->client[i].done) {
+      netsrv_client_end(&run->client[i], "timeout");
+    }
+  }
+}
+
+static int netsrv_run(struct netsrv_run *run, u32_t clients)
+{
+  netsrv_stats_t st;
+  u32_t start = sys_now();
+
+  /* The server takes no more than NETSRV_CONN_MAX: let it close the
+     connections of the previous run first */
+  do {
+    netsrv_get_stats(&st);
+    if (st.used == 0) {
+      break;
+    }
+    sys_msleep(1);
+  } while (sys_now() - start < BENCH_RECV_TIMEOUT);
+
+  run->clients = clients;
+  run->n = 0;
+  run->finished = 0;
+  run->error = NULL;
+
+  tcpip_callback(netsrv_start, run);
+  if (sys_arch_sem_wait(&run->done, BENCH_RECV_TIMEOUT) == SYS_ARCH_TIMEOUT) {
+    tcpip_callback(netsrv_stop, run);
+    sys_arch_sem_wait(&run->done, 0);
+  }
+  return run->error == NULL;
+}
+
+/* The TCP echo server multiplexed by the connection server
+   (Library/myLib/systemNetServer.c): request/response latency and bulk
+   throughput with 1 to NETSRV_CONN_MAX clients at once */
+static int bench_netsrv(u32_t total, u32_t count)
+{
+  static const u32_t points[] = { 1, 8, BENCH_NETSRV_MAX };
+  static struct netsrv_run run;
+  struct netconn *conn;
+  netsrv_stats_t st;
+  char name[32];
+  size_t i;
+  int ok = 1;
+
+  /* The raw clients do not retry: wait for the server to listen */
+  conn = bench_connect(NETCONN_TCP, TCP_ECHO_PORT);
+  if (conn == NULL) {
+    printf("bench netsrv error=connect\n");
+    return 0;
+  }
+  netconn_close(conn);
+  netconn_delete(conn);
+
+  run.rtt = (u32_t *)calloc(BENCH_NETSRV_MAX * count, sizeof(u32_t));
+  if (run.rtt == NULL) {
+    printf("bench netsrv error=memory\n");
+    return 0;
+  }
+  sys_sem_new(&run.done, 0);
+
+  for (i = 0; ok && (i < LWIP_ARRAYSIZE(points)); i++) {
+    run.bytes = 0;
+    run.count = count;
+    if (!netsrv_run(&run, points[i])) {
+      printf("bench netsrv_rtt clients=%u error=%s done=%u\n", (unsigned)points[i], run.error, (unsigned)run.n);
+      ok = 0;
+      break;
+    }
+    snprintf(name, sizeof(name), "netsrv_rtt clients=%u", (unsigned)points[i]);
+    report_rtt(name, run.rtt, run.n, points[i] * count);
+
+    run.bytes = total / points[i];
+    if (!netsrv_run(&run, points[i])) {
+      printf("bench netsrv_echo clients=%u error=%s\n", (unsigned)points[i], run.error);
+      ok = 0;
+      break;
+    }
+    printf("bench netsrv_echo clients=%u bytes=%u ms=%u kbit_s=%u\n", (unsigned)points[i],
+           (unsigned)(run.bytes * points[i]), (unsigned)(run.elapsed / 1000),
+           (unsigned)(run.elapsed ? ((uint64_t)run.bytes * points[i] * 8U * 1000U) / run.elapsed : 0));
+  }
+  sys_sem_free(&run.done);
+  free(run.rtt);
+
+  netsrv_get_stats(&st);
+  printf("bench netsrv_server accepted=%u refused=%u high_water=%u wakeups=%u events=%u rx_held=%u tx_full=%u\n",
+         (unsigned)st.accepted, (unsigned)st.refused, (unsigned)st.high_water, (unsigned)st.wakeups,
+         (unsigned)st.events, (unsigned)st.rx_held, (unsigned)st.tx_full);
+  return ok;
+}
+
+/* Datagram latency and loss through the UDP echo server */
+static int bench_udp_rtt(u32_t count)
+{
+  struct netconn *conn;
+  struct netbuf *buf;
+  u8_t req[BENCH_RTT_SIZE];
+  u32_t *rtt, seq, echoed, n = 0, i;
+  uint64_t start;
+
+  conn = bench_connect(NETCONN_UDP, UDP_ECHO_PORT);
+  rtt = (u32_t *)calloc(count, sizeof(u32_t));
+  if ((conn == NULL) || (rtt == NULL)) {
+    printf("bench udp_rtt error=connect\n");
+    free(rtt);
+    return 0;
+  }
+  netconn_set_recvtimeout(conn, BENCH_UDP_TIMEOUT);
+
+  for (i = 0; i < count; i++) {
+    seq = i;
+    memset(req, 0, sizeof(req));
+    memcpy(req, &seq, sizeof(seq));
+    buf = netbuf_new();
+    netbuf_ref(buf, req, sizeof(req));
+    start = bench_now_us();
+    netconn_send(conn, buf);
+    netbuf_delete(buf);
+
+    /* Late echoes of earlier datagrams are skipped */
+    while (netconn_recv(conn, &buf) == ERR_OK) {
+      netbuf_copy(buf, &echoed, sizeof(echoed));
+      netbuf_delete(buf);
+      if (echoed == seq) {
+        rtt[n++] = (u32_t)(bench_now_us() - start);
+        break;
+      }
+    }
+  }
+
+  netconn_delete(conn);
+  report_rtt("udp_rtt", rtt, n, count);
+  free(rtt);
+  return n > 0;
+}
+
+#if __LOG_BINARY__
+/* __PRINT_LOG__ in the binary mode (make LOGBIN=1): the line printlog_thread
+   formats from the record of each call is the one vsnprintf() prints. The
+   first call of the site parses its format, the second one takes the
+   cached layout. */
+static int bench_log_binary(void)
+{
+  const char *null_string = NULL;
+  char expect[BOARD_UART_LINE];
+  uint64_t start;
+  int i, waited;
+
+  for (i = 0; i < 2; i++) {
+    snprintf(expect, sizeof(expect), "log_binary %d %u %s %s %5.2f %% %c\n", -42 - i, 7U, "text", "(null)", 1.5, 'x');
+    start = bench_now_us();
+    __PRINT_LOG__(__CRITICAL_LEVEL__, "log_binary %d %u %s %s %5.2f %% %c\n", -42 - i, 7U, "text", null_string, 1.5, 'x');
+    for (waited = 0; (strstr(board_uart_line, expect) == NULL) && (waited < 1000); waited += 10) {
+      sys_msleep(10);
+    }
+    if (strstr(board_uart_line, expect) == NULL) {
+      printf("bench log_binary error=format call=%d line=%s", i, board_uart_line);
+      return 0;
+    }
+    printf("bench log_binary call=%d line_us=%u\n", i, (unsigned)(bench_now_us() - start));
+  }
+  return 1;
+}
+#endif /* __LOG_BINARY__ */
+
+/* The seq-API client streaming the log ring to TARGET_SERVER */
+static int bench_log_stream(u32_t total)
+{
+  u8_t record[BENCH_LOG_RECORD];
+  u32_t written = 0, base, last, len, i;
+  uint64_t start, elapsed;
+  u32_t idle_since;
+  netlog_stats_t st;
+
+  idle_since = sys_now();
+  while (!netlog_attached()) {
+    if (sys_now() - idle_since > BENCH_CONNECT_TIMEOUT) {
+      printf("bench log_stream error=connect\n");
+      return 0;
+    }
+    sys_msleep(10);
+  }
+
+  base = __atomic_load_n(&sink_bytes, __ATOMIC_RELAXED);
+  start = bench_now_us();
+  idle_since = sys_now();
+  while (written < total) {
+    len = LWIP_MIN(BENCH_LOG_RECORD, total - written);
+    for (i = 0; i < len; i++) {
+      record[i] = bench_pattern(written + i);
+    }
+    /* Unlike printlog() on the target, retry a record the ring drops */
+    while (netlog_write(record, len) == 0) {
+      if (sys_now() - idle_since > BENCH_RECV_TIMEOUT) {
+        printf("bench log_stream error=stalled written=%u\n", (unsigned)written);
+        return 0;
+      }
+      sched_yield();
+    }
+    idle_since = sys_now();
+    written += len;
+  }
+
+  last = base;
+  idle_since = sys_now();
+  while (__atomic_load_n(&sink_bytes, __ATOMIC_RELAXED) - base < total) {
+    if (__atomic_load_n(&sink_bytes, __ATOMIC_RELAXED) != last) {
+      last = __atomic_load_n(&sink_bytes, __ATOMIC_RELAXED);
+      idle_since = sys_now();
+    } else if (sys_now() - idle_since > BENCH_RECV_TIMEOUT) {
+      printf("bench log_stream error=stalled bytes=%u\n", (unsigned)(last - base));
+      return 0;
+    }
+    sys_msleep(1);
+  }
+  elapsed = bench_now_us() - start;
+
+  netlog_get_stats(&st);
+  printf("bench log_stream bytes=%u ms=%u kbit_s=%u records=%u segments=%u wakeups=%u dropped=%u stalls=%u high_water=%u\n",
+         (unsigned)total, (unsigned)(elapsed / 1000),
+         (unsigned)(elapsed ? ((uint64_t)total * 8U * 1000U) / elapsed : 0),
+         (unsigned)st.records, (unsigned)st.segments, (unsigned)st.wakeups, (unsigned)st.dropped,
+         (unsigned)st.stalls, (unsigned)st.high_water);
+  return 1;
+}
+
+/* Cost of a netconn call made from an application thread: with
+   LWIP_TCPIP_CORE_LOCKING it runs under the core lock, otherwise it is a
+   message to tcpip_thread and a wait for its reply */
+static int bench_api_call(u32_t count)
+{
+  struct netconn *conn;
+  struct netbuf *buf;
+  ip_addr_t addr;
+  u16_t port;
+  u8_t data[16];
+  uint64_t start, getaddr_ns, send_ns;
+  u32_t i;
+
+  conn = bench_connect(NETCONN_UDP, BENCH_DISCARD_PORT);
+  if ((conn == NULL) || (count == 0)) {
+    printf("bench api_call error=connect\n");
+    if (conn != NULL) {
+      netconn_delete(conn);
+    }
+    return 0;
+  }
+  memset(data, 0, sizeof(data));
+
+  start = bench_now_us();
+  for (i = 0; i < count; i++) {
+    netconn_getaddr(conn, &addr, &port, 1);
+  }
+  getaddr_ns = (bench_now_us() - start) * 1000U / count;
+
+  start = bench_now_us();
+  for (i = 0; i < count; i++) {
+    buf = netbuf_new();
+    netbuf_ref(buf, data, sizeof(data));
+    netconn_send(conn, buf);
+    netbuf_delete(buf);
+  }
+  send_ns = (bench_now_us() - start) * 1000U / count;
+
+  netconn_delete(conn);
+  printf("bench api_call calls=%u core_locking=%d getaddr_ns=%u udp_send_ns=%u\n", (unsigned)count,
+         LWIP_TCPIP_CORE_LOCKING, (unsigned)getaddr_ns, (unsigned)send_ns);
+  return 1;
+}
+
+static void httpd_start(void *arg)
+{
+  static int started;
+
+  if (!started) {
+    httpd_init();
+    started = 1;
+  }
+  sys_sem_signal((sys_sem_t *)arg);
+}
+
+static void bench_httpd_start(void)
+{
+  sys_sem_t started;
+
+  sys_sem_new(&started, 0);
+  tcpip_callback(httpd_start, &started);
+  sys_arch_sem_wait(&started, 0);
+  sys_sem_free(&started);
+}
+
+/* One GET on the persistent connection conn, with the header field accept
+   (an Accept-Encoding one) if given, conditional if etag is given. Returns
+   the status of the response, which is received whole into resp (a 304 has
+   no body), or 0 on error */
+static int httpd_get(struct netconn *conn, const char *accept, const char *etag, char *resp, u32_t *len)
+{
+  char req[256];
+  const char *end = NULL, *field;
+  struct netbuf *buf;
+  u32_t need = BENCH_HTTPD_RESPONSE;
+  int n, status = 0;
+  void *data;
+  u16_t l;
+
+  n = snprintf(req, sizeof(req), "GET " BENCH_HTTPD_URI " HTTP/1.1\r\nHost: board\r\n"
+               "Connection: keep-alive\r\n%s%s%s%s%s\r\n",
+               accept ? accept : "", accept ? "\r\n" : "",
+               etag ? "If-None-Match: " : "", etag ? etag : "", etag ? "\r\n" : "");
+  if (netconn_write(conn, req, (size_t)n, NETCONN_COPY) != ERR_OK) {
+    return 0;
+  }
+  *len = 0;
+  while (*len < need) {
+    if (netconn_recv(conn, &buf) != ERR_OK) {
+      return 0;
+    }
+    do {
+      netbuf_data(buf, &data, &l);
+      if (*len + l >= BENCH_HTTPD_RESPONSE) {
+        netbuf_delete(buf);
+        return 0;
+      }
+      memcpy(&resp[*len], data, l);
+      *len += l;
+    } while (netbuf_next(buf) >= 0);
+    netbuf_delete(buf);
+    resp[*len] = 0;
+    if ((end == NULL) && ((end = strstr(resp, "\r\n\r\n")) != NULL)) {
+      status = atoi(&resp[9]);
+      need = (u32_t)(end + 4 - resp);
+      field = strstr(resp, "Content-Length: ");
+      if ((status != 304) && (field != NULL) && (field < end)) {
+        need += (u32_t)atoi(field + 16);
+      }
+    }
+  }
+  return status;
+}
+
+/* count GETs of the page with the Accept-Encoding field accept (none if
+   NULL), then count conditional ones with the ETag it came with, answered
+   with a 304 that is its header alone. The page must come as the gzip
+   stream makefsdata stored if gzip is set, as is otherwise, and say that it
+   varies with Accept-Encoding. Returns the size of the 200, 0 on error. */
+static u32_t httpd_run(struct netconn *conn, const char *name, const char *accept, int gzip, u32_t count,
+                       u32_t *rtt, char *resp, char *etag)
+{
+  char rtt_name[32];
+  const char *field, *body;
+  u32_t get_len = 0, cond_len = 0, n;
+  uint64_t start;
+  int ok = 1;
+
+  for (n = 0; ok && (n < count); n++) {
+    start = bench_now_us();
+    ok = (httpd_get(conn, accept, NULL, resp, &get_len) == 200);
+    rtt[n] = (u32_t)(bench_now_us() - start);
+  }
+  field = ok ? strstr(resp, "ETag: ") : NULL;
+  body = ok ? strstr(resp, "\r\n\r\n") + 4 : NULL;
+  if (ok && (strstr(resp, "Vary: Accept-Encoding\r\n") == NULL)) {
+    ok = 0;
+  } else if (ok && gzip) {
+    ok = (strstr(resp, "Content-Encoding: gzip\r\n") != NULL) && ((u8_t)body[0] == 0x1f) && ((u8_t)body[1] == 0x8b);
+  } else if (ok) {
+    ok = (strstr(resp, "Content-Encoding: ") == NULL) && (body[0] == '<');
+  }
+  if ((field == NULL) || (sscanf(field + 6, "%31[^\r]", etag) != 1) || !ok) {
+    printf("bench httpd error=%s encoding=%s\n", (field != NULL) ? "headers" : "get", name);
+    return 0;
+  }
+  snprintf(rtt_name, sizeof(rtt_name), "httpd_get%s%s", strcmp(name, "gzip") ? "_" : "", strcmp(name, "gzip") ? name : "");
+  report_rtt(rtt_name, rtt, n, count);
+
+  for (n = 0; ok && (n < count); n++) {
+    start = bench_now_us();
+    ok = (httpd_get(conn, accept, etag, resp, &cond_len) == 304);
+    rtt[n] = (u32_t)(bench_now_us() - start);
+  }
+  if (!ok) {
+    printf("bench httpd error=not_modified encoding=%s done=%u\n", name, (unsigned)n);
+    return 0;
+  }
+  snprintf(rtt_name, sizeof(rtt_name), "httpd_304%s%s", strcmp(name, "gzip") ? "_" : "", strcmp(name, "gzip") ? name : "");
+  report_rtt(rtt_name, rtt, n, count);
+  printf("bench httpd encoding=%s etag=%s get_bytes=%u not_modified_bytes=%u\n", name, etag, (unsigned)get_len,
+         (unsigned)cond_len);
+  return get_len;
+}
+
+/* GETs of a page of the firmware's httpd on one persistent connection and
+   their revalidations: from a browser, which accepts gzip, and from a
+   client sending no Accept-Encoding (curl), which gets the identity copy.
+   Then one each from a client refusing gzip with a quality of 0, from a
+   proxy writing the field in lower case, and from one listing only codings
+   that merely contain "gzip" */
+static int bench_httpd(u32_t count)
+{
+  struct netconn *conn;
+  char *resp, etag[32], identity_etag[32], refused_etag[32], proxy_etag[32], lookalike_etag[32];
+  u32_t *rtt;
+  int ok;
+
+  bench_httpd_start();
+
+  conn = bench_connect(NETCONN_TCP, HTTPD_SERVER_PORT);
+  rtt = (u32_t *)calloc(count, sizeof(u32_t));
+  resp = (char *)malloc(BENCH_HTTPD_RESPONSE);
+  if ((conn == NULL) || (rtt == NULL) || (resp == NULL) || (count == 0)) {
+    printf("bench httpd error=connect\n");
+    if (conn != NULL) {
+      netconn_delete(conn);
+    }
+    free(rtt);
+    free(resp);
+    return 0;
+  }
+
+  ok = (httpd_run(conn, "gzip", "Accept-Encoding: gzip, deflate", 1, count, rtt, resp, etag) != 0) &&
+       (httpd_run(conn, "identity", NULL, 0, count, rtt, resp, identity_etag) != 0) &&
+       (httpd_run(conn, "refused", "Accept-Encoding: gzip;q=0, deflate", 0, 1, rtt, resp, refused_etag) != 0) &&
+       (httpd_run(conn, "proxy", "accept-encoding: deflate, GZIP;Q=0.5", 1, 1, rtt, resp, proxy_etag) != 0) &&
+       (httpd_run(conn, "lookalike", "Accept-Encoding: x-gzip, gzipfoo", 0, 1, rtt, resp, lookalike_etag) != 0);
+  /* Each copy has its own tag: a cache never takes one for the other */
+  if (ok && (!strcmp(etag, identity_etag) || strcmp(identity_etag, refused_etag) || strcmp(etag, proxy_etag) ||
+             strcmp(identity_etag, lookalike_etag))) {
+    printf("bench httpd error=etags\n");
+    ok = 0;
+  }
+
+  netconn_close(conn);
+  netconn_delete(conn);
+  free(rtt);
+  free(resp);
+  return ok;
+}
+
+/* Record i of the bulk stream: its index, letters from it, a newline */
+static void stream_record(u32_t i, char *rec)
+{
+  int k;
+
+  snprintf(rec, BENCH_STREAM_RECORD + 1, "%08x ", (unsigned)i);
+  for (k = 9; k < BENCH_STREAM_RECORD - 1; k++) {
+    rec[k] = (char)('a' + (i + (u32_t)k) % 26);
+  }
+  rec[BENCH_STREAM_RECORD - 1] = '\n';
+  rec[BENCH_STREAM_RECORD] = 0;
+}
+
+static u32_t stream_records;
+
+static u8_t stream_bulk(struct httpd_stream *s)
+{
+  char rec[BENCH_STREAM_RECORD + 1];
+
+  while (s->record < stream_records) {
+    stream_record(s->record, rec);
+    if (httpd_stream_printf(s, "%s", rec) != ERR_OK) {
+      return HTTPD_STREAM_MORE;
+    }
+  }
+  return HTTPD_STREAM_DONE;
+}
+
+static u8_t stream_events(struct httpd_stream *s)
+{
+  if ((s->record == 0) &&
+      (httpd_stream_printf(s, "id: %u\ndata: {\"pass\":%u,\"ms\":%u}\n\n", (unsigned)s->pass,
+                           (unsigned)s->pass, (unsigned)sys_now()) != ERR_OK)) {
+    return HTTPD_STREAM_MORE;
+  }
+  return HTTPD_STREAM_WAIT;
+}
+
+static const tStream bench_streams[] = {
+  { "/bulk.txt", "text/plain", stream_bulk, 0 },
+  { "/events", "text/event-stream", stream_events, BENCH_STREAM_INTERVAL }
+};
+
+static void stream_register(void *arg)
+{
+  http_set_stream_handlers(bench_streams, LWIP_ARRAYSIZE(bench_streams));
+  sys_sem_signal((sys_sem_t *)arg);
+}
+
+/* GET uri on a new connection; returns it with the response header read
+   into hdr, the bytes of the body received with it in hdr after the header
+   (*body_len of them at *body) */
+static struct netconn *stream_get(const char *uri, char *hdr, size_t size, char **body, u32_t *body_len)
+{
+  struct netconn *conn = bench_connect(NETCONN_TCP, HTTPD_SERVER_PORT);
+  struct netbuf *buf;
+  char req[128], *end = NULL;
+  u32_t len = 0;
+  void *data;
+  u16_t l;
+  int n;
+
+  if (conn == NULL) {
+    return NULL;
+  }
+  n = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: board\r\n\r\n", uri);
+  if (netconn_write(conn, req, (size_t)n, NETCONN_COPY) != ERR_OK) {
+    netconn_delete(conn);
+    return NULL;
+  }
+  while (end == NULL) {
+    if (netconn_recv(conn, &buf) != ERR_OK) {
+      netconn_delete(conn);
+      return NULL;
+    }
+    do {
+      netbuf_data(buf, &data, &l);
+      if (len + l >= size) {
+        netbuf_delete(buf);
+        netconn_delete(conn);
+        return NULL;
+      }
+      memcpy(&hdr[len], data, l);
+      len += l;
+    } while (netbuf_next(buf) >= 0);
+    netbuf_delete(buf);
+    hdr[len] = 0;
+    end = strstr(hdr, "\r\n\r\n");
+  }
+  *body = end + 4;
+  *body_len = len - (u32_t)(*body - hdr);
+  return conn;
+}
+
+/* Responses written record by record into the send buffer by handlers of
+   httpd (LWIP_HTTPD_STREAM): a bulk document of 'total' bytes in 64 byte
+   records, checked byte by byte, then an event stream */
+static int bench_httpd_stream(u32_t total)
+{
+  struct netconn *conn;
+  struct netbuf *buf;
+  sys_sem_t registered;
+  char *hdr, rec[BENCH_STREAM_RECORD + 1], *body;
+  u32_t rcvd = 0, len, events = 0, i, first_ms = 0, last_ms = 0, ms;
+  uint64_t start, elapsed;
+  const char *error = NULL, *p, *q;
+  unsigned id, pass;
+  void *data;
+  u16_t l;
+
+  hdr = (char *)malloc(BENCH_STREAM_BUF);
+  if (hdr == NULL) {
+    printf("bench httpd_stream error=connect\n");
+    return 0;
+  }
+  bench_httpd_start();
+  sys_sem_new(&registered, 0);
+  tcpip_callback(stream_register, &registered);
+  sys_arch_sem_wait(&registered, 0);
+  sys_sem_free(&registered);
+  stream_records = LWIP_MAX(1, total / BENCH_STREAM_RECORD);
+  total = stream_records * BENCH_STREAM_RECORD;
+
+  start = bench_now_us();
+  conn = stream_get("/bulk.txt", hdr, BENCH_STREAM_BUF, &body, &len);
+  if (conn == NULL) {
+    printf("bench httpd_stream error=connect\n");
+    free(hdr);
+    return 0;
+  }
+  if ((strncmp(hdr, "HTTP/1.1 200 OK\r\n", 17) != 0) || (strstr(hdr, "Content-Type: text/plain\r\n") == NULL)) {
+    error = "headers";
+  }
+  data = body;
+  l = (u16_t)len;
+  buf = NULL;
+  /* The body ends with the connection */
+  while (error == NULL) {
+    for (i = 0; (error == NULL) && (i < l); i++, rcvd++) {
+      if ((rcvd % BENCH_STREAM_RECORD) == 0) {
+        stream_record(rcvd / BENCH_STREAM_RECORD, rec);
+      }
+      if ((rcvd >= total) || (((char *)data)[i] != rec[rcvd % BENCH_STREAM_RECORD])) {
+        error = "data";
+      }
+    }
+    if ((buf != NULL) && (netbuf_next(buf) >= 0)) {
+      netbuf_data(buf, &data, &l);
+      continue;
+    }
+    if (buf != NULL) {
+      netbuf_delete(buf);
+      buf = NULL;
+    }
+    if ((error == NULL) && (netconn_recv(conn, &buf) != ERR_OK)) {
+      break;
+    }
+    if (buf != NULL) {
+      netbuf_data(buf, &data, &l);
+    }
+  }
+  elapsed = bench_now_us() - start;
+  if (buf != NULL) {
+    netbuf_delete(buf);
+  }
+  netconn_close(conn);
+  netconn_delete(conn);
+  if ((error == NULL) && (rcvd != total)) {
+    error = "short";
+  }
+  if (error != NULL) {
+    printf("bench httpd_stream error=%s bytes=%u\n", error, (unsigned)rcvd);
+    free(hdr);
+    return 0;
+  }
+
+  /* Events: one per interval, numbered from 0 */
+  conn = stream_get("/events", hdr, BENCH_STREAM_BUF, &body, &len);
+  if ((conn == NULL) || (strstr(hdr, "Content-Type: text/event-stream\r\n") == NULL)) {
+    printf("bench httpd_stream error=events\n");
+    if (conn != NULL) {
+      netconn_delete(conn);
+    }
+    free(hdr);
+    return 0;
+  }
+  p = body;
+  while (error == NULL) {
+    while ((events < BENCH_STREAM_EVENTS) && ((q = strstr(p, "}\n\n")) != NULL)) {
+      if ((sscanf(p, "id: %u\ndata: {\"pass\":%u,\"ms\":%u}", &id, &pass, &ms) != 3) ||
+          (id != events) || (pass != events)) {
+        error = "event";
+        break;
+      }
+      /* the first interval starts with the request, not on the poll timer */
+      if (events == 1) {
+        first_ms = ms;
+      }
+      last_ms = ms;
+      events++;
+      p = q + 3;
+    }
+    if ((error != NULL) || (events == BENCH_STREAM_EVENTS)) {
+      break;
+    }
+    /* keep the partial event, append what follows */
+    len = (u32_t)strlen(p);
+    memmove(hdr, p, len + 1);
+    p = hdr;
+    if (netconn_recv(conn, &buf) != ERR_OK) {
+      error = "recv";
+      break;
+    }
+    do {
+      netbuf_data(buf, &data, &l);
+      if (len + l >= BENCH_STREAM_BUF) {
+        error = "event";
+        break;
+      }
+      memcpy(&hdr[len], data, l);
+      len += l;
+    } while (netbuf_next(buf) >= 0);
+    netbuf_delete(buf);
+    hdr[len] = 0;
+  }
+  netconn_close(conn);
+  netconn_delete(conn);
+  free(hdr);
+  if (error != NULL) {
+    printf("bench httpd_stream error=%s events=%u\n", error, (unsigned)events);
+    return 0;
+  }
+
+  printf("bench httpd_stream bytes=%u ms=%u kbit_s=%u records=%u events=%u event_ms=%u\n",
+         (unsigned)total, (unsigned)(elapsed / 1000),
+         (unsigned)(elapsed ? ((uint64_t)total * 8U * 1000U) / elapsed : 0), (unsigned)stream_records,
+         (unsigned)events, (unsigned)((last_ms - first_ms) / (events - 2)));
+  return 1;
+}
+
+struct demux_run {
+  u32_t pcbs;
+  u32_t tcp_ns;
+  u32_t udp_ns;
+  int ok;
+  sys_sem_t done;
+};
+
+/* IPv4 packet from the PC to the firmware around the transport header and
+   payload of t, checksums computed */
+static u16_t demux_packet(u8_t *packet, u8_t proto, struct pbuf *t)
+{
+  struct ip_hdr *iph = (struct ip_hdr *)packet;
+  u16_t len = (u16_t)(IP_HLEN + t->tot_len);
+
+  memset(iph, 0, IP_HLEN);
+  IPH_VHL_SET(iph, 4, IP_HLEN / 4);
+  IPH_LEN_SET(iph, lwip_htons(len));
+  IPH_TTL_SET(iph, 64);
+  IPH_PROTO_SET(iph, proto);
+  ip4_addr_copy(iph->src, *ip_2_ip4(&pc_addr));
+  ip4_addr_copy(iph->dest, *ip_2_ip4(&dut_addr));
+  IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+  pbuf_copy_partial(t, packet + IP_HLEN, t->tot_len, 0);
+  return len;
+}
+
+/* Feeds the packets to the firmware netif in turn: no PCB is found twice in
+   a row, as with many polling clients. Best of BENCH_DEMUX_ROUNDS, the
+   first one warms the caches. */
+static u32_t demux_feed(u8_t (*packets)[BENCH_DEMUX_SIZE], const u16_t *lens, u32_t n)
+{
+  struct pbuf *p;
+  uint64_t start, elapsed, best = 0;
+  u32_t i, round;
+
+  for (round = 0; round < BENCH_DEMUX_ROUNDS; round++) {
+    start = bench_now_us();
+    for (i = 0; i < BENCH_DEMUX_PACKETS; i++) {
+      p = pbuf_alloc(PBUF_RAW, lens[i % n], PBUF_RAM);
+      if (p == NULL) {
+        return 0;
+      }
+      pbuf_take(p, packets[i % n], lens[i % n]);
+      ip4_input(p, get_gnetif());
+    }
+    elapsed = bench_now_us() - start;
+    if ((round == 1) || ((round > 1) && (elapsed < best))) {
+      best = elapsed;
+    }
+  }
+  return (u32_t)(best * 1000U / BENCH_DEMUX_PACKETS);
+}
+
+/* In tcpip_thread: run->pcbs connections to BENCH_DEMUX_PORT and as many UDP
+   PCBs, then the cost of a segment and a datagram to each of them */
+static void demux_run(void *arg)
+{
+  static u8_t tcp_packets[BENCH_DEMUX_MAX][BENCH_DEMUX_SIZE];
+  static u8_t udp_packets[BENCH_DEMUX_MAX][BENCH_DEMUX_SIZE];
+  struct demux_run *run = (struct demux_run *)arg;
+  struct tcp_pcb *tpcb[BENCH_DEMUX_MAX];
+  struct udp_pcb *upcb[BENCH_DEMUX_MAX];
+  u16_t tcp_lens[BENCH_DEMUX_MAX], udp_lens[BENCH_DEMUX_MAX];
+  struct tcp_hdr *tcphdr;
+  struct udp_hdr *udphdr;
+  struct pbuf *t;
+  u32_t i, n;
+
+  run->ok = 0;
+  for (n = 0; n < run->pcbs; n++) {
+    tpcb[n] = tcp_new();
+    upcb[n] = udp_new();
+    if ((tpcb[n] == NULL) || (upcb[n] == NULL) || (udp_bind(upcb[n], &dut_addr, (u16_t)(BENCH_DEMUX_PORT + n)) != ERR_OK)) {
+      if (tpcb[n] != NULL) {
+        tcp_abort(tpcb[n]);
+      }
+      if (upcb[n] != NULL) {
+        udp_remove(upcb[n]);
+      }
+      goto cleanup;
+    }
+
+    /* A connection waiting for its SYN+ACK: a reset that does not
+       acknowledge the SYN is dropped right after the lookup, nothing is
+       sent back */
+    ip_addr_copy(tpcb[n]->local_ip, dut_addr);
+    ip_addr_copy(tpcb[n]->remote_ip, pc_addr);
+    tpcb[n]->local_port = BENCH_DEMUX_PORT;
+    tpcb[n]->remote_port = (u16_t)(BENCH_DEMUX_CLIENT + n);
+    tpcb[n]->state = SYN_SENT;
+    TCP_REG_ACTIVE(tpcb[n]);
+
+    t = pbuf_alloc(PBUF_RAW, TCP_HLEN, PBUF_RAM);
+    if (t == NULL) {
+      n++;
+      goto cleanup;
+    }
+    tcphdr = (struct tcp_hdr *)t->payload;
+    memset(tcphdr, 0, TCP_HLEN);
+    tcphdr->src = lwip_htons(tpcb[n]->remote_port);
+    tcphdr->dest = lwip_htons(tpcb[n]->local_port);
+    tcphdr->ackno = lwip_htonl(tpcb[n]->snd_nxt + 1);
+    TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, TCP_RST | TCP_ACK);
+    tcphdr->chksum = ip_chksum_pseudo(t, IP_PROTO_TCP, t->tot_len, &pc_addr, &dut_addr);
+    tcp_lens[n] = demux_packet(tcp_packets[n], IP_PROTO_TCP, t);
+    pbuf_free(t);
+
+    /* No recv callback: the datagram is freed once its PCB is found */
+    t = pbuf_alloc(PBUF_RAW, UDP_HLEN + 16, PBUF_RAM);
+    if (t == NULL) {
+      n++;
+      goto cleanup;
+    }
+    udphdr = (struct udp_hdr *)t->payload;
+    memset(udphdr, 0, UDP_HLEN + 16);
+    udphdr->src = lwip_htons(BENCH_DEMUX_CLIENT);
+    udphdr->dest = lwip_htons(upcb[n]->local_port);
+    udphdr->len = lwip_htons(t->tot_len);
+    udphdr->chksum = ip_chksum_pseudo(t, IP_PROTO_UDP, t->tot_len, &pc_addr, &dut_addr);
+    udp_lens[n] = demux_packet(udp_packets[n], IP_PROTO_UDP, t);
+    pbuf_free(t);
+  }
+
+  run->tcp_ns = demux_feed(tcp_packets, tcp_lens, n);
+  run->udp_ns = demux_feed(udp_packets, udp_lens, n);
+  run->ok = (run->tcp_ns != 0) && (run->udp_ns != 0);
+
+cleanup:
+  for (i = 0; i < n; i++) {
+    tcp_close(tpcb[i]);
+    udp_remove(upcb[i]);
+  }
+  sys_sem_signal(&run->done);
+}
+
+/* Input cost of a TCP segment and a UDP datagram as the number of PCBs
+   grows, the firmware's own ones on top. Build with TCP_PCB_HASH_SIZE and
+   UDP_PCB_HASH_SIZE 0 to compare with the list walk. */
+static int bench_pcb_demux(void)
+{
+  static const u32_t points[] = { 1, 8, 32, BENCH_DEMUX_MAX };
+  struct demux_run run;
+  size_t i;
+
+  sys_sem_new(&run.done, 0);
+  for (i = 0; i < LWIP_ARRAYSIZE(points); i++) {
+    run.pcbs = points[i];
+    tcpip_callback(demux_run, &run);
+    sys_arch_sem_wait(&run.done, 0);
+    if (!run.ok) {
+      printf("bench pcb_demux error=alloc pcbs=%u\n", (unsigned)run.pcbs);
+      sys_sem_free(&run.done);
+      return 0;
+    }
+    printf("bench pcb_demux pcbs=%u tcp_hash=%d udp_hash=%d tcp_ns=%u udp_ns=%u\n", (unsigned)run.pcbs,
+           TCP_PCB_HASH_SIZE, UDP_PCB_HASH_SIZE, (unsigned)run.tcp_ns, (unsigned)run.udp_ns);
+  }
+  sys_sem_free(&run.done);
+  return 1;
+}
+
+struct arp_run {
+  u32_t entries;
+  u32_t ns;
+  int ok;
+  sys_sem_t done;
+};
+
+/* In tcpip_thread: run->entries static neighbours on the firmware subnet,
+   then the cost of finding them in turn as etharp_input() and
+   etharp_query() do. Best of BENCH_DEMUX_ROUNDS. */
+static void arp_run(void *arg)
+{
+  struct arp_run *run = (struct arp_run *)arg;
+  ip4_addr_t addrs[BENCH_ARP_MAX];
+  struct eth_addr mac = {{ 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }};
+  struct eth_addr *eth_ret;
+  const ip4_addr_t *ip_ret;
+  uint64_t start, elapsed, best = 0;
+  u32_t i, n, round;
+
+  run->ok = 1;
+  for (n = 0; n < run->entries; n++) {
+    ip4_addr_set_u32(&addrs[n], (ip4_addr_get_u32(ip_2_ip4(&dut_addr)) & PP_HTONL(0xffffff00UL)) |
+                     PP_HTONL(BENCH_ARP_HOST + n));
+    mac.addr[5] = (u8_t)n;
+    if (etharp_add_static_entry(&addrs[n], &mac) != ERR_OK) {
+      run->ok = 0;
+      goto cleanup;
+    }
+  }
+
+  for (round = 0; round < BENCH_DEMUX_ROUNDS; round++) {
+    start = bench_now_us();
+    for (i = 0; i < BENCH_ARP_LOOKUPS; i++) {
+      if (etharp_find_addr(get_gnetif(), &addrs[i % n], &eth_ret, &ip_ret) < 0) {
+        run->ok = 0;
+        goto cleanup;
+      }
+    }
+    elapsed = bench_now_us() - start;
+    if ((round == 1) || ((round > 1) && (elapsed < best))) {
+      best = elapsed;
+    }
+  }
+  run->ns = (u32_t)(best * 1000U / BENCH_ARP_LOOKUPS);
+
+cleanup:
+  for (i = 0; i < n; i++) {
+    etharp_remove_static_entry(&addrs[i]);
+  }
+  sys_sem_signal(&run->done);
+}
+
+/* ARP cache lookup cost as the number of neighbours grows. Build with
+   ARP_HASH_SIZE 0 to compare with the scan of the table. */
+static int bench_arp_lookup(void)
+{
+  static const u32_t points[] = { 1, 8, 32, BENCH_ARP_MAX };
+  struct arp_run run;
+  size_t i;
+
+  sys_sem_new(&run.done, 0);
+  for (i = 0; i < LWIP_ARRAYSIZE(points); i++) {
+    run.entries = points[i];
+    tcpip_callback(arp_run, &run);
+    sys_arch_sem_wait(&run.done, 0);
+    if (!run.ok) {
+      printf("bench arp_lookup error=add entries=%u\n", (unsigned)run.entries);
+      sys_sem_free(&run.done);
+      return 0;
+    }
+    printf("bench arp_lookup entries=%u hash=%d ns=%u\n", (unsigned)run.entries, ARP_HASH_SIZE, (unsigned)run.ns);
+  }
+  sys_sem_free(&run.done);
+  return 1;
+}
+
+/* The two links of napt: point to point, as the LTE uplink, each keeping
+   the last packet it was given to send */
+static struct netif napt_lan, napt_wan;
+static u8_t napt_sent[2][BENCH_NAPT_ERROR_SIZE];
+static u16_t napt_sent_len[2];
+
+struct napt_run {
+  u32_t flows;
+  u32_t out_ns;
+  u32_t in_ns;
+  int ok;
+  sys_sem_t done;
+};
+
+static err_t napt_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+  int i = (netif == &napt_wan);
+
+  LWIP_UNUSED_ARG(ipaddr);
+
+  napt_sent_len[i] = (u16_t)pbuf_copy_partial(p, napt_sent[i], sizeof(napt_sent[i]), 0);
+  return ERR_OK;
+}
+
+static err_t napt_netif_init(struct netif *netif)
+{
+  netif->name[0] = 'n';
+  netif->name[1] = (netif == &napt_wan) ? 'w' : 'l';
+  netif->output = napt_output;
+  netif->mtu = 1500;
+  netif->flags |= NETIF_FLAG_LINK_UP;
+  return ERR_OK;
+}
+
+/* Flow n: TCP, UDP or ICMP echo in turn, from a host on the LAN to a remote
+   host, with its own port */
+static u8_t napt_proto(u32_t n)
+{
+  static const u8_t protos[] = { IP_PROTO_TCP, IP_PROTO_UDP, IP_PROTO_ICMP };
+  return protos[n % 3];
+}
+
+/* IPv4 header of a packet of proto carrying len bytes, zeroed */
+static void napt_iphdr(u8_t *packet, u8_t proto, const ip4_addr_t *src, const ip4_addr_t *dest, u16_t len)
+{
+  struct ip_hdr *iph = (struct ip_hdr *)packet;
+
+  memset(packet, 0, IP_HLEN + len);
+  IPH_VHL_SET(iph, 4, IP_HLEN / 4);
+  IPH_LEN_SET(iph, lwip_htons(IP_HLEN + len));
+  IPH_TTL_SET(iph, 64);
+  IPH_PROTO_SET(iph, proto);
+  ip4_addr_copy(iph->src, *src);
+  ip4_addr_copy(iph->dest, *dest);
+  IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+}
+
+/* IPv4 packet of proto between src:sport and dest:dport, checksums computed.
+   An ICMP echo carries sport as identifier, a request if dport is 0. */
+static u16_t napt_packet(u8_t *packet, u8_t proto, const ip4_addr_t *src, u16_t sport,
+                         const ip4_addr_t *dest, u16_t dport)
+{
+  u8_t *th = packet + IP_HLEN;
+  u16_t hlen = (proto == IP_PROTO_TCP) ? TCP_HLEN : ((proto == IP_PROTO_UDP) ? UDP_HLEN : sizeof(struct icmp_echo_hdr));
+  u16_t len = (u16_t)(hlen + BENCH_NAPT_PAYLOAD);
+  ip_addr_t s, d;
+  struct pbuf *t;
+
+  napt_iphdr(packet, proto, src, dest, len);
+
+  if (proto == IP_PROTO_ICMP) {
+    struct icmp_echo_hdr *echo = (struct icmp_echo_hdr *)th;
+    ICMPH_TYPE_SET(echo, (dport == 0) ? ICMP_ECHO : ICMP_ER);
+    echo->id = lwip_htons(sport);
+    echo->seqno = PP_HTONS(1);
+    echo->chksum = inet_chksum(echo, len);
+    return (u16_t)(IP_HLEN + len);
+  }
+
+  if (proto == IP_PROTO_TCP) {
+    struct tcp_hdr *tcphdr = (struct tcp_hdr *)th;
+    tcphdr->src = lwip_htons(sport);
+    tcphdr->dest = lwip_htons(dport);
+    tcphdr->seqno = PP_HTONL(1);
+    tcphdr->ackno = PP_HTONL(1);
+    TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, TCP_ACK | TCP_PSH);
+    tcphdr->wnd = PP_HTONS(TCP_WND);
+  } else {
+    struct udp_hdr *udphdr = (struct udp_hdr *)th;
+    udphdr->src = lwip_htons(sport);
+    udphdr->dest = lwip_htons(dport);
+    udphdr->len = lwip_htons(len);
+  }
+
+  t = pbuf_alloc(PBUF_RAW, len, PBUF_REF);
+  if (t == NULL) {
+    return 0;
+  }
+  t->payload = th;
+  ip_addr_copy_from_ip4(s, *src);
+  ip_addr_copy_from_ip4(d, *dest);
+  *(u16_t *)(th + ((proto == IP_PROTO_TCP) ? 16 : 6)) = ip_chksum_pseudo(t, proto, len, &s, &d);
+  pbuf_free(t);
+  return (u16_t)(IP_HLEN + len);
+}
+
+/* Whether a packet of size bytes has valid sums, and its addresses and
+   ports (identifier for ICMP) */
+static int napt_parse(u8_t *packet, u16_t size, u8_t proto, ip4_addr_t *src, u16_t *sport, ip4_addr_t *dest, u16_t *dport)
+{
+  struct ip_hdr *iph = (struct ip_hdr *)packet;
+  u8_t *th = packet + IP_HLEN;
+  u16_t len = (u16_t)(size - IP_HLEN);
+  ip_addr_t s, d;
+  struct pbuf *t;
+  u16_t sum;
+
+  if ((size <= IP_HLEN) || (IPH_PROTO(iph) != proto) || (inet_chksum(iph, IP_HLEN) != 0)) {
+    return 0;
+  }
+  ip4_addr_copy(*src, iph->src);
+  ip4_addr_copy(*dest, iph->dest);
+
+  if (proto == IP_PROTO_ICMP) {
+    *sport = *dport = lwip_ntohs(((struct icmp_echo_hdr *)th)->id);
+    return inet_chksum(th, len) == 0;
+  }
+  *sport = lwip_ntohs(((struct udp_hdr *)th)->src);
+  *dport = lwip_ntohs(((struct udp_hdr *)th)->dest);
+
+  t = pbuf_alloc(PBUF_RAW, len, PBUF_REF);
+  if (t == NULL) {
+    return 0;
+  }
+  t->payload = th;
+  ip_addr_copy_from_ip4(s, *src);
+  ip_addr_copy_from_ip4(d, *dest);
+  sum = ip_chksum_pseudo(t, proto, len, &s, &d);
+  pbuf_free(t);
+  return sum == 0;
+}
+
+/* napt_parse() of the last packet a link sent */
+static int napt_check(int link, u8_t proto, ip4_addr_t *src, u16_t *sport, ip4_addr_t *dest, u16_t *dport)
+{
+  u16_t size = napt_sent_len[link];
+
+  napt_sent_len[link] = 0;
+  return napt_parse(napt_sent[link], size, proto, src, sport, dest, dport);
+}
+
+/* Feeds the packets to a link in turn, best of BENCH_DEMUX_ROUNDS */
+static u32_t napt_feed(struct netif *inp, u8_t (*packets)[BENCH_NAPT_SIZE], const u16_t *lens, u32_t n)
+{
+  struct pbuf *p;
+  uint64_t start, elapsed, best = 0;
+  u32_t i, round;
+
+  for (round = 0; round < BENCH_DEMUX_ROUNDS; round++) {
+    start = bench_now_us();
+    for (i = 0; i < BENCH_DEMUX_PACKETS; i++) {
+      p = pbuf_alloc(PBUF_RAW, lens[i % n], PBUF_RAM);
+      if (p == NULL) {
+        return 0;
+      }
+      pbuf_take(p, packets[i % n], lens[i % n]);
+      ip4_input(p, inp);
+    }
+    elapsed = bench_now_us() - start;
+    if ((round == 1) || ((round > 1) && (elapsed < best))) {
+      best = elapsed;
+    }
+  }
+  return (u32_t)(best * 1000U / BENCH_DEMUX_PACKETS);
+}
+
+/* In tcpip_thread: run->flows flows from the LAN through the WAN link, each
+   checked once both ways, then the cost of a packet out and of a reply */
+static void napt_run(void *arg)
+{
+  static u8_t out_packets[BENCH_NAPT_MAX][BENCH_NAPT_SIZE];
+  static u8_t in_packets[BENCH_NAPT_MAX][BENCH_NAPT_SIZE];
+  struct napt_run *run = (struct napt_run *)arg;
+  u16_t out_lens[BENCH_NAPT_MAX], in_lens[BENCH_NAPT_MAX];
+  ip4_addr_t host, server, src, dest;
+  u16_t sport, dport, mport;
+  struct netif *default_netif = netif_default;
+  struct pbuf *p;
+  u32_t n;
+  u8_t proto;
+
+  run->ok = 0;
+  netif_set_default(&napt_wan);
+
+  for (n = 0; n < run->flows; n++) {
+    proto = napt_proto(n);
+    ip4_addr_set_u32(&host, lwip_htonl(lwip_ntohl(ip4_addr_get_u32(netif_ip4_addr(&napt_lan))) + 1 + n % 4));
+    ip4_addr_set_u32(&server, lwip_htonl(lwip_ntohl(ipaddr_addr(BENCH_NAPT_SERVER)) + n % 8));
+    sport = (u16_t)(20000 + n);
+    dport = (proto == IP_PROTO_ICMP) ? 0 : 443;
+
+    /* Out: from the board's address on the WAN link, an outside port */
+    out_lens[n] = napt_packet(out_packets[n], proto, &host, sport, &server, dport);
+    p = pbuf_alloc(PBUF_RAW, out_lens[n], PBUF_RAM);
+    if ((out_lens[n] == 0) || (p == NULL)) {
+      goto cleanup;
+    }
+    pbuf_take(p, out_packets[n], out_lens[n]);
+    ip4_input(p, &napt_lan);
+    if (!napt_check(1, proto, &src, &mport, &dest, &dport) ||
+        !ip4_addr_cmp(&src, netif_ip4_addr(&napt_wan)) || !ip4_addr_cmp(&dest, &server) ||
+        (mport < IP_NAPT_PORT_FIRST) || (mport > IP_NAPT_PORT_LAST)) {
+      goto cleanup;
+    }
+
+    /* In: back to the host and its port */
+    in_lens[n] = napt_packet(in_packets[n], proto, &server, dport, netif_ip4_addr(&napt_wan), mport);
+    p = pbuf_alloc(PBUF_RAW, in_lens[n], PBUF_RAM);
+    if ((in_lens[n] == 0) || (p == NULL)) {
+      goto cleanup;
+    }
+    pbuf_take(p, in_packets[n], in_lens[n]);
+    ip4_input(p, &napt_wan);
+    if (!napt_check(0, proto, &src, &dport, &dest, &mport) ||
+        !ip4_addr_cmp(&src, &server) || !ip4_addr_cmp(&dest, &host) || (mport != sport)) {
+      goto cleanup;
+    }
+  }
+
+  run->out_ns = napt_feed(&napt_lan, out_packets, out_lens, n);
+  run->in_ns = napt_feed(&napt_wan, in_packets, in_lens, n);
+  run->ok = (run->out_ns != 0) && (run->in_ns != 0);
+
+cleanup:
+  netif_set_default(default_netif);
+  sys_sem_signal(&run->done);
+}
+
+static void napt_links(void *arg)
+{
+  ip4_addr_t addr, mask, gw;
+
+  ip4_addr_set_zero(&gw);
+  if (arg != NULL) {
+    ip4addr_aton(BENCH_NAPT_LAN, &addr);
+    ip4addr_aton(BENCH_NETMASK, &mask);
+    netif_add(&napt_lan, &addr, &mask, &gw, NULL, napt_netif_init, ip4_input);
+    ip4addr_aton(BENCH_NAPT_WAN, &addr);
+    ip4addr_aton("255.255.255.255", &mask);
+    netif_add(&napt_wan, &addr, &mask, &gw, NULL, napt_netif_init, ip4_input);
+    ip4_napt_enable(&napt_lan, 1);
+    netif_set_up(&napt_lan);
+    netif_set_up(&napt_wan);
+  } else {
+    netif_remove(&napt_lan);
+    netif_remove(&napt_wan);
+  }
+  sys_sem_signal(&pc_ready);
+}
+
+/* The napt_* cases run with the core locked and the WAN link as the
+   default netif, which linkmgr may have moved in between */
+static struct netif *napt_saved_default;
+
+static void napt_lock(void)
+{
+  LOCK_TCPIP_CORE();
+  napt_saved_default = netif_default;
+  netif_set_default(&napt_wan);
+}
+
+static void napt_unlock(void)
+{
+  netif_set_default(napt_saved_default);
+  UNLOCK_TCPIP_CORE();
+}
+
+/* Feeds a packet to a link, as received, after forgetting what the links
+   sent; 0 if it could not be built */
+static int napt_inject(struct netif *inp, const u8_t *packet, u16_t len)
+{
+  struct pbuf *p;
+
+  napt_sent_len[0] = napt_sent_len[1] = 0;
+  if (len == 0) {
+    return 0;
+  }
+  p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+  if (p == NULL) {
+    return 0;
+  }
+  pbuf_take(p, packet, len);
+  ip4_input(p, inp);
+  return 1;
+}
+
+/* The outside port of a flow from host:sport to server:dport once a
+   packet of it went out, 0 if it was not translated */
+static u16_t napt_open(u8_t proto, const ip4_addr_t *host, u16_t sport, const ip4_addr_t *server, u16_t dport)
+{
+  u8_t packet[BENCH_NAPT_SIZE];
+  ip4_addr_t src, dest;
+  u16_t mport, port;
+
+  if (!napt_inject(&napt_lan, packet, napt_packet(packet, proto, host, sport, server, dport)) ||
+      !napt_check(1, proto, &src, &mport, &dest, &port) || !ip4_addr_cmp(&src, netif_ip4_addr(&napt_wan))) {
+    return 0;
+  }
+  return mport;
+}
+
+/* Whether a reply from server:dport to the outside port mport is
+   forwarded to host:sport */
+static int napt_reply(u8_t proto, const ip4_addr_t *server, u16_t dport, u16_t mport,
+                      const ip4_addr_t *host, u16_t sport)
+{
+  u8_t packet[BENCH_NAPT_SIZE];
+  ip4_addr_t src, dest;
+  u16_t port, from;
+
+  /* An echo reply carries the identifier in place of both ports */
+  if (proto == IP_PROTO_ICMP) {
+    dport = mport;
+  }
+  return napt_inject(&napt_wan, packet, napt_packet(packet, proto, server, dport, netif_ip4_addr(&napt_wan), mport)) &&
+         napt_check(0, proto, &src, &from, &dest, &port) && ip4_addr_cmp(&dest, host) && (port == sport);
+}
+
+/* ICMP error of type and code from src to dest quoting qlen bytes of a
+   packet */
+static u16_t napt_error(u8_t *packet, u8_t type, u8_t code, const ip4_addr_t *src, const ip4_addr_t *dest,
+                        const u8_t *quote, u16_t qlen)
+{
+  struct icmp_echo_hdr *icmp = (struct icmp_echo_hdr *)(packet + IP_HLEN);
+  u16_t len = (u16_t)(sizeof(struct icmp_echo_hdr) + qlen);
+
+  napt_iphdr(packet, IP_PROTO_ICMP, src, dest, len);
+  ICMPH_TYPE_SET(icmp, type);
+  ICMPH_CODE_SET(icmp, code);
+  memcpy(packet + IP_HLEN + sizeof(struct icmp_echo_hdr), quote, qlen);
+  icmp->chksum = inet_chksum(icmp, len);
+  return (u16_t)(IP_HLEN + len);
+}
+
+/* Whether the LAN link sent host an ICMP error of type and code with valid
+   sums, quoting a packet of proto from host:sport. The sums of the quoted
+   packet are checked if it is quoted whole, its first 8 bytes otherwise. */
+static int napt_check_error(const ip4_addr_t *host, u8_t type, u8_t code, u8_t proto, u16_t sport)
+{
+  struct icmp_echo_hdr *icmp = (struct icmp_echo_hdr *)(napt_sent[0] + IP_HLEN);
+  u8_t *quote = napt_sent[0] + IP_HLEN + sizeof(struct icmp_echo_hdr);
+  struct ip_hdr *inner = (struct ip_hdr *)quote;
+  u16_t qlen = (u16_t)(napt_sent_len[0] - IP_HLEN - sizeof(struct icmp_echo_hdr));
+  ip4_addr_t src, dest;
+  u16_t port, dport;
+
+  if ((napt_sent_len[0] < IP_HLEN + sizeof(struct icmp_echo_hdr) + IP_HLEN + 8) ||
+      !napt_check(0, IP_PROTO_ICMP, &src, &port, &dest, &dport) || !ip4_addr_cmp(&dest, host) ||
+      (ICMPH_TYPE(icmp) != type) || (ICMPH_CODE(icmp) != code)) {
+    return 0;
+  }
+  if (qlen >= lwip_ntohs(IPH_LEN(inner))) {
+    return napt_parse(quote, lwip_ntohs(IPH_LEN(inner)), proto, &src, &port, &dest, &dport) &&
+           ip4_addr_cmp(&src, host) && (port == sport);
+  }
+  ip4_addr_copy(src, inner->src);
+  port = (proto == IP_PROTO_ICMP) ? ((struct icmp_echo_hdr *)(quote + IP_HLEN))->id : ((struct udp_hdr *)(quote + IP_HLEN))->src;
+  return (IPH_PROTO(inner) == proto) && (inet_chksum(inner, IP_HLEN) == 0) && ip4_addr_cmp(&src, host) &&
+         (lwip_ntohs(port) == sport);
+}
+
+/* A translation idle for longer than IP_NAPT_TMOT_ICMP no longer takes
+   replies, and the flow gets a new one */
+static int napt_expiry(void)
+{
+  struct ip4_napt_stats before, after;
+  ip4_addr_t host, server;
+  u16_t mport, again;
+  int ok;
+
+  ip4_addr_set_u32(&host, lwip_htonl(lwip_ntohl(ip4_addr_get_u32(netif_ip4_addr(&napt_lan))) + 1));
+  ip4addr_aton(BENCH_NAPT_SERVER, &server);
+
+  napt_lock();
+  ip4_napt_get_stats(&before);
+  mport = napt_open(IP_PROTO_ICMP, &host, BENCH_NAPT_PORT, &server, 0);
+  ok = (mport != 0) && napt_reply(IP_PROTO_ICMP, &server, 0, mport, &host, BENCH_NAPT_PORT);
+  napt_unlock();
+
+  sys_msleep(IP_NAPT_TMOT_ICMP + 100);
+
+  napt_lock();
+  ok = ok && !napt_reply(IP_PROTO_ICMP, &server, 0, mport, &host, BENCH_NAPT_PORT);
+  again = napt_open(IP_PROTO_ICMP, &host, BENCH_NAPT_PORT, &server, 0);
+  ok = ok && (again != 0) && napt_reply(IP_PROTO_ICMP, &server, 0, again, &host, BENCH_NAPT_PORT);
+  ip4_napt_get_stats(&after);
+  napt_unlock();
+
+  if (!ok || (after.expired == before.expired) || (after.created - before.created != 2)) {
+    printf("bench napt error=expiry expired=%u created=%u\n", (unsigned)(after.expired - before.expired),
+           (unsigned)(after.created - before.created));
+    return 0;
+  }
+  printf("bench napt_expiry timeout_ms=%d expired=%u\n", IP_NAPT_TMOT_ICMP, (unsigned)(after.expired - before.expired));
+  return 1;
+}
+
+/* With the table full, a new flow takes the translation idle the longest:
+   the flow opened first loses its replies, the others keep them */
+static int napt_recycle(void)
+{
+  static u16_t mports[IP_NAPT_MAX + 1];
+  struct ip4_napt_stats before, after;
+  ip4_addr_t host, server;
+  u16_t i;
+  int ok;
+
+  ip4_addr_set_u32(&host, lwip_htonl(lwip_ntohl(ip4_addr_get_u32(netif_ip4_addr(&napt_lan))) + 2));
+  ip4addr_aton(BENCH_NAPT_SERVER, &server);
+
+  /* The translations of napt_run are older than the first flow, which is
+     older than the others */
+  sys_msleep(10);
+  napt_lock();
+  ip4_napt_get_stats(&before);
+  mports[0] = napt_open(IP_PROTO_UDP, &host, BENCH_NAPT_PORT, &server, 53);
+  napt_unlock();
+  sys_msleep(10);
+
+  napt_lock();
+  ok = (mports[0] != 0);
+  for (i = 1; ok && (i <= IP_NAPT_MAX); i++) {
+    mports[i] = napt_open(IP_PROTO_UDP, &host, (u16_t)(BENCH_NAPT_PORT + i), &server, 53);
+    ok = (mports[i] != 0);
+  }
+  ok = ok && !napt_reply(IP_PROTO_UDP, &server, 53, mports[0], &host, BENCH_NAPT_PORT) &&
+       napt_reply(IP_PROTO_UDP, &server, 53, mports[1], &host, BENCH_NAPT_PORT + 1) &&
+       napt_reply(IP_PROTO_UDP, &server, 53, mports[IP_NAPT_MAX], &host, BENCH_NAPT_PORT + IP_NAPT_MAX);
+  ip4_napt_get_stats(&after);
+  napt_unlock();
+
+  if (!ok || (after.recycled == before.recycled) || (after.used != IP_NAPT_MAX)) {
+    printf("bench napt error=recycle recycled=%u used=%u\n", (unsigned)(after.recycled - before.recycled),
+           (unsigned)after.used);
+    return 0;
+  }
+  printf("bench napt_recycle entries=%d recycled=%u\n", IP_NAPT_MAX, (unsigned)(after.recycled - before.recycled));
+  return 1;
+}
+
+/* ICMP errors about translated packets reach the inside host with the
+   packet they quote translated back, every sum valid; and a packet too big
+   for the WAN link with DF set gets "fragmentation needed" quoting it as
+   the inside host sent it */
+static int napt_icmp_errors(void)
+{
+  static const u8_t protos[] = { IP_PROTO_TCP, IP_PROTO_UDP, IP_PROTO_ICMP };
+  u8_t quote[BENCH_NAPT_SIZE], packet[BENCH_NAPT_ERROR_SIZE];
+  ip4_addr_t host, server;
+  u16_t sport, dport, mport, len;
+  size_t i;
+  int ok = 1;
+
+  ip4_addr_set_u32(&host, lwip_htonl(lwip_ntohl(ip4_addr_get_u32(netif_ip4_addr(&napt_lan))) + 3));
+  ip4addr_aton(BENCH_NAPT_SERVER, &server);
+
+  napt_lock();
+  for (i = 0; ok && (i < LWIP_ARRAYSIZE(protos)); i++) {
+    sport = (u16_t)(BENCH_NAPT_PORT + i);
+    dport = (protos[i] == IP_PROTO_ICMP) ? 0 : 443;
+    mport = napt_open(protos[i], &host, sport, &server, dport);
+    /* The packet as it left, quoted whole, as a router sends it back */
+    len = napt_packet(quote, protos[i], netif_ip4_addr(&napt_wan), mport, &server, dport);
+    ok = (mport != 0) &&
+         napt_inject(&napt_wan, packet, napt_error(packet, ICMP_DUR, ICMP_DUR_PORT, &server, netif_ip4_addr(&napt_wan), quote, len)) &&
+         napt_check_error(&host, ICMP_DUR, ICMP_DUR_PORT, protos[i], sport);
+    if (!ok) {
+      printf("bench napt error=icmp_error proto=%u\n", (unsigned)protos[i]);
+    }
+  }
+
+  if (ok) {
+    sport = (u16_t)(BENCH_NAPT_PORT + i);
+    len = napt_packet(packet, IP_PROTO_TCP, &host, sport, &server, 443);
+    IPH_OFFSET_SET((struct ip_hdr *)packet, PP_HTONS(IP_DF));
+    IPH_CHKSUM_SET((struct ip_hdr *)packet, 0);
+    IPH_CHKSUM_SET((struct ip_hdr *)packet, inet_chksum(packet, IP_HLEN));
+    napt_wan.mtu = IP_HLEN + TCP_HLEN;
+    ok = napt_inject(&napt_lan, packet, len) && (napt_sent_len[1] == 0) &&
+         napt_check_error(&host, ICMP_DUR, ICMP_DUR_FRAG, IP_PROTO_TCP, sport);
+    napt_wan.mtu = 1500;
+    if (!ok) {
+      printf("bench napt error=frag_needed\n");
+    }
+  }
+  napt_unlock();
+
+  if (ok) {
+    printf("bench napt_icmp_error protos=%u frag_needed=1\n", (unsigned)LWIP_ARRAYSIZE(protos));
+  }
+  return ok;
+}
+
+/* Forwarding cost from a LAN link to a WAN link and back through the
+   translation of IP_NAPT, as the number of flows grows */
+static int bench_napt(void)
+{
+  static const u32_t points[] = { 1, 8, 32, BENCH_NAPT_MAX };
+  struct ip4_napt_stats st;
+  struct napt_run run;
+  size_t i;
+  int ok = 1;
+
+  tcpip_callback(napt_links, &napt_lan);
+  sys_arch_sem_wait(&pc_ready, 0);
+
+  sys_sem_new(&run.done, 0);
+  for (i = 0; i < LWIP_ARRAYSIZE(points); i++) {
+    run.flows = points[i];
+    tcpip_callback(napt_run, &run);
+    sys_arch_sem_wait(&run.done, 0);
+    if (!run.ok) {
+      printf("bench napt error=translate flows=%u\n", (unsigned)run.flows);
+      ok = 0;
+      break;
+    }
+    printf("bench napt flows=%u hash=%d out_ns=%u in_ns=%u\n", (unsigned)run.flows, IP_NAPT_HASH_SIZE,
+           (unsigned)run.out_ns, (unsigned)run.in_ns);
+  }
+  sys_sem_free(&run.done);
+
+  if (ok) {
+    ok = napt_expiry() && napt_recycle() && napt_icmp_errors();
+  }
+
+  tcpip_callback(napt_links, NULL);
+  sys_arch_sem_wait(&pc_ready, 0);
+
+  ip4_napt_get_stats(&st);
+  printf("bench napt_table used=%u max=%u created=%u expired=%u recycled=%u dropped=%u\n", (unsigned)st.used,
+         (unsigned)st.max, (unsigned)st.created, (unsigned)st.expired, (unsigned)st.recycled, (unsigned)st.dropped);
+  return ok;
+}
+
+/* The LTE uplink of linkmgr: a point to point netif on which TARGET_SERVER
+   answers the probes, keeping the destination of anything else it sends */
+static struct netif lte_netif;
+static ip4_addr_t lte_last_dest;
+static u32_t lte_sent;
+
+/* Eats the echo requests of the Ethernet probes at the PC while set */
+static struct raw_pcb *eth_blackhole;
+static volatile int eth_unreachable;
+
+static err_t lte_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+  struct ip_hdr *iph;
+  struct icmp_echo_hdr *echo;
+  struct pbuf *q;
+  ip4_addr_t addr;
+  u16_t hlen;
+
+  LWIP_UNUSED_ARG(ipaddr);
+
+  q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+  if (q == NULL) {
+    return ERR_MEM;
+  }
+  pbuf_copy(q, p);
+  iph = (struct ip_hdr *)q->payload;
+  hlen = (u16_t)(IPH_HL(iph) * 4);
+  echo = (struct icmp_echo_hdr *)((u8_t *)q->payload + hlen);
+  if ((IPH_PROTO(iph) != IP_PROTO_ICMP) || (q->len < hlen + sizeof(*echo)) || (ICMPH_TYPE(echo) != ICMP_ECHO) ||
+      !ip4_addr_cmp(&iph->dest, ip_2_ip4(&pc_addr))) {
+    ip4_addr_copy(lte_last_dest, iph->dest);
+    lte_sent++;
+    pbuf_free(q);
+    return ERR_OK;
+  }
+
+  /* The reply of the probe target, in through tcpip_thread */
+  ip4_addr_copy(addr, iph->src);
+  ip4_addr_copy(iph->src, iph->dest);
+  ip4_addr_copy(iph->dest, addr);
+  IPH_CHKSUM_SET(iph, 0);
+  IPH_CHKSUM_SET(iph, inet_chksum(iph, hlen));
+  ICMPH_TYPE_SET(echo, ICMP_ER);
+  echo->chksum = 0;
+  echo->chksum = inet_chksum(echo, (u16_t)(q->len - hlen));
+  if (tcpip_inpkt(q, netif, ip4_input) != ERR_OK) {
+    pbuf_free(q);
+  }
+  return ERR_OK;
+}
+
+static err_t lte_netif_init(struct netif *netif)
+{
+  netif->name[0] = 'l';
+  netif->name[1] = 't';
+  netif->output = lte_output;
+  netif->mtu = 1500;
+  netif->flags |= NETIF_FLAG_LINK_UP;
+  return ERR_OK;
+}
+
+static u8_t eth_blackhole_recv(void *arg, struct raw_pcb *pcb, struct pbuf *p, const ip_addr_t *addr)
+{
+  struct icmp_echo_hdr echo;
+
+  LWIP_UNUSED_ARG(arg);
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(addr);
+
+  if (!eth_unreachable ||
+      (pbuf_copy_partial(p, &echo, sizeof(echo), (u16_t)(IPH_HL((struct ip_hdr *)p->payload) * 4)) != sizeof(echo)) ||
+      (ICMPH_TYPE(&echo) != ICMP_ECHO)) {
+    return 0;
+  }
+  pbuf_free(p);
+  return 1;
+}
+
+static void lte_link(void *arg)
+{
+  ip4_addr_t addr, mask, gw;
+
+  if (arg != NULL) {
+    ip4addr_aton(BENCH_LTE_ADDR, &addr);
+    ip4addr_aton("255.255.255.255", &mask);
+    ip4_addr_set_zero(&gw);
+    netif_add(&lte_netif, &addr, &mask, &gw, NULL, lte_netif_init, ip4_input);
+    netif_set_up(&lte_netif);
+    linkmgr_attach(LINK_LTE, &lte_netif);
+    ip4addr_aton(BENCH_LTE_PINNED, &addr);
+    ip4addr_aton(BENCH_NETMASK, &mask);
+    linkmgr_route_add(&addr, &mask, LINK_LTE);
+
+    eth_blackhole = raw_new(IP_PROTO_ICMP);
+    if (eth_blackhole != NULL) {
+      raw_bind(eth_blackhole, &pc_addr);
+      raw_recv(eth_blackhole, eth_blackhole_recv, NULL);
+    }
+  } else {
+    linkmgr_detach(LINK_LTE);
+    netif_remove(&lte_netif);
+    if (eth_blackhole != NULL) {
+      raw_remove(eth_blackhole);
+      eth_blackhole = NULL;
+    }
+  }
+  sys_sem_signal(&pc_ready);
+}
+
+/* ms until linkmgr has uplink id healthy, or active if active is set; -1
+   after BENCH_LINK_TIMEOUT */
+static int linkmgr_wait(link_id_t id, int active)
+{
+  link_status_t st;
+  uint64_t start = bench_now_us();
+  int ms;
+
+  for (;;) {
+    LOCK_TCPIP_CORE();
+    linkmgr_get_status(id, &st);
+    UNLOCK_TCPIP_CORE();
+    ms = (int)((bench_now_us() - start) / 1000U);
+    if (active ? st.active : st.healthy) {
+      return ms;
+    }
+    if (ms > BENCH_LINK_TIMEOUT) {
+      return -1;
+    }
+    sys_msleep(10);
+  }
+}
+
+/* Whether a datagram to dest from an unbound PCB left through LTE */
+static int lte_send(const char *dest)
+{
+  struct udp_pcb *pcb;
+  struct pbuf *p;
+  ip_addr_t addr;
+  u32_t sent;
+
+  ipaddr_aton(dest, &addr);
+  LOCK_TCPIP_CORE();
+  sent = lte_sent;
+  pcb = udp_new();
+  p = pbuf_alloc(PBUF_TRANSPORT, BENCH_RTT_SIZE, PBUF_RAM);
+  if ((pcb != NULL) && (p != NULL)) {
+    memset(p->payload, 0, BENCH_RTT_SIZE);
+    udp_sendto(pcb, p, &addr, BENCH_DISCARD_PORT);
+  }
+  if (p != NULL) {
+    pbuf_free(p);
+  }
+  if (pcb != NULL) {
+    udp_remove(pcb);
+  }
+  sent = (lte_sent != sent) && ip4_addr_cmp(&lte_last_dest, ip_2_ip4(&addr));
+  UNLOCK_TCPIP_CORE();
+  return (int)sent;
+}
+
+/* linkmgr_route() and failover with an LTE uplink next to the firmware's
+   Ethernet: a destination pinned on LTE leaves through it, the others
+   through Ethernet; once the PC stops answering the Ethernet probes the
+   default netif moves to LTE, and back when it answers again */
+static int bench_linkmgr(void)
+{
+  int failover_ms, restore_ms, ok = 0;
+
+  tcpip_callback(lte_link, &lte_netif);
+  sys_arch_sem_wait(&pc_ready, 0);
+
+  if ((eth_blackhole == NULL) || (linkmgr_wait(LINK_LTE, 0) < 0) || (linkmgr_wait(LINK_ETH, 1) < 0)) {
+    printf("bench linkmgr error=probe\n");
+    goto cleanup;
+  }
+  if (!lte_send(BENCH_LTE_PINNED) || lte_send(BENCH_LTE_REMOTE)) {
+    printf("bench linkmgr error=route\n");
+    goto cleanup;
+  }
+
+  eth_unreachable = 1;
+  failover_ms = linkmgr_wait(LINK_LTE, 1);
+  if ((failover_ms < 0) || !lte_send(BENCH_LTE_REMOTE)) {
+    printf("bench linkmgr error=failover\n");
+    goto cleanup;
+  }
+
+  eth_unreachable = 0;
+  restore_ms = linkmgr_wait(LINK_ETH, 1);
+  if ((restore_ms < 0) || lte_send(BENCH_LTE_REMOTE)) {
+    printf("bench linkmgr error=restore\n");
+    goto cleanup;
+  }
+
+  printf("bench linkmgr probe_ms=%d loss=%d failover_ms=%d restore_ms=%d\n", LINKMGR_PROBE_MS,
+         LINKMGR_PROBE_LOSS, failover_ms, restore_ms);
+  ok = 1;
+
+cleanup:
+  eth_unreachable = 0;
+  tcpip_callback(lte_link, NULL);
+  sys_arch_sem_wait(&pc_ready, 0);
+  return ok;
+}
+
+static void replay_barrier(void *arg)
+{
+  sys_sem_signal((sys_sem_t *)arg);
+}
+
+/* Frame processing rate of the firmware netif on a recorded trace */
+static int bench_replay(const char *path, u32_t speedup)
+{
+  sys_sem_t done;
+  uint64_t start, elapsed;
+  int n;
+
+  sys_sem_new(&done, 0);
+  start = bench_now_us();
+  n = vwire_replay(path, get_gnetif(), speedup);
+  if (n >= 0) {
+    /* Everything injected before the barrier has been processed after it */
+    tcpip_callback(replay_barrier, &done);
+    sys_arch_sem_wait(&done, 0);
+  }
+  elapsed = bench_now_us() - start;
+  sys_sem_free(&done);
+
+  if (n < 0) {
+    printf("bench replay error=file\n");
+    return 0;
+  }
+  printf("bench replay frames=%d ms=%u frames_s=%u\n", n, (unsigned)(elapsed / 1000),
+         (unsigned)(elapsed ? ((uint64_t)n * 1000000U) / elapsed : 0));
+  return 1;
+}
+
+/* High-water marks of the memp pools and mem_malloc() size classes, the PC
+   side's share included (see lwipopts.h) */
+static void report_pools(void)
+{
+  int i;
+
+  for (i = 0; i < MEMP_MAX; i++) {
+    const struct stats_mem *st = lwip_stats.memp[i];
+    printf("bench pool name=%s avail=%u max=%u err=%u\n", st->name, (unsigned)st->avail,
+           (unsigned)st->max, (unsigned)st->err);
+  }
+}
+
+#if LWIP_PERF
+/* Time spent in each PERF_START/PERF_STOP site of the stack */
+static void report_perf(void)
+{
+  struct perf_site site;
+  int i;
+
+  for (i = 0; perf_get(i, &site) == 0; i++) {
+    if (site.count == 0) {
+      continue;
+    }
+    printf("bench perf site=%s n=%u avg_ns=%u p50_ns=%u p99_ns=%u max_ns=%u\n", site.name, (unsigned)site.count,
+           (unsigned)(site.total / site.count), (unsigned)perf_percentile(&site, 50),
+           (unsigned)perf_percentile(&site, 99), (unsigned)site.max);
+  }
+}
+#endif /* LWIP_PERF */
+
+/*---------------------------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+  printf("usage: %s [options]\n"
+         "  -l us      one-way latency (default 0)\n"
+         "  -j us      jitter, uniform in [0, us] (default 0)\n"
+         "  -p ppm     frame loss per million (default 0)\n"
+         "  -b kbps    bandwidth per port, 0 unlimited (default 100000)\n"
+         "  -s seed    loss and jitter generator seed (default 1)\n"
+         "  -n bytes   payload of tcp_echo, netsrv, log_stream and httpd_stream (default 1048576)\n"
+         "  -c count   exchanges of tcp_rtt, udp_rtt, httpd and of each netsrv client, calls of api_call (default 200)\n"
+         "  -t list    comma separated benchmarks: tcp_echo,tcp_rtt,udp_rtt,netsrv,log_stream,log_binary,\n"
+         "             httpd,httpd_stream,api_call,pcb_demux,arp_lookup,napt,linkmgr,replay,chksum\n"
+         "             (default: all but replay, which needs -r)\n"
+         "  -w file    capture every frame on the wire to a pcap file\n"
+         "  -r file    replay a pcap file into the firmware netif\n"
+         "  -x n       replay n times faster than captured, 0 as fast as possible (default 0)\n",
+         prog);
+}
+
+static int selected(const char *list, const char *name)
+{
+  size_t len = strlen(name);
+  const char *s = list;
+
+  while ((s = strstr(s, name)) != NULL) {
+    if (((s == list) || (s[-1] == ',')) && ((s[len] == '\0') || (s[len] == ','))) {
+      return 1;
+    }
+    s += len;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  struct vwire_config cfg;
+  struct vwire_stats st;
+  const char *tests = BENCH_DEFAULT_TESTS;
+  const char *capture = NULL, *replay = NULL;
+  u32_t bytes = 1024 * 1024, count = 200, speedup = 0;
+  int opt, ok = 1;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.bandwidth_kbps = 100000;
+  cfg.seed = 1;
+
+  while ((opt = getopt(argc, argv, "l:j:p:b:s:n:c:t:w:r:x:h")) != -1) {
+    switch (opt) {
+      case 'l': cfg.latency_us = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 'j': cfg.jitter_us = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 'p': cfg.loss_ppm = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 'b': cfg.bandwidth_kbps = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 's': cfg.seed = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 'n': bytes = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 'c': count = (u32_t)strtoul(optarg, NULL, 0); break;
+      case 't': tests = optarg; break;
+      case 'w': capture = optarg; break;
+      case 'r': replay = optarg; break;
+      case 'x': speedup = (u32_t)strtoul(optarg, NULL, 0); break;
+      default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+    }
+  }
+  if ((replay != NULL) && (strcmp(tests, BENCH_DEFAULT_TESTS) == 0)) {
+    tests = "replay";
+  }
+
+  srandom(cfg.seed);
+  if (vwire_init(&cfg) != 0) {
+    return 1;
+  }
+  if ((capture != NULL) && (vwire_capture(capture) != 0)) {
+    printf("cannot create %s\n", capture);
+    return 1;
+  }
+  ipaddr_aton(TARGET_SERVER, &pc_addr);
+  sys_sem_new(&pc_ready, 0);
+  vwire_set_attach_hook(bench_attach);
+
+  /* The firmware, as started from main.c */
+  printlog_init();
+  osThreadDef(start_lwip_thread_seq, start_lwip_thread_seq, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+  osThreadCreate(osThread(start_lwip_thread_seq), NULL);
+
+  sys_arch_sem_wait(&pc_ready, 0);
+  sys_sem_signal(&pc_ready);
+  sys_thread_new("sink", sink_thread, NULL, DEFAULT_THREAD_STACKSIZE, DEFAULT_THREAD_PRIO);
+
+  osThreadDef(start_lwip_echo_thread, start_lwip_echo_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+  osThreadCreate(osThread(start_lwip_echo_thread), NULL);
+
+  while (!dhcp_supplied_address(get_gnetif())) {
+    sys_msleep(10);
+  }
+  ip_addr_copy(dut_addr, get_gnetif()->ip_addr);
+  printf("bench setup dut=%s latency_us=%u jitter_us=%u loss_ppm=%u kbps=%u\n", ipaddr_ntoa(&dut_addr),
+         (unsigned)cfg.latency_us, (unsigned)cfg.jitter_us, (unsigned)cfg.loss_ppm, (unsigned)cfg.bandwidth_kbps);
+
+  if (selected(tests, "tcp_echo")) {
+    ok &= bench_tcp_echo(bytes);
+  }
+  if (selected(tests, "tcp_rtt")) {
+    ok &= bench_tcp_rtt(count);
+  }
+  if (selected(tests, "udp_rtt")) {
+    ok &= bench_udp_rtt(count);
+  }
+  if (selected(tests, "netsrv")) {
+    ok &= bench_netsrv(bytes, count);
+  }
+  if (selected(tests, "log_stream")) {
+    ok &= bench_log_stream(bytes);
+  }
+#if __LOG_BINARY__
+  if (selected(tests, "log_binary")) {
+    ok &= bench_log_binary();
+  }
+#endif /* __LOG_BINARY__ */
+  if (selected(tests, "httpd")) {
+    ok &= bench_httpd(count);
+  }
+  if (selected(tests, "httpd_stream")) {
+    ok &= bench_httpd_stream(bytes);
+  }
+  if (selected(tests, "api_call")) {
+    ok &= bench_api_call(count);
+  }
+  if (selected(tests, "pcb_demux")) {
+    ok &= bench_pcb_demux();
+  }
+  if (selected(tests, "arp_lookup")) {
+    ok &= bench_arp_lookup();
+  }
+  if (selected(tests, "napt")) {
+    ok &= bench_napt();
+  }
+  if (selected(tests, "linkmgr")) {
+    ok &= bench_linkmgr();
+  }
+  if (selected(tests, "replay")) {
+    ok &= (replay != NULL) && bench_replay(replay, speedup);
+  }
+  if (selected(tests, "chksum")) {
+    ok &= (lwip_chksum_bench() == 0);
+  }
+
+  vwire_capture_stop();
+  report_pools();
+#if LWIP_PERF
+  report_perf();
+#endif /* LWIP_PERF */
+  vwire_get_stats(&st);
+  printf("bench wire tx_frames=%u tx_bytes=%u lost=%u delivered=%u rx_drops=%u\n",
+         (unsigned)st.tx_frames, (unsigned)st.tx_bytes, (unsigned)st.lost,
+         (unsigned)st.delivered, (unsigned)st.rx_drops);
+
+  fflush(stdout);
+  _exit(ok ? 0 : 1);
+}
@@ -0,0 +1,59 @@
+/*
+ * Host implementation of the board services declared in main.h.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <string.h>
+
+#include "main.h"
+#include "app_telemetry.h"
+#include "systemUartInit.h"
+
+#if __LOG_BINARY__
+char board_uart_line[BOARD_UART_LINE];
+
+/* Where Library/myLib/systemlog.c writes its lines */
+void uart_write(const char * data, uint32_t len)
+{
+    fwrite(data, 1, len, stdout);
+    if (len >= sizeof(board_uart_line))
+    {
+        len = sizeof(board_uart_line) - 1;
+    }
+    memcpy(board_uart_line, data, len);
+    board_uart_line[len] = '\0';
+}
+#else
+/* Text mode of Library/myLib/systemlog.c, __PRINT_LOG__ has filtered the
+   level already */
+void printlog(int level, const char * funcname, int linenum, const char * format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    printf("In %s at %d line :", funcname, linenum);
+    vprintf(format, ap);
+    va_end(ap);
+}
+
+void printlog_init(void)
+{
+}
+#endif
+
+void HAL_Delay(uint32_t Delay)
+{
+    osDelay(Delay);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return osKernelSysTick();
+}
+
+/* User/app_telemetry.c reads FreeRTOS and the USB host: not on the host.
+   bench.c starts the httpd and registers its own streams. */
+void telemetry_init(void)
+{
+}
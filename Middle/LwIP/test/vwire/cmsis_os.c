@@ -0,0 +1,197 @@
+/*
+ * pthread implementation of the CMSIS-RTOS subset in cmsis_os.h.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "cmsis_os.h"
+
+struct os_thread_cb
+{
+  pthread_t        tid;
+  os_pthread       fn;
+  void            *arg;
+  pthread_mutex_t  lock;
+  pthread_cond_t   cond;
+  int32_t          signals;
+};
+
+static pthread_key_t os_self_key;
+static pthread_once_t os_self_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t os_critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static void os_self_init(void)
+{
+  pthread_key_create(&os_self_key, NULL);
+}
+
+static void *os_thread_main(void *arg)
+{
+  struct os_thread_cb *t = (struct os_thread_cb *)arg;
+
+  pthread_setspecific(os_self_key, t);
+  t->fn(t->arg);
+  return NULL;
+}
+
+osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument)
+{
+  struct os_thread_cb *t;
+  pthread_condattr_t attr;
+
+  pthread_once(&os_self_once, os_self_init);
+
+  t = (struct os_thread_cb *)calloc(1, sizeof(struct os_thread_cb));
+  if (t == NULL)
+  {
+    return NULL;
+  }
+  t->fn = thread_def->pthread;
+  t->arg = argument;
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&t->cond, &attr);
+  pthread_condattr_destroy(&attr);
+  if (pthread_create(&t->tid, NULL, os_thread_main, t) != 0)
+  {
+    free(t);
+    return NULL;
+  }
+  pthread_detach(t->tid);
+  return t;
+}
+
+osThreadId osThreadGetId(void)
+{
+  pthread_once(&os_self_once, os_self_init);
+  return (osThreadId)pthread_getspecific(os_self_key);
+}
+
+/* Only self-termination is carried out: the tests terminate other threads
+   solely after those have already ended themselves, and a thread control
+   block is never reused, so the handle stays valid for that call. */
+osStatus osThreadTerminate(osThreadId thread_id)
+{
+  if ((thread_id == NULL) || (thread_id == osThreadGetId()))
+  {
+    pthread_exit(NULL);
+  }
+  return osOK;
+}
+
+osStatus osThreadYield(void)
+{
+  sched_yield();
+  return osOK;
+}
+
+osStatus osDelay(uint32_t millisec)
+{
+  struct timespec ts;
+
+  ts.tv_sec = millisec / 1000;
+  ts.tv_nsec = (long)(millisec % 1000) * 1000000L;
+  while (nanosleep(&ts, &ts) != 0)
+  {
+  }
+  return osOK;
+}
+
+uint32_t osKernelSysTick(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000L);
+}
+
+/* The control block outlives its thread (see osThreadTerminate), so a
+   late signal is harmless */
+int32_t osSignalSet(osThreadId thread_id, int32_t signal)
+{
+  int32_t prev;
+
+  if (thread_id == NULL)
+  {
+    return (int32_t)0x80000000;
+  }
+  pthread_mutex_lock(&thread_id->lock);
+  prev = thread_id->signals;
+  thread_id->signals |= signal;
+  pthread_cond_signal(&thread_id->cond);
+  pthread_mutex_unlock(&thread_id->lock);
+  return prev;
+}
+
+/* Like the FreeRTOS port: returns on any flag and clears those in signals */
+osEvent osSignalWait(int32_t signals, uint32_t millisec)
+{
+  struct os_thread_cb *t = osThreadGetId();
+  struct timespec ts;
+  osEvent ret;
+
+  ret.value.signals = 0;
+  if (t == NULL)
+  {
+    ret.status = osErrorOS;
+    return ret;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  ts.tv_sec += millisec / 1000;
+  ts.tv_nsec += (long)(millisec % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L)
+  {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&t->lock);
+  while ((t->signals == 0) && (millisec != 0))
+  {
+    if (millisec == osWaitForever)
+    {
+      pthread_cond_wait(&t->cond, &t->lock);
+    }
+    else if (pthread_cond_timedwait(&t->cond, &t->lock, &ts) != 0)
+    {
+      break;
+    }
+  }
+  ret.value.signals = t->signals;
+  t->signals &= ~signals;
+  pthread_mutex_unlock(&t->lock);
+
+  if (ret.value.signals != 0)
+  {
+    ret.status = osEventSignal;
+  }
+  else
+  {
+    ret.status = (millisec == 0) ? osOK : osEventTimeout;
+  }
+  return ret;
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+  return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+  free(pv);
+}
+
+void vPortEnterCritical(void)
+{
+  pthread_mutex_lock(&os_critical);
+}
+
+void vPortExitCritical(void)
+{
+  pthread_mutex_unlock(&os_critical);
+}
@@ -0,0 +1,96 @@
+/*
+ * Subset of CMSIS-RTOS v1 (and the FreeRTOS heap calls) used by the User/
+ * network tests, implemented on pthreads so they build unmodified on a host.
+ */
+#ifndef LWIP_VWIRE_CMSIS_OS_H
+#define LWIP_VWIRE_CMSIS_OS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define osWaitForever             0xFFFFFFFFU
+
+#define configMINIMAL_STACK_SIZE  128
+#define configMAX_TASK_NAME_LEN   16
+
+typedef enum
+{
+  osPriorityIdle          = -3,
+  osPriorityLow           = -2,
+  osPriorityBelowNormal   = -1,
+  osPriorityNormal        =  0,
+  osPriorityAboveNormal   = +1,
+  osPriorityHigh          = +2,
+  osPriorityRealtime      = +3,
+  osPriorityError         =  0x84
+}osPriority;
+
+typedef enum
+{
+  osOK                    =     0,
+  osEventSignal           =  0x08,
+  osEventTimeout          =  0x40,
+  osErrorParameter        =  0x80,
+  osErrorResource         =  0x81,
+  osErrorOS               =  0xFF
+}osStatus;
+
+typedef struct
+{
+  osStatus                 status;
+  union
+  {
+    uint32_t               v;
+    void                  *p;
+    int32_t                signals;
+  } value;
+}osEvent;
+
+typedef void (*os_pthread) (void const *argument);
+
+typedef struct os_thread_def
+{
+  const char              *name;
+  os_pthread               pthread;
+  osPriority               tpriority;
+  uint32_t                 instances;
+  uint32_t                 stacksize;
+}osThreadDef_t;
+
+typedef struct os_thread_cb *osThreadId;
+
+#define osThreadDef(name, thread, priority, instances, stacksz)  \
+const osThreadDef_t os_thread_def_##name =                       \
+{ #name, (thread), (priority), (instances), (stacksz) }
+
+#define osThread(name)  &os_thread_def_##name
+
+osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument);
+osThreadId osThreadGetId(void);
+osStatus osThreadTerminate(osThreadId thread_id);
+osStatus osThreadYield(void);
+osStatus osDelay(uint32_t millisec);
+uint32_t osKernelSysTick(void);
+
+/* Signal flags, the task notifications of the FreeRTOS port */
+int32_t osSignalSet(osThreadId thread_id, int32_t signal);
+osEvent osSignalWait(int32_t signals, uint32_t millisec);
+
+void *pvPortMalloc(size_t xSize);
+void vPortFree(void *pv);
+
+/* One process-wide recursive lock in place of masking interrupts */
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+#define portENTER_CRITICAL()      vPortEnterCritical()
+#define portEXIT_CRITICAL()       vPortExitCritical()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_VWIRE_CMSIS_OS_H */
@@ -0,0 +1,182 @@
+/*
+ * Minimal DHCP server for the virtual wire: answers DISCOVER and REQUEST on
+ * one netif so that firmware code waiting for dhcp_supplied_address() runs
+ * unmodified. Each client hardware address gets its own lease, counting up
+ * from the first address given. Runs in the tcpip thread.
+ */
+#include <string.h>
+
+#include "lwip/opt.h"
+#include "lwip/ip_addr.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "lwip/prot/dhcp.h"
+#include "lwip/prot/ethernet.h"
+
+#include "dhcpd.h"
+#include "vwire.h"
+
+#define DHCPD_LEASE_TIME    3600
+#define DHCPD_MSG_MAX       576
+
+struct dhcpd_lease
+{
+  u8_t       chaddr[ETH_HWADDR_LEN];
+  ip4_addr_t addr;
+};
+
+static struct udp_pcb *dhcpd_pcb;
+static struct netif *dhcpd_netif;
+static ip4_addr_t dhcpd_first;
+static struct dhcpd_lease dhcpd_leases[VWIRE_MAX_PORTS];
+static int dhcpd_nleases;
+
+/* Returns the lease of a client, creating it on first sight */
+static const ip4_addr_t *dhcpd_lease_of(const u8_t *chaddr)
+{
+  int i;
+
+  for (i = 0; i < dhcpd_nleases; i++) {
+    if (memcmp(dhcpd_leases[i].chaddr, chaddr, ETH_HWADDR_LEN) == 0) {
+      return &dhcpd_leases[i].addr;
+    }
+  }
+  if (dhcpd_nleases == VWIRE_MAX_PORTS) {
+    return NULL;
+  }
+  memcpy(dhcpd_leases[i].chaddr, chaddr, ETH_HWADDR_LEN);
+  ip4_addr_set_u32(&dhcpd_leases[i].addr, lwip_htonl(lwip_ntohl(ip4_addr_get_u32(&dhcpd_first)) + (u32_t)i));
+  dhcpd_nleases++;
+  return &dhcpd_leases[i].addr;
+}
+
+/* Value of the message type option, 0 if absent */
+static u8_t dhcpd_msg_type(const u8_t *opt, u16_t len)
+{
+  u16_t i = 0;
+
+  while ((i < len) && (opt[i] != DHCP_OPTION_END)) {
+    if (opt[i] == DHCP_OPTION_PAD) {
+      i++;
+      continue;
+    }
+    if (i + 1 >= len) {
+      break;
+    }
+    if ((opt[i] == DHCP_OPTION_MESSAGE_TYPE) && (opt[i + 1] == 1) && (i + 2 < len)) {
+      return opt[i + 2];
+    }
+    i += 2 + opt[i + 1];
+  }
+  return 0;
+}
+
+static u8_t *dhcpd_opt(u8_t *opt, u8_t code, u8_t len, const void *val)
+{
+  opt[0] = code;
+  opt[1] = len;
+  memcpy(&opt[2], val, len);
+  return opt + 2 + len;
+}
+
+static void dhcpd_reply(const struct dhcp_msg *req, u8_t type, const ip4_addr_t *yiaddr)
+{
+  struct pbuf *q;
+  struct dhcp_msg *msg;
+  u8_t *opt;
+  u32_t lease = lwip_htonl(DHCPD_LEASE_TIME);
+
+  q = pbuf_alloc(PBUF_TRANSPORT, sizeof(struct dhcp_msg), PBUF_RAM);
+  if (q == NULL) {
+    return;
+  }
+  msg = (struct dhcp_msg *)q->payload;
+  memset(msg, 0, sizeof(struct dhcp_msg));
+
+  msg->op = DHCP_BOOTREPLY;
+  msg->htype = DHCP_HTYPE_ETH;
+  msg->hlen = ETH_HWADDR_LEN;
+  msg->xid = req->xid;
+  msg->flags = req->flags;
+  ip4_addr_copy(msg->yiaddr, *yiaddr);
+  ip4_addr_copy(msg->siaddr, *netif_ip4_addr(dhcpd_netif));
+  memcpy(msg->chaddr, req->chaddr, DHCP_CHADDR_LEN);
+  msg->cookie = PP_HTONL(DHCP_MAGIC_COOKIE);
+
+  opt = msg->options;
+  opt = dhcpd_opt(opt, DHCP_OPTION_MESSAGE_TYPE, 1, &type);
+  opt = dhcpd_opt(opt, DHCP_OPTION_SERVER_ID, 4, netif_ip4_addr(dhcpd_netif));
+  opt = dhcpd_opt(opt, DHCP_OPTION_LEASE_TIME, 4, &lease);
+  opt = dhcpd_opt(opt, DHCP_OPTION_SUBNET_MASK, 4, netif_ip4_netmask(dhcpd_netif));
+  opt = dhcpd_opt(opt, DHCP_OPTION_ROUTER, 4, netif_ip4_addr(dhcpd_netif));
+  *opt = DHCP_OPTION_END;
+
+  udp_sendto_if(dhcpd_pcb, q, IP_ADDR_BROADCAST, DHCP_CLIENT_PORT, dhcpd_netif);
+  pbuf_free(q);
+}
+
+static void dhcpd_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+  static u8_t buf[DHCPD_MSG_MAX];
+  const struct dhcp_msg *req = (const struct dhcp_msg *)buf;
+  const ip4_addr_t *yiaddr;
+  u16_t len;
+  u8_t type;
+
+  LWIP_UNUSED_ARG(arg);
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(addr);
+  LWIP_UNUSED_ARG(port);
+
+  if (ip_current_input_netif() != dhcpd_netif) {
+    pbuf_free(p);
+    return;
+  }
+
+  len = pbuf_copy_partial(p, buf, sizeof(buf), 0);
+  pbuf_free(p);
+  if ((len < DHCP_OPTIONS_OFS) || (req->op != DHCP_BOOTREQUEST) ||
+      (req->cookie != PP_HTONL(DHCP_MAGIC_COOKIE))) {
+    return;
+  }
+
+  yiaddr = dhcpd_lease_of(req->chaddr);
+  if (yiaddr == NULL) {
+    return;
+  }
+
+  type = dhcpd_msg_type(&buf[DHCP_OPTIONS_OFS], (u16_t)(len - DHCP_OPTIONS_OFS));
+  if (type == DHCP_DISCOVER) {
+    dhcpd_reply(req, DHCP_OFFER, yiaddr);
+  } else if (type == DHCP_REQUEST) {
+    dhcpd_reply(req, DHCP_ACK, yiaddr);
+  }
+}
+
+/**
+ * Starts serving leases on netif, the first one being first_lease.
+ * Must be called from the tcpip thread.
+ */
+err_t dhcpd_start(struct netif *netif, const ip4_addr_t *first_lease)
+{
+  err_t err;
+
+  dhcpd_netif = netif;
+  ip4_addr_copy(dhcpd_first, *first_lease);
+  dhcpd_nleases = 0;
+
+  dhcpd_pcb = udp_new();
+  if (dhcpd_pcb == NULL) {
+    return ERR_MEM;
+  }
+  ip_set_option(dhcpd_pcb, SOF_BROADCAST);
+  err = udp_bind(dhcpd_pcb, IP4_ADDR_ANY, DHCP_SERVER_PORT);
+  if (err != ERR_OK) {
+    udp_remove(dhcpd_pcb);
+    dhcpd_pcb = NULL;
+    return err;
+  }
+  udp_recv(dhcpd_pcb, dhcpd_recv, NULL);
+  return ERR_OK;
+}
@@ -0,0 +1,13 @@
+/*
+ * Minimal DHCP server for the virtual wire.
+ */
+#ifndef LWIP_VWIRE_DHCPD_H
+#define LWIP_VWIRE_DHCPD_H
+
+#include "lwip/err.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/netif.h"
+
+err_t dhcpd_start(struct netif *netif, const ip4_addr_t *first_lease);
+
+#endif /* LWIP_VWIRE_DHCPD_H */
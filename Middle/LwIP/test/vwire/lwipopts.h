@@ -0,0 +1,75 @@
+/*
+ * lwIP options for the virtual wire harness.
+ *
+ * The firmware configuration is used as is so that what is measured here is
+ * the stack that ships; only what the host cannot provide is overridden.
+ */
+#ifndef LWIP_VWIRE_LWIPOPTS_H
+#define LWIP_VWIRE_LWIPOPTS_H
+
+/* netsrv runs up to 32 clients against the connection server at once: a
+   raw PCB each on the PC side, a netconn each on the firmware side, which
+   serves NETSRV_CONN_MAX connections instead of 4. Each of them beyond the
+   firmware's holds up to TCP_WND of received frames and TCP_SND_BUF of
+   copied segments. */
+#define NETSRV_CONN_MAX                 32
+#define NETSRV_EXTRA                    (2 * NETSRV_CONN_MAX - 4)
+
+#include "../../src/include/lwip/lwipopts.h"
+
+/* Received frames are copied into the pbuf pool: give it as many buffers as
+   the target driver has for reception (ETH_RXBUFNB + ETHIF_RX_REFILL_NB) */
+#undef  PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE                  (12 + NETSRV_EXTRA * (TCP_WND/TCP_MSS + 1))
+
+/* The PC side's connections come out of the same pools: add what it uses
+   (DHCP server, log sink, benchmark clients) on top of the firmware sizes */
+#define LWIP_POOL_SMALL_NUM             (8 + 4 + NETSRV_EXTRA)
+#define LWIP_POOL_MEDIUM_NUM            (2 + 2)
+#define LWIP_POOL_LARGE_NUM             (4 + (1 + NETSRV_EXTRA) * TCP_SND_BUF/TCP_MSS)
+#undef  MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG                (8 + (2 + NETSRV_EXTRA) * TCP_SND_QUEUELEN)
+#undef  MEMP_NUM_NETCONN
+#define MEMP_NUM_NETCONN                (6 + 3 + NETSRV_CONN_MAX + TCP_DEFAULT_LISTEN_BACKLOG)
+#define MEMP_NUM_NETBUF                 (2 + 4)
+
+/* The frames of both ends go through the one tcpip mailbox, and the clients
+   of netsrv connect at once: make room for the PC side's, and for a window
+   and an ACK in flight on every connection, or the frames dropped there are
+   only sent again by the retransmission timer */
+#undef  TCPIP_MBOX_SIZE
+#define TCPIP_MBOX_SIZE                 (6 + NETSRV_EXTRA * (TCP_WND/TCP_MSS + 1))
+#define MEMP_NUM_TCPIP_MSG_INPKT        (8 + NETSRV_EXTRA * (TCP_WND/TCP_MSS + 1))
+/* ...and all of them may be waiting to be accepted, a netconn each */
+#undef  DEFAULT_ACCEPTMBOX_SIZE
+#define DEFAULT_ACCEPTMBOX_SIZE         NETSRV_CONN_MAX
+#undef  TCP_DEFAULT_LISTEN_BACKLOG
+#define TCP_DEFAULT_LISTEN_BACKLOG      NETSRV_CONN_MAX
+
+/* pcb_demux adds up to 64 connections and UDP PCBs (BENCH_DEMUX_MAX) */
+#undef  MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB                (10 + 64)
+#undef  MEMP_NUM_UDP_PCB
+#define MEMP_NUM_UDP_PCB                (6 + 64)
+
+/* arp_lookup measures the cache with up to 120 neighbours (BENCH_ARP_MAX) */
+#undef  ARP_TABLE_SIZE
+#define ARP_TABLE_SIZE                  128
+
+/* napt waits for an echo translation to expire */
+#undef  IP_NAPT_TMOT_ICMP
+#define IP_NAPT_TMOT_ICMP               1000
+
+/* No modem on the host: the LTE uplink is not built */
+#undef  PPP_SUPPORT
+#define PPP_SUPPORT                     0
+
+/* All instances share one stack: route by source address so that each one
+   only sends through its own port, after the link manager's hook
+   (linkmgr_route) has picked the uplink of a source or a pinned route. */
+#undef  LWIP_HOOK_FILENAME
+#undef  LWIP_HOOK_IP4_ROUTE_SRC
+#define LWIP_HOOK_FILENAME              "vwire.h"
+#define LWIP_HOOK_IP4_ROUTE_SRC(dest, src)  vwire_route(dest, src)
+
+#endif /* LWIP_VWIRE_LWIPOPTS_H */
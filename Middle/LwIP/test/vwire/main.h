@@ -0,0 +1,21 @@
+/*
+ * Host stand-in for User/main.h: the board services the User/ network tests
+ * use, without the STM32 HAL.
+ */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+
+/* Lines are printed where they are logged, no formatting task. make
+   LOGBIN=1 builds the binary mode of the firmware instead. */
+#ifndef __LOG_BINARY__
+#define __LOG_BINARY__ 0
+#endif
+#include "systemlog.h"
+#include "cmsis_os.h"
+
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+#endif /* __MAIN_H */
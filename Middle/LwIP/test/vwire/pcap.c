@@ -0,0 +1,147 @@
+/*
+ * Minimal libpcap file format reader and writer (LINKTYPE_ETHERNET).
+ */
+#include <string.h>
+
+#include "pcap.h"
+
+#define PCAP_MAGIC_US       0xa1b2c3d4U
+#define PCAP_MAGIC_NS       0xa1b23c4dU
+#define PCAP_LINKTYPE_ETH   1
+
+struct pcap_hdr
+{
+  uint32_t magic;
+  uint16_t version_major;
+  uint16_t version_minor;
+  int32_t  thiszone;
+  uint32_t sigfigs;
+  uint32_t snaplen;
+  uint32_t network;
+};
+
+struct pcap_rec
+{
+  uint32_t ts_sec;
+  uint32_t ts_frac;
+  uint32_t incl_len;
+  uint32_t orig_len;
+};
+
+static uint32_t pcap_swap32(uint32_t v)
+{
+  return ((v & 0xff) << 24) | ((v & 0xff00) << 8) | ((v >> 8) & 0xff00) | (v >> 24);
+}
+
+int pcap_create(struct pcap_file *pf, const char *path)
+{
+  struct pcap_hdr hdr;
+
+  memset(pf, 0, sizeof(*pf));
+  pf->fp = fopen(path, "wb");
+  if (pf->fp == NULL) {
+    return -1;
+  }
+
+  hdr.magic = PCAP_MAGIC_US;
+  hdr.version_major = 2;
+  hdr.version_minor = 4;
+  hdr.thiszone = 0;
+  hdr.sigfigs = 0;
+  hdr.snaplen = PCAP_SNAPLEN;
+  hdr.network = PCAP_LINKTYPE_ETH;
+  if (fwrite(&hdr, sizeof(hdr), 1, pf->fp) != 1) {
+    pcap_close(pf);
+    return -1;
+  }
+  return 0;
+}
+
+int pcap_write(struct pcap_file *pf, uint64_t ts_us, const void *frame, uint32_t len)
+{
+  struct pcap_rec rec;
+
+  rec.ts_sec = (uint32_t)(ts_us / 1000000U);
+  rec.ts_frac = (uint32_t)(ts_us % 1000000U);
+  rec.incl_len = len;
+  rec.orig_len = len;
+  if ((fwrite(&rec, sizeof(rec), 1, pf->fp) != 1) ||
+      (fwrite(frame, 1, len, pf->fp) != len)) {
+    return -1;
+  }
+  return 0;
+}
+
+int pcap_open(struct pcap_file *pf, const char *path)
+{
+  struct pcap_hdr hdr;
+  uint32_t network;
+
+  memset(pf, 0, sizeof(*pf));
+  pf->fp = fopen(path, "rb");
+  if (pf->fp == NULL) {
+    return -1;
+  }
+  if (fread(&hdr, sizeof(hdr), 1, pf->fp) != 1) {
+    pcap_close(pf);
+    return -1;
+  }
+
+  if ((hdr.magic == PCAP_MAGIC_US) || (hdr.magic == PCAP_MAGIC_NS)) {
+    pf->swapped = 0;
+  } else if ((pcap_swap32(hdr.magic) == PCAP_MAGIC_US) || (pcap_swap32(hdr.magic) == PCAP_MAGIC_NS)) {
+    pf->swapped = 1;
+    hdr.magic = pcap_swap32(hdr.magic);
+  } else {
+    pcap_close(pf);
+    return -1;
+  }
+  pf->nsec = (hdr.magic == PCAP_MAGIC_NS);
+
+  network = pf->swapped ? pcap_swap32(hdr.network) : hdr.network;
+  if (network != PCAP_LINKTYPE_ETH) {
+    pcap_close(pf);
+    return -1;
+  }
+  return 0;
+}
+
+/* Returns 1 with a frame, 0 at end of file, -1 on a malformed record.
+   Frames longer than size are truncated to it. */
+int pcap_read(struct pcap_file *pf, uint64_t *ts_us, void *frame, uint32_t size, uint32_t *len)
+{
+  struct pcap_rec rec;
+  uint32_t incl;
+
+  if (fread(&rec, sizeof(rec), 1, pf->fp) != 1) {
+    return 0;
+  }
+  if (pf->swapped) {
+    rec.ts_sec = pcap_swap32(rec.ts_sec);
+    rec.ts_frac = pcap_swap32(rec.ts_frac);
+    rec.incl_len = pcap_swap32(rec.incl_len);
+  }
+  if (rec.incl_len > PCAP_SNAPLEN) {
+    return -1;
+  }
+
+  incl = rec.incl_len;
+  *len = (incl < size) ? incl : size;
+  if (fread(frame, 1, *len, pf->fp) != *len) {
+    return -1;
+  }
+  if ((incl > *len) && (fseek(pf->fp, (long)(incl - *len), SEEK_CUR) != 0)) {
+    return -1;
+  }
+
+  *ts_us = (uint64_t)rec.ts_sec * 1000000U + (pf->nsec ? rec.ts_frac / 1000U : rec.ts_frac);
+  return 1;
+}
+
+void pcap_close(struct pcap_file *pf)
+{
+  if (pf->fp != NULL) {
+    fclose(pf->fp);
+    pf->fp = NULL;
+  }
+}
@@ -0,0 +1,25 @@
+/*
+ * Minimal libpcap file format reader and writer (LINKTYPE_ETHERNET).
+ */
+#ifndef LWIP_VWIRE_PCAP_H
+#define LWIP_VWIRE_PCAP_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define PCAP_SNAPLEN        65535
+
+struct pcap_file
+{
+  FILE     *fp;
+  int       swapped;        /* file written with the other byte order */
+  int       nsec;           /* timestamps in nanoseconds               */
+};
+
+int  pcap_create(struct pcap_file *pf, const char *path);
+int  pcap_write(struct pcap_file *pf, uint64_t ts_us, const void *frame, uint32_t len);
+int  pcap_open(struct pcap_file *pf, const char *path);
+int  pcap_read(struct pcap_file *pf, uint64_t *ts_us, void *frame, uint32_t size, uint32_t *len);
+void pcap_close(struct pcap_file *pf);
+
+#endif /* LWIP_VWIRE_PCAP_H */
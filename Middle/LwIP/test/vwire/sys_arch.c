@@ -0,0 +1,383 @@
+/*
+ * lwIP OS abstraction for the virtual wire harness, backed by pthreads.
+ *
+ * Semantics follow Middle/LwIP/system/OS/sys_arch.c: mailboxes are bounded
+ * queues of pointers, sys_arch_protect() is one recursive lock.
+ */
+#include <pthread.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/sys.h"
+
+struct sys_sem
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  unsigned int    count;
+};
+
+struct sys_mutex
+{
+  pthread_mutex_t lock;
+};
+
+struct sys_mbox
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  not_empty;
+  pthread_cond_t  not_full;
+  int             size;
+  int             head;
+  int             count;
+  void          **msgs;
+};
+
+struct sys_thread
+{
+  pthread_t       tid;
+  lwip_thread_fn  fn;
+  void           *arg;
+};
+
+static pthread_mutex_t sys_prot_lock;
+static struct timespec sys_start;
+
+/* Absolute CLOCK_MONOTONIC deadline timeout ms from now */
+static void sys_deadline(struct timespec *ts, u32_t timeout)
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+  ts->tv_sec += timeout / 1000;
+  ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+  if (ts->tv_nsec >= 1000000000L) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+static void sys_cond_init(pthread_cond_t *cond)
+{
+  pthread_condattr_t attr;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+/* Waits on cond until pred is true or timeout ms (0: forever) elapsed.
+   Returns the ms waited or SYS_ARCH_TIMEOUT. */
+#define SYS_COND_WAIT(cond, lock, pred, timeout, result)                  \
+  do {                                                                    \
+    u32_t start_ = sys_now();                                             \
+    struct timespec ts_;                                                  \
+    int rc_ = 0;                                                          \
+    if ((timeout) != 0) {                                                 \
+      sys_deadline(&ts_, (timeout));                                      \
+    }                                                                     \
+    while (!(pred) && (rc_ != ETIMEDOUT)) {                               \
+      if ((timeout) != 0) {                                               \
+        rc_ = pthread_cond_timedwait((cond), (lock), &ts_);               \
+      } else {                                                            \
+        pthread_cond_wait((cond), (lock));                                \
+      }                                                                   \
+    }                                                                     \
+    (result) = (pred) ? (sys_now() - start_) : SYS_ARCH_TIMEOUT;          \
+  } while (0)
+
+void sys_init(void)
+{
+  pthread_mutexattr_t attr;
+
+  clock_gettime(CLOCK_MONOTONIC, &sys_start);
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&sys_prot_lock, &attr);
+  pthread_mutexattr_destroy(&attr);
+#if LWIP_PERF
+  perf_init();
+#endif /* LWIP_PERF */
+}
+
+/* PERF_CLOCK of arch/cc.h: nanoseconds, wrapping every 4.3 s */
+uint32_t sys_perf_clock(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+
+u32_t sys_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u32_t)((ts.tv_sec - sys_start.tv_sec) * 1000 + (ts.tv_nsec - sys_start.tv_nsec) / 1000000L);
+}
+
+/*-------------------------------------------------------------------------*/
+err_t sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+  struct sys_mbox *mb = (struct sys_mbox *)calloc(1, sizeof(struct sys_mbox));
+
+  if (mb == NULL) {
+    return ERR_MEM;
+  }
+  mb->msgs = (void **)calloc((size_t)size, sizeof(void *));
+  if (mb->msgs == NULL) {
+    free(mb);
+    return ERR_MEM;
+  }
+  mb->size = size;
+  pthread_mutex_init(&mb->lock, NULL);
+  sys_cond_init(&mb->not_empty);
+  sys_cond_init(&mb->not_full);
+  *mbox = mb;
+  return ERR_OK;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+  struct sys_mbox *mb = *mbox;
+
+  pthread_mutex_destroy(&mb->lock);
+  pthread_cond_destroy(&mb->not_empty);
+  pthread_cond_destroy(&mb->not_full);
+  free(mb->msgs);
+  free(mb);
+}
+
+static void sys_mbox_put(struct sys_mbox *mb, void *msg)
+{
+  mb->msgs[(mb->head + mb->count) % mb->size] = msg;
+  mb->count++;
+  pthread_cond_signal(&mb->not_empty);
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+  struct sys_mbox *mb = *mbox;
+
+  pthread_mutex_lock(&mb->lock);
+  while (mb->count == mb->size) {
+    pthread_cond_wait(&mb->not_full, &mb->lock);
+  }
+  sys_mbox_put(mb, msg);
+  pthread_mutex_unlock(&mb->lock);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+  struct sys_mbox *mb = *mbox;
+  err_t err = ERR_MEM;
+
+  pthread_mutex_lock(&mb->lock);
+  if (mb->count < mb->size) {
+    sys_mbox_put(mb, msg);
+    err = ERR_OK;
+  }
+  pthread_mutex_unlock(&mb->lock);
+  return err;
+}
+
+static void *sys_mbox_get(struct sys_mbox *mb)
+{
+  void *msg = mb->msgs[mb->head];
+
+  mb->head = (mb->head + 1) % mb->size;
+  mb->count--;
+  pthread_cond_signal(&mb->not_full);
+  return msg;
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+  struct sys_mbox *mb = *mbox;
+  u32_t waited;
+  void *m;
+
+  pthread_mutex_lock(&mb->lock);
+  SYS_COND_WAIT(&mb->not_empty, &mb->lock, mb->count > 0, timeout, waited);
+  if (waited != SYS_ARCH_TIMEOUT) {
+    m = sys_mbox_get(mb);
+    if (msg != NULL) {
+      *msg = m;
+    }
+  } else if (msg != NULL) {
+    *msg = NULL;
+  }
+  pthread_mutex_unlock(&mb->lock);
+  return waited;
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+  struct sys_mbox *mb = *mbox;
+  u32_t ret = SYS_MBOX_EMPTY;
+  void *m;
+
+  pthread_mutex_lock(&mb->lock);
+  if (mb->count > 0) {
+    m = sys_mbox_get(mb);
+    if (msg != NULL) {
+      *msg = m;
+    }
+    ret = 0;
+  }
+  pthread_mutex_unlock(&mb->lock);
+  return ret;
+}
+
+int sys_mbox_valid(sys_mbox_t *mbox)
+{
+  return (*mbox != NULL);
+}
+
+void sys_mbox_set_invalid(sys_mbox_t *mbox)
+{
+  *mbox = NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+  struct sys_sem *s = (struct sys_sem *)calloc(1, sizeof(struct sys_sem));
+
+  if (s == NULL) {
+    return ERR_MEM;
+  }
+  pthread_mutex_init(&s->lock, NULL);
+  sys_cond_init(&s->cond);
+  s->count = count;
+  *sem = s;
+  return ERR_OK;
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+  struct sys_sem *s = *sem;
+  u32_t waited;
+
+  pthread_mutex_lock(&s->lock);
+  SYS_COND_WAIT(&s->cond, &s->lock, s->count > 0, timeout, waited);
+  if (waited != SYS_ARCH_TIMEOUT) {
+    s->count--;
+  }
+  pthread_mutex_unlock(&s->lock);
+  return waited;
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+  struct sys_sem *s = *sem;
+
+  pthread_mutex_lock(&s->lock);
+  s->count++;
+  pthread_cond_signal(&s->cond);
+  pthread_mutex_unlock(&s->lock);
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+  struct sys_sem *s = *sem;
+
+  pthread_mutex_destroy(&s->lock);
+  pthread_cond_destroy(&s->cond);
+  free(s);
+}
+
+int sys_sem_valid(sys_sem_t *sem)
+{
+  return (*sem != NULL);
+}
+
+void sys_sem_set_invalid(sys_sem_t *sem)
+{
+  *sem = NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+err_t sys_mutex_new(sys_mutex_t *mutex)
+{
+  struct sys_mutex *m = (struct sys_mutex *)calloc(1, sizeof(struct sys_mutex));
+
+  if (m == NULL) {
+    return ERR_MEM;
+  }
+  pthread_mutex_init(&m->lock, NULL);
+  *mutex = m;
+  return ERR_OK;
+}
+
+void sys_mutex_free(sys_mutex_t *mutex)
+{
+  pthread_mutex_destroy(&(*mutex)->lock);
+  free(*mutex);
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex)
+{
+  pthread_mutex_lock(&(*mutex)->lock);
+}
+
+void sys_mutex_unlock(sys_mutex_t *mutex)
+{
+  pthread_mutex_unlock(&(*mutex)->lock);
+}
+
+int sys_mutex_valid(sys_mutex_t *mutex)
+{
+  return (*mutex != NULL);
+}
+
+void sys_mutex_set_invalid(sys_mutex_t *mutex)
+{
+  *mutex = NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+static void *sys_thread_main(void *arg)
+{
+  struct sys_thread *t = (struct sys_thread *)arg;
+
+  t->fn(t->arg);
+  return NULL;
+}
+
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg, int stacksize, int prio)
+{
+  struct sys_thread *t = (struct sys_thread *)calloc(1, sizeof(struct sys_thread));
+
+  LWIP_UNUSED_ARG(name);
+  LWIP_UNUSED_ARG(stacksize);
+  LWIP_UNUSED_ARG(prio);
+
+  if (t == NULL) {
+    return NULL;
+  }
+  t->fn = thread;
+  t->arg = arg;
+  if (pthread_create(&t->tid, NULL, sys_thread_main, t) != 0) {
+    free(t);
+    return NULL;
+  }
+  pthread_detach(t->tid);
+  return t;
+}
+
+/*-------------------------------------------------------------------------*/
+sys_prot_t sys_arch_protect(void)
+{
+  pthread_mutex_lock(&sys_prot_lock);
+  return 1;
+}
+
+void sys_arch_unprotect(sys_prot_t pval)
+{
+  LWIP_UNUSED_ARG(pval);
+  pthread_mutex_unlock(&sys_prot_lock);
+}
@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for Library/myLib/systemMyLib.h: the board services of
+ * main.h instead of the STM32 HAL.
+ */
+#ifndef __SYS_MY_LIB_H__
+#define __SYS_MY_LIB_H__
+
+#include "main.h"
+
+#endif
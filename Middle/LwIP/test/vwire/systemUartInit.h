@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for Library/myLib/systemUartInit.h: what is written to the
+ * debug UART goes to stdout (board.c).
+ */
+#ifndef __SYS_UART_INIT__
+#define __SYS_UART_INIT__
+
+#include <stdint.h>
+
+#include "systemMyLib.h"
+
+/* The last line written, bench.c checks the log lines of the binary mode */
+#define BOARD_UART_LINE             256
+
+extern char board_uart_line[BOARD_UART_LINE];
+
+void uart_write(const char * data, uint32_t len);
+
+#endif
@@ -0,0 +1,399 @@
+/*
+ * Virtual wire: an in-process Ethernet segment standing in for the ETH MAC
+ * driver on a Linux host. See vwire.h.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lwip/opt.h"
+#include "lwip/etharp.h"
+#include "lwip/ethernetif.h"
+#include "lwip/pbuf.h"
+#include "netif/ethernet.h"
+
+#include "app_linkmgr.h"
+#include "pcap.h"
+#include "vwire.h"
+
+#define IFNAME0 'v'
+#define IFNAME1 'w'
+
+/* A frame in flight, kept in vw.head ordered by due time */
+struct vwire_frame
+{
+  struct vwire_frame *next;
+  uint64_t            due_us;
+  int                 src;
+  u16_t               len;
+  u8_t                data[];
+};
+
+struct vwire_port
+{
+  struct netif       *netif;
+  uint64_t            tx_free_us;   /* end of the frame being serialized */
+};
+
+static struct
+{
+  struct vwire_config cfg;
+  struct vwire_port   port[VWIRE_MAX_PORTS];
+  int                 nports;
+  struct vwire_frame *head;
+  pthread_mutex_t     lock;
+  pthread_cond_t      cond;
+  pthread_t           thread;
+  struct pcap_file    pcap;
+  int                 capturing;
+  struct vwire_stats  stats;
+  unsigned int        rnd;
+  vwire_attach_fn     attach;
+} vw;
+
+static uint64_t vwire_now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static uint64_t vwire_wall_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static int vwire_port_of(struct netif *netif)
+{
+  return (int)(intptr_t)netif->state - 1;
+}
+
+/* Hands a copy of the frame to one port, as its driver thread would */
+static void vwire_deliver_port(struct vwire_port *port, const struct vwire_frame *f)
+{
+  struct pbuf *p;
+  int ok = 0;
+
+  p = pbuf_alloc(PBUF_RAW, f->len, PBUF_POOL);
+  if (p != NULL) {
+    pbuf_take(p, f->data, f->len);
+    if (port->netif->input(p, port->netif) == ERR_OK) {
+      ok = 1;
+    } else {
+      pbuf_free(p);
+    }
+  }
+
+  pthread_mutex_lock(&vw.lock);
+  if (ok) {
+    vw.stats.delivered++;
+  } else {
+    vw.stats.rx_drops++;
+  }
+  pthread_mutex_unlock(&vw.lock);
+}
+
+static void vwire_deliver(const struct vwire_frame *f)
+{
+  int i;
+  int group = (f->data[0] & 0x01) != 0;
+
+  pthread_mutex_lock(&vw.lock);
+  if (vw.capturing) {
+    pcap_write(&vw.pcap, vwire_wall_us(), f->data, f->len);
+  }
+  pthread_mutex_unlock(&vw.lock);
+
+  for (i = 0; i < vw.nports; i++) {
+    struct vwire_port *port = &vw.port[i];
+    if ((i == f->src) || (port->netif == NULL)) {
+      continue;
+    }
+    if (group || (memcmp(f->data, port->netif->hwaddr, ETH_HWADDR_LEN) == 0)) {
+      vwire_deliver_port(port, f);
+    }
+  }
+}
+
+static void *vwire_thread(void *arg)
+{
+  struct vwire_frame *f;
+  struct timespec ts;
+  uint64_t now;
+
+  LWIP_UNUSED_ARG(arg);
+
+  pthread_mutex_lock(&vw.lock);
+  for (;;) {
+    if (vw.head == NULL) {
+      pthread_cond_wait(&vw.cond, &vw.lock);
+      continue;
+    }
+    now = vwire_now_us();
+    if (vw.head->due_us > now) {
+      ts.tv_sec = (time_t)(vw.head->due_us / 1000000U);
+      ts.tv_nsec = (long)(vw.head->due_us % 1000000U) * 1000L;
+      pthread_cond_timedwait(&vw.cond, &vw.lock, &ts);
+      continue;
+    }
+    f = vw.head;
+    vw.head = f->next;
+    pthread_mutex_unlock(&vw.lock);
+
+    vwire_deliver(f);
+    free(f);
+
+    pthread_mutex_lock(&vw.lock);
+  }
+  return NULL;
+}
+
+/* netif->linkoutput: puts the frame on the wire, called from the tcpip thread */
+static err_t vwire_output(struct netif *netif, struct pbuf *p)
+{
+  struct vwire_frame *f, **pos;
+  struct vwire_port *port;
+  uint64_t now, start;
+  int src = vwire_port_of(netif);
+
+  f = (struct vwire_frame *)malloc(sizeof(struct vwire_frame) + p->tot_len);
+  if (f == NULL) {
+    return ERR_MEM;
+  }
+  f->src = src;
+  f->len = p->tot_len;
+  pbuf_copy_partial(p, f->data, p->tot_len, 0);
+
+  pthread_mutex_lock(&vw.lock);
+  port = &vw.port[src];
+  vw.stats.tx_frames++;
+  vw.stats.tx_bytes += f->len;
+
+  /* Serialization: frames leave a port one after the other */
+  now = vwire_now_us();
+  start = (port->tx_free_us > now) ? port->tx_free_us : now;
+  if (vw.cfg.bandwidth_kbps != 0) {
+    start += ((uint64_t)f->len * 8U * 1000U) / vw.cfg.bandwidth_kbps;
+  }
+  port->tx_free_us = start;
+
+  /* A lost frame still occupied the sender's link */
+  if ((vw.cfg.loss_ppm != 0) && ((u32_t)(rand_r(&vw.rnd) % 1000000) < vw.cfg.loss_ppm)) {
+    vw.stats.lost++;
+    pthread_mutex_unlock(&vw.lock);
+    free(f);
+    return ERR_OK;
+  }
+
+  f->due_us = start + vw.cfg.latency_us;
+  if (vw.cfg.jitter_us != 0) {
+    f->due_us += (u32_t)rand_r(&vw.rnd) % (vw.cfg.jitter_us + 1);
+  }
+
+  for (pos = &vw.head; (*pos != NULL) && ((*pos)->due_us <= f->due_us); pos = &(*pos)->next) {
+  }
+  f->next = *pos;
+  *pos = f;
+  pthread_cond_signal(&vw.cond);
+  pthread_mutex_unlock(&vw.lock);
+
+  return ERR_OK;
+}
+
+int vwire_init(const struct vwire_config *cfg)
+{
+  pthread_condattr_t attr;
+
+  memset(&vw, 0, sizeof(vw));
+  vw.cfg = *cfg;
+  vw.rnd = cfg->seed;
+  pthread_mutex_init(&vw.lock, NULL);
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&vw.cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  if (pthread_create(&vw.thread, NULL, vwire_thread, NULL) != 0) {
+    return -1;
+  }
+  pthread_detach(vw.thread);
+  return 0;
+}
+
+void vwire_set_attach_hook(vwire_attach_fn fn)
+{
+  vw.attach = fn;
+}
+
+/* Records every frame delivered from now on */
+int vwire_capture(const char *path)
+{
+  int ret;
+
+  pthread_mutex_lock(&vw.lock);
+  ret = pcap_create(&vw.pcap, path);
+  vw.capturing = (ret == 0);
+  pthread_mutex_unlock(&vw.lock);
+  return ret;
+}
+
+void vwire_capture_stop(void)
+{
+  pthread_mutex_lock(&vw.lock);
+  if (vw.capturing) {
+    pcap_close(&vw.pcap);
+    vw.capturing = 0;
+  }
+  pthread_mutex_unlock(&vw.lock);
+}
+
+void vwire_get_stats(struct vwire_stats *stats)
+{
+  pthread_mutex_lock(&vw.lock);
+  *stats = vw.stats;
+  pthread_mutex_unlock(&vw.lock);
+}
+
+/**
+ * Attaches a netif to the next free port of the wire. Pass it to
+ * netif_add() like ethernetif_init().
+ */
+err_t vwire_netif_init(struct netif *netif)
+{
+  int idx;
+
+  pthread_mutex_lock(&vw.lock);
+  if (vw.nports == VWIRE_MAX_PORTS) {
+    pthread_mutex_unlock(&vw.lock);
+    return ERR_IF;
+  }
+  idx = vw.nports++;
+  vw.port[idx].netif = netif;
+  pthread_mutex_unlock(&vw.lock);
+
+#if LWIP_NETIF_HOSTNAME
+  netif->hostname = "lwip";
+#endif
+  netif->name[0] = IFNAME0;
+  netif->name[1] = IFNAME1;
+  netif->state = (void *)(intptr_t)(idx + 1);
+  netif->output = etharp_output;
+  netif->linkoutput = vwire_output;
+
+  /* Locally administered address, one per port */
+  netif->hwaddr_len = ETH_HWADDR_LEN;
+  netif->hwaddr[0] = 0x02;
+  netif->hwaddr[1] = 0x00;
+  netif->hwaddr[2] = 0x00;
+  netif->hwaddr[3] = 0x00;
+  netif->hwaddr[4] = 0x00;
+  netif->hwaddr[5] = (u8_t)(idx + 1);
+  netif->mtu = 1500;
+
+  /* The wire is always plugged in */
+  netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
+
+  if (vw.attach != NULL) {
+    vw.attach(netif, idx);
+  }
+  return ERR_OK;
+}
+
+/* The firmware tests call the ETH driver's init: give them a port instead */
+err_t ethernetif_init(struct netif *netif)
+{
+  return vwire_netif_init(netif);
+}
+
+/**
+ * Feeds the frames of a pcap file to a netif as if they came off the wire.
+ * With speedup 0 they are injected as fast as the tcpip thread takes them,
+ * otherwise spaced like in the capture, speedup times faster.
+ * Returns the number of frames injected, -1 if the file can't be read.
+ */
+int vwire_replay(const char *path, struct netif *netif, u32_t speedup)
+{
+  struct pcap_file pf;
+  static u8_t frame[PCAP_SNAPLEN];
+  uint64_t ts, first_ts = 0, start_us = 0, due;
+  uint32_t len;
+  struct pbuf *p;
+  int n = 0;
+  int rc;
+
+  if (pcap_open(&pf, path) != 0) {
+    return -1;
+  }
+
+  while ((rc = pcap_read(&pf, &ts, frame, sizeof(frame), &len)) == 1) {
+    if ((len < SIZEOF_ETH_HDR) || (len > 0xffff)) {
+      continue;
+    }
+    if (n == 0) {
+      first_ts = ts;
+      start_us = vwire_now_us();
+    }
+    if (speedup != 0) {
+      due = start_us + (ts - first_ts) / speedup;
+      while (vwire_now_us() < due) {
+        sched_yield();
+      }
+    }
+
+    /* Lossless: wait for the tcpip mailbox rather than drop */
+    for (;;) {
+      p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_POOL);
+      if (p != NULL) {
+        pbuf_take(p, frame, (u16_t)len);
+        if (netif->input(p, netif) == ERR_OK) {
+          break;
+        }
+        pbuf_free(p);
+      }
+      sched_yield();
+    }
+    n++;
+  }
+
+  pcap_close(&pf);
+  return (rc < 0) ? -1 : n;
+}
+
+/**
+ * LWIP_HOOK_IP4_ROUTE_SRC: the firmware's hook first, linkmgr_route() picks
+ * the uplink of a source address or of a pinned destination. Then, every
+ * instance on the wire is a netif of the same stack, so a packet must leave
+ * through the netif owning its source address, and a connection from an
+ * unbound pcb must not pick the netif that owns the destination.
+ */
+struct netif *vwire_route(const ip4_addr_t *dest, const ip4_addr_t *src)
+{
+  struct netif *netif;
+
+  netif = linkmgr_route(dest, src);
+  if ((netif != NULL) || (src == NULL)) {
+    return netif;
+  }
+
+  for (netif = netif_list; netif != NULL; netif = netif->next) {
+    if (!netif_is_up(netif) || !netif_is_link_up(netif) || ip4_addr_isany_val(*netif_ip4_addr(netif))) {
+      continue;
+    }
+    if (!ip4_addr_isany(src)) {
+      if (ip4_addr_cmp(src, netif_ip4_addr(netif))) {
+        return netif;
+      }
+    } else if (!ip4_addr_cmp(dest, netif_ip4_addr(netif)) &&
+               ip4_addr_netcmp(dest, netif_ip4_addr(netif), netif_ip4_netmask(netif))) {
+      return netif;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,60 @@
+/*
+ * Virtual wire: an in-process Ethernet segment standing in for the ETH MAC
+ * driver (Middle/LwIP/src/netif/ethernetif.c) on a Linux host.
+ *
+ * Every netif attached to the wire is a port. A frame sent on one port is
+ * delayed, possibly lost, paced to the configured bandwidth and delivered to
+ * the port owning its destination MAC, or to all other ports for broadcast
+ * and multicast.
+ */
+#ifndef LWIP_VWIRE_H
+#define LWIP_VWIRE_H
+
+#include "lwip/err.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VWIRE_MAX_PORTS     4
+
+/** Impairments applied to every frame */
+struct vwire_config
+{
+  u32_t latency_us;         /* one-way propagation delay                  */
+  u32_t jitter_us;          /* uniform extra delay in [0, jitter_us]      */
+  u32_t loss_ppm;           /* frames lost per million                    */
+  u32_t bandwidth_kbps;     /* serialization rate per port, 0: unlimited  */
+  u32_t seed;               /* seed of the loss and jitter generator      */
+};
+
+struct vwire_stats
+{
+  u32_t tx_frames;          /* frames sent by all ports                   */
+  u32_t tx_bytes;
+  u32_t lost;               /* frames dropped by loss_ppm                 */
+  u32_t delivered;          /* frames handed to a port's netif->input     */
+  u32_t rx_drops;           /* deliveries refused: no pbuf or input error */
+};
+
+/** Called when a port is attached, from the netif init function */
+typedef void (*vwire_attach_fn)(struct netif *netif, int port);
+
+int   vwire_init(const struct vwire_config *cfg);
+void  vwire_set_attach_hook(vwire_attach_fn fn);
+int   vwire_capture(const char *path);
+void  vwire_capture_stop(void);
+err_t vwire_netif_init(struct netif *netif);
+void  vwire_get_stats(struct vwire_stats *stats);
+int   vwire_replay(const char *path, struct netif *netif, u32_t speedup);
+
+struct netif *vwire_route(const ip4_addr_t *dest, const ip4_addr_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_VWIRE_H */
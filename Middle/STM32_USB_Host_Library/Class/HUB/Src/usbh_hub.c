@@ -347,45 +347,49 @@ USBH_StatusTypeDef USBH_HUB_InterfaceDeInit (USBH_HandleTypeDef *phost)
 {
 	HUB_HandleTypeDef *HUB_Handle =	(HUB_HandleTypeDef*) phost->pClassData[0]; 
 	//HUB_HandleTypeDef *HUB_Handle =  (HUB_HandleTypeDef*) phost->pActiveClass->pData;
+	USBH_HandleTypeDef *child;
 	int idx;
 
 	for(idx = 0; idx < USBH_MAX_NUM_CHILD; ++idx)
 	{
 		if(phost->children[idx])
 		{
+			/* A transfer still running on it ends */
+			phost->children[idx]->device.is_connected = 0;
 			phost->children[idx]->pUser(phost->children[idx], HOST_USER_DISCONNECTION); 
 		}	
 	}
 
 	for(idx = 0; idx < USBH_MAX_NUM_CHILD; ++idx)
 	{
-		if(phost->children[idx])
+		/* Off the port first, so that nobody looks it up while it is freed
+		   (see USBH_MSC_Pin) */
+		child = phost->children[idx];
+		phost->children[idx] = NULL;
+		
+		if(child)
 		{
 			//__PRINT_LOG__(__CRITICAL_LEVEL__, "DeInit: %d\r\n", idx);
-			phost->children[idx]->pActiveClass->DeInit(phost->children[idx]); 
-			phost->children[idx]->pActiveClass = NULL;
-		}	
-	}
-
-	for(idx = 0; idx < USBH_MAX_NUM_CHILD; ++idx)
-	{
-		if(phost->children[idx])
-		{
-			if(0xff != phost->children[idx]->Control.pipe_in)
+			if(child->pActiveClass != NULL)
+			{
+				child->pActiveClass->DeInit(child); 
+				child->pActiveClass = NULL;
+			}
+			
+			if(0xff != child->Control.pipe_in)
 			{
-				USBH_ClosePipe(phost->children[idx], phost->children[idx]->Control.pipe_in);
-			    USBH_FreePipe(phost->children[idx], phost->children[idx]->Control.pipe_in);
+				USBH_ClosePipe(child, child->Control.pipe_in);
+			    USBH_FreePipe(child, child->Control.pipe_in);
 			}
 			
-			if(0xff != phost->children[idx]->Control.pipe_out)
+			if(0xff != child->Control.pipe_out)
 			{
-				USBH_ClosePipe(phost->children[idx], phost->children[idx]->Control.pipe_out);
-			    USBH_FreePipe(phost->children[idx], phost->children[idx]->Control.pipe_out);
+				USBH_ClosePipe(child, child->Control.pipe_out);
+			    USBH_FreePipe(child, child->Control.pipe_out);
 			}
 		
 			//__PRINT_LOG__(__CRITICAL_LEVEL__, "Free: %d\r\n", idx);
-			USBH_free (phost->children[idx]);
-			phost->children[idx] = NULL;
+			USBH_free (child);
 		}
 	}
   
@@ -772,29 +776,33 @@ RESET_PORT:
 							{
 								__PRINT_LOG__(__CRITICAL_LEVEL__, "port%d disabled!\r\n", port); 
 								if(NULL != phost->children[port - 1])
-								{																
-									USBH_LL_Disconnect(phost->children[port - 1]);
+								{
+									USBH_HandleTypeDef * child = phost->children[port - 1];
+
+									/* Off the port first, so that nobody looks it up
+									   while it is freed (see USBH_MSC_Pin) */
+									phost->children[port - 1] = NULL;
+									USBH_LL_Disconnect(child);
 		
-									if(phost->children[port - 1]->pActiveClass != NULL)
+									if(child->pActiveClass != NULL)
 									{
-										phost->children[port - 1]->pActiveClass->DeInit(phost->children[port - 1]); 
-										phost->children[port - 1]->pActiveClass = NULL;
+										child->pActiveClass->DeInit(child); 
+										child->pActiveClass = NULL;
 									}	  
 		
-									HUB_Child_DeInitStateMachine(phost->children[port - 1]);
+									HUB_Child_DeInitStateMachine(child);
 
-									if(0xff != phost->children[port - 1]->Control.pipe_in)
+									if(0xff != child->Control.pipe_in)
 									{
-										USBH_ClosePipe(phost->children[port - 1], phost->children[port - 1]->Control.pipe_in);
+										USBH_ClosePipe(child, child->Control.pipe_in);
 									}
 									
-									if(0xff != phost->children[port - 1]->Control.pipe_out)
+									if(0xff != child->Control.pipe_out)
 									{
-										USBH_ClosePipe(phost->children[port - 1], phost->children[port - 1]->Control.pipe_out);
+										USBH_ClosePipe(child, child->Control.pipe_out);
 									}							
 									
-									USBH_free(phost->children[port - 1]);
-									phost->children[port - 1] = NULL;
+									USBH_free(child);
 		
 									//osMessagePut(phost->os_event, USBH_PORT_EVENT, 0);
 									__PRINT_LOG__(__CRITICAL_LEVEL__, "port%d deattached!\r\n", port); 
@@ -92,7 +92,7 @@ typedef enum
 MSC_ReqStateTypeDef;
 
 #ifndef MAX_SUPPORTED_LUN       
-    #define MAX_SUPPORTED_LUN       2
+    #define MAX_SUPPORTED_LUN       4
 #endif
 
 
@@ -129,6 +129,10 @@ typedef struct _MSC_Process
   uint16_t             current_lun; 
   uint16_t             rw_lun;   
   uint32_t             timer;
+#if (USBH_USE_OS == 1)
+  osSemaphoreId        rw_sem;     /* held for a Read/Write, the BOT pipes are shared by the LUNs */
+#endif
+  volatile uint8_t     users;      /* USBH_MSC_Pin() holders, the handle is freed once they are gone */
 }
 MSC_HandleTypeDef; 
 
@@ -187,6 +191,12 @@ int8_t             USBH_MSC_GetMaxLUN (USBH_HandleTypeDef *phost);
 uint8_t            USBH_MSC_UnitIsReady (USBH_HandleTypeDef *phost, uint8_t lun);
 
 USBH_StatusTypeDef USBH_MSC_GetLUNInfo(USBH_HandleTypeDef *phost, uint8_t lun, MSC_LUNTypeDef *info);
+
+USBH_HandleTypeDef *USBH_MSC_GetDevice(USBH_HandleTypeDef *phost, uint8_t port);
+
+USBH_HandleTypeDef *USBH_MSC_Pin(USBH_HandleTypeDef *phost, uint8_t port);
+
+void               USBH_MSC_Unpin(USBH_HandleTypeDef *phost);
                                  
 USBH_StatusTypeDef USBH_MSC_Read(USBH_HandleTypeDef *phost,
                                      uint8_t lun,
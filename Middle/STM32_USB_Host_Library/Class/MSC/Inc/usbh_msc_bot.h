@@ -137,6 +137,7 @@ typedef struct
   BOT_CSWTypeDef             csw; 
   uint8_t                    Reserved2[3];  
   uint8_t                    *pbuf;
+  uint32_t                   xfer_len;    /* bytes requested by the URB in flight */
 } 
 BOT_HandleTypeDef;
 
@@ -166,6 +167,12 @@ BOT_HandleTypeDef;
 
 #define BOT_PAGE_LENGTH              512
 
+/* Packets moved by a single Data-In URB. The OTG_FS channel re-arms itself
+   after every packet until HCTSIZ.PKTCNT drains, and the LL driver caps the
+   count at 256. Data-Out stays one packet per URB: the non periodic Tx FIFO
+   only holds 384 bytes and the HCD has no NPTXFE refill path. */
+#define BOT_DATA_IN_MAX_PACKETS      256
+
 
 #define BOT_CBW_CB_LENGTH            16
 
@@ -77,6 +77,8 @@
 /** @defgroup USBH_MSC_CORE_Private_Defines
   * @{
   */ 
+/* How long a Read/Write waits for another LUN of the same device (ms) */
+#define MSC_ACQUIRE_TIMEOUT                             5000
 /**
   * @}
   */ 
@@ -113,6 +115,10 @@ static USBH_StatusTypeDef USBH_MSC_SOFProcess(USBH_HandleTypeDef *phost);
 
 static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_t lun);
 
+static USBH_StatusTypeDef USBH_MSC_Acquire(USBH_HandleTypeDef *phost, uint8_t lun, MSC_StateTypeDef state);
+
+static uint32_t USBH_MSC_Timer(USBH_HandleTypeDef *phost);
+
 USBH_ClassTypeDef  USBH_msc = 
 {
   "MSC",
@@ -168,8 +174,17 @@ static USBH_StatusTypeDef USBH_MSC_InterfaceInit (USBH_HandleTypeDef *phost)
   {
     USBH_SelectInterface (phost, interface);
     
-    phost->pActiveClass->pData = (MSC_HandleTypeDef *)USBH_malloc (sizeof(MSC_HandleTypeDef));
-    MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+    phost->pClassData[0] = (MSC_HandleTypeDef *)USBH_malloc (sizeof(MSC_HandleTypeDef));
+    MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+    if(MSC_Handle == NULL)
+    {
+      return USBH_FAIL;
+    }
+    MSC_Handle->users = 0;
+#if (USBH_USE_OS == 1)
+    osSemaphoreDef(MSC_RW);
+    MSC_Handle->rw_sem = osSemaphoreCreate(osSemaphore(MSC_RW), 1);
+#endif
     
     if(phost->device.CfgDesc.Itf_Desc[phost->device.current_interface].Ep_Desc[0].bEndpointAddress & 0x80)
     {
@@ -239,7 +254,29 @@ static USBH_StatusTypeDef USBH_MSC_InterfaceInit (USBH_HandleTypeDef *phost)
   */
 USBH_StatusTypeDef USBH_MSC_InterfaceDeInit (USBH_HandleTypeDef *phost)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+
+  if (MSC_Handle == NULL)
+  {
+    return USBH_OK;
+  }
+
+  /* A task that pinned the handle sees the disconnect in its Read/Write
+     and unpins it: the pipes and the handle stay until then. No new pin
+     is taken once it is off the host handle. */
+#if (USBH_USE_OS == 1)
+  osThreadSuspendAll();
+  while (MSC_Handle->users != 0)
+  {
+    osThreadResumeAll();
+    osDelay(1);
+    osThreadSuspendAll();
+  }
+  phost->pClassData[0] = NULL;
+  osThreadResumeAll();
+#else
+  phost->pClassData[0] = NULL;
+#endif
 
   if ( MSC_Handle->OutPipe)
   {
@@ -257,11 +294,13 @@ USBH_StatusTypeDef USBH_MSC_InterfaceDeInit (USBH_HandleTypeDef *phost)
 
   USBH_Free_One_Address(phost);
 
-  /*if(phost->pActiveClass->pData)
+#if (USBH_USE_OS == 1)
+  if (MSC_Handle->rw_sem != NULL)
   {
-    USBH_free (phost->pActiveClass->pData);
-    phost->pActiveClass->pData = 0;
-  }*/
+    osSemaphoreDelete(MSC_Handle->rw_sem);
+  }
+#endif
+  USBH_free (MSC_Handle);
   
   return USBH_OK;
 }
@@ -275,7 +314,7 @@ USBH_StatusTypeDef USBH_MSC_InterfaceDeInit (USBH_HandleTypeDef *phost)
   */
 static USBH_StatusTypeDef USBH_MSC_ClassRequest(USBH_HandleTypeDef *phost)
 {   
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;  
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];  
   USBH_StatusTypeDef status = USBH_BUSY;
   uint8_t i;
   
@@ -298,6 +337,12 @@ static USBH_StatusTypeDef USBH_MSC_ClassRequest(USBH_HandleTypeDef *phost)
     if(status == USBH_OK)
     {
       MSC_Handle->max_lun = (uint8_t )(MSC_Handle->max_lun) + 1;
+      
+      /* Multi-slot card readers report more LUNs than unit[] can hold */
+      if(MSC_Handle->max_lun > MAX_SUPPORTED_LUN)
+      {
+        MSC_Handle->max_lun = MAX_SUPPORTED_LUN;
+      }
       USBH_UsrLog ("Number of supported LUN: %lu", (int32_t)(MSC_Handle->max_lun));
       
       for(i = 0; i < MSC_Handle->max_lun; i++)
@@ -331,7 +376,7 @@ static USBH_StatusTypeDef USBH_MSC_ClassRequest(USBH_HandleTypeDef *phost)
   */
 static USBH_StatusTypeDef USBH_MSC_Process(USBH_HandleTypeDef *phost)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   USBH_StatusTypeDef error = USBH_BUSY ;
   USBH_StatusTypeDef scsi_status = USBH_BUSY ;  
   USBH_StatusTypeDef ready_status = USBH_BUSY ;
@@ -522,14 +567,16 @@ static USBH_StatusTypeDef USBH_MSC_SOFProcess(USBH_HandleTypeDef *phost)
 }
 /**
   * @brief  USBH_MSC_RdWrProcess 
-  *         The function is for managing state machine for MSC I/O Process
+  *         The function is for managing state machine for MSC I/O Process.
+  *         It runs in the task calling USBH_MSC_Read/Write, which polls it
+  *         until done: the host thread has no part in it, no class event.
   * @param  phost: Host handle
   * @param  lun: logical Unit Number
   * @retval USBH Status
   */
 static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_t lun)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   USBH_StatusTypeDef error = USBH_BUSY ;
   USBH_StatusTypeDef scsi_status = USBH_BUSY ;  
   
@@ -554,9 +601,6 @@ static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_
       MSC_Handle->unit[lun].state = MSC_UNRECOVERED_ERROR;
           error = USBH_FAIL;
     }
-#if (USBH_USE_OS == 1)
-    osMessagePut ( phost->os_event, USBH_CLASS_EVENT, 0);
-#endif   
     break;     
     
   case MSC_WRITE: 
@@ -576,9 +620,6 @@ static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_
       MSC_Handle->unit[lun].state = MSC_UNRECOVERED_ERROR;
           error = USBH_FAIL;
     }
-#if (USBH_USE_OS == 1)
-    osMessagePut ( phost->os_event, USBH_CLASS_EVENT, 0);
-#endif       
     break; 
   
   case MSC_REQUEST_SENSE:
@@ -603,9 +644,6 @@ static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_
       MSC_Handle->unit[lun].state = MSC_UNRECOVERED_ERROR;  
           error = USBH_FAIL;
     }
-#if (USBH_USE_OS == 1)
-    osMessagePut ( phost->os_event, USBH_CLASS_EVENT, 0);
-#endif       
     break;  
     
   default:
@@ -623,7 +661,7 @@ static USBH_StatusTypeDef USBH_MSC_RdWrProcess(USBH_HandleTypeDef *phost, uint8_
   */
 uint8_t  USBH_MSC_IsReady (USBH_HandleTypeDef *phost)
 {
-    MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;  
+    MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];  
     
   if(phost->gState == HOST_CLASS)
   {
@@ -643,7 +681,7 @@ uint8_t  USBH_MSC_IsReady (USBH_HandleTypeDef *phost)
   */
 int8_t  USBH_MSC_GetMaxLUN (USBH_HandleTypeDef *phost)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;    
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];    
   
   if ((phost->gState == HOST_CLASS) && (MSC_Handle->state == MSC_IDLE))
   {
@@ -661,7 +699,7 @@ int8_t  USBH_MSC_GetMaxLUN (USBH_HandleTypeDef *phost)
   */
 uint8_t  USBH_MSC_UnitIsReady (USBH_HandleTypeDef *phost, uint8_t lun)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;  
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];  
   
   if(phost->gState == HOST_CLASS)
   {
@@ -682,7 +720,7 @@ uint8_t  USBH_MSC_UnitIsReady (USBH_HandleTypeDef *phost, uint8_t lun)
   */
 USBH_StatusTypeDef USBH_MSC_GetLUNInfo(USBH_HandleTypeDef *phost, uint8_t lun, MSC_LUNTypeDef *info)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;    
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];    
   if(phost->gState == HOST_CLASS)
   {
     USBH_memcpy(info,&MSC_Handle->unit[lun], sizeof(MSC_LUNTypeDef));
@@ -694,9 +732,174 @@ USBH_StatusTypeDef USBH_MSC_GetLUNInfo(USBH_HandleTypeDef *phost, uint8_t lun, M
   }
 }
 
+/**
+  * @brief  USBH_MSC_Timer 
+  *         The function returns the frame counter of the root port. Only
+  *         the root handle is ticked by the SOF interrupt, hub children
+  *         read it through their parent.
+  * @param  phost: Host handle
+  * @retval Timer value
+  */
+static uint32_t USBH_MSC_Timer(USBH_HandleTypeDef *phost)
+{
+  while(phost->is_child && (phost->parent != NULL))
+  {
+    phost = phost->parent;
+  }
+  return phost->Timer;
+}
+
+/**
+  * @brief  USBH_MSC_Acquire 
+  *         The function claims the device for a Read/Write on a LUN. The
+  *         BOT pipes are shared by all LUNs of a device, so a second LUN
+  *         blocks on the semaphore of the device until it is released.
+  * @param  phost: Host handle
+  * @param  lun: logical Unit Number
+  * @param  state: MSC_READ or MSC_WRITE
+  * @retval USBH Status
+  */
+static USBH_StatusTypeDef USBH_MSC_Acquire(USBH_HandleTypeDef *phost, uint8_t lun, MSC_StateTypeDef state)
+{
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+  
+  if ((MSC_Handle == NULL) || (lun >= MSC_Handle->max_lun))
+  {
+    return USBH_FAIL;
+  }
+  
+#if (USBH_USE_OS == 1)
+  if ((MSC_Handle->rw_sem == NULL) || 
+      (osSemaphoreWait(MSC_Handle->rw_sem, MSC_ACQUIRE_TIMEOUT) != osOK))
+  {
+    return USBH_FAIL;
+  }
+#endif
+  
+  if ((phost->device.is_connected == 0) || 
+      (phost->gState != HOST_CLASS) || 
+      (MSC_Handle->state != MSC_IDLE) || 
+      (MSC_Handle->unit[lun].state != MSC_IDLE))
+  {
+#if (USBH_USE_OS == 1)
+    osSemaphoreRelease(MSC_Handle->rw_sem);
+#endif
+    return  USBH_FAIL;
+  }
+  
+  MSC_Handle->state = state;
+  MSC_Handle->unit[lun].state = state;
+  MSC_Handle->rw_lun = lun;
+  return USBH_OK;
+}
+
+/**
+  * @brief  USBH_MSC_Release 
+  *         The function ends a Read/Write claimed by USBH_MSC_Acquire. A
+  *         transfer abandoned on a timeout or a disconnect leaves the LUN
+  *         and the BOT command idle as well, for the next one to start
+  *         from scratch.
+  * @param  phost: Host handle
+  * @param  lun: logical Unit Number
+  * @retval None
+  */
+static void USBH_MSC_Release(USBH_HandleTypeDef *phost, uint8_t lun)
+{
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+  
+  if ((MSC_Handle->unit[lun].state == MSC_READ) || 
+      (MSC_Handle->unit[lun].state == MSC_WRITE) || 
+      (MSC_Handle->unit[lun].state == MSC_REQUEST_SENSE))
+  {
+    MSC_Handle->unit[lun].state = MSC_IDLE;
+    MSC_Handle->hbot.cmd_state = BOT_CMD_SEND;
+  }
+  MSC_Handle->state = MSC_IDLE;
+#if (USBH_USE_OS == 1)
+  osSemaphoreRelease(MSC_Handle->rw_sem);
+#endif
+}
+
+/**
+  * @brief  USBH_MSC_GetDevice 
+  *         The function returns the MSC handle on a port of the root hub,
+  *         valid until the device is unplugged (see USBH_MSC_Pin)
+  * @param  phost: Host handle of the root port
+  * @param  port: 0 for the device on the root port, 1..USBH_MAX_NUM_CHILD
+  *         for a device behind a hub attached to it
+  * @retval MSC device handle, NULL when no MSC device is ready on the port
+  */
+USBH_HandleTypeDef *USBH_MSC_GetDevice(USBH_HandleTypeDef *phost, uint8_t port)
+{
+  if(port > USBH_MAX_NUM_CHILD)
+  {
+    return NULL;
+  }
+  
+  if(port != 0)
+  {
+    phost = phost->children[port - 1];
+  }
+  
+  if((phost == NULL) ||
+     (phost->pActiveClass != USBH_MSC_CLASS) ||
+     (phost->pClassData[0] == NULL) ||
+     (USBH_MSC_IsReady(phost) == 0))
+  {
+    return NULL;
+  }
+  return phost;
+}
+
+/**
+  * @brief  USBH_MSC_Pin 
+  *         The function returns the MSC handle on a port of the root hub,
+  *         as USBH_MSC_GetDevice, and keeps it from being freed until
+  *         USBH_MSC_Unpin: a hub child handle goes away on unplug, a task
+  *         that may be preempted while using it has to pin it.
+  * @param  phost: Host handle of the root port
+  * @param  port: 0 for the device on the root port, 1..USBH_MAX_NUM_CHILD
+  *         for a device behind a hub attached to it
+  * @retval MSC device handle, NULL when no MSC device is ready on the port
+  */
+USBH_HandleTypeDef *USBH_MSC_Pin(USBH_HandleTypeDef *phost, uint8_t port)
+{
+#if (USBH_USE_OS == 1)
+  osThreadSuspendAll();
+#endif
+  phost = USBH_MSC_GetDevice(phost, port);
+  if(phost != NULL)
+  {
+    ((MSC_HandleTypeDef *) phost->pClassData[0])->users++;
+  }
+#if (USBH_USE_OS == 1)
+  osThreadResumeAll();
+#endif
+  return phost;
+}
+
+/**
+  * @brief  USBH_MSC_Unpin 
+  *         The function releases a handle returned by USBH_MSC_Pin, the
+  *         caller no longer uses it afterwards.
+  * @param  phost: MSC device handle
+  * @retval None
+  */
+void USBH_MSC_Unpin(USBH_HandleTypeDef *phost)
+{
+#if (USBH_USE_OS == 1)
+  osThreadSuspendAll();
+#endif
+  ((MSC_HandleTypeDef *) phost->pClassData[0])->users--;
+#if (USBH_USE_OS == 1)
+  osThreadResumeAll();
+#endif
+}
+
 /**
   * @brief  USBH_MSC_Read 
-  *         The function performs a Read operation 
+  *         The function performs a Read operation. A device behind a hub
+  *         has to be pinned meanwhile, see USBH_MSC_Pin.
   * @param  phost: Host handle
   * @param  lun: logical Unit Number
   * @param  address: sector address
@@ -711,40 +914,40 @@ USBH_StatusTypeDef USBH_MSC_Read(USBH_HandleTypeDef *phost,
                                      uint32_t length)
 {
   uint32_t timeout;
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;   
+  USBH_StatusTypeDef status;
   
-  if ((phost->device.is_connected == 0) || 
-      (phost->gState != HOST_CLASS) || 
-      (MSC_Handle->unit[lun].state != MSC_IDLE))
+  if(USBH_MSC_Acquire(phost, lun, MSC_READ) != USBH_OK)
   {
     return  USBH_FAIL;
   }
-  MSC_Handle->state = MSC_READ;
-  MSC_Handle->unit[lun].state = MSC_READ;
-  MSC_Handle->rw_lun = lun;
   USBH_MSC_SCSI_Read(phost,
                      lun,
                      address,
                      pbuf,
                      length);
   
-  timeout = phost->Timer;
+  timeout = USBH_MSC_Timer(phost);
   
-  while (USBH_MSC_RdWrProcess(phost, lun) == USBH_BUSY)
+  while ((status = USBH_MSC_RdWrProcess(phost, lun)) == USBH_BUSY)
   {
-    if(((phost->Timer - timeout) > (10000 * length)) || (phost->device.is_connected == 0))
+    if(((USBH_MSC_Timer(phost) - timeout) > (10000 * length)) || (phost->device.is_connected == 0))
     {
-      MSC_Handle->state = MSC_IDLE;
-      return USBH_FAIL;
+      status = USBH_FAIL;
+      break;
     }
+#if (USBH_USE_OS == 1)
+    /* Let an equal priority task drive a transfer on another device */
+    osThreadYield();
+#endif
   }
-  MSC_Handle->state = MSC_IDLE;
-  return USBH_OK;
+  USBH_MSC_Release(phost, lun);
+  return status;
 }
 
 /**
   * @brief  USBH_MSC_Write 
-  *         The function performs a Write operation 
+  *         The function performs a Write operation. A device behind a hub
+  *         has to be pinned meanwhile, see USBH_MSC_Pin.
   * @param  phost: Host handle
   * @param  lun: logical Unit Number
   * @param  address: sector address
@@ -759,34 +962,34 @@ USBH_StatusTypeDef USBH_MSC_Write(USBH_HandleTypeDef *phost,
                                      uint32_t length)
 {
   uint32_t timeout;
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;   
+  USBH_StatusTypeDef status;
   
-  if ((phost->device.is_connected == 0) || 
-      (phost->gState != HOST_CLASS) || 
-      (MSC_Handle->unit[lun].state != MSC_IDLE))
+  if(USBH_MSC_Acquire(phost, lun, MSC_WRITE) != USBH_OK)
   {
     return  USBH_FAIL;
   }
-  MSC_Handle->state = MSC_WRITE;
-  MSC_Handle->unit[lun].state = MSC_WRITE;
-  MSC_Handle->rw_lun = lun;
   USBH_MSC_SCSI_Write(phost,
                      lun,
                      address,
                      pbuf,
                      length);
   
-  timeout = phost->Timer;
-  while (USBH_MSC_RdWrProcess(phost, lun) == USBH_BUSY)
+  timeout = USBH_MSC_Timer(phost);
+  
+  while ((status = USBH_MSC_RdWrProcess(phost, lun)) == USBH_BUSY)
   {
-    if(((phost->Timer - timeout) >  (10000 * length)) || (phost->device.is_connected == 0))
+    if(((USBH_MSC_Timer(phost) - timeout) > (10000 * length)) || (phost->device.is_connected == 0))
     {
-      MSC_Handle->state = MSC_IDLE;
-      return USBH_FAIL;
+      status = USBH_FAIL;
+      break;
     }
+#if (USBH_USE_OS == 1)
+    /* Let an equal priority task drive a transfer on another device */
+    osThreadYield();
+#endif
   }
-  MSC_Handle->state = MSC_IDLE;
-  return USBH_OK;
+  USBH_MSC_Release(phost, lun);
+  return status;
 }
 
 /**
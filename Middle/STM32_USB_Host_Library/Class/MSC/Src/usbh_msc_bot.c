@@ -88,6 +88,9 @@
 */ 
 static USBH_StatusTypeDef USBH_MSC_BOT_Abort(USBH_HandleTypeDef *phost, uint8_t lun, uint8_t dir);
 static BOT_CSWStatusTypeDef USBH_MSC_DecodeCSW(USBH_HandleTypeDef *phost);
+static void USBH_MSC_BOT_DataIn(USBH_HandleTypeDef *phost);
+static void USBH_MSC_BOT_DataOut(USBH_HandleTypeDef *phost);
+static void USBH_MSC_BOT_ReceiveCSW(USBH_HandleTypeDef *phost);
 /**
 * @}
 */ 
@@ -156,7 +159,7 @@ USBH_StatusTypeDef USBH_MSC_BOT_REQ_GetMaxLUN(USBH_HandleTypeDef *phost, uint8_t
 USBH_StatusTypeDef USBH_MSC_BOT_Init(USBH_HandleTypeDef *phost)
 {
   
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   
   MSC_Handle->hbot.cbw.field.Signature = BOT_CBW_SIGNATURE;
   MSC_Handle->hbot.cbw.field.Tag = BOT_CBW_TAG;
@@ -181,8 +184,9 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
   USBH_StatusTypeDef   error  = USBH_BUSY;  
   BOT_CSWStatusTypeDef CSW_Status = BOT_CSW_CMD_FAILED;
   USBH_URBStateTypeDef URB_Status = USBH_URB_IDLE;
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   uint8_t toggle = 0;
+  uint32_t xfer_size = 0;
   
   switch (MSC_Handle->hbot.state)
   {
@@ -203,29 +207,27 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     
     if(URB_Status == USBH_URB_DONE)
     { 
+      /* Start the next phase from here: its URB completion wakes the host
+         thread, so no extra event is needed between the phases */
       if ( MSC_Handle->hbot.cbw.field.DataTransferLength != 0 )
       {
         /* If there is Data Transfer Stage */
         if (((MSC_Handle->hbot.cbw.field.Flags) & USB_REQ_DIR_MASK) == USB_D2H)
         {
           /* Data Direction is IN */
-          MSC_Handle->hbot.state = BOT_DATA_IN;
+          USBH_MSC_BOT_DataIn(phost);
         }
         else
         {
           /* Data Direction is OUT */
-          MSC_Handle->hbot.state = BOT_DATA_OUT;
+          USBH_MSC_BOT_DataOut(phost);
         } 
       }
       
       else
       {/* If there is NO Data Transfer Stage */
-        MSC_Handle->hbot.state = BOT_RECEIVE_CSW;
+        USBH_MSC_BOT_ReceiveCSW(phost);
       }
-#if (USBH_USE_OS == 1)
-    osMessagePut ( phost->os_event, USBH_URB_EVENT, 0);
-#endif   
-    
     }   
     else if(URB_Status == USBH_URB_NOTREADY)
     {
@@ -245,14 +247,7 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     break;
     
   case BOT_DATA_IN:   
-    /* Send first packet */        
-    USBH_BulkReceiveData (phost,
-                          MSC_Handle->hbot.pbuf, 
-                          MSC_Handle->InEpSize , 
-                          MSC_Handle->InPipe);
-    
-    MSC_Handle->hbot.state  = BOT_DATA_IN_WAIT;
-    
+    USBH_MSC_BOT_DataIn(phost);
     break;   
     
   case BOT_DATA_IN_WAIT:  
@@ -261,34 +256,27 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     
     if(URB_Status == USBH_URB_DONE) 
     {
-      /* Adjust Data pointer and data length */
-      if(MSC_Handle->hbot.cbw.field.DataTransferLength > MSC_Handle->InEpSize)
-      {
-          MSC_Handle->hbot.pbuf += MSC_Handle->InEpSize;
-          MSC_Handle->hbot.cbw.field.DataTransferLength -= MSC_Handle->InEpSize;  
-      }
-      else
+      /* Adjust Data pointer and data length by what actually arrived */
+      xfer_size = USBH_LL_GetLastXferSize(phost, MSC_Handle->InPipe);
+      
+      if(xfer_size > MSC_Handle->hbot.cbw.field.DataTransferLength)
       {
-        MSC_Handle->hbot.cbw.field.DataTransferLength = 0;
+        xfer_size = MSC_Handle->hbot.cbw.field.DataTransferLength;
       }
+      MSC_Handle->hbot.pbuf += xfer_size;
+      MSC_Handle->hbot.cbw.field.DataTransferLength -= xfer_size;
         
-      /* More Data To be Received */
-      if(MSC_Handle->hbot.cbw.field.DataTransferLength > 0)
+      /* More Data To be Received, unless the device ended the phase with a
+         short packet: the residue is then reported in the CSW */
+      if((MSC_Handle->hbot.cbw.field.DataTransferLength > 0) &&
+         (xfer_size == MSC_Handle->hbot.xfer_len))
       {
-        /* Send next packet */        
-        USBH_BulkReceiveData (phost,
-                              MSC_Handle->hbot.pbuf, 
-                              MSC_Handle->InEpSize , 
-                              MSC_Handle->InPipe);
-        
+        USBH_MSC_BOT_DataIn(phost);
       }
       else
       {
-        /* If value was 0, and successful transfer, then change the state */
-        MSC_Handle->hbot.state  = BOT_RECEIVE_CSW;
-#if (USBH_USE_OS == 1)
-        osMessagePut ( phost->os_event, USBH_URB_EVENT, 0);
-#endif 
+        /* Last data packet is in, arm the CSW right away */
+        USBH_MSC_BOT_ReceiveCSW(phost);
       }
     }
     else if(URB_Status == USBH_URB_STALL)
@@ -310,15 +298,7 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     break;  
     
   case BOT_DATA_OUT:
-    
-    USBH_BulkSendData (phost,
-                       MSC_Handle->hbot.pbuf, 
-                       MSC_Handle->OutEpSize , 
-                       MSC_Handle->OutPipe,
-                       1);
-    
-    
-    MSC_Handle->hbot.state  = BOT_DATA_OUT_WAIT;
+    USBH_MSC_BOT_DataOut(phost);
     break;
     
   case BOT_DATA_OUT_WAIT:
@@ -327,33 +307,19 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     if(URB_Status == USBH_URB_DONE)
     {
       /* Adjust Data pointer and data length */
-      if(MSC_Handle->hbot.cbw.field.DataTransferLength > MSC_Handle->OutEpSize)
-      {
-          MSC_Handle->hbot.pbuf += MSC_Handle->OutEpSize;
-          MSC_Handle->hbot.cbw.field.DataTransferLength -= MSC_Handle->OutEpSize; 
-      }
-      else
-      {
-        MSC_Handle->hbot.cbw.field.DataTransferLength = 0;
-      } 
+      MSC_Handle->hbot.pbuf += MSC_Handle->hbot.xfer_len;
+      MSC_Handle->hbot.cbw.field.DataTransferLength -= MSC_Handle->hbot.xfer_len; 
       
       /* More Data To be Sent */
       if(MSC_Handle->hbot.cbw.field.DataTransferLength > 0)
       {
-        USBH_BulkSendData (phost,
-                           MSC_Handle->hbot.pbuf, 
-                           MSC_Handle->OutEpSize , 
-                           MSC_Handle->OutPipe,
-                           1);
+        USBH_MSC_BOT_DataOut(phost);
       }
       else
       {
-        /* If value was 0, and successful transfer, then change the state */
-        MSC_Handle->hbot.state  = BOT_RECEIVE_CSW;
+        /* Last data packet is out, arm the CSW right away */
+        USBH_MSC_BOT_ReceiveCSW(phost);
       }  
-#if (USBH_USE_OS == 1)
-    osMessagePut ( phost->os_event, USBH_URB_EVENT, 0);
-#endif       
     }
     
     else if(URB_Status == USBH_URB_NOTREADY)
@@ -382,13 +348,7 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
     break;
     
   case BOT_RECEIVE_CSW:
-    
-    USBH_BulkReceiveData (phost,
-                          MSC_Handle->hbot.csw.data, 
-                          BOT_CSW_LENGTH , 
-                          MSC_Handle->InPipe);
-    
-    MSC_Handle->hbot.state  = BOT_RECEIVE_CSW_WAIT;
+    USBH_MSC_BOT_ReceiveCSW(phost);
     break;
     
   case BOT_RECEIVE_CSW_WAIT:
@@ -410,9 +370,8 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
       {
         status = USBH_FAIL;
       }
-#if (USBH_USE_OS == 1)
-      osMessagePut ( phost->os_event, USBH_URB_EVENT, 0);
-#endif       
+      /* The SCSI layer stages the next CBW on its very next call, which
+         sends it from BOT_SEND_CBW without waiting for another event */
     }
     else if(URB_Status == USBH_URB_STALL)     
     {
@@ -469,6 +428,75 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
   return status;
 }
 
+/**
+  * @brief  USBH_MSC_BOT_DataIn 
+  *         The function submits the next Data-In URB. Up to
+  *         BOT_DATA_IN_MAX_PACKETS packets are moved by the channel before
+  *         the host thread sees the completion.
+  * @param  phost: Host handle
+  * @retval None
+  */
+static void USBH_MSC_BOT_DataIn(USBH_HandleTypeDef *phost)
+{
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+  uint32_t burst = (uint32_t)MSC_Handle->InEpSize * BOT_DATA_IN_MAX_PACKETS;
+  
+  MSC_Handle->hbot.xfer_len = MSC_Handle->hbot.cbw.field.DataTransferLength;
+  
+  if(MSC_Handle->hbot.xfer_len > burst)
+  {
+    MSC_Handle->hbot.xfer_len = burst;
+  }
+  
+  MSC_Handle->hbot.state = BOT_DATA_IN_WAIT;
+  USBH_BulkReceiveData (phost,
+                        MSC_Handle->hbot.pbuf, 
+                        (uint16_t)MSC_Handle->hbot.xfer_len, 
+                        MSC_Handle->InPipe);
+}
+
+/**
+  * @brief  USBH_MSC_BOT_DataOut 
+  *         The function submits the next Data-Out packet.
+  * @param  phost: Host handle
+  * @retval None
+  */
+static void USBH_MSC_BOT_DataOut(USBH_HandleTypeDef *phost)
+{
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+  
+  MSC_Handle->hbot.xfer_len = MSC_Handle->hbot.cbw.field.DataTransferLength;
+  
+  if(MSC_Handle->hbot.xfer_len > MSC_Handle->OutEpSize)
+  {
+    MSC_Handle->hbot.xfer_len = MSC_Handle->OutEpSize;
+  }
+  
+  MSC_Handle->hbot.state = BOT_DATA_OUT_WAIT;
+  USBH_BulkSendData (phost,
+                     MSC_Handle->hbot.pbuf, 
+                     (uint16_t)MSC_Handle->hbot.xfer_len, 
+                     MSC_Handle->OutPipe,
+                     1);
+}
+
+/**
+  * @brief  USBH_MSC_BOT_ReceiveCSW 
+  *         The function arms the Bulk-In pipe for the CSW.
+  * @param  phost: Host handle
+  * @retval None
+  */
+static void USBH_MSC_BOT_ReceiveCSW(USBH_HandleTypeDef *phost)
+{
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
+  
+  MSC_Handle->hbot.state = BOT_RECEIVE_CSW_WAIT;
+  USBH_BulkReceiveData (phost,
+                        MSC_Handle->hbot.csw.data, 
+                        BOT_CSW_LENGTH , 
+                        MSC_Handle->InPipe);
+}
+
 /**
   * @brief  USBH_MSC_BOT_Abort 
   *         The function handle the BOT Abort process.
@@ -480,7 +508,7 @@ USBH_StatusTypeDef USBH_MSC_BOT_Process (USBH_HandleTypeDef *phost, uint8_t lun)
 static USBH_StatusTypeDef USBH_MSC_BOT_Abort(USBH_HandleTypeDef *phost, uint8_t lun, uint8_t dir)
 {
   USBH_StatusTypeDef status = USBH_FAIL;
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   
   switch (dir)
   {
@@ -518,7 +546,7 @@ static USBH_StatusTypeDef USBH_MSC_BOT_Abort(USBH_HandleTypeDef *phost, uint8_t
 
 static BOT_CSWStatusTypeDef USBH_MSC_DecodeCSW(USBH_HandleTypeDef *phost)
 {
-  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pActiveClass->pData;
+  MSC_HandleTypeDef *MSC_Handle =  (MSC_HandleTypeDef *) phost->pClassData[0];
   BOT_CSWStatusTypeDef status = BOT_CSW_CMD_FAILED;
   
     /*Checking if the transfer length is different than 13*/    
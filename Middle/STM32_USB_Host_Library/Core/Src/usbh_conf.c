@@ -348,9 +348,22 @@ USBH_StatusTypeDef USBH_LL_SubmitURB(USBH_HandleTypeDef * phost,
                                      uint8_t * pbuff,
                                      uint16_t length, uint8_t do_ping)
 {
+#if (USBH_USE_OS == 1)
+  /* Class drivers of different devices submit from their own tasks, and the
+     host thread polls the hub at the same time. The channel registers are
+     per pipe but the non periodic Tx FIFO is shared: USB_WritePacket()
+     pushes a packet word by word into it, and a task preempted halfway
+     would have another task's packet interleaved with its own. The HCD
+     interrupt must not see the hc[] entry of the pipe half written
+     either, it re-arms the channel from it on a NAK. */
+  taskENTER_CRITICAL();
+#endif
   HAL_HCD_HC_SubmitRequest(phost->pData,
                            pipe,
                            direction, ep_type, token, pbuff, length, do_ping);
+#if (USBH_USE_OS == 1)
+  taskEXIT_CRITICAL();
+#endif
   return USBH_OK;
 }
 
@@ -5,6 +5,11 @@
 #include "usbh_ec20.h"
 
 #include "app_ec20.h"
+#if PPP_SUPPORT
+#include "lwip/tcpip.h"
+#include "systemRing.h"
+#include "app_linkmgr.h"
+#endif
 
 //#define __EC20_DEBUG__
 
@@ -18,11 +23,28 @@
 #define _CMD_QUERY_PS_			"AT+CGREG?"
 #define _CMD_CONFIG_PDP_		"AT+QICSGP=1"
 #define _CMD_ACTIVATE_PDP_		"AT+QIACT=1"
+#define _CMD_DIAL_				"ATD*99#"
 #define _CMD_RUNNING_			"AT+QPING=1,\"www.baidu.com\""
 
 #define MAX_TIME_OUT			(30 * 1000)
 #define MAX_TIME_OUT_NUM		(5)
 
+#if PPP_SUPPORT
+#define EC20_THREAD_STACK		(4 * configMINIMAL_STACK_SIZE)	//PPP is connected and closed from it
+#else
+#define EC20_THREAD_STACK		(2 * configMINIMAL_STACK_SIZE)
+#endif
+
+#if PPP_SUPPORT
+#define EC20_TX_SIGNAL			0x0002					//next to RING_SIGNAL
+#define EC20_PPP_TX_SIZE		(1U << 11)				//frames waiting for the USB pipe
+
+/* PPP frames are written here in the tcpip thread and sent from in place by
+   the application thread, the USB transfer reading them */
+static uint8_t		ec20_tx_buf[EC20_PPP_TX_SIZE];
+static ring_t		ec20_tx = RING_INIT(ec20_tx_buf);
+#endif
+
 
 char * ec20_tx_cmd[EC20_APPLICATION_MAX_NUM] = 
 {
@@ -30,12 +52,39 @@ char * ec20_tx_cmd[EC20_APPLICATION_MAX_NUM] =
 	[EC20_APPLICATION_QUERY_CS] 	= _CMD_QUERY_CS_,
 	[EC20_APPLICATION_QUERY_PS] 	= _CMD_QUERY_PS_,
 	[EC20_APPLICATION_CONFIG_PDP] 	= _CMD_CONFIG_PDP_,
+#if PPP_SUPPORT
+	[EC20_APPLICATION_DIAL] 		= _CMD_DIAL_,
+#endif
 	[EC20_APPLICATION_ACTIVATE_PDP] = _CMD_ACTIVATE_PDP_,
 	[EC20_APPLICATION_RUNNING] 		= _CMD_RUNNING_,
 };
 
 ec20_cmd cmd[];
 
+static const char * ec20_state_names[EC20_APPLICATION_MAX_NUM] =
+{
+	[EC20_APPLICATION_IDLE]			= "IDLE",
+	[EC20_APPLICATION_START]		= "START",
+	[EC20_APPLICATION_READY]		= "READY",
+	[EC20_APPLICATION_SMS_DONE]		= "SMS_DONE",
+	[EC20_APPLICATION_QUERY_CARD]	= "QUERY_CARD",
+	[EC20_APPLICATION_QUERY_CS]		= "QUERY_CS",
+	[EC20_APPLICATION_QUERY_PS]		= "QUERY_PS",
+	[EC20_APPLICATION_CONFIG_PDP]	= "CONFIG_PDP",
+#if PPP_SUPPORT
+	[EC20_APPLICATION_DIAL]			= "DIAL",
+	[EC20_APPLICATION_PPP]			= "PPP",
+#endif
+	[EC20_APPLICATION_ACTIVATE_PDP]	= "ACTIVATE_PDP",
+	[EC20_APPLICATION_RUNNING]		= "RUNNING",
+	[EC20_APPLICATION_DISCONNECT]	= "DISCONNECT",
+};
+
+/* The host handle of the modem while it is enumerated, for ec20_get_status() */
+static USBH_HandleTypeDef *	ec20_host = NULL;
+
+static void Start_EC20_Application_Thread(void const *argument);
+
 int	ec20_recv_cmd_select(USBH_HandleTypeDef *phost);
 
 USBH_StatusTypeDef delete_EC20_Application(USBH_HandleTypeDef *phost);
@@ -72,6 +121,7 @@ USBH_StatusTypeDef new_EC20_Application(USBH_HandleTypeDef *phost)
 	app_data->Appli_state = EC20_APPLICATION_IDLE;
 
 	phost->app_data = app_data;
+	ec20_host = phost;
 
 	return USBH_OK;
 }
@@ -125,6 +175,176 @@ static USBH_StatusTypeDef EC20_send_data(USBH_HandleTypeDef *phost, uint8_t *pbu
 
 void ec20PowerInit(void);
 
+#if PPP_SUPPORT
+void USBH_EC20_TransmitCallback(USBH_HandleTypeDef *phost)
+{
+	ec20_app 				*app_data		= NULL;
+
+	if(NULL == phost || NULL == phost->app_data)
+		return;
+
+	app_data = (ec20_app *)phost->app_data;
+	if(1 == app_data->ppp_tx_busy)
+	{
+		app_data->ppp_tx_busy = 0;
+		osSignalSet(app_data->EC20_Send_Thread_id, EC20_TX_SIGNAL);
+	}
+}
+
+int	ec20_recv_ppp(USBH_HandleTypeDef *phost)
+{
+	ec20_app 				*app_data		= NULL;
+
+	if(NULL == phost->app_data)
+		return -1;
+
+	app_data = (ec20_app *)phost->app_data;
+
+	//copied into pbufs and handed to the tcpip thread, recv_buf is rearmed after
+	pppos_input_tcpip(app_data->ppp, (u8_t *)app_data->recv_buf, USBH_EC20_GetLastReceivedDataSize(phost));
+
+	return 0;
+}
+
+/* tcpip thread: the escaped frame is queued, not copied again */
+static u32_t ec20_ppp_output(ppp_pcb *pcb, u8_t *data, u32_t len, void *ctx)
+{
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(ctx);
+
+	return ring_write(&ec20_tx, data, len);
+}
+
+/* tcpip thread */
+static void ec20_ppp_status(ppp_pcb *pcb, int err_code, void *ctx)
+{
+	USBH_HandleTypeDef 		*phost			= (USBH_HandleTypeDef *)ctx;
+	ec20_app 				*app_data		= (ec20_app *)phost->app_data;
+
+	if(PPPERR_NONE == err_code)
+	{
+		__PRINT_LOG__(__CRITICAL_LEVEL__, "PPP up: %s\r\n", ip4addr_ntoa(netif_ip4_addr(ppp_netif(pcb))));
+		linkmgr_attach(LINK_LTE, ppp_netif(pcb));
+		return;
+	}
+
+	__PRINT_LOG__(__ERR_LEVEL__, "PPP down: %d\r\n", err_code);
+	linkmgr_detach(LINK_LTE);
+	if(NULL != app_data)
+	{
+		app_data->ppp_dead = 1;
+		osSignalSet(app_data->EC20_Send_Thread_id, RING_SIGNAL);
+	}
+}
+
+/* CONNECT is in the data received last, the modem sends PPP from the end
+   of its line: in this packet already or in the next one. PPP is started
+   before the next packet is taken and given the rest of this one, queued
+   behind ppp_connect() in the tcpip thread. */
+static int ec20_ppp_connect(USBH_HandleTypeDef *phost, ec20_app *app_data)
+{
+	char 					*end			= app_data->recv_buf + USBH_EC20_GetLastReceivedDataSize(phost);
+	char 					*data;
+
+	if(NULL != app_data->result_buff)
+	{
+		vPortFree(app_data->result_buff);
+		app_data->result_buff = NULL;
+	}
+	app_data->result_flag = 0;
+	app_data->timeout_times = 0;
+
+	data = strstr(app_data->recv_buf, "CONNECT");
+	if(NULL == data)
+	{
+		//split over two packets, its end is in this one
+		data = app_data->recv_buf;
+	}
+	data = (char *)memchr(data, '\n', end - data);
+	data = (NULL == data) ? end : data + 1;
+
+	LOCK_TCPIP_CORE();
+	if(NULL == app_data->ppp)
+	{
+		app_data->ppp = pppos_create(&app_data->ppp_netif, ec20_ppp_output, ec20_ppp_status, phost);
+	}
+	if(NULL != app_data->ppp)
+	{
+		app_data->ppp_dead = 0;
+		app_data->ec20_recvdata = ec20_recv_ppp;
+		ppp_connect(app_data->ppp, 0);
+	}
+	UNLOCK_TCPIP_CORE();
+
+	if(NULL == app_data->ppp)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "pppos_create failed!\r\n");
+		app_data->ec20_recvdata = ec20_recv_cmd_select;
+	}
+	else if(data < end)
+	{
+		pppos_input_tcpip(app_data->ppp, (u8_t *)data, end - data);
+	}
+
+	osMessagePut(app_data->AppliEvent, EC20_APPLICATION_PPP, 0);
+	return 0;
+}
+
+/* Runs the PPP session started by ec20_ppp_connect() until it ends or the
+   application stops, sending the frames queued by ec20_ppp_output() */
+static USBH_StatusTypeDef ec20_ppp_run(USBH_HandleTypeDef *phost, ec20_app *app_data)
+{
+	const uint8_t 			*data;
+	uint32_t 				len;
+
+	if(ec20_recv_ppp != app_data->ec20_recvdata)
+	{
+		return USBH_FAIL;
+	}
+
+	ring_attach(&ec20_tx, osThreadGetId(), 1);
+
+	while(0 == app_data->g_stop_flag && 0 == app_data->ppp_dead)
+	{
+		len = ring_peek(&ec20_tx, &data);
+		if(0 == len)
+		{
+			osSignalWait(RING_SIGNAL, (0 == ring_pending(&ec20_tx)) ? 100 : 1);
+			continue;
+		}
+
+		app_data->ppp_tx_busy = 1;
+		if(USBH_OK != USBH_EC20_Transmit(phost, (uint8_t *)data, len))
+		{
+			app_data->ppp_tx_busy = 0;
+			osDelay(1);
+			continue;
+		}
+		ring_consume(&ec20_tx, len);
+
+		while(1 == app_data->ppp_tx_busy && 0 == app_data->g_stop_flag)
+		{
+			osSignalWait(EC20_TX_SIGNAL, 100);
+		}
+		ring_release(&ec20_tx, 0);
+		app_data->tx_total_num += len;
+	}
+
+	LOCK_TCPIP_CORE();
+	if(0 == app_data->ppp_dead)
+	{
+		linkmgr_detach(LINK_LTE);
+		ppp_close(app_data->ppp, 1);
+	}
+	app_data->ec20_recvdata = ec20_recv_cmd_select;
+	UNLOCK_TCPIP_CORE();
+
+	ring_detach(&ec20_tx, 0);
+
+	return USBH_OK;
+}
+#endif
+
 static void Start_EC20_Application_Thread(void const *argument)
 {
 	USBH_HandleTypeDef 			*phost 		= NULL;
@@ -209,6 +429,25 @@ static void Start_EC20_Application_Thread(void const *argument)
 				Status = EC20_send_data(phost, (unsigned char *)send_buf, 64, _CMD_CONFIG_PDP_);
 				break;
 
+#if PPP_SUPPORT
+			case EC20_APPLICATION_DIAL:
+				app_data->Appli_state = EC20_APPLICATION_DIAL;
+				++app_data->timeout_times;
+				Status = EC20_send_data(phost, (unsigned char *)send_buf, 64, _CMD_DIAL_);
+				break;
+
+			case EC20_APPLICATION_PPP:
+				app_data->Appli_state = EC20_APPLICATION_PPP;
+				Status = ec20_ppp_run(phost, app_data);
+				if(USBH_OK == Status && 0 == app_data->g_stop_flag)
+				{
+					app_data->timeout_times = 0;
+					osDelay(1000);
+					osMessagePut(app_data->AppliEvent, EC20_APPLICATION_DIAL, 0);// redial
+				}
+				break;
+#endif
+
 			case EC20_APPLICATION_ACTIVATE_PDP:
 				app_data->Appli_state = EC20_APPLICATION_ACTIVATE_PDP;
 				++app_data->timeout_times;
@@ -274,7 +513,7 @@ USBH_StatusTypeDef start_EC20_Application(USBH_HandleTypeDef *phost)
 
 	app_data = (ec20_app *)phost->app_data;
 
-	osThreadDef(EC20_Send_Thread, Start_EC20_Application_Thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	osThreadDef(EC20_Send_Thread, Start_EC20_Application_Thread, osPriorityNormal, 0, EC20_THREAD_STACK);
     app_data->EC20_Send_Thread_id = osThreadCreate(osThread(EC20_Send_Thread), phost);
 	if(NULL == app_data->EC20_Send_Thread_id)
 	{
@@ -350,7 +589,10 @@ USBH_StatusTypeDef delete_EC20_Application(USBH_HandleTypeDef *phost)
 	{
 		__PRINT_LOG__(__CRITICAL_LEVEL__, "app_data is null!\r\n");
 	}
+	taskENTER_CRITICAL();
+	ec20_host = NULL;
 	phost->app_data = NULL;
+	taskEXIT_CRITICAL();
 
 	app_data->ec20_recvdata = NULL;
 
@@ -360,6 +602,16 @@ USBH_StatusTypeDef delete_EC20_Application(USBH_HandleTypeDef *phost)
 		app_data->result_buff = NULL;
 	}
 
+#if PPP_SUPPORT
+	if(NULL != app_data->ppp)
+	{
+		LOCK_TCPIP_CORE();
+		ppp_free(app_data->ppp);
+		UNLOCK_TCPIP_CORE();
+		app_data->ppp = NULL;
+	}
+#endif
+
 	osMessageDelete(app_data->AppliEvent);
 	vPortFree(app_data);
 	app_data = NULL;
@@ -470,6 +722,13 @@ int	ec20_recv_general(USBH_HandleTypeDef *phost)
 						strlen(cmd[app_data->cmd_index].result));
 			}
 		}
+#if PPP_SUPPORT
+		if(1 == app_data->result_flag && EC20_APPLICATION_DIAL == app_data->Appli_state)
+		{
+			//PPP follows, there is no short packet to wait for
+			return ec20_ppp_connect(phost, app_data);
+		}
+#endif
 		app_data->ec20_recvdata = ec20_recv_general;
 	}
 	else//last segment or frist segment
@@ -501,6 +760,12 @@ int	ec20_recv_general(USBH_HandleTypeDef *phost)
 
 		if(1 == app_data->result_flag)
 		{			
+#if PPP_SUPPORT
+			if(EC20_APPLICATION_DIAL == app_data->Appli_state)
+			{
+				return ec20_ppp_connect(phost, app_data);
+			}
+#endif
 			app_data->result_flag = 0;
 			
 #ifdef __EC20_DEBUG__
@@ -578,6 +843,9 @@ ec20_cmd cmd[] =
 	{_CMD_QUERY_CS_, 		"OK", 		ec20_recv_general},
 	{_CMD_QUERY_PS_, 		"OK", 		ec20_recv_general},
 	{_CMD_CONFIG_PDP_, 		"OK", 		ec20_recv_general},
+#if PPP_SUPPORT
+	{_CMD_DIAL_, 			"CONNECT", 	ec20_recv_general},
+#endif
 	{_CMD_ACTIVATE_PDP_, 	"OK", 		ec20_recv_general},
 	{_CMD_RUNNING_, 		"OK", 		ec20_recv_running},
 };
@@ -708,6 +976,41 @@ int	ec20_recv_cmd_select(USBH_HandleTypeDef *phost)
 	return 0;*/
 }
 
+/* A copy of the state of the modem, from any thread: the application is
+   not deleted while it is taken */
+void ec20_get_status(ec20_status_t *status)
+{
+	ec20_app 	*app_data	= NULL;
+
+	memset(status, 0, sizeof(ec20_status_t));
+	taskENTER_CRITICAL();
+	if(NULL != ec20_host)
+	{
+		app_data = (ec20_app *)ec20_host->app_data;
+	}
+	if(NULL != app_data)
+	{
+		status->present		= 1;
+		status->state		= (uint8_t)app_data->Appli_state;
+		status->timeouts	= app_data->timeout_times;
+		status->rx_bytes	= app_data->rx_total_num;
+		status->tx_bytes	= app_data->tx_total_num;
+#if PPP_SUPPORT
+		status->ppp_up		= (EC20_APPLICATION_PPP == app_data->Appli_state) && netif_is_up(&app_data->ppp_netif);
+#endif
+	}
+	taskEXIT_CRITICAL();
+}
+
+const char * ec20_state_name(uint8_t state)
+{
+	if((state < EC20_APPLICATION_MAX_NUM) && (NULL != ec20_state_names[state]))
+	{
+		return ec20_state_names[state];
+	}
+	return "?";
+}
+
 Usb_Application_Class app_ec20 =
 {
 	USB_EC20_CLASS,
@@ -2,6 +2,11 @@
 #include "cmsis_os.h"
 #include "usbh_ec20.h"
 
+#include "lwip/opt.h"
+#if PPP_SUPPORT
+#include "netif/ppp/pppos.h"
+#endif
+
 #define RECV_BUFF_SIZE		(64)
 
 typedef enum {
@@ -14,6 +19,10 @@ typedef enum {
 	EC20_APPLICATION_QUERY_CS,					//AT+CREG?
 	EC20_APPLICATION_QUERY_PS,					//AT+CGREG?/AT+CEREG?
 	EC20_APPLICATION_CONFIG_PDP,				//AT+QICSGP/AT+CGQREQ/AT+CGEQREQ/AT+CGQMIN/AT+CGEQMIN
+#if PPP_SUPPORT
+	EC20_APPLICATION_DIAL,						//ATD*99#
+	EC20_APPLICATION_PPP,						//IP over PPP: the LTE uplink of the link manager
+#endif
 	EC20_APPLICATION_ACTIVATE_PDP,				//AT+QIACT=<contextID>
 	EC20_APPLICATION_RUNNING,					//AT+QPING=1,"www.baidu.com"
 	EC20_APPLICATION_DISCONNECT,
@@ -37,6 +46,12 @@ typedef struct _ec20_app
 	char					*result_buff;
 	int						result_flag;
 	unsigned char			timeout_times;
+#if PPP_SUPPORT
+	ppp_pcb					*ppp;
+	struct netif			ppp_netif;
+	volatile unsigned char	ppp_dead;				//set by the PPP status callback
+	volatile unsigned char	ppp_tx_busy;			//cleared by USBH_EC20_TransmitCallback()
+#endif
 }ec20_app;
 
 typedef struct _ec20_cmd
@@ -46,5 +61,17 @@ typedef struct _ec20_cmd
 	int						(*ec20_recvdata)(USBH_HandleTypeDef *phost);
 }ec20_cmd;
 
-static void Start_EC20_Application_Thread(void const *argument);
+/* What the telemetry reports of the modem (app_telemetry.c) */
+typedef struct
+{
+	uint8_t					present;				//an EC20 is enumerated
+	uint8_t					state;					//ApplicationTypeDef
+	uint8_t					timeouts;
+	uint8_t					ppp_up;
+	uint32_t				rx_bytes;
+	uint32_t				tx_bytes;
+}ec20_status_t;
+
+void ec20_get_status(ec20_status_t *status);
+const char * ec20_state_name(uint8_t state);
 
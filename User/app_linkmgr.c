@@ -0,0 +1,444 @@
+#include <string.h>
+
+#include "lwip/tcpip.h"
+#include "lwip/timeouts.h"
+#include "lwip/raw.h"
+#include "lwip/udp.h"
+#include "lwip/icmp.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip4.h"
+
+#include "main.h"
+#include "app_linkmgr.h"
+
+#define LINKMGR_ICMP_ID			0x4c4d		/* identifier of the echo requests */
+
+/* Payload of a probe, echoed back as is */
+typedef struct
+{
+	uint32_t		tick;					/* sys_now() when sent */
+	uint16_t		seq;
+	uint8_t			id;						/* link_id_t */
+	uint8_t			reserved;
+} link_probe_t;
+
+typedef struct
+{
+	struct netif *		netif;				/* NULL while detached */
+#if LINKMGR_PROBE_PORT
+	struct udp_pcb *	pcb;
+#else
+	struct raw_pcb *	pcb;
+#endif
+	uint16_t			seq;				/* of the last probe */
+	uint8_t				sent;				/* a probe is out since the last tick */
+	uint8_t				answered;			/* and it was answered */
+	uint8_t				misses;				/* in a row */
+	uint8_t				answers;			/* in a row */
+	link_status_t		status;
+} link_t;
+
+typedef struct
+{
+	ip4_addr_t			dest;
+	ip4_addr_t			mask;
+	link_id_t			id;
+	uint8_t				used;
+} link_route_t;
+
+static const char *		link_name[LINK_NUM] = { "eth", "lte" };
+
+static link_t			links[LINK_NUM];
+static link_route_t		routes[LINKMGR_ROUTES_MAX];
+static link_policy_t	link_policy = LINK_POLICY_PREFERRED;
+static ip_addr_t		probe_target;
+static int				active = -1;		/* link of the default netif, -1 if none yet */
+static int				running = 0;
+
+
+static void linkmgr_answer(link_t * link, const link_probe_t * probe)
+{
+	uint32_t rtt;
+
+	if((probe->id != (uint8_t)(link - links)) || (probe->seq != link->seq) || (0 == link->sent))
+	{
+		/* Late, it was counted as lost */
+		return;
+	}
+
+	link->answered = 1;
+	rtt = sys_now() - probe->tick;
+	if(rtt > 0xffff)
+	{
+		rtt = 0xffff;
+	}
+	link->status.srtt_ms = (0 == link->status.srtt_ms) ? (uint16_t)rtt :
+						   (uint16_t)((7U * link->status.srtt_ms + rtt) / 8U);
+}
+
+#if LINKMGR_PROBE_PORT
+static void linkmgr_recv(void * arg, struct udp_pcb * pcb, struct pbuf * p, const ip_addr_t * addr, u16_t port)
+{
+	link_probe_t probe;
+
+	if(ip_addr_cmp(addr, &probe_target) && (LINKMGR_PROBE_PORT == port) &&
+	   (sizeof(probe) == pbuf_copy_partial(p, &probe, sizeof(probe), 0)))
+	{
+		linkmgr_answer((link_t *)arg, &probe);
+	}
+	pbuf_free(p);
+}
+#else
+/* Echo replies to the address of the link, the rest goes on to icmp_input() */
+static u8_t linkmgr_recv(void * arg, struct raw_pcb * pcb, struct pbuf * p, const ip_addr_t * addr)
+{
+	struct icmp_echo_hdr	echo;
+	link_probe_t			probe;
+	u16_t					hlen;
+
+	if(!ip_addr_cmp(addr, &probe_target))
+	{
+		return 0;
+	}
+
+	hlen = (u16_t)(IPH_HL((struct ip_hdr *)p->payload) * 4);
+	if((sizeof(echo) != pbuf_copy_partial(p, &echo, sizeof(echo), hlen)) ||
+	   (ICMP_ER != ICMPH_TYPE(&echo)) || (PP_HTONS(LINKMGR_ICMP_ID) != echo.id))
+	{
+		return 0;
+	}
+
+	if(sizeof(probe) == pbuf_copy_partial(p, &probe, sizeof(probe), (u16_t)(hlen + sizeof(echo))))
+	{
+		linkmgr_answer((link_t *)arg, &probe);
+	}
+	pbuf_free(p);
+	return 1;
+}
+#endif
+
+/* Sends the next probe from the address of the link: linkmgr_route() makes
+   it leave through the link's netif */
+static void linkmgr_probe(link_t * link)
+{
+	link_probe_t	probe;
+	struct pbuf		* p;
+#if !LINKMGR_PROBE_PORT
+	struct icmp_echo_hdr * echo;
+#endif
+
+	probe.tick = sys_now();
+	probe.seq = ++link->seq;
+	probe.id = (uint8_t)(link - links);
+	probe.reserved = 0;
+
+	link->sent = 1;
+	link->answered = 0;
+	link->status.probes++;
+
+#if LINKMGR_PROBE_PORT
+	/* The address may have changed since the last probe (DHCP, IPCP) */
+	udp_bind(link->pcb, &link->netif->ip_addr, link->pcb->local_port);
+
+	p = pbuf_alloc(PBUF_TRANSPORT, sizeof(probe), PBUF_RAM);
+	if(NULL == p)
+	{
+		return;
+	}
+	pbuf_take(p, &probe, sizeof(probe));
+	udp_sendto(link->pcb, p, &probe_target, LINKMGR_PROBE_PORT);
+#else
+	raw_bind(link->pcb, &link->netif->ip_addr);
+
+	p = pbuf_alloc(PBUF_IP, sizeof(*echo) + sizeof(probe), PBUF_RAM);
+	if(NULL == p)
+	{
+		return;
+	}
+	echo = (struct icmp_echo_hdr *)p->payload;
+	ICMPH_TYPE_SET(echo, ICMP_ECHO);
+	ICMPH_CODE_SET(echo, 0);
+	echo->id = PP_HTONS(LINKMGR_ICMP_ID);
+	echo->seqno = lwip_htons(link->seq);
+	echo->chksum = 0;
+	MEMCPY(echo + 1, &probe, sizeof(probe));
+	echo->chksum = inet_chksum(echo, p->len);
+	raw_sendto(link->pcb, p, &probe_target);
+#endif
+	pbuf_free(p);
+}
+
+static void linkmgr_down(link_t * link)
+{
+	if(link->status.healthy)
+	{
+		link->status.healthy = 0;
+		link->status.downs++;
+		__PRINT_LOG__(__ERR_LEVEL__, "uplink %s down!\r\n", link_name[link - links]);
+	}
+	link->sent = 0;
+	link->misses = 0;
+	link->answers = 0;
+}
+
+/* Makes the best healthy link of the policy the default netif. Without
+   any, the default stays: it is the first to be probed back. */
+static void linkmgr_select(void)
+{
+	int best = -1;
+	int i;
+
+	for(i = 0; i < LINK_NUM; i++)
+	{
+		if(!links[i].status.healthy)
+		{
+			continue;
+		}
+		if(best < 0)
+		{
+			best = i;
+			if(LINK_POLICY_PREFERRED == link_policy)
+			{
+				break;
+			}
+		}
+		else if(links[i].status.srtt_ms < links[best].status.srtt_ms)
+		{
+			best = i;
+		}
+	}
+
+	if((LINK_POLICY_LATENCY == link_policy) && (best >= 0) && (active >= 0) && (best != active) &&
+	   links[active].status.healthy &&
+	   (links[active].status.srtt_ms < links[best].status.srtt_ms + LINKMGR_RTT_HYSTERESIS))
+	{
+		best = active;
+	}
+
+	if((best < 0) || (best == active))
+	{
+		return;
+	}
+
+	if(active >= 0)
+	{
+		links[active].status.active = 0;
+	}
+	active = best;
+	links[active].status.active = 1;
+	netif_set_default(links[active].netif);
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "uplink %s active, rtt %d ms!\r\n", link_name[active], links[active].status.srtt_ms);
+}
+
+static void linkmgr_tick(void * arg)
+{
+	link_t	* link;
+	int		i;
+
+	for(i = 0; i < LINK_NUM; i++)
+	{
+		link = &links[i];
+		if(NULL == link->netif)
+		{
+			continue;
+		}
+
+		if(!netif_is_up(link->netif) || !netif_is_link_up(link->netif) ||
+		   ip4_addr_isany_val(*netif_ip4_addr(link->netif)))
+		{
+			/* Nothing to wait for */
+			linkmgr_down(link);
+			continue;
+		}
+
+		if(link->sent && link->answered)
+		{
+			link->misses = 0;
+			if((++link->answers >= LINKMGR_PROBE_UP) && !link->status.healthy)
+			{
+				link->status.healthy = 1;
+				__PRINT_LOG__(__CRITICAL_LEVEL__, "uplink %s up, rtt %d ms!\r\n", link_name[i], link->status.srtt_ms);
+			}
+		}
+		else if(link->sent)
+		{
+			link->status.lost++;
+			link->answers = 0;
+			if(++link->misses >= LINKMGR_PROBE_LOSS)
+			{
+				linkmgr_down(link);
+			}
+		}
+
+		linkmgr_probe(link);
+	}
+
+	linkmgr_select();
+	sys_timeout(LINKMGR_PROBE_MS, linkmgr_tick, NULL);
+}
+
+static void linkmgr_start(void * arg)
+{
+	sys_timeout(LINKMGR_PROBE_MS, linkmgr_tick, NULL);
+}
+
+/**
+ * Starts probing the uplinks attached, from any thread once tcpip_init()
+ * is done. probe_target answers the probes, a server behind every uplink.
+ */
+void linkmgr_init(link_policy_t policy, const ip4_addr_t * target)
+{
+	link_policy = policy;
+	ip_addr_copy_from_ip4(probe_target, *target);
+
+	if(0 == running)
+	{
+		running = 1;
+		tcpip_callback(linkmgr_start, NULL);
+	}
+}
+
+/* netif is the uplink id from now on, it is probed at the next tick */
+void linkmgr_attach(link_id_t id, struct netif * netif)
+{
+	link_t * link;
+
+	if((id >= LINK_NUM) || (NULL == netif))
+	{
+		return;
+	}
+	link = &links[id];
+
+	if(NULL == link->pcb)
+	{
+#if LINKMGR_PROBE_PORT
+		link->pcb = udp_new();
+		if(NULL != link->pcb)
+		{
+			udp_recv(link->pcb, linkmgr_recv, link);
+		}
+#else
+		link->pcb = raw_new(IP_PROTO_ICMP);
+		if(NULL != link->pcb)
+		{
+			raw_recv(link->pcb, linkmgr_recv, link);
+		}
+#endif
+		if(NULL == link->pcb)
+		{
+			__PRINT_LOG__(__ERR_LEVEL__, "uplink %s: no pcb for the probes!\r\n", link_name[id]);
+			return;
+		}
+	}
+
+	link->netif = netif;
+	link->status.attached = 1;
+	linkmgr_down(link);
+}
+
+/* The netif of the uplink goes away: the traffic moves at once */
+void linkmgr_detach(link_id_t id)
+{
+	link_t * link;
+
+	if((id >= LINK_NUM) || (NULL == links[id].netif))
+	{
+		return;
+	}
+	link = &links[id];
+
+	linkmgr_down(link);
+#if LINKMGR_PROBE_PORT
+	udp_remove(link->pcb);
+#else
+	raw_remove(link->pcb);
+#endif
+	link->pcb = NULL;
+	link->netif = NULL;
+	link->status.attached = 0;
+
+	if(active == (int)id)
+	{
+		link->status.active = 0;
+		active = -1;
+		linkmgr_select();
+	}
+}
+
+void linkmgr_set_policy(link_policy_t policy)
+{
+	link_policy = policy;
+	linkmgr_select();
+}
+
+/**
+ * Sends the traffic to dest/mask through uplink id while it is healthy,
+ * through the default netif otherwise.
+ * @return 0, -1 if LINKMGR_ROUTES_MAX are in use or id is no uplink
+ */
+int linkmgr_route_add(const ip4_addr_t * dest, const ip4_addr_t * mask, link_id_t id)
+{
+	int i;
+
+	if(id >= LINK_NUM)
+	{
+		return -1;
+	}
+
+	for(i = 0; i < LINKMGR_ROUTES_MAX; i++)
+	{
+		if(!routes[i].used)
+		{
+			ip4_addr_set_u32(&routes[i].dest, ip4_addr_get_u32(dest) & ip4_addr_get_u32(mask));
+			ip4_addr_copy(routes[i].mask, *mask);
+			routes[i].id = id;
+			routes[i].used = 1;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void linkmgr_get_status(link_id_t id, link_status_t * status)
+{
+	if(id < LINK_NUM)
+	{
+		*status = links[id].status;
+	}
+}
+
+/**
+ * LWIP_HOOK_IP4_ROUTE_SRC: a packet from the address of an uplink leaves
+ * through it, one from no address to a pinned destination through the
+ * uplink of the route. NULL leaves it to ip4_route(): the netif on the
+ * destination's subnet, else the default one.
+ */
+struct netif * linkmgr_route(const ip4_addr_t * dest, const ip4_addr_t * src)
+{
+	struct netif	* netif;
+	int				i;
+
+	if(!ip4_addr_isany(src))
+	{
+		for(i = 0; i < LINK_NUM; i++)
+		{
+			netif = links[i].netif;
+			if((NULL != netif) && ip4_addr_cmp(src, netif_ip4_addr(netif)) &&
+			   netif_is_up(netif) && netif_is_link_up(netif))
+			{
+				return netif;
+			}
+		}
+		return NULL;
+	}
+
+	for(i = 0; i < LINKMGR_ROUTES_MAX; i++)
+	{
+		if(routes[i].used && links[routes[i].id].status.healthy &&
+		   ip4_addr_netcmp(dest, &routes[i].dest, &routes[i].mask))
+		{
+			return links[routes[i].id].netif;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,96 @@
+#ifndef __APP_LINKMGR_H__
+#define __APP_LINKMGR_H__
+
+#include <stdint.h>
+
+#include "lwip/netif.h"
+#include "lwip/ip4_addr.h"
+
+/*
+ * Link manager: the uplinks of the board, Ethernet and LTE (PPP over the
+ * EC20), and which one the traffic leaves through.
+ *
+ * Every LINKMGR_PROBE_MS each attached uplink sends a probe from its own
+ * address: an ICMP echo, or a datagram to LINKMGR_PROBE_PORT that the server
+ * echoes back. An uplink is healthy after LINKMGR_PROBE_UP answers in a row,
+ * down after LINKMGR_PROBE_LOSS unanswered probes in a row or at once when
+ * its link drops. The default netif follows the policy among the healthy
+ * ones, and linkmgr_route_add() pins destinations on an uplink while it is
+ * healthy.
+ *
+ * Datagrams of a PCB bound to no address pick their netif and source when
+ * they are sent: the ones after a failover leave through the new uplink,
+ * nothing queued is dropped. A PCB bound to the address of an uplink keeps
+ * leaving through it.
+ *
+ * Runs in the tcpip thread. The functions below are called from it or with
+ * LOCK_TCPIP_CORE(), linkmgr_init() from any thread after tcpip_init().
+ */
+
+/* Period of the probes */
+#ifndef LINKMGR_PROBE_MS
+#define LINKMGR_PROBE_MS			200
+#endif
+
+/* Unanswered probes in a row that take an uplink down: failover within
+   (LINKMGR_PROBE_LOSS + 1) * LINKMGR_PROBE_MS */
+#ifndef LINKMGR_PROBE_LOSS
+#define LINKMGR_PROBE_LOSS			3
+#endif
+
+/* Answers in a row that bring an uplink back */
+#ifndef LINKMGR_PROBE_UP
+#define LINKMGR_PROBE_UP			2
+#endif
+
+/* 0: ICMP echo probes, else the UDP echo port of the probe target */
+#ifndef LINKMGR_PROBE_PORT
+#define LINKMGR_PROBE_PORT			0
+#endif
+
+/* LINK_POLICY_LATENCY moves to another uplink only when it answers that
+   much faster, in ms */
+#ifndef LINKMGR_RTT_HYSTERESIS
+#define LINKMGR_RTT_HYSTERESIS		20
+#endif
+
+/* Destinations pinned with linkmgr_route_add() */
+#ifndef LINKMGR_ROUTES_MAX
+#define LINKMGR_ROUTES_MAX			8
+#endif
+
+typedef enum
+{
+	LINK_ETH = 0,
+	LINK_LTE,
+	LINK_NUM
+} link_id_t;
+
+typedef enum
+{
+	LINK_POLICY_PREFERRED = 0,		/* the first healthy one: Ethernet, then LTE */
+	LINK_POLICY_LATENCY				/* the healthy one answering the fastest */
+} link_policy_t;
+
+typedef struct
+{
+	uint8_t		attached;
+	uint8_t		healthy;
+	uint8_t		active;				/* the default netif */
+	uint16_t	srtt_ms;			/* smoothed probe round trip */
+	uint32_t	probes;
+	uint32_t	lost;
+	uint32_t	downs;				/* times it went down */
+} link_status_t;
+
+void linkmgr_init(link_policy_t policy, const ip4_addr_t * probe_target);
+void linkmgr_attach(link_id_t id, struct netif * netif);
+void linkmgr_detach(link_id_t id);
+void linkmgr_set_policy(link_policy_t policy);
+int linkmgr_route_add(const ip4_addr_t * dest, const ip4_addr_t * mask, link_id_t id);
+void linkmgr_get_status(link_id_t id, link_status_t * status);
+
+/* LWIP_HOOK_IP4_ROUTE_SRC */
+struct netif * linkmgr_route(const ip4_addr_t * dest, const ip4_addr_t * src);
+
+#endif
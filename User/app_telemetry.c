@@ -0,0 +1,466 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "lwip/apps/httpd.h"
+
+#include "cmsis_os.h"
+#include "main.h"
+#include "usbh_def.h"
+#include "app_ec20.h"
+#include "app_linkmgr.h"
+#include "app_telemetry.h"
+
+#define NUM_OF_ARRAY(x)			(sizeof(x) / sizeof(x[0]))
+
+#define TELEMETRY_JSON			"application/json"
+#define TELEMETRY_EVENTS		"text/event-stream"
+
+/* The counters of the protocols, the ones kept: all of them with LWIP_PERF */
+#define TELEMETRY_PROTOS		(LINK_STATS || ETHARP_STATS || IP_STATS || ICMP_STATS || UDP_STATS || TCP_STATS)
+
+extern USBH_HandleTypeDef hUSBHost;
+
+/* A copy of a port of the USB host, taken with the scheduler stopped */
+typedef struct
+{
+	uint8_t			present;
+	uint8_t			state;				/* HOST_StateTypeDef */
+	uint8_t			connected;
+	uint8_t			address;
+	uint8_t			speed;
+	uint16_t		vid;
+	uint16_t		pid;
+	const char *	class_name;
+} usb_port_t;
+
+#if TELEMETRY_PROTOS
+static const struct
+{
+	const char *			name;
+	struct stats_proto *	proto;
+} telemetry_protos[] =
+{
+#if LINK_STATS
+	{ "link",	&lwip_stats.link },
+#endif
+#if ETHARP_STATS
+	{ "etharp",	&lwip_stats.etharp },
+#endif
+#if IP_STATS
+	{ "ip",		&lwip_stats.ip },
+#endif
+#if ICMP_STATS
+	{ "icmp",	&lwip_stats.icmp },
+#endif
+#if UDP_STATS
+	{ "udp",	&lwip_stats.udp },
+#endif
+#if TCP_STATS
+	{ "tcp",	&lwip_stats.tcp },
+#endif
+};
+#endif
+
+static const char *		usb_state_name[] =
+{
+	"IDLE", "WAIT_ATTACH", "ATTACHED", "DISCONNECTED", "SPEED", "ENUMERATION", "CLASS_REQUEST",
+	"INPUT", "SET_CONFIG", "CHECK_CLASS", "CLASS", "SUSPENDED", "ABORT"
+};
+static const char *		usb_speed_name[] = { "high", "full", "low" };
+static const char *		link_name[LINK_NUM] = { "eth", "lte" };
+
+/* The SSI tags of status.shtml, in the order of telemetry_ssi() */
+static const char *		telemetry_tags[] =
+{
+	"uptime", "heap", "memerr", "tasks", "eth", "lte", "ec20", "usb"
+};
+
+static TaskStatus_t		task_status[TELEMETRY_TASKS_MAX];
+
+static uint32_t			runtime_last;		/* CYCCNT when last read */
+static uint64_t			runtime_cycles;		/* since telemetry_runtime_init() */
+
+
+static uint32_t memp_errors(void)
+{
+	uint32_t	err = 0;
+#if MEMP_STATS
+	int			i;
+
+	for(i = 0; i < MEMP_MAX; i++)
+	{
+		err += lwip_stats.memp[i]->err;
+	}
+#endif
+	return err;
+}
+
+static const char * link_state(link_id_t id)
+{
+	link_status_t	status;
+
+	linkmgr_get_status(id, &status);
+	if(0 == status.attached)
+	{
+		return "off";
+	}
+	if(0 == status.healthy)
+	{
+		return "down";
+	}
+	return status.active ? "active" : "up";
+}
+
+/* The tasks sorted by number: a document taken in several passes lists them
+   in the same order. Taken again at each pass, as a task deleted since would
+   leave its name pointer dangling. */
+static UBaseType_t task_snapshot(uint32_t * total)
+{
+	TaskStatus_t	task;
+	UBaseType_t		n;
+	UBaseType_t		i;
+	UBaseType_t		j;
+
+	n = uxTaskGetSystemState(task_status, TELEMETRY_TASKS_MAX, total);
+	for(i = 1; i < n; i++)
+	{
+		task = task_status[i];
+		for(j = i; (j > 0) && (task_status[j - 1].xTaskNumber > task.xTaskNumber); j--)
+		{
+			task_status[j] = task_status[j - 1];
+		}
+		task_status[j] = task;
+	}
+	return n;
+}
+
+static void usb_port(uint32_t port, usb_port_t * p)
+{
+	USBH_HandleTypeDef	* phost = &hUSBHost;
+
+	memset(p, 0, sizeof(usb_port_t));
+	taskENTER_CRITICAL();
+	if(0 != port)
+	{
+		phost = hUSBHost.children[port - 1];
+	}
+	if(NULL != phost)
+	{
+		p->present		= 1;
+		p->state		= (uint8_t)phost->gState;
+		p->connected	= phost->device.is_connected;
+		p->address		= phost->device.address;
+		p->speed		= phost->device.speed;
+		p->vid			= phost->device.DevDesc.idVendor;
+		p->pid			= phost->device.DevDesc.idProduct;
+		p->class_name	= (NULL != phost->pActiveClass) ? phost->pActiveClass->Name : NULL;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/* Each handler below writes its document from record s->record on and
+   returns HTTPD_STREAM_MORE when the send buffer is full: it is called again
+   from the same record once it drains */
+
+static u8_t telemetry_stats(struct httpd_stream * s)
+{
+	uint32_t	i;
+
+	if(0 == s->record)
+	{
+		if(ERR_OK != httpd_stream_printf(s, "{\"uptime_ms\":%u,\"heap_free\":%u,\"heap_min\":%u,\"pools\":[",
+			(unsigned)sys_now(), (unsigned)xPortGetFreeHeapSize(), (unsigned)xPortGetMinimumEverFreeHeapSize()))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+#if MEMP_STATS
+	while((i = s->record - 1) < MEMP_MAX)
+	{
+		const struct stats_mem	* pool = lwip_stats.memp[i];
+
+		if(ERR_OK != httpd_stream_printf(s, "%s{\"name\":\"%s\",\"avail\":%u,\"used\":%u,\"max\":%u,\"err\":%u}",
+			(0 == i) ? "" : ",", pool->name, (unsigned)pool->avail, (unsigned)pool->used,
+			(unsigned)pool->max, (unsigned)pool->err))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+#else
+	i = 0;
+	if(1 == s->record)
+	{
+		s->record = 1 + MEMP_MAX;
+	}
+#endif
+#if TELEMETRY_PROTOS
+	while((i = s->record - 1 - MEMP_MAX) < NUM_OF_ARRAY(telemetry_protos))
+	{
+		const struct stats_proto	* proto = telemetry_protos[i].proto;
+
+		if(ERR_OK != httpd_stream_printf(s, "%s\"%s\":{\"xmit\":%u,\"recv\":%u,\"fw\":%u,\"drop\":%u,\"memerr\":%u,\"err\":%u}",
+			(0 == i) ? "],\"protos\":{" : ",", telemetry_protos[i].name, (unsigned)proto->xmit,
+			(unsigned)proto->recv, (unsigned)proto->fw, (unsigned)proto->drop, (unsigned)proto->memerr,
+			(unsigned)proto->err))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	if(ERR_OK != httpd_stream_printf(s, "}}\n"))
+#else
+	LWIP_UNUSED_ARG(i);
+	if(ERR_OK != httpd_stream_printf(s, "]}\n"))
+#endif
+	{
+		return HTTPD_STREAM_MORE;
+	}
+	return HTTPD_STREAM_DONE;
+}
+
+static u8_t telemetry_tasks(struct httpd_stream * s)
+{
+	static const char	* state_name[] = { "running", "ready", "blocked", "suspended", "deleted" };
+	uint32_t			total;
+	UBaseType_t			n = task_snapshot(&total);
+	uint32_t			i;
+
+	if(0 == s->record)
+	{
+		if(ERR_OK != httpd_stream_printf(s, "{\"count\":%u,\"runtime_hz\":%u,\"runtime_total\":%u,\"tasks\":[",
+			(unsigned)uxTaskGetNumberOfTasks(), (unsigned)(SystemCoreClock >> TELEMETRY_RUNTIME_SHIFT),
+			(unsigned)total))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	while((i = s->record - 1) < n)
+	{
+		const TaskStatus_t	* task = &task_status[i];
+
+		if(ERR_OK != httpd_stream_printf(s, "%s{\"name\":\"%s\",\"state\":\"%s\",\"prio\":%u,\"stack_free\":%u,\"runtime\":%u,\"permille\":%u}",
+			(0 == i) ? "" : ",", task->pcTaskName,
+			(task->eCurrentState < NUM_OF_ARRAY(state_name)) ? state_name[task->eCurrentState] : "?",
+			(unsigned)task->uxCurrentPriority, (unsigned)(task->usStackHighWaterMark * sizeof(StackType_t)),
+			(unsigned)task->ulRunTimeCounter,
+			(unsigned)((0 == total) ? 0 : ((uint64_t)task->ulRunTimeCounter * 1000U) / total)))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	/* Listed all of them unless there are more than TELEMETRY_TASKS_MAX */
+	if(ERR_OK != httpd_stream_printf(s, "]}\n"))
+	{
+		return HTTPD_STREAM_MORE;
+	}
+	return HTTPD_STREAM_DONE;
+}
+
+static u8_t telemetry_usb(struct httpd_stream * s)
+{
+	usb_port_t		port;
+	ec20_status_t	ec20;
+	uint32_t		i;
+
+	if(0 == s->record)
+	{
+		if(ERR_OK != httpd_stream_printf(s, "{\"ports\":["))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	/* Port 0 is the root port, always there; the ones of a hub follow */
+	while((i = s->record - 1) <= USBH_MAX_NUM_CHILD)
+	{
+		usb_port(i, &port);
+		if(0 == port.present)
+		{
+			s->record++;
+			continue;
+		}
+		if(ERR_OK != httpd_stream_printf(s, "%s{\"port\":%u,\"state\":\"%s\",\"connected\":%u,\"address\":%u,\"speed\":\"%s\",\"vid\":\"%04x\",\"pid\":\"%04x\",\"class\":\"%s\"}",
+			(0 == i) ? "" : ",", (unsigned)i,
+			(port.state < NUM_OF_ARRAY(usb_state_name)) ? usb_state_name[port.state] : "?",
+			(unsigned)port.connected, (unsigned)port.address,
+			(port.speed < NUM_OF_ARRAY(usb_speed_name)) ? usb_speed_name[port.speed] : "?",
+			(unsigned)port.vid, (unsigned)port.pid, (NULL != port.class_name) ? port.class_name : ""))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	ec20_get_status(&ec20);
+	if(ERR_OK != httpd_stream_printf(s, "],\"ec20\":{\"present\":%u,\"state\":\"%s\",\"timeouts\":%u,\"ppp\":%u,\"rx_bytes\":%u,\"tx_bytes\":%u}}\n",
+		(unsigned)ec20.present, ec20_state_name(ec20.state), (unsigned)ec20.timeouts, (unsigned)ec20.ppp_up,
+		(unsigned)ec20.rx_bytes, (unsigned)ec20.tx_bytes))
+	{
+		return HTTPD_STREAM_MORE;
+	}
+	return HTTPD_STREAM_DONE;
+}
+
+static u8_t telemetry_link(struct httpd_stream * s)
+{
+	link_status_t	status;
+	uint32_t		i;
+
+	/* Two records per uplink */
+	while((i = s->record / 2) < LINK_NUM)
+	{
+		linkmgr_get_status((link_id_t)i, &status);
+		if(0 == (s->record % 2))
+		{
+			if(ERR_OK != httpd_stream_printf(s, "%s\"%s\":{\"state\":\"%s\",\"attached\":%u,\"healthy\":%u,\"active\":%u,\"rtt_ms\":%u,",
+				(0 == i) ? "{" : ",", link_name[i], link_state((link_id_t)i), (unsigned)status.attached,
+				(unsigned)status.healthy, (unsigned)status.active, (unsigned)status.srtt_ms))
+			{
+				return HTTPD_STREAM_MORE;
+			}
+		}
+		if(ERR_OK != httpd_stream_printf(s, "\"probes\":%u,\"lost\":%u,\"downs\":%u}",
+			(unsigned)status.probes, (unsigned)status.lost, (unsigned)status.downs))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+	}
+	if(ERR_OK != httpd_stream_printf(s, "}\n"))
+	{
+		return HTTPD_STREAM_MORE;
+	}
+	return HTTPD_STREAM_DONE;
+}
+
+/* One event per pass, in two records */
+static u8_t telemetry_events(struct httpd_stream * s)
+{
+	ec20_status_t	ec20;
+
+	switch(s->record)
+	{
+	case 0:
+		if(ERR_OK != httpd_stream_printf(s, "id: %u\ndata: {\"uptime_ms\":%u,\"heap_free\":%u,\"mem_err\":%u,\"tasks\":%u,",
+			(unsigned)s->pass, (unsigned)sys_now(), (unsigned)xPortGetFreeHeapSize(), (unsigned)memp_errors(),
+			(unsigned)uxTaskGetNumberOfTasks()))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+		/* fall through */
+	case 1:
+		ec20_get_status(&ec20);
+		if(ERR_OK != httpd_stream_printf(s, "\"eth\":\"%s\",\"lte\":\"%s\",\"ec20\":\"%s\",\"rx_bytes\":%u,\"tx_bytes\":%u}\n\n",
+			link_state(LINK_ETH), link_state(LINK_LTE), ec20.present ? ec20_state_name(ec20.state) : "absent",
+			(unsigned)ec20.rx_bytes, (unsigned)ec20.tx_bytes))
+		{
+			return HTTPD_STREAM_MORE;
+		}
+		/* fall through */
+	default:
+		break;
+	}
+	return HTTPD_STREAM_WAIT;
+}
+
+static const tStream telemetry_streams[] =
+{
+	{ "/stats.json",	TELEMETRY_JSON,		telemetry_stats,	0 },
+	{ "/tasks.json",	TELEMETRY_JSON,		telemetry_tasks,	0 },
+	{ "/usb.json",		TELEMETRY_JSON,		telemetry_usb,		0 },
+	{ "/link.json",		TELEMETRY_JSON,		telemetry_link,		0 },
+	{ "/events",		TELEMETRY_EVENTS,	telemetry_events,	TELEMETRY_EVENT_MS },
+};
+
+/* The values of the tags of status.shtml, LWIP_HTTPD_MAX_TAG_INSERT_LEN
+   characters at most */
+static u16_t telemetry_ssi(int index, char * insert, int len)
+{
+	link_status_t	status;
+	ec20_status_t	ec20;
+	usb_port_t		port;
+	uint32_t		value;
+	uint32_t		i;
+	int				n = 0;
+
+	switch(index)
+	{
+	case 0:		/* uptime */
+		value = sys_now() / 1000U;
+		n = snprintf(insert, len, "%ud %02u:%02u:%02u", (unsigned)(value / 86400U),
+					 (unsigned)(value / 3600U % 24U), (unsigned)(value / 60U % 60U), (unsigned)(value % 60U));
+		break;
+	case 1:		/* heap */
+		n = snprintf(insert, len, "%u of %u bytes free, %u at least", (unsigned)xPortGetFreeHeapSize(),
+					 (unsigned)configTOTAL_HEAP_SIZE, (unsigned)xPortGetMinimumEverFreeHeapSize());
+		break;
+	case 2:		/* memerr */
+		n = snprintf(insert, len, "%u", (unsigned)memp_errors());
+		break;
+	case 3:		/* tasks */
+		n = snprintf(insert, len, "%u", (unsigned)uxTaskGetNumberOfTasks());
+		break;
+	case 4:		/* eth */
+	case 5:		/* lte */
+		linkmgr_get_status((4 == index) ? LINK_ETH : LINK_LTE, &status);
+		n = snprintf(insert, len, "%s, rtt %u ms, %u of %u lost", link_state((4 == index) ? LINK_ETH : LINK_LTE),
+					 (unsigned)status.srtt_ms, (unsigned)status.lost, (unsigned)status.probes);
+		break;
+	case 6:		/* ec20 */
+		ec20_get_status(&ec20);
+		n = ec20.present ? snprintf(insert, len, "%s, rx %u tx %u", ec20_state_name(ec20.state),
+									(unsigned)ec20.rx_bytes, (unsigned)ec20.tx_bytes) :
+						   snprintf(insert, len, "absent");
+		break;
+	case 7:		/* usb */
+		value = 0;
+		for(i = 0; i <= USBH_MAX_NUM_CHILD; i++)
+		{
+			usb_port(i, &port);
+			value += port.connected;
+		}
+		n = snprintf(insert, len, "%u connected", (unsigned)value);
+		break;
+	default:
+		break;
+	}
+
+	if(n < 0)
+	{
+		n = 0;
+	}
+	return (u16_t)((n < len) ? n : (len - 1));
+}
+
+void telemetry_init(void)
+{
+	http_set_ssi_handler(telemetry_ssi, telemetry_tags, NUM_OF_ARRAY(telemetry_tags));
+	http_set_stream_handlers(telemetry_streams, NUM_OF_ARRAY(telemetry_streams));
+	httpd_init();
+}
+
+void telemetry_runtime_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	runtime_last = DWT->CYCCNT;
+	runtime_cycles = 0;
+}
+
+/* The cycle counter extended to 64 bits: read at every context switch, far
+   more often than it wraps (59 s at 72 MHz). perf_init() (LWIP_PERF) zeroes
+   it once at startup, the task running then is charged for up to a wrap. */
+uint32_t telemetry_runtime_count(void)
+{
+	uint32_t	primask = __get_PRIMASK();
+	uint32_t	now;
+	uint32_t	count;
+
+	__disable_irq();
+	now = DWT->CYCCNT;
+	runtime_cycles += now - runtime_last;
+	runtime_last = now;
+	count = (uint32_t)(runtime_cycles >> TELEMETRY_RUNTIME_SHIFT);
+	__set_PRIMASK(primask);
+
+	return count;
+}
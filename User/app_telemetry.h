@@ -0,0 +1,48 @@
+#ifndef __APP_TELEMETRY_H__
+#define __APP_TELEMETRY_H__
+
+#include <stdint.h>
+
+/*
+ * Telemetry of the board, served by the httpd for the monitoring system to
+ * scrape:
+ *
+ *   /stats.json	the lwIP pools and the FreeRTOS heap, the counters of
+ *					the protocols as well with LWIP_PERF
+ *   /tasks.json	the FreeRTOS tasks: state, priority, free stack, CPU time
+ *   /usb.json		the USB host ports, the devices on them, the EC20
+ *   /link.json		the uplinks of the link manager
+ *   /events		a summary of them as server-sent events, every
+ *					TELEMETRY_EVENT_MS
+ *   /status.shtml	a status page, its values filled in by SSI tags
+ *
+ * The documents are written record by record into the TCP send buffer as it
+ * drains (LWIP_HTTPD_STREAM): no response buffer, whatever their length.
+ * Everything runs in the tcpip thread.
+ */
+
+/* Period of the events of /events */
+#ifndef TELEMETRY_EVENT_MS
+#define TELEMETRY_EVENT_MS			1000
+#endif
+
+/* Tasks listed by /tasks.json at most, TaskStatus_t (36 bytes) each */
+#ifndef TELEMETRY_TASKS_MAX
+#define TELEMETRY_TASKS_MAX			12
+#endif
+
+/* The run time clock of the tasks is the DWT cycle counter divided by
+   2^TELEMETRY_RUNTIME_SHIFT: 17.6 kHz at 72 MHz, wrapping every 2.8 days */
+#ifndef TELEMETRY_RUNTIME_SHIFT
+#define TELEMETRY_RUNTIME_SHIFT		12
+#endif
+
+/* Registers the handlers and starts the httpd, in the tcpip thread */
+void telemetry_init(void);
+
+/* portCONFIGURE_TIMER_FOR_RUN_TIME_STATS and portGET_RUN_TIME_COUNTER_VALUE
+   (configGENERATE_RUN_TIME_STATS) */
+void telemetry_runtime_init(void);
+uint32_t telemetry_runtime_count(void);
+
+#endif
@@ -27,8 +27,11 @@
 #include "test_lwip.h"
 #include "test_lwip_seq_api.h"
 #include "test_lwip_tcp_udp_echo_server.h"
+#include "test_lwip_chksum.h"
+#include "test_lwip_mac_filter.h"
 
 #include "test_usbh.h"
+#include "test_fatfs.h"
 
 
 /** @addtogroup STM32F1xx_HAL_Examples
@@ -73,6 +76,7 @@ int main(void)
 
 	/* Add your application code here */
 	uart_init(921600);
+	printlog_init();
 
 	__PRINT_LOG__(__CRITICAL_LEVEL__, "freertos start!\r\n");
 
@@ -81,6 +85,15 @@ int main(void)
 
 	osThreadDef(start_usbh_thread, start_usbh_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
     osThreadCreate(osThread(start_usbh_thread), NULL);
+
+	//osThreadDef(start_fatfs_thread, start_fatfs_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	//osThreadCreate(osThread(start_fatfs_thread), NULL);
+
+	//osThreadDef(start_fatfs_bench_thread, start_fatfs_bench_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	//osThreadCreate(osThread(start_fatfs_bench_thread), NULL);
+
+	//osThreadDef(start_fatfs_copy_thread, start_fatfs_copy_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	//osThreadCreate(osThread(start_fatfs_copy_thread), NULL);
     
 #if LWIP_SOCKET
 	__PRINT_LOG__(__CRITICAL_LEVEL__, "lwip socket start!\r\n");
@@ -92,6 +105,12 @@ int main(void)
 
 	//osThreadDef(start_lwip_echo_thread, start_lwip_echo_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
 	//osThreadCreate(osThread(start_lwip_echo_thread), NULL);
+
+	//osThreadDef(start_lwip_chksum_bench_thread, start_lwip_chksum_bench_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	//osThreadCreate(osThread(start_lwip_chksum_bench_thread), NULL);
+
+	//osThreadDef(start_lwip_mac_filter_test_thread, start_lwip_mac_filter_test_thread, osPriorityNormal, 0, 2 * configMINIMAL_STACK_SIZE);
+	//osThreadCreate(osThread(start_lwip_mac_filter_test_thread), NULL);
 #endif
 
 	/* Start scheduler */
@@ -182,8 +182,9 @@
 #define LAN8742A_PHY_ADDRESS             0x00U
 /* PHY Reset delay these values are based on a 1 ms Systick interrupt*/ 
 #define PHY_RESET_DELAY                 0x000000FFU
-/* PHY Configuration delay */
-#define PHY_CONFIG_DELAY                0x00000FFFU
+/* PHY Configuration delay: ethernetif.c restarts the auto-negotiation right
+   after HAL_ETH_Init(), there is no forced mode to settle */
+#define PHY_CONFIG_DELAY                0x00000001U
 
 #define PHY_READ_TO                     0x0000FFFFU
 #define PHY_WRITE_TO                    0x0000FFFFU
@@ -218,6 +219,8 @@
 
 #define PHY_ISFR                        ((uint16_t)0x1D)    /*!< PHY Interrupt Source Flag register Offset       */
 #define PHY_ISFR_INT4                   ((uint16_t)0x0010)  /*!< PHY Link down inturrupt  						 */
+#define PHY_ISFR_INT6                   ((uint16_t)0x0040)  /*!< PHY Auto-Negotiation complete interrupt         */
+#define PHY_IMR                         ((uint16_t)0x1E)    /*!< PHY Interrupt Mask register Offset              */
 
 /* ################## SPI peripheral configuration ########################## */
 
@@ -0,0 +1,667 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cmsis_os.h"
+#include "ff_gen_drv.h"
+#include "ff_logfile.h"
+#include "usbh_diskio_dma.h"
+
+#include "main.h"
+#include "test_fatfs.h"
+
+extern USBH_HandleTypeDef hUSBHost;
+
+static FATFS 					usb_fs;
+static char 					usb_path[4];
+
+/* FIL objects carry a full sector buffer, keep them off the task stacks */
+static FIL 						data_file;
+
+static struct fatfs_task_stat 	logger_stat = { "logger" };
+static struct fatfs_task_stat 	server_stat = { "server" };
+static struct fatfs_task_stat 	house_stat  = { "housekeeping" };
+
+static char 					copy_path[FATFS_COPY_VOLUMES][4];
+static struct fatfs_task_stat 	copy_stat[FATFS_COPY_VOLUMES] = { { "copy0" }, { "copy1" } };
+
+/* main.c starts one of the three tests: they share their buffers */
+static union
+{
+	struct
+	{
+#if FATFS_TEST_USE_FLOG
+		FLOG 					log_file;
+#else
+		FIL 					log_file;
+#endif
+		BYTE 					log_block[FATFS_TEST_BLOCK_SIZE];
+		BYTE 					data_block[FATFS_TEST_BLOCK_SIZE];
+	} stress;
+	struct
+	{
+		BYTE 					buf[FATFS_BENCH_CHUNK];
+	} bench;
+	struct
+	{
+		FATFS 					fs[FATFS_COPY_VOLUMES];
+		FIL 					src[FATFS_COPY_VOLUMES];
+		FIL 					dst[FATFS_COPY_VOLUMES];
+		BYTE 					buf[FATFS_COPY_VOLUMES][FATFS_COPY_CHUNK];
+	} copy;
+} fatfs_work;
+
+static void fatfs_account(struct fatfs_task_stat * stat, FRESULT res, uint32_t start, uint32_t bytes)
+{
+	uint32_t latency = HAL_GetTick() - start;
+
+	if(FR_OK == res)
+	{
+		stat->ops++;
+		stat->bytes += bytes;
+	}
+	else if(FR_TIMEOUT == res)
+	{
+		stat->timeouts++;
+	}
+	else
+	{
+		stat->errors++;
+	}
+
+	if(latency > stat->max_latency)
+	{
+		stat->max_latency = latency;
+	}
+}
+
+#if FATFS_TEST_USE_FLOG
+static void fatfs_logger_task(void const * argument)
+{
+	FRESULT 	res;
+	UINT 		bw;
+	UINT 		expect;
+	uint32_t 	start;
+	uint32_t 	seq = 0;
+
+	/* the region is allocated once, steady state appends never touch the FAT */
+	f_unlink(FATFS_TEST_LOG_FILE);
+	res = flog_open(&fatfs_work.stress.log_file, FATFS_TEST_LOG_FILE, FATFS_TEST_LOG_LIMIT);
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "flog_open %s failed(%d)!\r\n", FATFS_TEST_LOG_FILE, res);
+		osThreadTerminate(NULL);
+	}
+
+	for(;;)
+	{
+		memset(fatfs_work.stress.log_block, ' ', sizeof(fatfs_work.stress.log_block));
+		snprintf((char *)fatfs_work.stress.log_block, sizeof(fatfs_work.stress.log_block), "%08lu %08lu", (unsigned long)seq++, (unsigned long)HAL_GetTick());
+		fatfs_work.stress.log_block[sizeof(fatfs_work.stress.log_block) - 1] = '\n';
+
+		/* a write fills what is left of the region and no more */
+		expect = sizeof(fatfs_work.stress.log_block);
+		if(flog_space(&fatfs_work.stress.log_file) < expect)
+		{
+			expect = (UINT)flog_space(&fatfs_work.stress.log_file);
+		}
+
+		start = HAL_GetTick();
+		res = flog_write(&fatfs_work.stress.log_file, fatfs_work.stress.log_block, sizeof(fatfs_work.stress.log_block), &bw);
+		if(FR_OK == res && bw != expect)
+		{
+			__PRINT_LOG__(__ERR_LEVEL__, "flog_write %s wrote %u of %u bytes!\r\n", FATFS_TEST_LOG_FILE, bw, expect);
+			break;
+		}
+		if(FR_OK == res && bw < sizeof(fatfs_work.stress.log_block))
+		{
+			/* region full: truncate and start over on a fresh preallocation */
+			fatfs_account(&logger_stat, res, start, bw);
+			res = flog_close(&fatfs_work.stress.log_file);
+			if(FR_OK == res)
+			{
+				f_unlink(FATFS_TEST_LOG_FILE);
+				res = flog_open(&fatfs_work.stress.log_file, FATFS_TEST_LOG_FILE, FATFS_TEST_LOG_LIMIT);
+			}
+			if(FR_OK != res)
+			{
+				__PRINT_LOG__(__ERR_LEVEL__, "flog reopen %s failed(%d)!\r\n", FATFS_TEST_LOG_FILE, res);
+				break;
+			}
+			continue;
+		}
+		fatfs_account(&logger_stat, res, start, bw);
+
+		if(0 == (seq % FATFS_TEST_SYNC_BLOCKS))
+		{
+			start = HAL_GetTick();
+			res = flog_sync(&fatfs_work.stress.log_file);
+			fatfs_account(&logger_stat, res, start, 0);
+		}
+	}
+
+	osThreadTerminate(NULL);
+}
+#else
+static void fatfs_logger_task(void const * argument)
+{
+	FRESULT 	res;
+	UINT 		bw;
+	uint32_t 	start;
+	uint32_t 	seq = 0;
+
+	res = f_open(&fatfs_work.stress.log_file, FATFS_TEST_LOG_FILE, FA_WRITE | FA_OPEN_APPEND);
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "open %s failed(%d)!\r\n", FATFS_TEST_LOG_FILE, res);
+		osThreadTerminate(NULL);
+	}
+
+	for(;;)
+	{
+		memset(fatfs_work.stress.log_block, ' ', sizeof(fatfs_work.stress.log_block));
+		snprintf((char *)fatfs_work.stress.log_block, sizeof(fatfs_work.stress.log_block), "%08lu %08lu", (unsigned long)seq++, (unsigned long)HAL_GetTick());
+		fatfs_work.stress.log_block[sizeof(fatfs_work.stress.log_block) - 1] = '\n';
+
+		start = HAL_GetTick();
+		res = f_write(&fatfs_work.stress.log_file, fatfs_work.stress.log_block, sizeof(fatfs_work.stress.log_block), &bw);
+		fatfs_account(&logger_stat, res, start, bw);
+
+		if(0 == (seq % FATFS_TEST_SYNC_BLOCKS))
+		{
+			start = HAL_GetTick();
+			res = f_sync(&fatfs_work.stress.log_file);
+			fatfs_account(&logger_stat, res, start, 0);
+		}
+
+		if(f_size(&fatfs_work.stress.log_file) >= FATFS_TEST_LOG_LIMIT)
+		{
+			f_close(&fatfs_work.stress.log_file);
+			res = f_open(&fatfs_work.stress.log_file, FATFS_TEST_LOG_FILE, FA_WRITE | FA_CREATE_ALWAYS);
+			if(FR_OK != res)
+			{
+				__PRINT_LOG__(__ERR_LEVEL__, "reopen %s failed(%d)!\r\n", FATFS_TEST_LOG_FILE, res);
+				break;
+			}
+		}
+	}
+
+	osThreadTerminate(NULL);
+}
+#endif
+
+static void fatfs_server_task(void const * argument)
+{
+	FRESULT 	res;
+	UINT 		br;
+	uint32_t 	start;
+
+	for(;;)
+	{
+		/* a TFTP/HTTP style client: open, stream the whole file, close */
+		start = HAL_GetTick();
+		res = f_open(&data_file, FATFS_TEST_DATA_FILE, FA_READ);
+		fatfs_account(&server_stat, res, start, 0);
+		if(FR_OK != res)
+		{
+			osDelay(100);
+			continue;
+		}
+
+		do
+		{
+			start = HAL_GetTick();
+			res = f_read(&data_file, fatfs_work.stress.data_block, sizeof(fatfs_work.stress.data_block), &br);
+			fatfs_account(&server_stat, res, start, br);
+		} while(FR_OK == res && br == sizeof(fatfs_work.stress.data_block));
+
+		f_close(&data_file);
+	}
+}
+
+static void fatfs_housekeeping_task(void const * argument)
+{
+	FRESULT 	res;
+	FATFS 		* fs;
+	DWORD 		fre_clust;
+	FILINFO 	fno;
+	DIR 		dir;
+	uint32_t 	start;
+
+	for(;;)
+	{
+		start = HAL_GetTick();
+		res = f_getfree(usb_path, &fre_clust, &fs);
+		fatfs_account(&house_stat, res, start, 0);
+
+		start = HAL_GetTick();
+		res = f_stat(FATFS_TEST_LOG_FILE, &fno);
+		fatfs_account(&house_stat, res, start, 0);
+
+		start = HAL_GetTick();
+		res = f_opendir(&dir, usb_path);
+		if(FR_OK == res)
+		{
+			while(FR_OK == (res = f_readdir(&dir, &fno)) && 0 != fno.fname[0])
+			{
+			}
+			f_closedir(&dir);
+		}
+		fatfs_account(&house_stat, res, start, 0);
+
+		osDelay(200);
+	}
+}
+
+static void fatfs_report(struct fatfs_task_stat * stat, uint32_t period)
+{
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "%s: ops %lu, %lu KB/s, max %lu ms, timeout %lu, err %lu\r\n",
+					stat->name,
+					(unsigned long)stat->ops,
+					(unsigned long)(stat->bytes / period),
+					(unsigned long)stat->max_latency,
+					(unsigned long)stat->timeouts,
+					(unsigned long)stat->errors);
+
+	stat->bytes = 0;
+	stat->max_latency = 0;
+}
+
+static FRESULT fatfs_prepare_data_file(void)
+{
+	FRESULT 	res;
+	UINT 		bw;
+	uint32_t 	i;
+
+	res = f_open(&data_file, FATFS_TEST_DATA_FILE, FA_WRITE | FA_CREATE_ALWAYS);
+	if(FR_OK != res)
+	{
+		return res;
+	}
+
+	for(i = 0; i < sizeof(fatfs_work.stress.data_block); ++i)
+	{
+		fatfs_work.stress.data_block[i] = (BYTE)i;
+	}
+
+	for(i = 0; i < FATFS_TEST_DATA_SIZE / sizeof(fatfs_work.stress.data_block) && FR_OK == res; ++i)
+	{
+		res = f_write(&data_file, fatfs_work.stress.data_block, sizeof(fatfs_work.stress.data_block), &bw);
+	}
+
+	f_close(&data_file);
+
+	return res;
+}
+
+static FRESULT fatfs_mount_usb(void)
+{
+	if(0 != USBH_LinkDisk(&hUSBHost, 0, 0, usb_path))
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "USBH_LinkDisk failed!\r\n");
+		return FR_NOT_ENABLED;
+	}
+
+	while(NULL == USBH_MSC_GetDevice(&hUSBHost, 0))
+	{
+		osDelay(500);
+	}
+
+	return f_mount(&usb_fs, usb_path, 1);
+}
+
+/*
+ * Multi-task stress and throughput test for the re-entrant FatFs
+ * configuration. A logger, a file server and a housekeeping task share the
+ * USB volume with no application level lock; FatFs serialises them through
+ * the per-volume mutex. Results are printed every FATFS_TEST_REPORT_PERIOD.
+ */
+void start_fatfs_thread(void const * argument)
+{
+	FRESULT res;
+	uint32_t period = FATFS_TEST_REPORT_PERIOD;
+
+	res = fatfs_mount_usb();
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "f_mount failed(%d)!\r\n", res);
+		osThreadTerminate(NULL);
+	}
+
+	res = fatfs_prepare_data_file();
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "prepare %s failed(%d)!\r\n", FATFS_TEST_DATA_FILE, res);
+		osThreadTerminate(NULL);
+	}
+
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "fatfs stress test start on %s\r\n", usb_path);
+
+	/* different priorities so that the volume mutex has to inherit */
+	osThreadDef(fatfs_logger_task, fatfs_logger_task, osPriorityAboveNormal, 0, configMINIMAL_STACK_SIZE * 3);
+	osThreadCreate(osThread(fatfs_logger_task), NULL);
+
+	osThreadDef(fatfs_server_task, fatfs_server_task, osPriorityNormal, 0, configMINIMAL_STACK_SIZE * 3);
+	osThreadCreate(osThread(fatfs_server_task), NULL);
+
+	osThreadDef(fatfs_housekeeping_task, fatfs_housekeeping_task, osPriorityBelowNormal, 0, configMINIMAL_STACK_SIZE * 3);
+	osThreadCreate(osThread(fatfs_housekeeping_task), NULL);
+
+	for(;;)
+	{
+		osDelay(period);
+
+		fatfs_report(&logger_stat, period);
+		fatfs_report(&server_stat, period);
+		fatfs_report(&house_stat, period);
+	}
+}
+
+static const char * fatfs_type_name(BYTE fs_type)
+{
+	switch(fs_type)
+	{
+	case FS_FAT12:
+		return "FAT12";
+	case FS_FAT16:
+		return "FAT16";
+	case FS_FAT32:
+		return "FAT32";
+	case FS_EXFAT:
+		return "exFAT";
+	default:
+		return "unknown";
+	}
+}
+
+static void fatfs_bench_run(BYTE prealloc)
+{
+	FRESULT 	res;
+	UINT 		bw;
+	uint32_t 	i;
+	uint32_t 	seed = 1;
+	uint32_t 	t_write, t_read, t_seek;
+
+	res = f_open(&data_file, FATFS_BENCH_FILE, FA_READ | FA_WRITE | FA_CREATE_ALWAYS);
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "open %s failed(%d)!\r\n", FATFS_BENCH_FILE, res);
+		return;
+	}
+
+	if(prealloc)
+	{
+		/* on exFAT this gives a file with no FAT chain at all */
+		res = f_expand(&data_file, FATFS_BENCH_FILE_SIZE, 1);
+		if(FR_OK != res)
+		{
+			__PRINT_LOG__(__ERR_LEVEL__, "f_expand failed(%d)!\r\n", res);
+			f_close(&data_file);
+			return;
+		}
+	}
+
+	memset(fatfs_work.bench.buf, 0x5A, sizeof(fatfs_work.bench.buf));
+
+	t_write = HAL_GetTick();
+	for(i = 0; i < FATFS_BENCH_FILE_SIZE / sizeof(fatfs_work.bench.buf) && FR_OK == res; ++i)
+	{
+		res = f_write(&data_file, fatfs_work.bench.buf, sizeof(fatfs_work.bench.buf), &bw);
+	}
+	if(FR_OK == res)
+	{
+		res = f_sync(&data_file);
+	}
+	t_write = HAL_GetTick() - t_write;
+
+	t_read = HAL_GetTick();
+	if(FR_OK == res)
+	{
+		res = f_lseek(&data_file, 0);
+	}
+	for(i = 0; i < FATFS_BENCH_FILE_SIZE / sizeof(fatfs_work.bench.buf) && FR_OK == res; ++i)
+	{
+		res = f_read(&data_file, fatfs_work.bench.buf, sizeof(fatfs_work.bench.buf), &bw);
+	}
+	t_read = HAL_GetTick() - t_read;
+
+	t_seek = HAL_GetTick();
+	for(i = 0; i < FATFS_BENCH_SEEKS && FR_OK == res; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		res = f_lseek(&data_file, (seed % (FATFS_BENCH_FILE_SIZE / FATFS_TEST_BLOCK_SIZE)) * FATFS_TEST_BLOCK_SIZE);
+		if(FR_OK == res)
+		{
+			res = f_read(&data_file, fatfs_work.bench.buf, FATFS_TEST_BLOCK_SIZE, &bw);
+		}
+	}
+	t_seek = HAL_GetTick() - t_seek;
+
+	f_close(&data_file);
+
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "bench failed(%d)!\r\n", res);
+		return;
+	}
+
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "%s %s: write %lu KB/s, read %lu KB/s, %d seeks %lu ms\r\n",
+					fatfs_type_name(usb_fs.fs_type),
+					prealloc ? "contiguous" : "chained",
+					(unsigned long)(FATFS_BENCH_FILE_SIZE / (t_write + 1)),
+					(unsigned long)(FATFS_BENCH_FILE_SIZE / (t_read + 1)),
+					FATFS_BENCH_SEEKS,
+					(unsigned long)t_seek);
+}
+
+/*
+ * Large sequential file benchmark. Run it once with a FAT32 stick and once
+ * with an exFAT one; each pass is done on a cluster-by-cluster grown file
+ * and on a preallocated contiguous one.
+ */
+void start_fatfs_bench_thread(void const * argument)
+{
+	FRESULT res;
+
+	res = fatfs_mount_usb();
+	if(FR_OK != res)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "f_mount failed(%d)!\r\n", res);
+		osThreadTerminate(NULL);
+	}
+
+	fatfs_bench_run(0);
+	fatfs_bench_run(1);
+
+	f_unlink(FATFS_BENCH_FILE);
+
+	osThreadTerminate(NULL);
+}
+
+static FRESULT fatfs_copy_file(int job, const char * src, const char * dst)
+{
+	FRESULT 	res;
+	UINT 		br, bw;
+	uint32_t 	start;
+
+	res = f_open(&fatfs_work.copy.src[job], src, FA_READ);
+	if(FR_OK != res)
+	{
+		return res;
+	}
+
+	res = f_open(&fatfs_work.copy.dst[job], dst, FA_WRITE | FA_CREATE_ALWAYS);
+	if(FR_OK != res)
+	{
+		f_close(&fatfs_work.copy.src[job]);
+		return res;
+	}
+
+	for(;;)
+	{
+		start = HAL_GetTick();
+		res = f_read(&fatfs_work.copy.src[job], fatfs_work.copy.buf[job], FATFS_COPY_CHUNK, &br);
+		if(FR_OK != res || 0 == br)
+		{
+			break;
+		}
+
+		res = f_write(&fatfs_work.copy.dst[job], fatfs_work.copy.buf[job], br, &bw);
+		fatfs_account(&copy_stat[job], res, start, bw);
+		if(FR_OK != res || bw != br)
+		{
+			break;
+		}
+	}
+
+	f_close(&fatfs_work.copy.src[job]);
+	if(FR_OK == res)
+	{
+		res = f_close(&fatfs_work.copy.dst[job]);
+	}
+	else
+	{
+		f_close(&fatfs_work.copy.dst[job]);
+	}
+
+	return res;
+}
+
+static void fatfs_copy_task(void const * argument)
+{
+	int 		job = (int)argument;
+	char 		src[16];
+	char 		dst[16];
+	FRESULT 	res;
+
+	/* job i offloads volume i to the next one, so every device reads and writes at once */
+	snprintf(src, sizeof(src), "%s%s", copy_path[job], FATFS_COPY_FILE);
+	snprintf(dst, sizeof(dst), "%s%d.bin", copy_path[(job + 1) % FATFS_COPY_VOLUMES], job);
+
+	for(;;)
+	{
+		res = fatfs_copy_file(job, src, dst);
+		if(FR_OK != res)
+		{
+			__PRINT_LOG__(__ERR_LEVEL__, "copy %s -> %s failed(%d)!\r\n", src, dst, res);
+			osDelay(1000);
+		}
+	}
+}
+
+static int fatfs_mount_all(void)
+{
+	USBH_HandleTypeDef * dev;
+	uint32_t 	start = HAL_GetTick();
+	int 		mounted = 0;
+	uint8_t 	port, lun;
+	int8_t 		max_lun;
+
+	/* hub children enumerate from the host thread after the hub itself */
+	while(mounted < FATFS_COPY_VOLUMES && HAL_GetTick() - start < FATFS_COPY_SCAN_TIMEOUT)
+	{
+		for(port = 0; port <= USBH_MAX_NUM_CHILD && mounted < FATFS_COPY_VOLUMES; ++port)
+		{
+			/* pinned: a hub child handle is freed if unplugged meanwhile */
+			dev = USBH_MSC_Pin(&hUSBHost, port);
+			if(NULL == dev)
+			{
+				continue;
+			}
+
+			max_lun = USBH_MSC_GetMaxLUN(dev);
+			for(lun = 0; lun < max_lun && mounted < FATFS_COPY_VOLUMES; ++lun)
+			{
+				if(0 == USBH_MSC_UnitIsReady(dev, lun))
+				{
+					continue;
+				}
+
+				if(0 != USBH_LinkDisk(&hUSBHost, port, lun, copy_path[mounted]))
+				{
+					USBH_MSC_Unpin(dev);
+					return mounted;
+				}
+
+				if(FR_OK != f_mount(&fatfs_work.copy.fs[mounted], copy_path[mounted], 1))
+				{
+					USBH_UnLinkDisk(copy_path[mounted]);
+					continue;
+				}
+
+				__PRINT_LOG__(__CRITICAL_LEVEL__, "port %d lun %d mounted on %s\r\n", port, lun, copy_path[mounted]);
+				++mounted;
+			}
+			USBH_MSC_Unpin(dev);
+		}
+
+		if(mounted < FATFS_COPY_VOLUMES)
+		{
+			/* start over so that a LUN is never linked twice */
+			while(mounted > 0)
+			{
+				--mounted;
+				f_mount(NULL, copy_path[mounted], 0);
+				USBH_UnLinkDisk(copy_path[mounted]);
+			}
+			osDelay(500);
+		}
+	}
+
+	return mounted;
+}
+
+/*
+ * Concurrent multi-device test: mounts the first FATFS_COPY_VOLUMES ready
+ * LUNs found on the root port and behind a hub, then runs one copy job per
+ * volume at the same priority so that transfers on different devices
+ * interleave.
+ */
+void start_fatfs_copy_thread(void const * argument)
+{
+	FRESULT 	res;
+	UINT 		bw;
+	uint32_t 	i;
+	int 		job;
+	char 		path[16];
+	uint32_t 	period = FATFS_TEST_REPORT_PERIOD;
+
+	if(FATFS_COPY_VOLUMES != fatfs_mount_all())
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "need %d MSC volumes!\r\n", FATFS_COPY_VOLUMES);
+		osThreadTerminate(NULL);
+	}
+
+	memset(fatfs_work.copy.buf[0], 0xA5, FATFS_COPY_CHUNK);
+	for(job = 0; job < FATFS_COPY_VOLUMES; ++job)
+	{
+		snprintf(path, sizeof(path), "%s%s", copy_path[job], FATFS_COPY_FILE);
+		res = f_open(&fatfs_work.copy.src[0], path, FA_WRITE | FA_CREATE_ALWAYS);
+		for(i = 0; i < FATFS_COPY_FILE_SIZE / FATFS_COPY_CHUNK && FR_OK == res; ++i)
+		{
+			res = f_write(&fatfs_work.copy.src[0], fatfs_work.copy.buf[0], FATFS_COPY_CHUNK, &bw);
+		}
+		f_close(&fatfs_work.copy.src[0]);
+
+		if(FR_OK != res)
+		{
+			__PRINT_LOG__(__ERR_LEVEL__, "prepare %s failed(%d)!\r\n", path, res);
+			osThreadTerminate(NULL);
+		}
+	}
+
+	osThreadDef(fatfs_copy_task, fatfs_copy_task, osPriorityNormal, 0, configMINIMAL_STACK_SIZE * 3);
+	for(job = 0; job < FATFS_COPY_VOLUMES; ++job)
+	{
+		osThreadCreate(osThread(fatfs_copy_task), (void *)job);
+	}
+
+	for(;;)
+	{
+		osDelay(period);
+
+		for(job = 0; job < FATFS_COPY_VOLUMES; ++job)
+		{
+			fatfs_report(&copy_stat[job], period);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef __TEST_FATFS_H__
+#define __TEST_FATFS_H__
+
+#include "ff.h"
+
+#define FATFS_TEST_LOG_FILE				"stress.log"
+#define FATFS_TEST_DATA_FILE			"stress.dat"
+#define FATFS_TEST_BLOCK_SIZE			(512)
+#define FATFS_TEST_DATA_SIZE			(64 * 1024)		/* file served by the server task */
+#define FATFS_TEST_LOG_LIMIT			(1024 * 1024)	/* logger restarts its file past this size */
+#define FATFS_TEST_SYNC_BLOCKS			(8)				/* logger calls f_sync every N blocks */
+#define FATFS_TEST_REPORT_PERIOD		(5000)			/* ms between throughput reports */
+
+/* 1: the logger appends through the preallocated ff_logfile API instead of f_write */
+#define FATFS_TEST_USE_FLOG				1
+
+#define FATFS_BENCH_FILE				"bench.bin"
+#define FATFS_BENCH_FILE_SIZE			(8 * 1024 * 1024)
+#define FATFS_BENCH_CHUNK				(4096)
+#define FATFS_BENCH_SEEKS				(256)
+
+#define FATFS_COPY_FILE					"copy.bin"
+#define FATFS_COPY_VOLUMES				(2)				/* e.g. a data stick and one card reader slot */
+#define FATFS_COPY_FILE_SIZE			(1024 * 1024)
+#define FATFS_COPY_CHUNK				(1024)
+#define FATFS_COPY_SCAN_TIMEOUT			(10000)			/* ms to wait for hub children to enumerate */
+
+
+struct fatfs_task_stat
+{
+	const char * name;
+	uint32_t ops;				/* completed file operations */
+	uint32_t bytes;				/* payload moved since the last report */
+	uint32_t errors;			/* FatFs calls that failed for any other reason */
+	uint32_t timeouts;			/* FR_TIMEOUT: the volume mutex was not granted in _FS_TIMEOUT */
+	uint32_t max_latency;		/* worst single call in ms */
+};
+
+void start_fatfs_thread(void const * argument);
+void start_fatfs_bench_thread(void const * argument);
+void start_fatfs_copy_thread(void const * argument);
+
+#endif
@@ -11,6 +11,7 @@
 
 
 #include "main.h"
+#include "systemNetLog.h"
 #include "test_lwip.h"
 
 #if LWIP_SOCKET
@@ -31,7 +32,8 @@ __IO uint8_t DHCP_state = DHCP_OFF;
 
 static struct netif 	gnetif; /* network interface structure */
 static char 			rxbuf[RX_BUFFER_SIZE];
-struct TX_buffer_manage * txbuf = NULL;
+static volatile int		send_running = 0;	/* cleared to stop the log sender */
+static volatile int		send_ended = 0;
 
 struct netif * get_gnetif(void)
 {
@@ -117,7 +119,7 @@ static void Netif_Config(void)
 	}
 
 	/* Set the link callback function, this function is called on change of link status */
-	//netif_set_link_callback(&gnetif, ethernetif_update_config);
+	netif_set_link_callback(&gnetif, ethernetif_update_config);
 }
 
 
@@ -253,76 +255,65 @@ int connect_to_server(struct netif *netif)
 	}
 }
 
+/* Streams the log ring to the socket. write() copies, so the records are
+   given back to the ring as soon as they are written. */
 void send_thread(void const * argument)
 {
 	int * socket_fd = (int *) argument;
-	int ret;
-	struct TX_buffer_manage * tmp = NULL;
-	
-	tmp = (struct TX_buffer_manage *)pvPortMalloc(sizeof(struct TX_buffer_manage));
+	int ret = 0;
+	const uint8_t * data;
+	uint32_t len;
+	uint32_t waiting = 0;
 
-	if(NULL != tmp)
+	netlog_attach(osThreadGetId(), TCP_MSS);
+
+	while(send_running && netif_is_up(&gnetif))
 	{
-		memset(tmp, 0, sizeof(struct TX_buffer_manage));
-		txbuf = tmp;
-		
-		while(netif_is_up(&gnetif))
+		if(0 == netlog_pending())
 		{
-			if(txbuf->p_write - txbuf->p_read)
-			{				
-				unsigned short p_rd = txbuf->p_read;
-				unsigned short p_wt = txbuf->p_write;
-				unsigned short len = (p_wt - p_rd) & TX_BUFFER_MASK;
-				
-				if(((p_rd & TX_BUFFER_MASK) + len) > TX_BUFFER_SIZE)
-				{
-					ret = write(*socket_fd, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK], 
-								TX_BUFFER_SIZE - (p_rd & TX_BUFFER_MASK));
-					if(ret <= 0)
-					{
-						//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-						break;
-					}
-						
-					ret = write(*socket_fd, &txbuf->tx_buffer[0], 
-							(p_rd & TX_BUFFER_MASK) + len - TX_BUFFER_SIZE);
-					if(ret <= 0)
-					{
-						//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-						break;
-					}
-
-				}
-				else
-				{
-					ret = write(*socket_fd, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK], len);
-					if(ret <= 0)
-					{
-						//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-						break;
-					}
-				}
+			waiting = 0;
+			osSignalWait(NETLOG_SIGNAL, LOG_IDLE_MS);
+			continue;
+		}
 
-				txbuf->p_read += (p_wt - p_rd);
+		if(netlog_pending() < TCP_MSS)
+		{
+			if(0 == waiting)
+			{
+				waiting = osKernelSysTick();
 			}
-			else
+			if(osKernelSysTick() - waiting < LOG_FLUSH_MS)
 			{
-				HAL_Delay(1);
+				osSignalWait(NETLOG_SIGNAL, LOG_FLUSH_MS - (osKernelSysTick() - waiting));
+				continue;
 			}
 		}
 
-		__PRINT_LOG__(__ERR_LEVEL__, "netif_is_down tx thread exit(%d)!\r\n", ret);
+		len = netlog_peek(&data);
+		if(0 == len)
+		{
+			/* A record is being written in front */
+			osThreadYield();
+			continue;
+		}
 
-		portENTER_CRITICAL();
-		vPortFree(txbuf);
-		txbuf = NULL;
-		portEXIT_CRITICAL();
-	}
-	else
-	{
-		__PRINT_LOG__(__ERR_LEVEL__, "malloc txbuf failed!\r\n");
+		ret = write(*socket_fd, data, len);
+		if(ret <= 0)
+		{
+			//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
+			break;
+		}
+		netlog_consume((uint32_t)ret);
+		netlog_release(0);
+		waiting = 0;
 	}
 
+	netlog_detach(0);
+
+	__PRINT_LOG__(__ERR_LEVEL__, "netif_is_down tx thread exit(%d)!\r\n", ret);
+
+	send_ended = 1;
+
 	/* Delete the Init Thread */ 
 	for( ;; )
 	{
@@ -381,6 +372,8 @@ void start_lwip_thread(void const * argument)
 			{
 				osThreadId ret;
 				osThreadDef(send_thread, send_thread, osPriorityNormal, 0, configMINIMAL_STACK_SIZE * 5);
+				send_running = 1;
+				send_ended = 0;
 				ret = osThreadCreate (osThread(send_thread), &socket_fd);
 				if(NULL == ret)
 				{
@@ -390,7 +383,9 @@ void start_lwip_thread(void const * argument)
 				{
 					recv_data(&gnetif, socket_fd);
 
-					while(NULL != txbuf)
+					/* The sender notices within LOG_IDLE_MS */
+					send_running = 0;
+					while(!send_ended)
 					{
 						HAL_Delay(1);
 					}
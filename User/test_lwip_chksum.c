@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+
+#include "main.h"
+#include "test_lwip_chksum.h"
+
+/* one spare word so that every source/destination alignment fits */
+static u32_t 					chksum_src[(CHKSUM_BENCH_SIZE + 8) / 4];
+static u32_t 					chksum_dst[(CHKSUM_BENCH_SIZE + 8) / 4];
+static volatile u16_t 			chksum_sink;
+
+/* Byte by byte RFC 1071 sum, as stored in a header */
+static u16_t chksum_reference(const u8_t * data, int len)
+{
+	u32_t sum = 0;
+	int i;
+
+	for(i = 0; i + 1 < len; i += 2)
+	{
+		sum += ((u32_t)data[i] << 8) | data[i + 1];
+	}
+	if(i < len)
+	{
+		sum += (u32_t)data[i] << 8;
+	}
+	while(sum >> 16)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	return lwip_htons((u16_t)~sum);
+}
+
+static int chksum_verify(void)
+{
+	const u8_t * src = (const u8_t *)chksum_src;
+	int soff, len;
+#if LWIP_CHECKSUM_ON_COPY
+	u8_t * dst = (u8_t *)chksum_dst;
+	int doff;
+#endif
+
+	for(soff = 0; soff < 4; ++soff)
+	{
+		for(len = 0; len <= 67; ++len)
+		{
+			if(inet_chksum(src + soff, (u16_t)len) != chksum_reference(src + soff, len))
+			{
+				__PRINT_LOG__(__ERR_LEVEL__, "inet_chksum wrong at offset %d len %d!\r\n", soff, len);
+				return -1;
+			}
+#if LWIP_CHECKSUM_ON_COPY
+			for(doff = 0; doff < 4; ++doff)
+			{
+				memset(dst, 0, CHKSUM_BENCH_SIZE + 8);
+				if((u16_t)~LWIP_CHKSUM_COPY(dst + doff, src + soff, (u16_t)len) != chksum_reference(src + soff, len) ||
+					memcmp(dst + doff, src + soff, len) != 0)
+				{
+					__PRINT_LOG__(__ERR_LEVEL__, "LWIP_CHKSUM_COPY wrong at offsets %d/%d len %d!\r\n", soff, doff, len);
+					return -1;
+				}
+			}
+#endif
+		}
+	}
+	return 0;
+}
+
+static unsigned long chksum_rate(uint32_t ms)
+{
+	return (unsigned long)((uint64_t)CHKSUM_BENCH_SIZE * CHKSUM_BENCH_ROUNDS / (ms + 1));
+}
+
+/*
+ * Checksum throughput over one TCP segment, in KB/s: the sum alone, aligned
+ * and at an odd address, then copying a segment and summing it in two passes
+ * against the fused LWIP_CHKSUM_COPY. Returns -1 if a result is wrong.
+ */
+int lwip_chksum_bench(void)
+{
+	u8_t 		* src = (u8_t *)chksum_src;
+	u8_t 		* dst = (u8_t *)chksum_dst;
+	uint32_t 	i, start;
+	uint32_t 	t_sum, t_odd, t_two_pass;
+#if LWIP_CHECKSUM_ON_COPY
+	uint32_t 	t_fused;
+#endif
+
+	for(i = 0; i < sizeof(chksum_src); ++i)
+	{
+		src[i] = (u8_t)(i * 7 + (i >> 8));
+	}
+
+	if(0 != chksum_verify())
+	{
+		return -1;
+	}
+
+	start = HAL_GetTick();
+	for(i = 0; i < CHKSUM_BENCH_ROUNDS; ++i)
+	{
+		chksum_sink = inet_chksum(src, CHKSUM_BENCH_SIZE);
+	}
+	t_sum = HAL_GetTick() - start;
+
+	start = HAL_GetTick();
+	for(i = 0; i < CHKSUM_BENCH_ROUNDS; ++i)
+	{
+		chksum_sink = inet_chksum(src + 1, CHKSUM_BENCH_SIZE);
+	}
+	t_odd = HAL_GetTick() - start;
+
+	start = HAL_GetTick();
+	for(i = 0; i < CHKSUM_BENCH_ROUNDS; ++i)
+	{
+		MEMCPY(dst, src, CHKSUM_BENCH_SIZE);
+		chksum_sink = inet_chksum(dst, CHKSUM_BENCH_SIZE);
+	}
+	t_two_pass = HAL_GetTick() - start;
+
+#if LWIP_CHECKSUM_ON_COPY
+	start = HAL_GetTick();
+	for(i = 0; i < CHKSUM_BENCH_ROUNDS; ++i)
+	{
+		chksum_sink = LWIP_CHKSUM_COPY(dst, src, CHKSUM_BENCH_SIZE);
+	}
+	t_fused = HAL_GetTick() - start;
+
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "chksum: %lu KB/s, odd %lu KB/s, copy+chksum %lu KB/s, fused %lu KB/s\r\n",
+					chksum_rate(t_sum), chksum_rate(t_odd), chksum_rate(t_two_pass), chksum_rate(t_fused));
+#else
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "chksum: %lu KB/s, odd %lu KB/s, copy+chksum %lu KB/s\r\n",
+					chksum_rate(t_sum), chksum_rate(t_odd), chksum_rate(t_two_pass));
+#endif
+
+	return 0;
+}
+
+void start_lwip_chksum_bench_thread(void const * argument)
+{
+	lwip_chksum_bench();
+
+	osThreadTerminate(NULL);
+}
@@ -0,0 +1,10 @@
+#ifndef __TEST_LWIP_CHKSUM_H__
+#define __TEST_LWIP_CHKSUM_H__
+
+#define CHKSUM_BENCH_SIZE		(1460)			/* one full TCP segment */
+#define CHKSUM_BENCH_ROUNDS		(10000)
+
+int lwip_chksum_bench(void);
+void start_lwip_chksum_bench_thread(void const * argument);
+
+#endif
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/ethernetif.h"
+#include "lwip/netif.h"
+#include "lwip/tcpip.h"
+
+#include "main.h"
+#include "test_lwip_seq_api.h"
+#include "test_lwip_mac_filter.h"
+
+#define MAC_FILTER_TEST_GROUPS		(ETHIF_MAC_FILTER_MAX + MAC_FILTER_TEST_SPILL)
+
+/* Group i of the test: 01:00:5e:7f:00:i, out of the way of real groups */
+static void mac_filter_addr(int i, struct eth_addr * addr)
+{
+	addr->addr[0] = 0x01;
+	addr->addr[1] = 0x00;
+	addr->addr[2] = 0x5e;
+	addr->addr[3] = 0x7f;
+	addr->addr[4] = 0x00;
+	addr->addr[5] = (u8_t)i;
+}
+
+/* Joins or leaves groups first to last-1 of the test in the tcpip thread */
+static err_t mac_filter_set(int first, int last, enum netif_mac_filter_action action)
+{
+	struct eth_addr addr;
+	err_t err = ERR_OK;
+	int i;
+
+	LOCK_TCPIP_CORE();
+	for(i = first; i < last && ERR_OK == err; ++i)
+	{
+		mac_filter_addr(i, &addr);
+		err = ethernetif_mac_filter(&addr, action);
+	}
+	UNLOCK_TCPIP_CORE();
+	return err;
+}
+
+/* Checks the groups the driver counts and the multicast mode of the MAC */
+static int mac_filter_check(const char * step, uint32_t groups, uint32_t spilled, int hash)
+{
+	ethernetif_filter_stats_t stats;
+	uint32_t ffr = ETH->MACFFR;
+
+	ethernetif_get_filter_stats(&stats);
+	if(stats.groups != groups || stats.spilled != spilled || (ffr & ETH_MACFFR_PAM) != 0 ||
+		((ffr & ETH_MACFFR_HM) != 0) != hash)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "mac filter %s: groups %lu/%lu, spilled %lu/%lu, MACFFR 0x%08lx!\r\n", step,
+						(unsigned long)stats.groups, (unsigned long)groups,
+						(unsigned long)stats.spilled, (unsigned long)spilled, (unsigned long)ffr);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Joins more groups than the driver's table holds, then leaves them: the
+ * joins past ETHIF_MAC_FILTER_MAX stay in the hash table, the MAC never
+ * falls back to passing all multicast, and after the last leave it is back
+ * to where it started. Returns -1 if a step is wrong.
+ */
+int lwip_mac_filter_test(void)
+{
+	ethernetif_filter_stats_t base;
+	int hashed;
+
+	/* the groups the stack joined take the first table entries, the test
+	   groups fill it up and MAC_FILTER_TEST_SPILL more spill over */
+	ethernetif_get_filter_stats(&base);
+	hashed = (0 != base.hashed);
+	if(base.groups + MAC_FILTER_TEST_SPILL > ETHIF_MAC_FILTER_MAX)
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "mac filter: %lu groups joined already!\r\n", (unsigned long)base.groups);
+		return -1;
+	}
+
+	if(ERR_OK != mac_filter_set(0, MAC_FILTER_TEST_GROUPS, NETIF_ADD_MAC_FILTER) ||
+		0 != mac_filter_check("join", base.groups + MAC_FILTER_TEST_GROUPS,
+								base.groups + MAC_FILTER_TEST_SPILL, 1))
+	{
+		mac_filter_set(0, MAC_FILTER_TEST_GROUPS, NETIF_DEL_MAC_FILTER);
+		return -1;
+	}
+
+	/* the table entries freed first do not take back the spilled joins */
+	mac_filter_set(0, MAC_FILTER_TEST_SPILL, NETIF_DEL_MAC_FILTER);
+	if(0 != mac_filter_check("leave table", base.groups + MAC_FILTER_TEST_GROUPS - MAC_FILTER_TEST_SPILL,
+								base.groups + MAC_FILTER_TEST_SPILL, 1))
+	{
+		mac_filter_set(MAC_FILTER_TEST_SPILL, MAC_FILTER_TEST_GROUPS, NETIF_DEL_MAC_FILTER);
+		return -1;
+	}
+
+	mac_filter_set(MAC_FILTER_TEST_SPILL, MAC_FILTER_TEST_GROUPS, NETIF_DEL_MAC_FILTER);
+	if(0 != mac_filter_check("leave", base.groups, base.spilled, hashed))
+	{
+		return -1;
+	}
+
+	__PRINT_LOG__(__CRITICAL_LEVEL__, "mac filter: %d groups joined and left, %d past the table\r\n",
+					MAC_FILTER_TEST_GROUPS, MAC_FILTER_TEST_SPILL);
+	return 0;
+}
+
+void start_lwip_mac_filter_test_thread(void const * argument)
+{
+	while(!netif_is_up(get_gnetif()))
+	{
+		osDelay(100);
+	}
+
+	lwip_mac_filter_test();
+
+	osThreadTerminate(NULL);
+}
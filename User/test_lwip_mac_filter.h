@@ -0,0 +1,9 @@
+#ifndef __TEST_LWIP_MAC_FILTER_H__
+#define __TEST_LWIP_MAC_FILTER_H__
+
+#define MAC_FILTER_TEST_SPILL		(4)				/* groups joined past ETHIF_MAC_FILTER_MAX */
+
+int lwip_mac_filter_test(void);
+void start_lwip_mac_filter_test_thread(void const * argument);
+
+#endif
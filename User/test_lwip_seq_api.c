@@ -8,10 +8,16 @@
 #include "lwip/dhcp.h"
 #include "lwip/ip_addr.h"
 #include "lwip/api.h"
+#include "lwip/tcp.h"
+#include "lwip/ip4_napt.h"
 
 
 #include "main.h"
+#include "systemNetLog.h"
+#include "systemNetLend.h"
 #include "test_lwip_seq_api.h"
+#include "app_linkmgr.h"
+#include "app_telemetry.h"
 
 #if LWIP_NETCONN
 
@@ -21,8 +27,8 @@
 
 static struct netif 		gnetif; 				/* network interface structure */
 static char 				rxbuf[RX_BUFFER_SIZE];	/* network RX buffer */
-struct TX_buffer_manage 	* txbuf = NULL;			/* network TX buffer */
 int 						connect_status = LINK_WAITING;
+static volatile int			send_running = 0;		/* the log sender has not ended yet */
 
 struct netif * get_gnetif(void)
 {
@@ -30,106 +36,154 @@ struct netif * get_gnetif(void)
 }
 
 #ifdef USE_TCP
+static osThreadId			log_sender = NULL;		/* woken when the connection is writable again */
+
+/* netconn callback, in the tcpip thread */
+static void log_conn_event(struct netconn * conn, enum netconn_evt evt, u16_t len)
+{
+	if((NETCONN_EVT_SENDPLUS == evt) && (NULL != log_sender))
+	{
+		osSignalSet(log_sender, NETLOG_SIGNAL);
+	}
+}
+
+/* Streams the log ring to conn without copying: a segment is written once
+   TCP_MSS bytes are waiting or the oldest record waited LOG_FLUSH_MS, and
+   its bytes are given back to the ring when acknowledged */
+static err_t tcp_send_log(struct netconn * conn)
+{
+	const uint8_t			* data[2];
+	uint32_t				len[2];
+	struct netvector		vectors[2];
+	uint32_t				waiting = 0;
+	size_t					written;
+	err_t					err = ERR_OK;
+
+	while((LINK_SUCCESS == connect_status) && netif_is_up(&gnetif))
+	{
+		netlog_release(netlend_tcp_unacked(conn));
+
+		if(0 == netlog_pending())
+		{
+			waiting = 0;
+			osSignalWait(NETLOG_SIGNAL, LOG_IDLE_MS);
+			continue;
+		}
+
+		if(netlog_pending() < TCP_MSS)
+		{
+			if(0 == waiting)
+			{
+				waiting = osKernelSysTick();
+			}
+			if(osKernelSysTick() - waiting < LOG_FLUSH_MS)
+			{
+				osSignalWait(NETLOG_SIGNAL, LOG_FLUSH_MS - (osKernelSysTick() - waiting));
+				continue;
+			}
+		}
+
+		if(0 == netlog_peekv(data, len))
+		{
+			/* A record is being written in front */
+			osThreadYield();
+			continue;
+		}
+
+		/* One segment at a time: a segment sent in place takes two pbufs
+		   of TCP_SND_QUEUELEN, three across the end of the ring, a longer
+		   write would not fit in it at once. Both sides of the end go in
+		   one write, so that they make one segment. */
+		if(len[0] >= TCP_MSS)
+		{
+			len[0] = TCP_MSS;
+			len[1] = 0;
+		}
+		else if(len[0] + len[1] > TCP_MSS)
+		{
+			len[1] = TCP_MSS - len[0];
+		}
+		vectors[0].ptr = data[0];
+		vectors[0].len = len[0];
+		vectors[1].ptr = data[1];
+		vectors[1].len = len[1];
+
+		err = netconn_write_vectors_partly(conn, vectors, 2, NETCONN_NOCOPY | NETCONN_DONTBLOCK, &written);
+		if(ERR_OK == err)
+		{
+			netlog_consume((uint32_t)written);
+			waiting = 0;
+		}
+		else if(ERR_WOULDBLOCK == err)
+		{
+			/* Send buffer or window full: woken on NETCONN_EVT_SENDPLUS */
+			netlog_stall();
+			osSignalWait(NETLOG_SIGNAL, LOG_FLUSH_MS);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	return err;
+}
+
 static void tcp_send_thread(void const * argument)
 {	
 	ip_addr_t           	serverAddr;
-	err_t               	err;
+	err_t               	err = ERR_OK;
+	uint32_t				unacked;
 	
 	struct netconn    		* conn = (struct netconn *)argument;
-	struct TX_buffer_manage * tmp = NULL;
 	
-	tmp = (struct TX_buffer_manage *)pvPortMalloc(sizeof(struct TX_buffer_manage));
-	if(NULL != tmp)
+	serverAddr.addr = ipaddr_addr(TARGET_SERVER);
+
+	if(NULL != conn)
 	{
-		memset(tmp, 0, sizeof(struct TX_buffer_manage));
-		txbuf = tmp;
+		__PRINT_LOG__(__CRITICAL_LEVEL__, "TCP identifier create success!\r\n");			
 		
-		serverAddr.addr = ipaddr_addr(TARGET_SERVER);
-
-		if(NULL != conn)
+		err = netconn_connect(conn, &serverAddr, TARGET_PORT);
+		if(ERR_OK == err)
 		{
-			__PRINT_LOG__(__CRITICAL_LEVEL__, "TCP identifier create success!\r\n");			
-			
-			err = netconn_connect(conn, &serverAddr, TARGET_PORT);
-			if(ERR_OK == err)
-			{
-				__PRINT_LOG__(__CRITICAL_LEVEL__, "TCP connect success!\r\n");
+			__PRINT_LOG__(__CRITICAL_LEVEL__, "TCP connect success!\r\n");
 
-				connect_status = LINK_SUCCESS;
-				while(netif_is_up(&gnetif))
-				{
-					if(txbuf->p_write - txbuf->p_read)
-					{				
-						unsigned short p_rd = txbuf->p_read;
-						unsigned short p_wt = txbuf->p_write;
-						unsigned short len = (p_wt - p_rd) & TX_BUFFER_MASK;
-						
-						if(((p_rd & TX_BUFFER_MASK) + len) > TX_BUFFER_SIZE)
-						{
-							err = netconn_write(conn, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK], 
-										TX_BUFFER_SIZE - (p_rd & TX_BUFFER_MASK), NETCONN_COPY);
-							if(ERR_OK != err)
-							{
-								//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-								break;
-							}
-								
-							err = netconn_write(conn, &txbuf->tx_buffer[0], 
-									(p_rd & TX_BUFFER_MASK) + len - TX_BUFFER_SIZE, NETCONN_COPY);
-							if(ERR_OK != err)
-							{
-								//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-								break;
-							}
+			log_sender = osThreadGetId();
+			netlog_attach(log_sender, TCP_MSS);
+			connect_status = LINK_SUCCESS;
 
-						}
-						else
-						{
-							err = netconn_write(conn, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK], 
-												len, NETCONN_COPY);
-							if(ERR_OK != err)
-							{
-								//__PRINT_LOG__(__ERR_LEVEL__, "write failed(%d)!\r\n", ret);
-								break;
-							}
-						}
+			err = tcp_send_log(conn);
 
-						txbuf->p_read += (p_wt - p_rd);
-					}
-					else
-					{
-						HAL_Delay(1);
-					}
-				}
-			}
-			else
+			LOCK_TCPIP_CORE();
+			log_sender = NULL;
+			UNLOCK_TCPIP_CORE();
+
+			/* The pcb would retransmit the bytes lent from the ring after
+			   new records overwrite them: drop them with the connection */
+			unacked = netlend_tcp_abort(conn);
+			if(0 != unacked)
 			{
-				__PRINT_LOG__(__ERR_LEVEL__, "TCP connect failed!\r\n");
-				
-				connect_status = LINK_FAILED;
+				__PRINT_LOG__(__ERR_LEVEL__, "TCP aborted, %u bytes unacked!\r\n", (unsigned)unacked);
 			}
+			netlog_detach(0);
 		}
 		else
 		{
-			__PRINT_LOG__(__ERR_LEVEL__, "TCP identifier create failed!\r\n");
-
+			__PRINT_LOG__(__ERR_LEVEL__, "TCP connect failed!\r\n");
+			
 			connect_status = LINK_FAILED;
 		}
-		
-		__PRINT_LOG__(__ERR_LEVEL__, "netif_is_down tx thread exit(%d)!\r\n", err);
-
-		portENTER_CRITICAL();
-		vPortFree(txbuf);
-		txbuf = NULL;
-		portEXIT_CRITICAL();
 	}
 	else
 	{
-		__PRINT_LOG__(__ERR_LEVEL__, "malloc txbuf failed!\r\n");
+		__PRINT_LOG__(__ERR_LEVEL__, "TCP identifier create failed!\r\n");
 
 		connect_status = LINK_FAILED;
 	}
+	
+	__PRINT_LOG__(__ERR_LEVEL__, "netif_is_down tx thread exit(%d)!\r\n", err);
 
+	send_running = 0;
 	osThreadTerminate(NULL);
 }
 
@@ -171,9 +225,12 @@ static void start_tcp_recv(struct netconn * conn)
 	        }
 	        
 	        if(ERR_MEM == err)
-	        {                            
+	        {
+	            /* No netbuf for now: the data is still queued on the
+	               connection, wait for the other ones to release theirs */
 	            __PRINT_LOG__(__ERR_LEVEL__, "Err val: Memory Error\r\n");
-	            memp_init();
+	            HAL_Delay(10);
+	            continue;
 	        }
 	        break;
 	    }
@@ -181,6 +238,86 @@ static void start_tcp_recv(struct netconn * conn)
 }
 
 #else
+static netlend_t			log_lend;				/* datagrams lent from the log ring, across connections */
+
+/* Streams the log ring to conn without copying: a datagram is sent once
+   TCP_MSS bytes are waiting or the oldest record waited LOG_FLUSH_MS, and
+   its bytes are given back to the ring when the driver has sent it */
+static err_t udp_send_log(struct netconn * conn, struct netbuf * buf)
+{
+	const uint8_t			* data[2];
+	uint32_t				len[2];
+	struct netvector		vectors[2];
+	uint32_t				waiting = 0;
+	err_t					err = ERR_OK;
+
+	while((LINK_SUCCESS == connect_status) && netif_is_up(&gnetif))
+	{
+		netlog_release(netlend_udp_unacked(&log_lend));
+
+		if(0 == netlog_pending())
+		{
+			waiting = 0;
+			osSignalWait(NETLOG_SIGNAL, LOG_IDLE_MS);
+			continue;
+		}
+
+		if(netlog_pending() < TCP_MSS)
+		{
+			if(0 == waiting)
+			{
+				waiting = osKernelSysTick();
+			}
+			if(osKernelSysTick() - waiting < LOG_FLUSH_MS)
+			{
+				osSignalWait(NETLOG_SIGNAL, LOG_FLUSH_MS - (osKernelSysTick() - waiting));
+				continue;
+			}
+		}
+
+		if(0 == netlog_peekv(data, len))
+		{
+			/* A record is being written in front */
+			osThreadYield();
+			continue;
+		}
+
+		/* Across the end of the ring, one datagram of two parts */
+		if(len[0] >= TCP_MSS)
+		{
+			len[0] = TCP_MSS;
+			len[1] = 0;
+		}
+		else if(len[0] + len[1] > TCP_MSS)
+		{
+			len[1] = TCP_MSS - len[0];
+		}
+		vectors[0].ptr = data[0];
+		vectors[0].len = len[0];
+		vectors[1].ptr = data[1];
+		vectors[1].len = len[1];
+
+		err = netlend_udp_send(&log_lend, conn, buf, vectors, 2);
+		if(ERR_WOULDBLOCK == err)
+		{
+			/* Every datagram still in the driver: they are freed as its
+			   DMA completes */
+			netlog_stall();
+			osDelay(1);
+			continue;
+		}
+		netlog_consume(len[0] + len[1]);
+		waiting = 0;
+
+		if(ERR_OK != err)
+		{
+			//__PRINT_LOG__(__ERR_LEVEL__, "netconn_send failed(%d)!\r\n", err);
+			break;
+		}
+	}
+
+	return err;
+}
 
 static void udp_send_thread(void const * argument)
 {
@@ -189,13 +326,9 @@ static void udp_send_thread(void const * argument)
 	
 	struct netconn    		* conn = (struct netconn *)argument;
 	struct netbuf     		* buf;
-	struct TX_buffer_manage * tmp = NULL;
 	
-	tmp = (struct TX_buffer_manage *)pvPortMalloc(sizeof(struct TX_buffer_manage));
-	if(NULL != tmp && NULL != conn)
+	if(NULL != conn)
 	{
-		memset(tmp, 0, sizeof(struct TX_buffer_manage));
-		txbuf = tmp;		
 		serverAddr.addr = ipaddr_addr(TARGET_SERVER);
 
 		err = netconn_bind(conn, IP_ADDR_ANY, TARGET_PORT + 1);
@@ -207,61 +340,16 @@ static void udp_send_thread(void const * argument)
 				buf = netbuf_new();
 				if(NULL != buf) 
 				{
+					netlog_attach(osThreadGetId(), TCP_MSS);
 					connect_status = LINK_SUCCESS;
-					while(netif_is_up(&gnetif))
-					{
-						if(txbuf->p_write - txbuf->p_read)
-						{
-							unsigned short p_rd = txbuf->p_read;
-							unsigned short p_wt = txbuf->p_write;
-							unsigned short len = (p_wt - p_rd) & TX_BUFFER_MASK;								
-
-							if(((p_rd & TX_BUFFER_MASK) + len) > TX_BUFFER_SIZE)
-							{
-								netbuf_ref(buf, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK],
-										TX_BUFFER_SIZE - (p_rd & TX_BUFFER_MASK));
-
-								err = netconn_send(conn, buf);
-								if(ERR_OK != err)
-								{
-									//__PRINT_LOG__(__ERR_LEVEL__, "netconn_send failed(%d)!\r\n", err);
-									break;
-								}
-
-								netbuf_ref(buf, &txbuf->tx_buffer[0],
-										(p_rd & TX_BUFFER_MASK) + len - TX_BUFFER_SIZE);
-								
-								err = netconn_send(conn, buf);
-								if(ERR_OK != err)
-								{
-									//__PRINT_LOG__(__ERR_LEVEL__, "netconn_send failed(%d)!\r\n", err);
-									break;
-								}
-							}
-							else
-							{
- 								netbuf_ref(buf, &txbuf->tx_buffer[p_rd & TX_BUFFER_MASK], len);
-
-								err = netconn_send(conn, buf);
-								if(ERR_OK != err)
-								{
-									//__PRINT_LOG__(__ERR_LEVEL__, "netconn_send failed(%d)!\r\n", err);
-									break;
-								}
-							}
-
-							txbuf->p_read += (p_wt - p_rd);
-						}
-						else
-						{
-							HAL_Delay(1);
-						}
-					}
-					if(NULL != buf)
-                    {
-                        netbuf_delete(buf);
-                        buf = NULL;
-                    }
+
+					udp_send_log(conn, buf);
+
+					/* The datagrams still in the driver stay reserved, the
+					   next sender gives them back as log_lend frees them */
+					netlog_detach(netlend_udp_unacked(&log_lend));
+					netbuf_delete(buf);
+					buf = NULL;
 				}
 				else
 				{
@@ -284,9 +372,10 @@ static void udp_send_thread(void const * argument)
 	else
 	{
 		connect_status = LINK_FAILED;
-		__PRINT_LOG__(__ERR_LEVEL__, "malloc txbuf failed or conn is null!\r\n");
+		__PRINT_LOG__(__ERR_LEVEL__, "conn is null!\r\n");
 	}
 	
+	send_running = 0;
 	osThreadTerminate(NULL);
 }
 
@@ -337,7 +426,7 @@ struct netconn * connect_to_server()
 	struct netconn * conn = NULL;
 	
 #ifdef USE_TCP
-	conn = netconn_new(NETCONN_TCP);
+	conn = netconn_new_with_callback(NETCONN_TCP, log_conn_event);
 #else
 	conn = netconn_new(NETCONN_UDP);
 #endif
@@ -373,6 +462,11 @@ static void start_recv(struct netconn * conn)
 void my_lwip_init_done(void * arg)
 {
 	__PRINT_LOG__(__CRITICAL_LEVEL__, "lwip init done!\r\n");
+#if LWIP_PERF
+	perf_dump_start(LWIP_PERF_DUMP_INTERVAL);
+#endif
+	/* The status page and the JSON endpoints on port 80 */
+	telemetry_init();
 }
 
 static void Netif_Config(void)
@@ -380,6 +474,7 @@ static void Netif_Config(void)
 	ip_addr_t ipaddr;
 	ip_addr_t netmask;
 	ip_addr_t gw;
+	ip4_addr_t target;
 
 #ifdef USE_DHCP
 	ip_addr_set_zero_ip4(&ipaddr);
@@ -401,16 +496,19 @@ static void Netif_Config(void)
 	/*  Registers the default network interface. */
 	netif_set_default(&gnetif);
 
-	if (netif_is_link_up(&gnetif))
-	{
-		/* When the netif is fully configured this function must be called.*/
-		netif_set_up(&gnetif);
-	}
-	else
-	{
-		/* When the netif link is down this function must be called */
-		netif_set_down(&gnetif);
-	}
+	/* The driver raises the link once the PHY has negotiated, DHCP starts then */
+	netif_set_up(&gnetif);
+
+	/* Ethernet is the preferred uplink, LTE takes over while it is down */
+	ip4_addr_set_u32(&target, ipaddr_addr(TARGET_SERVER));
+	LOCK_TCPIP_CORE();
+	linkmgr_attach(LINK_ETH, &gnetif);
+#if IP_NAPT
+	/* The hosts on the Ethernet port go out through LTE with its address */
+	ip4_napt_enable(&gnetif, 1);
+#endif
+	UNLOCK_TCPIP_CORE();
+	linkmgr_init(LINK_POLICY_PREFERRED, &target);
 }
 
 void start_lwip_thread_seq(void const * argument)
@@ -436,7 +534,7 @@ void start_lwip_thread_seq(void const * argument)
 
 		while(1)
 		{
-			if(netif_is_up(&gnetif))
+			if(netif_is_up(&gnetif) && netif_is_link_up(&gnetif))
 			{
 				struct netconn * conn = connect_to_server();
 				if(conn)
@@ -444,10 +542,12 @@ void start_lwip_thread_seq(void const * argument)
 					osThreadId id;
 					
 					connect_status = LINK_WAITING;
+					send_running = 1;
 					
 					if(NULL == (id = init_send_thread(conn)))
 					{
 						__PRINT_LOG__(__ERR_LEVEL__, "lwip send init failed !\r\n");
+						send_running = 0;
 						HAL_Delay(1000);
 					}
 					else
@@ -459,7 +559,9 @@ void start_lwip_thread_seq(void const * argument)
 						
 						start_recv(conn);// should nerver return
 						
-						while(NULL != txbuf)
+						/* The sender notices within LOG_IDLE_MS */
+						connect_status = LINK_FAILED;
+						while(send_running)
 						{
 							HAL_Delay(10);
 						}
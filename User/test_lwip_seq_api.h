@@ -30,16 +30,8 @@
 #define TARGET_SERVER		"192.168.31.30"
 #define TARGET_PORT			(8080)
 #define RX_BUFFER_SIZE		(512)
-#define TX_BUFFER_SIZE		(1U << 7)
-#define TX_BUFFER_MASK		(TX_BUFFER_SIZE - 1)
-
-
-struct TX_buffer_manage
-{
-	unsigned short p_write;
-	unsigned short p_read;
-	unsigned char tx_buffer[TX_BUFFER_SIZE];
-};
+#define LOG_FLUSH_MS		(20)	/* longest a log record waits to fill a segment */
+#define LOG_IDLE_MS			(100)	/* connection checks of the idle log sender */
 
 void start_lwip_thread_seq(void const * argument);
 struct netif * get_gnetif(void);
@@ -10,6 +10,7 @@
 #include "lwip/api.h"
 
 #include "main.h"
+#include "systemNetServer.h"
 #include "test_lwip.h"
 #include "test_lwip_seq_api.h"
 #include "test_lwip_tcp_udp_echo_server.h"
@@ -65,57 +66,21 @@ static void udpecho_thread(void const * argument)
     }
 }
 
-static void tcpecho_thread(void const * argument)
+/* Echoes what fits in the send buffer, the rest on the next call: a client
+   that does not read is slowed down instead of the other ones */
+static uint32_t tcpecho_recv(netsrv_conn_t * c, const uint8_t * data, uint32_t len)
 {
-    struct netconn *conn, *newconn;
-    err_t err;
-
-    __PRINT_LOG__(__CRITICAL_LEVEL__, "TCP echo thread start !\r\n");
-
-    // Create a new connection identifier
-    conn = netconn_new(NETCONN_TCP);
-
-    // Bind connection to well known port number 7
-    err = netconn_bind(conn, NULL, TCP_ECHO_PORT);
-    if(err != ERR_OK)
-    {
-        __PRINT_LOG__(__ERR_LEVEL__, "bind failed !\r\n"); 
-    }
-
-    // Tell connection to go into listening mode
-    netconn_listen(conn);
-
-    __PRINT_LOG__(__ERR_LEVEL__, "TCP listening !\r\n");
-
-    while (1) 
-    {
-        /* Grab new connection. */
-        err = netconn_accept(conn, &newconn);
-        /* Process the new connection. */
-        if (err == ERR_OK) 
-        {
-            struct netbuf *buf;
-            void *data;
-            u16_t len;
-
-            __PRINT_LOG__(__CRITICAL_LEVEL__, "accept new !\r\n");
-
-            while ((err = netconn_recv(newconn, &buf)) == ERR_OK) 
-            {
-                do 
-                {
-                    netbuf_data(buf, &data, &len);
-                    err = netconn_write(newconn, data, len, NETCONN_COPY);
-                } while (netbuf_next(buf) >= 0);
-                netbuf_delete(buf);
-            }
-            /* Close connection and discard connection identifier. */
-            netconn_close(newconn);
-            netconn_delete(newconn);
-        }
-    }
+	return netsrv_write(c, data, len);
 }
 
+static const netsrv_handler_t tcpecho_handler =
+{
+	NULL,
+	tcpecho_recv,
+	NULL,
+	NULL
+};
+
 osThreadId udp_echo_init(void)
 {    
 	osThreadId id;
@@ -126,12 +91,21 @@ osThreadId udp_echo_init(void)
 	return id;
 }
 
+/* The TCP echo port is served by the connection server, up to
+   NETSRV_CONN_MAX clients at once */
 osThreadId tcp_echo_init(void)
 {
 	osThreadId id;
 
-	osThreadDef(tcpecho_thread, tcpecho_thread, osPriorityNormal, 0, configMINIMAL_STACK_SIZE * 5);
-	id = osThreadCreate (osThread(tcpecho_thread), NULL);
+	id = netsrv_init();
+	if(ERR_OK != netsrv_listen(TCP_ECHO_PORT, &tcpecho_handler))
+	{
+		__PRINT_LOG__(__ERR_LEVEL__, "TCP echo listen failed !\r\n");
+	}
+	else
+	{
+		__PRINT_LOG__(__CRITICAL_LEVEL__, "TCP listening !\r\n");
+	}
 
 	return id;
 }